@@ -3,8 +3,24 @@
 
 #include "naru_stdint.h"
 
-/* フォーマットバージョン */
-#define NARU_FORMAT_VERSION   3
+/* フォーマットバージョン
+* 補足）3: 残差を全チャンネルインターリーブで1つのビット列に符号化
+*       4: 残差をチャンネル毎のサブストリームに分けて符号化
+*       5: ブロックのチェックサム種別、rANS符号化ブロック（データタイプ3）、シークテーブルブロック（データタイプ4）を追加
+*          これらは4以前のストリームには現れず、現れたら不正なフォーマットとして扱う */
+#define NARU_FORMAT_VERSION   5
+
+/* ヘッダのレイアウト（バージョン5、数値はビッグエンディアン）
+* 補足）オフセット[byte]: 内容
+*        0: シグネチャ'NARU'(4)      4: フォーマットバージョン(4)  8: コーデックバージョン(4)
+*       12: チャンネル数(2)         14: サンプル数(4)             18: サンプリングレート(4)
+*       22: サンプルあたりビット数(2)
+*       24: ブロックのチェックサム種別(1) 0:CRC16 1:CRC32C
+*       25: シークテーブルの有無(1) 1:末尾にシークテーブルブロック（データタイプ4）あり 0:なし
+*       26: 最大ブロックあたりサンプル数(2)
+*       28: フィルタ次数(1)  29: AR次数(1)  30: 2段目フィルタ次数(1)  31: マルチチャンネル処理法(1)
+*       4以前は24から4byteが最大ブロックあたりサンプル数で、24と25は常に0（CRC16、シークテーブルなし）と読める
+*       シークテーブルが壊れている・欠けている場合、デコーダはブロックヘッダを先頭から辿る */
 
 /* コーデックバージョン */
 #define NARU_CODEC_VERSION    8
@@ -40,6 +56,13 @@ typedef enum NARUChannelProcessMethodTag {
     NARU_CH_PROCESS_METHOD_INVALID    /* 無効値         */
 } NARUChannelProcessMethod;
 
+/* ブロックのチェックサム種別 */
+typedef enum NARUBlockChecksumTypeTag {
+    NARU_BLOCK_CHECKSUM_TYPE_CRC16 = 0,   /* CRC16(IBM)   */
+    NARU_BLOCK_CHECKSUM_TYPE_CRC32C,      /* CRC32C       */
+    NARU_BLOCK_CHECKSUM_TYPE_INVALID      /* 無効値       */
+} NARUBlockChecksumType;
+
 /* ヘッダ情報 */
 struct NARUHeader {
     uint32_t format_version;                    /* フォーマットバージョン         */
@@ -53,6 +76,8 @@ struct NARUHeader {
     uint8_t ar_order;                           /* AR次数                         */
     uint8_t second_filter_order;                /* 2段目フィルタ次数              */
     NARUChannelProcessMethod ch_process_method; /* マルチチャンネル処理法         */
+    NARUBlockChecksumType block_checksum_type;  /* ブロックのチェックサム種別     */
+    uint8_t has_seek_table;                     /* シークテーブルの有無 1:末尾にあり 0:なし */
 };
 
 #endif /* NARU_H_INCLDED */
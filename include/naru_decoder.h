@@ -9,8 +9,25 @@ struct NARUDecoderConfig {
     uint32_t max_num_channels;  /* エンコード可能な最大チャンネル数 */
     uint8_t max_filter_order;   /* 最大フィルタ次数 */
     uint8_t check_crc;          /* CRCによるデータ破損検査を行うか？ 1:ON それ意外:OFF */
+    uint8_t max_num_threads;    /* 一括デコード時に使用する最大スレッド数 */
+    uint32_t max_num_samples_per_block; /* 範囲デコードで使う最大ブロックサンプル数（0の時は範囲デコードを使わない） */
 };
 
+/* ブロック位置情報 */
+struct NARUBlockInformation {
+    uint32_t byte_offset;       /* データ先頭（ヘッダ先頭）からのブロック先頭位置[byte] */
+    uint32_t block_size;        /* 同期コードを含むブロック全体のサイズ[byte] */
+    uint32_t sample_offset;     /* ブロック先頭サンプルの位置 */
+    uint32_t num_samples;       /* ブロックのチャンネルあたりサンプル数 */
+    uint8_t block_type;         /* ブロックデータタイプ（ブロックヘッダの値） */
+};
+
+/* ストリーミングデコードの出力コールバック
+* 補足）bufferにはブロック1つ分（チャンネルあたりnum_samples）のデコード結果が入っている
+*       NARU_APIRESULT_OK以外を返すとデコードを中断し、その値をAPIの結果として返す */
+typedef NARUApiResult (*NARUDecoderWriteCallback)(
+        const struct NARUHeader *header, const int32_t *const *buffer, uint32_t num_samples, void *user_data);
+
 /* デコーダハンドル */
 struct NARUDecoder;
 
@@ -48,6 +65,64 @@ NARUApiResult NARUDecoder_DecodeWhole(
         const uint8_t *data, uint32_t data_size,
         int32_t **buffer, uint32_t buffer_num_channels, uint32_t buffer_num_samples);
 
+/* ヘッダを含むデータからデコードせずに全ブロックの位置を取得
+* 補足）ブロックヘッダのみを辿る。コンフィグでCRC検査がONならばスレッド並列にチェックサムを検査する
+*       block_infoがNULLの時はブロック数のみを数える（チェックサムは検査しない）
+*       失敗時もnum_blocksには先頭から正しく取得できたブロック数を設定する */
+NARUApiResult NARUDecoder_ScanBlocks(
+        struct NARUDecoder *decoder,
+        const uint8_t *data, uint32_t data_size,
+        struct NARUBlockInformation *block_info, uint32_t max_num_blocks, uint32_t *num_blocks);
+
+/* ヘッダを含むデータから指定サンプルを含むブロックの位置を取得
+* 補足）シークテーブルがあればそこからブロックを引き、ないか壊れていれば先頭からブロックヘッダを辿る */
+NARUApiResult NARUDecoder_FindBlock(
+        struct NARUDecoder *decoder,
+        const uint8_t *data, uint32_t data_size,
+        uint32_t sample_position, struct NARUBlockInformation *block_info);
+
+/* ヘッダを含むデータから指定サンプルを含むブロックのみをデコードし、指定サンプルからブロック末尾までを出力
+* 補足）bufferにはブロック全体のサンプル数分の領域が必要。num_decode_samplesには出力したサンプル数を設定する */
+NARUApiResult NARUDecoder_DecodeBlockFromSample(
+        struct NARUDecoder *decoder,
+        const uint8_t *data, uint32_t data_size, uint32_t sample_position,
+        int32_t **buffer, uint32_t buffer_num_channels, uint32_t buffer_num_samples,
+        uint32_t *num_decode_samples);
+
+/* ヘッダを含むデータから範囲[start_sample, end_sample)のサンプルのみをデコード
+* 補足）範囲に重なるブロックのみをデコードする。範囲の両端を含むブロックはコンフィグの
+*       max_num_samples_per_blockサンプルのブロックバッファを介して切り出す
+*       bufferには範囲のサンプル数(end_sample - start_sample)分の領域が必要 */
+NARUApiResult NARUDecoder_DecodeRange(
+        struct NARUDecoder *decoder,
+        const uint8_t *data, uint32_t data_size, uint32_t start_sample, uint32_t end_sample,
+        int32_t **buffer, uint32_t buffer_num_channels, uint32_t buffer_num_samples);
+
+/* ストリーミングデコードの開始
+* 補足）以降に供給されたデータのうち、未完了のヘッダ・ブロックをdataに溜める
+*       dataには最大のブロックサイズ以上が必要。デコード結果はコンフィグのmax_num_samples_per_blockサンプルの
+*       ブロックバッファに受けてからcallbackに渡すため、ヘッダのブロックあたり最大サンプル数以上が必要 */
+NARUApiResult NARUDecoder_BeginStreaming(
+        struct NARUDecoder *decoder,
+        uint8_t *data, uint32_t data_size,
+        NARUDecoderWriteCallback callback, void *user_data);
+
+/* ストリーミングデコードにデータを供給
+* 補足）任意のサイズを受け付け、ブロックが揃う毎にデコードして出力する
+*       最終ブロック（またはシークテーブル）より後のデータは読み捨てる */
+NARUApiResult NARUDecoder_PushData(
+        struct NARUDecoder *decoder, const uint8_t *data, uint32_t data_size);
+
+/* ストリーミングデコードで次の出力までに必要なデータサイズを取得
+* 補足）ブロックヘッダが揃うまではブロックヘッダの残りサイズを返す。全ブロックを出力済みならば0 */
+NARUApiResult NARUDecoder_GetStreamRequiredSize(
+        struct NARUDecoder *decoder, uint32_t *required_size);
+
+/* ストリーミングデコードの終了
+* 補足）ヘッダやブロックの途中で途切れている、またはヘッダの総サンプル数に満たない場合は
+*       NARU_APIRESULT_INSUFFICIENT_DATAを返す（総サンプル数が未確定のヘッダを除く） */
+NARUApiResult NARUDecoder_FinishStreaming(struct NARUDecoder *decoder);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -15,6 +15,11 @@ struct NARUEncodeParameter {
     uint8_t second_filter_order; /* 2段目フィルタ次数 */
     NARUChannelProcessMethod ch_process_method;  /* マルチチャンネル処理法 */
     uint8_t num_encode_trials; /* エンコード繰り返し回数 */
+    uint8_t num_threads;       /* エンコードスレッド数（0,1で単一スレッド） */
+    uint32_t num_preroll_samples; /* ブロック独立エンコード時にフィルタを慣らす先行サンプル数（0でブロック間の状態引き継ぎ） */
+    uint8_t use_rans;          /* rANS符号を使うか？ 1:再帰的ライス符号より小さくなるブロックで使う それ以外:使わない（1の時はコンフィグのenable_ransも1が必要） */
+    NARUBlockChecksumType block_checksum_type; /* ブロックのチェックサム種別 */
+    uint8_t use_seek_table;    /* シークテーブルを付加するか？ 1:全ブロックの後ろに付加する それ以外:付加しない（1の時はコンフィグのenable_seek_tableも1が必要） */
 };
 
 /* エンコーダコンフィグ */
@@ -22,8 +27,21 @@ struct NARUEncoderConfig {
     uint16_t max_num_channels;          /* エンコード可能な最大チャンネル数 */
     uint16_t max_num_samples_per_block; /* ブロックあたり最大サンプル数 */
     uint8_t max_filter_order;           /* 最大フィルタ次数 */
+    uint8_t max_num_threads;            /* 最大エンコードスレッド数 */
+    uint8_t enable_streaming;           /* ストリーミングエンコードを使うか？ 1:入力バッファ（2ブロック分）を確保する それ以外:確保しない */
+    uint8_t enable_rans;                /* rANS符号を使うか？ 1:rANS符号化の作業領域を確保する それ以外:確保しない */
+    uint8_t enable_seek_table;          /* シークテーブルを使うか？ 1:シークテーブルブロックの作成先を確保する それ以外:確保しない */
 };
 
+/* 1ブロックの最大出力サイズ[byte]の計算
+* 補足）1サンプルあたり入力の2倍(64bit)とブロックヘッダ・フィルタ状態の余裕を見込む */
+#define NARUENCODER_CALCULATE_MAX_BLOCK_SIZE(num_channels, num_samples_per_block)\
+    ((uint32_t)((num_channels) * (2 * sizeof(int32_t) * (num_samples_per_block) + 1024)))
+
+/* ストリーミングエンコードの出力コールバック
+* 補足）NARU_APIRESULT_OK以外を返すとエンコードを中断し、その値をAPIの結果として返す */
+typedef NARUApiResult (*NARUEncoderWriteCallback)(const uint8_t *data, uint32_t data_size, void *user_data);
+
 /* エンコーダハンドル */
 struct NARUEncoder;
 
@@ -54,6 +72,27 @@ NARUApiResult NARUEncoder_EncodeWhole(
         const int32_t *const *input, uint32_t num_samples,
         uint8_t *data, uint32_t data_size, uint32_t *output_size);
 
+/* ストリーミングエンコードの開始
+* 補足）総サンプル数が未確定のヘッダをcallbackに出力する。以降のブロックはdataに書き込んだ上でcallbackに渡す
+*       dataにはNARUENCODER_CALCULATE_MAX_BLOCK_SIZEで計算したサイズ以上が必要
+*       コンフィグのenable_streamingが1でないハンドルではNARU_APIRESULT_INSUFFICIENT_BUFFERを返す */
+NARUApiResult NARUEncoder_BeginStreaming(
+        struct NARUEncoder *encoder,
+        uint8_t *data, uint32_t data_size,
+        NARUEncoderWriteCallback callback, void *user_data);
+
+/* ストリーミングエンコードにサンプルを供給
+* 補足）任意のサンプル数を受け付け、ブロックが揃う毎にエンコードして出力する */
+NARUApiResult NARUEncoder_PushSamples(
+        struct NARUEncoder *encoder,
+        const int32_t *const *input, uint32_t num_samples);
+
+/* ストリーミングエンコードの終了
+* 補足）残りのサンプルをエンコードして出力し、総サンプル数を反映したヘッダをheader_dataに書き込む
+*       呼び出し側で出力先頭のヘッダを書き換えること */
+NARUApiResult NARUEncoder_FinishStreaming(
+        struct NARUEncoder *encoder, uint8_t *header_data, uint32_t header_data_size);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
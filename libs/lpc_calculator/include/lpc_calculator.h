@@ -45,6 +45,13 @@ LPCCalculatorApiResult LPCCalculator_EstimateCodeLength(
         const double *data, uint32_t num_samples, uint32_t bits_per_sample,
         const double *parcor_coef, uint32_t order, double *length_per_sample_bits);
 
+/* 自己相関を1回だけ計算し、LPC係数・PARCOR係数・サンプルあたりの推定符号長をまとめて求める */
+/* 係数lpc_coef, parcor_coefはorder+1個の配列 */
+LPCCalculatorApiResult LPCCalculator_CalculateCoefAndCodeLength(
+        struct LPCCalculator *lpcc,
+        const double *data, uint32_t num_samples, uint32_t bits_per_sample,
+        double *lpc_coef, double *parcor_coef, uint32_t order, double *length_per_sample_bits);
+
 #ifdef __cplusplus
 }
 #endif
@@ -48,6 +48,11 @@ static LPCCalculatorError LPCCalculator_CalculateCoef(
         struct LPCCalculator *lpc,
         const double *data, uint32_t num_samples, uint32_t order);
 
+/* 信号の二乗和とPARCOR係数からサンプルあたりの推定符号長を求める */
+static void LPCCalculator_EstimateCodeLengthFromPower(
+        double sum_power, uint32_t num_samples, uint32_t bits_per_sample,
+        const double *parcor_coef, uint32_t order, double *length_per_sample_bits);
+
 /* log2関数（C89で定義されていない） */
 static double LPCCalculator_Log2(double x);
 
@@ -381,34 +386,28 @@ static double LPCCalculator_Log2(double x)
 #undef INV_LOGE2
 }
 
-/* 入力データとPARCOR係数からサンプルあたりの推定符号長を求める */
-LPCCalculatorApiResult LPCCalculator_EstimateCodeLength(
-        const double *data, uint32_t num_samples, uint32_t bits_per_sample,
-        const double *parcor_coef, uint32_t order,
-        double *length_per_sample_bits)
+/* 信号の二乗和とPARCOR係数からサンプルあたりの推定符号長を求める */
+static void LPCCalculator_EstimateCodeLengthFromPower(
+        double sum_power, uint32_t num_samples, uint32_t bits_per_sample,
+        const double *parcor_coef, uint32_t order, double *length_per_sample_bits)
 {
-    uint32_t smpl, ord;
+    uint32_t ord;
     double log2_mean_res_power, log2_var_ratio;
 
     /* 定数値 */
 #define BETA_CONST_FOR_LAPLACE_DIST   (1.9426950408889634)  /* sqrt(2 * E * E) */
 #define BETA_CONST_FOR_GAUSS_DIST     (2.047095585180641)   /* sqrt(2 * E * PI) */
-    /* 引数チェック */
-    if ((data == NULL) || (parcor_coef == NULL) || (length_per_sample_bits == NULL)) {
-        return LPCCALCULATOR_APIRESULT_INVALID_ARGUMENT;
-    }
+
+    assert(parcor_coef != NULL);
+    assert(length_per_sample_bits != NULL);
 
     /* log2(パワー平均)の計算 */
-    log2_mean_res_power = 0.0f;
-    for (smpl = 0; smpl < num_samples; smpl++) {
-        log2_mean_res_power += data[smpl] * data[smpl];
-    }
     /* 整数PCMの振幅に変換（doubleの密度保障） */
-    log2_mean_res_power *= pow(2, (double)(2 * (bits_per_sample - 1)));
+    log2_mean_res_power = sum_power * pow(2, (double)(2 * (bits_per_sample - 1)));
     if (fabs(log2_mean_res_power) <= FLT_MIN) {
         /* ほぼ無音だった場合は符号長を0とする */
         (*length_per_sample_bits) = 0.0f;
-        return LPCCALCULATOR_APIRESULT_OK;
+        return;
     }
     log2_mean_res_power = LPCCalculator_Log2((double)log2_mean_res_power) - LPCCalculator_Log2((double)num_samples);
 
@@ -427,11 +426,68 @@ LPCCalculatorApiResult LPCCalculator_EstimateCodeLength(
     /* 補足）このケースは入力音声パワーが非常に低い */
     if ((*length_per_sample_bits) <= 0) {
         (*length_per_sample_bits) = 1.0f;
-        return LPCCALCULATOR_APIRESULT_OK;
     }
 
 #undef BETA_CONST_FOR_LAPLACE_DIST
 #undef BETA_CONST_FOR_GAUSS_DIST
+}
+
+/* 入力データとPARCOR係数からサンプルあたりの推定符号長を求める */
+LPCCalculatorApiResult LPCCalculator_EstimateCodeLength(
+        const double *data, uint32_t num_samples, uint32_t bits_per_sample,
+        const double *parcor_coef, uint32_t order,
+        double *length_per_sample_bits)
+{
+    uint32_t smpl;
+    double sum_power;
+
+    /* 引数チェック */
+    if ((data == NULL) || (parcor_coef == NULL) || (length_per_sample_bits == NULL)) {
+        return LPCCALCULATOR_APIRESULT_INVALID_ARGUMENT;
+    }
+
+    /* 信号の二乗和 */
+    sum_power = 0.0f;
+    for (smpl = 0; smpl < num_samples; smpl++) {
+        sum_power += data[smpl] * data[smpl];
+    }
+
+    LPCCalculator_EstimateCodeLengthFromPower(
+            sum_power, num_samples, bits_per_sample, parcor_coef, order, length_per_sample_bits);
+
+    return LPCCALCULATOR_APIRESULT_OK;
+}
+
+/* 自己相関を1回だけ計算し、LPC係数・PARCOR係数・サンプルあたりの推定符号長をまとめて求める */
+/* 係数lpc_coef, parcor_coefはorder+1個の配列 */
+LPCCalculatorApiResult LPCCalculator_CalculateCoefAndCodeLength(
+        struct LPCCalculator *lpcc,
+        const double *data, uint32_t num_samples, uint32_t bits_per_sample,
+        double *lpc_coef, double *parcor_coef, uint32_t order, double *length_per_sample_bits)
+{
+    /* 引数チェック */
+    if ((lpcc == NULL) || (data == NULL) || (num_samples == 0)
+            || (lpc_coef == NULL) || (parcor_coef == NULL) || (length_per_sample_bits == NULL)) {
+        return LPCCALCULATOR_APIRESULT_INVALID_ARGUMENT;
+    }
+
+    /* 次数チェック */
+    if (order > lpcc->max_order) {
+        return LPCCALCULATOR_APIRESULT_EXCEED_MAX_ORDER;
+    }
+
+    /* 係数計算 */
+    if (LPCCalculator_CalculateCoef(lpcc, data, num_samples, order) != LPCCALCULATOR_ERROR_OK) {
+        return LPCCALCULATOR_APIRESULT_FAILED_TO_CALCULATION;
+    }
+
+    /* 計算成功時は結果をコピー */
+    memmove(lpc_coef, lpcc->lpc_coef, sizeof(double) * (order + 1));
+    memmove(parcor_coef, lpcc->parcor_coef, sizeof(double) * (order + 1));
+
+    /* 0次の自己相関は信号の二乗和そのもの */
+    LPCCalculator_EstimateCodeLengthFromPower(
+            lpcc->auto_corr[0], num_samples, bits_per_sample, parcor_coef, order, length_per_sample_bits);
 
     return LPCCALCULATOR_APIRESULT_OK;
 }
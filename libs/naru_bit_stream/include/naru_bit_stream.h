@@ -3,10 +3,19 @@
 
 #include "naru_stdint.h"
 #include <stdio.h>
+#include <string.h>
 
 /* マクロ展開して処理を行うか？ */
 #define NARUBITSTREAM_PROCESS_BY_MACRO
 
+/* 64bitバッファで読み書きを行うか？
+* マクロ展開時かつ64bitのNLZを命令で計算できる環境でのみ有効
+* NARUBITSTREAM_DISABLE_64BIT_BUFFERを定義すると1バイトずつ読み書きする実装を使用 */
+#if defined(NARUBITSTREAM_PROCESS_BY_MACRO) && !defined(NARUBITSTREAM_DISABLE_64BIT_BUFFER)\
+    && (defined(__GNUC__) || (defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))))
+#define NARUBITSTREAM_USE_64BIT_BUFFER
+#endif
+
 /* NARUBitStream_Seek関数の探索コード */
 #define NARUBITSTREAM_SEEK_SET  (int32_t)SEEK_SET
 #define NARUBITSTREAM_SEEK_CUR  (int32_t)SEEK_CUR
@@ -14,17 +23,27 @@
 
 /* 読みモードか？（0で書きモード） */
 #define NARUBITSTREAM_FLAGS_MODE_READ  (1 << 0)
+/* 読みモードで終端を越えて読み込んだか？
+* 補足）終端以降は0が続くものとして読み進め、読み過ぎたかはまとめて検査する */
+#define NARUBITSTREAM_FLAGS_OVERRUN    (1 << 1)
 
 /* ビットストリーム構造体 */
 struct NARUBitStream {
+#if defined(NARUBITSTREAM_USE_64BIT_BUFFER)
+    uint64_t        bit_buffer;     /* 未読・未出力のビットを上位ビットから詰める */
+#else
     uint32_t        bit_buffer;
-    uint32_t        bit_count;
+#endif
+    uint32_t        bit_count;      /* 読みモードでは未読ビット数、書きモードでは空きビット数 */
     const uint8_t*  memory_image;
     size_t          memory_size;
     uint8_t*        memory_p;
     uint8_t         flags;
 };
 
+/* 終端を越えて読み込んだか？ */
+#define NARUBitReader_IsOverrun(stream) (((stream)->flags & NARUBITSTREAM_FLAGS_OVERRUN) != 0)
+
 #if defined(NARUBITSTREAM_PROCESS_BY_MACRO)
 
 #include "naru_internal.h"
@@ -77,7 +96,7 @@ extern const uint32_t g_naru_bitstream_zerobit_runlength_table[0x100];
         (stream)->flags = 0;\
         \
         /* バッファ初期化 */\
-        (stream)->bit_count   = 8;\
+        (stream)->bit_count   = NARUBITWRITER_BUFFER_BITS;\
         (stream)->bit_buffer  = 0;\
         \
         /* メモリセット */\
@@ -122,6 +141,7 @@ extern const uint32_t g_naru_bitstream_zerobit_runlength_table[0x100];
         \
         /* 内部バッファをクリア（副作用が起こる） */\
         NARUBitStream_Flush(stream);\
+        NARUBitReader_DropBuffer(stream);\
         \
         /* 起点をまず定める */\
         switch (origin) {\
@@ -160,8 +180,230 @@ extern const uint32_t g_naru_bitstream_zerobit_runlength_table[0x100];
         /* アクセスオフセットを返す */\
         (*result) = (int32_t)\
         ((stream)->memory_p - (stream)->memory_image);\
+        /* バッファ中のバイトを考慮 */\
+        (*result) += NARUBITSTREAM_BUFFERED_BYTES_OFFSET(stream);\
+    } while (0)
+
+#if defined(NARUBITSTREAM_USE_64BIT_BUFFER)
+
+/* 64bitバッファによる読み書きの実装 */
+
+/* 書き込みバッファのビット数 */
+#define NARUBITWRITER_BUFFER_BITS 64
+
+/* メモリ上の位置に対するバッファ中のバイト数分のずれ
+* 読みモードでは先読みしたバイトを戻し、書きモードでは未出力のバイトを進める */
+#define NARUBITSTREAM_BUFFERED_BYTES_OFFSET(stream)\
+    (((stream)->flags & NARUBITSTREAM_FLAGS_MODE_READ)\
+     ? -(int32_t)((stream)->bit_count >> 3) : (int32_t)((64 - (stream)->bit_count) >> 3))
+
+/* バッファにたまったバイトをメモリに書き出す（端数ビットはバッファに残す）
+* 補足）後続の領域を壊さないよう、書き出すバイトだけを書き込む */
+#define NARUBitWriter_FlushBytes(stream)\
+    do {\
+        uint32_t __i;\
+        const uint32_t __nbytes = (64 - (stream)->bit_count) >> 3;\
+        \
+        /* 終端に達していないかチェック */\
+        NARU_ASSERT(((stream)->memory_p + __nbytes) <= ((stream)->memory_image + (stream)->memory_size));\
+        \
+        for (__i = 0; __i < __nbytes; __i++) {\
+            (stream)->memory_p[__i] = (uint8_t)(((stream)->bit_buffer >> (56 - 8 * __i)) & 0xFF);\
+        }\
+        (stream)->memory_p += __nbytes;\
+        /* __nbytes == 8でも正しく動くよう2回に分けてシフト */\
+        (stream)->bit_buffer = ((stream)->bit_buffer << (4 * __nbytes)) << (4 * __nbytes);\
+        (stream)->bit_count += 8 * __nbytes;\
+    } while (0)
+
+/* valの右側（下位）nbits 出力（最大32bit出力可能） */
+#define NARUBitWriter_PutBits(stream, val, nbits)\
+    do {\
+        uint32_t __nbits;\
+        \
+        /* 引数チェック */\
+        NARU_ASSERT((void *)(stream) != NULL);\
+        \
+        /* 読み込みモードでは実行不可能 */\
+        NARU_ASSERT(!((stream)->flags & NARUBITSTREAM_FLAGS_MODE_READ));\
+        \
+        /* 出力可能な最大ビット数を越えている */\
+        NARU_ASSERT((nbits) <= (sizeof(uint32_t) * 8));\
+        \
+        /* 0ビット出力は冗長なのでアサートで落とす */\
+        NARU_ASSERT((nbits) > 0);\
+        \
+        /* 空きが足りなければ書き出して空ける */\
+        __nbits = (nbits);\
+        if (__nbits > (stream)->bit_count) {\
+            NARUBitWriter_FlushBytes(stream);\
+        }\
+        \
+        /* 空きの上位から詰める */\
+        (stream)->bit_count -= __nbits;\
+        (stream)->bit_buffer\
+            |= ((uint64_t)(val) & (0xFFFFFFFFUL >> (32 - __nbits))) << (stream)->bit_count;\
+    } while (0)
+
+/* nbitsの0を出力（ビット数の制限なし） */
+#define NARUBitWriter_PutZeroRun(stream, nbits)\
+    do {\
+        uint32_t __nbits;\
+        \
+        /* 引数チェック */\
+        NARU_ASSERT((void *)(stream) != NULL);\
+        \
+        /* 読み込みモードでは実行不可能 */\
+        NARU_ASSERT(!((stream)->flags & NARUBITSTREAM_FLAGS_MODE_READ));\
+        \
+        __nbits = (nbits);\
+        if (__nbits <= (stream)->bit_count) {\
+            /* バッファの空きに収まる: 0は既に入っているので空きを減らすだけ */\
+            (stream)->bit_count -= __nbits;\
+        } else {\
+            /* バッファを埋めて書き出し、残りのバイト単位の0はまとめて書き込む */\
+            __nbits -= (stream)->bit_count;\
+            (stream)->bit_count = 0;\
+            NARUBitWriter_FlushBytes(stream);\
+            NARU_ASSERT(((stream)->memory_p + (__nbits >> 3)) <= ((stream)->memory_image + (stream)->memory_size));\
+            memset((stream)->memory_p, 0, __nbits >> 3);\
+            (stream)->memory_p += __nbits >> 3;\
+            (stream)->bit_count = 64 - (__nbits & 7);\
+        }\
+    } while (0)
+
+/* 書き込み位置を次のバイト先頭にし、バッファを全て書き出す */
+#define NARUBitWriter_AlignByte(stream)\
+    do {\
+        (stream)->bit_count &= ~7U;\
+        NARUBitWriter_FlushBytes(stream);\
+    } while (0)
+
+/* 未読ビットが56bit以下ならばバッファに補充
+* 補足）終端まで8byte以上あればワード単位で読み込み、端数の先読みビットも有効ビットの下位に残す
+*       先読みビットは次の補充で同じ値が同じ位置に重ねられるので、論理和で補充して問題ない */
+#define NARUBitReader_Refill(stream)\
+    do {\
+        if ((stream)->bit_count <= 56) {\
+            if (((stream)->memory_p + 8) <= ((stream)->memory_image + (stream)->memory_size)) {\
+                const uint8_t *__p = (stream)->memory_p;\
+                const uint64_t __word\
+                    = ((uint64_t)__p[0] << 56) | ((uint64_t)__p[1] << 48)\
+                    | ((uint64_t)__p[2] << 40) | ((uint64_t)__p[3] << 32)\
+                    | ((uint64_t)__p[4] << 24) | ((uint64_t)__p[5] << 16)\
+                    | ((uint64_t)__p[6] <<  8) | ((uint64_t)__p[7] <<  0);\
+                (stream)->bit_buffer |= __word >> (stream)->bit_count;\
+                (stream)->memory_p += (63 - (stream)->bit_count) >> 3;\
+                (stream)->bit_count |= 56;\
+            } else {\
+                /* 終端付近では1バイトずつ読み込む */\
+                while (((stream)->bit_count <= 56)\
+                        && ((stream)->memory_p < ((stream)->memory_image + (stream)->memory_size))) {\
+                    (stream)->bit_buffer |= (uint64_t)(*(stream)->memory_p) << (56 - (stream)->bit_count);\
+                    (stream)->memory_p++;\
+                    (stream)->bit_count += 8;\
+                }\
+            }\
+        }\
+    } while (0)
+
+/* nbits 取得（最大32bit）し、その値を右詰めして出力 */
+#define NARUBitReader_GetBits(stream, val, nbits)\
+    do {\
+        uint32_t __nbits;\
+        \
+        /* 引数チェック */\
+        NARU_ASSERT((void *)(stream) != NULL);\
+        NARU_ASSERT((void *)(val) != NULL);\
+        \
+        /* 読み込みモードでない場合はアサート */\
+        NARU_ASSERT((stream)->flags & NARUBITSTREAM_FLAGS_MODE_READ);\
+        \
+        /* 入力可能な最大ビット数を越えている */\
+        NARU_ASSERT((nbits) <= (sizeof(uint32_t) * 8));\
+        \
+        /* 未読ビットが足りなければ補充 */\
+        __nbits = (nbits);\
+        if (__nbits > (stream)->bit_count) {\
+            NARUBitReader_Refill(stream);\
+            /* 終端を越えた: 不足分は0として読み、読み過ぎを記録 */\
+            if (__nbits > (stream)->bit_count) {\
+                (stream)->flags |= (uint8_t)NARUBITSTREAM_FLAGS_OVERRUN;\
+            }\
+        }\
+        \
+        /* 上位ビットから取り出す nbits == 0でも正しく動くよう2回に分けてシフト */\
+        (*(val)) = (uint32_t)(((stream)->bit_buffer >> 1) >> (63 - __nbits));\
+        (stream)->bit_buffer <<= __nbits;\
+        (stream)->bit_count -= NARUUTILITY_MIN(__nbits, (stream)->bit_count);\
+    } while (0)
+
+/* つぎの1にぶつかるまで読み込み、その間に読み込んだ0のランレングスを取得 */
+#define NARUBitReader_GetZeroRunLength(stream, runlength)\
+    do {\
+        uint32_t __run, __tmp_run;\
+        \
+        /* 引数チェック */\
+        NARU_ASSERT((void *)(stream) != NULL);\
+        NARU_ASSERT((void *)(runlength) != NULL);\
+        \
+        NARUBitReader_Refill(stream);\
+        \
+        __run = 0;\
+        while (1) {\
+            /* 上位ビットからの連続する0を計測 */\
+            __tmp_run = NARUUTILITY_NLZ64((stream)->bit_buffer);\
+            if (__tmp_run < (stream)->bit_count) {\
+                /* 続く1まで読み捨てる */\
+                (stream)->bit_buffer <<= __tmp_run;\
+                (stream)->bit_buffer <<= 1;\
+                (stream)->bit_count -= __tmp_run + 1;\
+                __run += __tmp_run;\
+                break;\
+            }\
+            /* 未読ビットが全て0: バッファを空にして補充 */\
+            __run += (stream)->bit_count;\
+            (stream)->bit_buffer = 0;\
+            (stream)->bit_count = 0;\
+            /* 終端に達した: 1が現れないまま読み過ぎている */\
+            if ((stream)->memory_p >= ((stream)->memory_image + (stream)->memory_size)) {\
+                (stream)->flags |= (uint8_t)NARUBITSTREAM_FLAGS_OVERRUN;\
+                break;\
+            }\
+            NARUBitReader_Refill(stream);\
+        }\
+        \
+        /* 正常終了 */\
+        (*(runlength)) = __run;\
+    } while (0)
+
+/* 読み込み位置を次のバイト先頭に */
+#define NARUBitReader_AlignByte(stream)\
+    do {\
+        (stream)->bit_buffer <<= (stream)->bit_count & 7;\
+        (stream)->bit_count &= ~7U;\
+    } while (0)
+
+/* 先読みしたバイトをメモリに戻してバッファを空にする */
+#define NARUBitReader_DropBuffer(stream)\
+    do {\
+        if ((stream)->flags & NARUBITSTREAM_FLAGS_MODE_READ) {\
+            (stream)->memory_p -= (stream)->bit_count >> 3;\
+            (stream)->bit_buffer = 0;\
+            (stream)->bit_count = 0;\
+        }\
     } while (0)
 
+#else /* NARUBITSTREAM_USE_64BIT_BUFFER */
+
+/* 1バイトずつ読み書きする実装 */
+
+/* メモリ上の位置に対するバッファ中のバイト数分のずれ（バイトはためないので0） */
+#define NARUBITSTREAM_BUFFERED_BYTES_OFFSET(stream) 0
+
+/* 書き込みバッファのビット数 */
+#define NARUBITWRITER_BUFFER_BITS 8
+
 /* valの右側（下位）nbits 出力（最大32bit出力可能） */
 #define NARUBitWriter_PutBits(stream, val, nbits)\
     do {\
@@ -212,6 +454,27 @@ extern const uint32_t g_naru_bitstream_zerobit_runlength_table[0x100];
                     (uint32_t)(val), __nbits) << (stream)->bit_count;\
     } while (0)
 
+/* nbitsの0を出力（ビット数の制限なし） */
+#define NARUBitWriter_PutZeroRun(stream, nbits)\
+    do {\
+        uint32_t __run = (nbits);\
+        while (__run > 0) {\
+            const uint32_t __n = NARUUTILITY_MIN(__run, 32U);\
+            NARUBitWriter_PutBits((stream), 0, __n);\
+            __run -= __n;\
+        }\
+    } while (0)
+
+/* 書き込み位置を次のバイト先頭に */
+#define NARUBitWriter_AlignByte(stream)\
+    do {\
+        /* 既に先頭にあるときは何もしない */\
+        if ((stream)->bit_count < 8) {\
+            /* バッファに余ったビットを強制出力 */\
+            NARUBitWriter_PutBits((stream), 0, (stream)->bit_count);\
+        }\
+    } while (0)
+
 /* nbits 取得（最大32bit）し、その値を右詰めして出力 */
 #define NARUBitReader_GetBits(stream, val, nbits)\
     do {\
@@ -239,14 +502,16 @@ extern const uint32_t g_naru_bitstream_zerobit_runlength_table[0x100];
                     |= NARUBITSTREAM_GETLOWERBITS(\
                             (stream)->bit_buffer, (stream)->bit_count) << __nbits;\
                     \
-                    /* 終端に達していないかチェック */\
+                    /* メモリから読み出し（終端以降は0を読み、読み過ぎを記録） */\
                     NARU_ASSERT((stream)->memory_p >= (stream)->memory_image);\
-                    NARU_ASSERT((stream)->memory_p\
-                            < ((stream)->memory_image + (stream)->memory_size));\
-                    \
-                    /* メモリから読み出し */\
-                    __ch = (*(stream)->memory_p);\
-                    (stream)->memory_p++;\
+                    __ch = 0;\
+                    if ((stream)->memory_p\
+                            < ((stream)->memory_image + (stream)->memory_size)) {\
+                        __ch = (*(stream)->memory_p);\
+                        (stream)->memory_p++;\
+                    } else {\
+                        (stream)->flags |= (uint8_t)NARUBITSTREAM_FLAGS_OVERRUN;\
+                    }\
                     \
                     (stream)->bit_buffer  = __ch;\
                     (stream)->bit_count   = 8;\
@@ -286,10 +551,14 @@ extern const uint32_t g_naru_bitstream_zerobit_runlength_table[0x100];
             uint8_t   __ch;\
             uint32_t  __tmp_run;\
             \
-            /* 終端に達していないかチェック */\
+            /* 終端に達した: 1が現れないまま読み過ぎている */\
             NARU_ASSERT((stream)->memory_p >= (stream)->memory_image);\
-            NARU_ASSERT((stream)->memory_p\
-                    < ((stream)->memory_image + (stream)->memory_size));\
+            if ((stream)->memory_p\
+                    >= ((stream)->memory_image + (stream)->memory_size)) {\
+                (stream)->flags |= (uint8_t)NARUBITSTREAM_FLAGS_OVERRUN;\
+                (stream)->bit_count = 1;\
+                break;\
+            }\
             \
             /* メモリから読み出し */\
             __ch = (*(stream)->memory_p);\
@@ -312,28 +581,42 @@ extern const uint32_t g_naru_bitstream_zerobit_runlength_table[0x100];
         (*(runlength)) = __run;\
     } while (0)
 
+/* 読み込み位置を次のバイト先頭に */
+#define NARUBitReader_AlignByte(stream)\
+    do {\
+        /* 既に先頭にあるときは何もしない */\
+        if ((stream)->bit_count < 8) {\
+            /* 残りビット分を空読み */\
+            uint32_t __dummy;\
+            NARUBitReader_GetBits((stream), &__dummy, (stream)->bit_count);\
+        }\
+    } while (0)
+
+/* 先読みしたバイトをメモリに戻してバッファを空にする（先読みしないので何もしない） */
+#define NARUBitReader_DropBuffer(stream) do { } while (0)
+
+#endif /* NARUBITSTREAM_USE_64BIT_BUFFER */
+
 /* バッファにたまったビットをクリア */
 #define NARUBitStream_Flush(stream)\
     do {\
         /* 引数チェック */\
         NARU_ASSERT((void *)(stream) != NULL);\
         \
-        /* 既に先頭にあるときは何もしない */\
-        if ((stream)->bit_count < 8) {\
+        if ((stream)->flags & NARUBITSTREAM_FLAGS_MODE_READ) {\
             /* 読み込み位置を次のバイト先頭に */\
-            if ((stream)->flags & NARUBITSTREAM_FLAGS_MODE_READ) {\
-                /* 残りビット分を空読み */\
-                uint32_t dummy;\
-                NARUBitReader_GetBits((stream), &dummy, (stream)->bit_count);\
-            } else {\
-                /* バッファに余ったビットを強制出力 */\
-                NARUBitWriter_PutBits((stream), 0, (stream)->bit_count);\
-            }\
+            NARUBitReader_AlignByte(stream);\
+        } else {\
+            /* 書き込み位置を次のバイト先頭に */\
+            NARUBitWriter_AlignByte(stream);\
         }\
     } while (0)
 
 #else /* NARUBITSTREAM_PROCESS_BY_MACRO */
 
+/* 書き込みバッファのビット数 */
+#define NARUBITWRITER_BUFFER_BITS 8
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -357,6 +640,9 @@ void NARUBitStream_Tell(struct NARUBitStream* stream, int32_t* result);
 /* valの右側（下位）n_bits 出力（最大32bit出力可能） */
 void NARUBitWriter_PutBits(struct NARUBitStream* stream, uint32_t val, uint32_t nbits);
 
+/* nbitsの0を出力（ビット数の制限なし） */
+void NARUBitWriter_PutZeroRun(struct NARUBitStream* stream, uint32_t nbits);
+
 /* n_bits 取得（最大32bit）し、その値を右詰めして出力 */
 void NARUBitReader_GetBits(struct NARUBitStream* stream, uint32_t* val, uint32_t nbits);
 
@@ -13,7 +13,7 @@ const uint32_t g_naru_bitstream_lower_bits_mask[33] = {
     0x000001FFUL, 0x000003FFUL, 0x000007FFUL, 0x00000FFFUL,
     0x00001FFFUL, 0x00003FFFUL, 0x00007FFFUL, 0x0000FFFFUL,
     0x0001FFFFUL, 0x0003FFFFUL, 0x0007FFFFUL, 0x000FFFFFUL,
-    0x001FFFFFUL, 0x000FFFFFUL, 0x007FFFFFUL, 0x00FFFFFFUL,
+    0x001FFFFFUL, 0x003FFFFFUL, 0x007FFFFFUL, 0x00FFFFFFUL,
     0x01FFFFFFUL, 0x03FFFFFFUL, 0x07FFFFFFUL, 0x0FFFFFFFUL,
     0x1FFFFFFFUL, 0x3FFFFFFFUL, 0x7FFFFFFFUL, 0xFFFFFFFFUL
 };
@@ -205,6 +205,23 @@ void NARUBitWriter_PutBits(struct NARUBitStream* stream, uint32_t val, uint32_t
     stream->bit_buffer |= (uint32_t)NARUBITSTREAM_GETLOWERBITS(val, bitcount) << stream->bit_count;
 }
 
+/* nbitsの0を出力（ビット数の制限なし） */
+void NARUBitWriter_PutZeroRun(struct NARUBitStream* stream, uint32_t nbits)
+{
+    uint32_t run;
+
+    /* 引数チェック */
+    NARU_ASSERT(stream != NULL);
+
+    /* 32bitずつ出力 */
+    run = nbits;
+    while (run > 0) {
+        const uint32_t n = NARUUTILITY_MIN(run, 32U);
+        NARUBitWriter_PutBits(stream, 0, n);
+        run -= n;
+    }
+}
+
 /* nbits 取得（最大32bit）し、その値を右詰めして出力 */
 void NARUBitReader_GetBits(struct NARUBitStream* stream, uint32_t* val, uint32_t nbits)
 {
@@ -229,13 +246,15 @@ void NARUBitReader_GetBits(struct NARUBitStream* stream, uint32_t* val, uint32_t
         bitcount  -= stream->bit_count;
         tmp       |= NARUBITSTREAM_GETLOWERBITS(stream->bit_buffer, stream->bit_count) << bitcount;
 
-        /* 終端に達していないかチェック */
+        /* メモリから読み出し（終端以降は0を読み、読み過ぎを記録） */
         NARU_ASSERT((stream)->memory_p >= (stream)->memory_image);
-        NARU_ASSERT((stream)->memory_p < ((stream)->memory_image + (stream)->memory_size));
-
-        /* メモリから読み出し */
-        ch = (*stream->memory_p);
-        stream->memory_p++;
+        ch = 0;
+        if ((stream)->memory_p < ((stream)->memory_image + (stream)->memory_size)) {
+            ch = (*stream->memory_p);
+            stream->memory_p++;
+        } else {
+            stream->flags |= (uint8_t)NARUBITSTREAM_FLAGS_OVERRUN;
+        }
 
         stream->bit_buffer  = ch;
         stream->bit_count   = 8;
@@ -275,9 +294,13 @@ void NARUBitReader_GetZeroRunLength(struct NARUBitStream* stream, uint32_t* runl
         uint8_t   ch;
         uint32_t  tmp_run;
 
-        /* 終端に達していないかチェック */
+        /* 終端に達した: 1が現れないまま読み過ぎている */
         NARU_ASSERT((stream)->memory_p >= (stream)->memory_image);
-        NARU_ASSERT((stream)->memory_p < ((stream)->memory_image + (stream)->memory_size));
+        if ((stream)->memory_p >= ((stream)->memory_image + (stream)->memory_size)) {
+            stream->flags |= (uint8_t)NARUBITSTREAM_FLAGS_OVERRUN;
+            stream->bit_count = 1;
+            break;
+        }
 
         /* メモリから読み出し */
         ch = (*stream->memory_p);
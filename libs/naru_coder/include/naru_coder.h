@@ -2,6 +2,7 @@
 #define NARU_CODER_H_INCLUDED
 
 #include "naru_stdint.h"
+#include "naru_internal.h"
 #include "naru_bit_stream.h"
 
 /* 符号化ハンドル */
@@ -34,16 +35,44 @@ void NARUCoder_PutInitialRecursiveRiceParameter(
 void NARUCoder_GetInitialRecursiveRiceParameter(
         struct NARUCoder *coder, struct NARUBitStream *stream, uint32_t num_parameters, uint32_t channel_index);
 
+/* 1チャンネル分の符号付き整数配列の符号長[bit]の計算
+* 補足）初期パラメータ2^log2_init_parameterでNARUCoder_PutChannelDataArrayした時のビット数を、出力せずに求める */
+uint64_t NARUCoder_CalculateChannelCodeLength(
+        uint32_t num_parameters, uint32_t log2_init_parameter, const int32_t *data, uint32_t num_samples);
+
 /* 符号付き整数配列の符号化 */
 void NARUCoder_PutDataArray(
         struct NARUCoder *coder, struct NARUBitStream *stream,
         uint32_t num_parameters, const int32_t **data, uint32_t num_channels, uint32_t num_samples);
 
-/* 符号付き整数配列の復号 */
-void NARUCoder_GetDataArray(
+/* 符号付き整数配列の復号
+* 補足）符号として解釈できないビット列を読んだ場合はNARU_ERROR_INVALID_FORMATを返す */
+NARUError NARUCoder_GetDataArray(
         struct NARUCoder *coder, struct NARUBitStream *stream,
         uint32_t num_parameters, int32_t **data, uint32_t num_channels, uint32_t num_samples);
 
+/* 1チャンネル分の符号付き整数配列の符号化 */
+void NARUCoder_PutChannelDataArray(
+        struct NARUCoder *coder, struct NARUBitStream *stream,
+        uint32_t num_parameters, uint32_t channel_index, const int32_t *data, uint32_t num_samples);
+
+/* 1チャンネル分の符号付き整数配列の復号
+* 補足）符号として解釈できないビット列を読んだ場合はNARU_ERROR_INVALID_FORMATを返す */
+NARUError NARUCoder_GetChannelDataArray(
+        struct NARUCoder *coder, struct NARUBitStream *stream,
+        uint32_t num_parameters, uint32_t channel_index, int32_t *data, uint32_t num_samples);
+
+/* 1チャンネル分の符号付き整数配列のrANS符号化
+* 補足）workはサンプル数分の作業領域。出力がoutput_sizeに収まらない場合はNARU_ERROR_INSUFFICIENT_BUFFERを返す */
+NARUError NARUCoder_PutChannelDataArrayRANS(
+        struct NARUCoder *coder, uint32_t channel_index, const int32_t *data, uint32_t num_samples,
+        uint32_t *work, uint8_t *output, uint32_t output_size, uint32_t *encoded_size);
+
+/* 1チャンネル分の符号付き整数配列のrANS復号 */
+NARUError NARUCoder_GetChannelDataArrayRANS(
+        struct NARUCoder *coder, uint32_t channel_index, const uint8_t *input, uint32_t input_size,
+        int32_t *data, uint32_t num_samples, uint32_t *decoded_size);
+
 #ifdef __cplusplus
 }
 #endif
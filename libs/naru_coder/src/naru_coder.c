@@ -1,9 +1,11 @@
 #include "naru_coder.h"
 #include "naru_utility.h"
 #include "naru_internal.h"
+#include "byte_array.h"
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 
 /* 再帰的ライス符号の最大段数 */
@@ -39,6 +41,40 @@
 /* 再帰的ライス符号パラメータ型 */
 typedef uint64_t NARURecursiveRiceParameter;
 
+/* 復号用の先読みビットバッファ */
+struct NARUCoderBitPeeker {
+    uint64_t buffer;        /* 先読みしたビット列（上位ビット詰め） */
+    uint32_t num_bits;      /* bufferの有効ビット数（終端以降に補った0を含む） */
+    uint32_t num_pad_bits;  /* 終端以降に補った0のビット数 */
+    const uint8_t *ptr;     /* 次に読み込むバイト */
+    const uint8_t *end;     /* 読み込み可能な終端 */
+    uint8_t is_corrupted;   /* 符号として解釈できないビット列を読んだか？ */
+};
+
+/* 再帰的ライス符号の復号テーブル（現在のパラメータから作成） */
+struct NARURecursiveRiceDecodeTable {
+    uint32_t k[NARUCODER_MAX_NUM_RECURSIVERICE_PARAMETER];      /* 各段の剰余部の桁数 */
+    uint32_t base[NARUCODER_MAX_NUM_RECURSIVERICE_PARAMETER];   /* 各段に達するまでのパラメータの和 */
+};
+
+/* 再帰的ライス符号の符号化テーブル（各段の剰余部桁数をキャッシュ） */
+struct NARURecursiveRiceEncodeTable {
+    uint32_t k[NARUCODER_MAX_NUM_RECURSIVERICE_PARAMETER];                      /* 各段の剰余部の桁数 */
+    NARURecursiveRiceParameter lower[NARUCODER_MAX_NUM_RECURSIVERICE_PARAMETER]; /* 桁数が変わらないパラメータの下限 */
+    NARURecursiveRiceParameter width[NARUCODER_MAX_NUM_RECURSIVERICE_PARAMETER]; /* 桁数が変わらないパラメータの範囲幅 */
+};
+
+/* 固定パラメータのゴロム符号のパラメータ（ブロック内で不変な値を前計算） */
+struct NARUGolombParameter {
+    uint32_t m;             /* ゴロム符号のパラメータ */
+    uint32_t k;             /* 剰余部の最大桁数 ceil(log2(m)) */
+    uint32_t threshold;     /* 剰余部がこの値未満ならばk-1桁で表す (2^k - m) */
+    uint32_t reciprocal;    /* mによる除算を乗算に置き換えるための逆数 */
+    uint32_t shift1;        /* 除算の補正に使うシフト量 */
+    uint32_t shift2;        /* 除算の最後のシフト量 */
+    uint8_t is_power_of_2;  /* mが2の冪か？ */
+};
+
 /* 符号化ハンドル */
 struct NARUCoder {
     NARURecursiveRiceParameter** rice_parameter;
@@ -49,81 +85,6 @@ struct NARUCoder {
     void *work;
 };
 
-/* ゴロム符号化の出力 */
-static void NARUGolomb_PutCode(struct NARUBitStream *stream, uint32_t m, uint32_t val)
-{
-    uint32_t quot;
-    uint32_t rest;
-    uint32_t b, two_b;
-
-    NARU_ASSERT(stream != NULL);
-    NARU_ASSERT(m != 0);
-
-    /* 商部分長と剰余部分の計算 */
-    quot = val / m;
-    rest = val % m;
-
-    /* 前半部分の出力(unary符号) */
-    while (quot > 0) {
-        NARUBitWriter_PutBits(stream, 0, 1);
-        quot--;
-    }
-    NARUBitWriter_PutBits(stream, 1, 1);
-
-    /* 剰余部分の出力 */
-    if (NARUUTILITY_IS_POWERED_OF_2(m)) {
-        /* mが2の冪: ライス符号化 m == 1の時は剰余0だから何もしない */
-        if (m > 1) {
-            NARUBitWriter_PutBits(stream, rest, NARUUTILITY_LOG2CEIL(m));
-        }
-        return;
-    }
-
-    /* ゴロム符号化 */
-    b = NARUUTILITY_LOG2CEIL(m);
-    two_b = (uint32_t)(1UL << b);
-    if (rest < (two_b - m)) {
-        NARUBitWriter_PutBits(stream, rest, b - 1);
-    } else {
-        NARUBitWriter_PutBits(stream, rest + two_b - m, b);
-    }
-}
-
-/* ゴロム符号の取得 */
-static uint32_t NARUGolomb_GetCode(struct NARUBitStream *stream, uint32_t m)
-{
-    uint32_t quot, rest, b, two_b;
-
-    NARU_ASSERT(stream != NULL);
-    NARU_ASSERT(m != 0);
-
-    /* 前半のunary符号部分を読み取り */
-    NARUBitReader_GetZeroRunLength(stream, &quot);
-
-    /* 剰余部の桁数 */
-    b = NARUUTILITY_LOG2CEIL(m);
-
-    /* 剰余部分の読み取り */
-    if (NARUUTILITY_IS_POWERED_OF_2(m)) {
-        /* mが2の冪: ライス符号化 */
-        NARUBitReader_GetBits(stream, &rest, b);
-        return (uint32_t)((quot << b) + rest);
-    }
-
-    /* ゴロム符号化 */
-    two_b = (uint32_t)(1UL << b);
-    NARUBitReader_GetBits(stream, &rest, b - 1);
-    if (rest < (two_b - m)) {
-        return (uint32_t)(quot * m + rest);
-    } else {
-        uint32_t buf;
-        rest <<= 1;
-        NARUBitReader_GetBits(stream, &buf, 1);
-        rest += buf;
-        return (uint32_t)(quot * m + rest - (two_b - m));
-    }
-}
-
 /* ガンマ符号の出力 */
 static void NARUGamma_PutCode(struct NARUBitStream *stream, uint32_t val)
 {
@@ -140,33 +101,15 @@ static void NARUGamma_PutCode(struct NARUBitStream *stream, uint32_t val)
     /* 桁数を取得 */
     ndigit = NARUUTILITY_LOG2CEIL(val + 2);
     /* 桁数-1だけ0を続ける */
-    NARUBitWriter_PutBits(stream, 0, ndigit - 1);
+    NARUBitWriter_PutZeroRun(stream, ndigit - 1);
     /* 桁数を使用して符号語を2進数で出力 */
     NARUBitWriter_PutBits(stream, val + 1, ndigit);
 }
 
-/* ガンマ符号の取得 */
-static uint32_t NARUGamma_GetCode(struct NARUBitStream *stream)
+/* ガンマ符号のビット数 */
+static uint32_t NARUGamma_GetCodeLength(uint32_t val)
 {
-    uint32_t ndigit;
-    uint32_t bitsbuf;
-
-    NARU_ASSERT(stream != NULL);
-
-    /* 桁数を取得 */
-    /* 1が出現するまで桁数を増加 */
-    NARUBitReader_GetZeroRunLength(stream, &ndigit);
-    /* 最低でも1のため下駄を履かせる */
-    ndigit++;
-
-    /* 桁数が1のときは0 */
-    if (ndigit == 1) {
-        return 0;
-    }
-
-    /* 桁数から符号語を出力 */
-    NARUBitReader_GetBits(stream, &bitsbuf, ndigit - 1);
-    return (uint32_t)((1UL << (ndigit - 1)) + bitsbuf - 1);
+    return (val == 0) ? 1 : (2 * NARUUTILITY_LOG2CEIL(val + 2) - 1);
 }
 
 /* 商部分（アルファ符号）を出力 */
@@ -175,28 +118,10 @@ static void NARURecursiveRice_PutQuotPart(
 {
     NARU_ASSERT(stream != NULL);
 
-    if (quot == 0) {
-        NARUBitWriter_PutBits(stream, 1, 1);
-        return;
-    }
-
-    NARU_ASSERT(quot < 32);
-    NARUBitWriter_PutBits(stream, 0, quot);
+    NARUBitWriter_PutZeroRun(stream, quot);
     NARUBitWriter_PutBits(stream, 1, 1);
 }
 
-/* 商部分（アルファ符号）を取得 */
-static uint32_t NARURecursiveRice_GetQuotPart(struct NARUBitStream *stream)
-{
-    uint32_t quot;
-
-    NARU_ASSERT(stream != NULL);
-
-    NARUBitReader_GetZeroRunLength(stream, &quot);
-
-    return quot;
-}
-
 /* 剰余部分を出力 kは剰余部の桁数（logを取ったライス符号） */
 static void NARURecursiveRice_PutRestPart(
         struct NARUBitStream *stream, uint32_t val, uint32_t k)
@@ -209,47 +134,97 @@ static void NARURecursiveRice_PutRestPart(
     }
 }
 
-/* 剰余部分を取得 kは剰余部の桁数（logを取ったライス符号） */
-static uint32_t NARURecursiveRice_GetRestPart(struct NARUBitStream *stream, uint32_t k)
+/* 商部分と剰余部分をまとめて出力 kは剰余部の桁数（logを取ったライス符号） */
+static void NARURecursiveRice_PutQuotAndRestPart(
+        struct NARUBitStream *stream, uint32_t quot, uint32_t val, uint32_t k)
 {
-    uint32_t rest;
-
     NARU_ASSERT(stream != NULL);
+    NARU_ASSERT(k < 32);
 
-    /* ライス符号の剰余部分取得 */
-    NARUBitReader_GetBits(stream, &rest, k);
+    /* 商部分の0の並び */
+    NARUBitWriter_PutZeroRun(stream, quot);
+    /* 商部分の終端の1と剰余部分は1回で出力 */
+    NARUBitWriter_PutBits(stream, (1U << k) | (val & ((1U << k) - 1)), k + 1);
+}
+
+/* 符号化テーブルのi段目を現在のパラメータから設定 */
+static void NARURecursiveRice_SetEncodeTableStage(
+        struct NARURecursiveRiceEncodeTable *table, const NARURecursiveRiceParameter *rice_parameters, uint32_t i)
+{
+    uint32_t k;
+    NARURecursiveRiceParameter upper;
+
+    NARU_ASSERT(table != NULL);
+    NARU_ASSERT(rice_parameters != NULL);
+    NARU_ASSERT(i < NARUCODER_MAX_NUM_RECURSIVERICE_PARAMETER);
+
+    k = NARURICE_CALCULATE_LOG2_RICE_PARAMETER(rice_parameters, i);
+    table->k[i] = k;
 
-    return rest;
+    /* kが変わらないパラメータの範囲を求める
+    * k = ceil(log2(max(round(p / 2), 1))) より、k > 0では (2^(k-1), 2^k] に丸められるpの範囲 */
+    upper = ((NARURecursiveRiceParameter)1 << (k + NARUCODER_NUM_FRACTION_PART_BITS + 1)) + 2 * NARUCODER_FIXED_FLOAT_0_5;
+    table->lower[i] = 0;
+    if (k > 0) {
+        table->lower[i] = ((NARURecursiveRiceParameter)1 << (k + NARUCODER_NUM_FRACTION_PART_BITS)) + 2 * NARUCODER_FIXED_FLOAT_0_5;
+    }
+    table->width[i] = upper - table->lower[i];
 }
 
-/* 再帰的ライス符号の出力 */
-static void NARURecursiveRice_PutCode(
-        struct NARUBitStream *stream, NARURecursiveRiceParameter* rice_parameters, uint32_t num_params, uint32_t val)
+/* 現在のパラメータから再帰的ライス符号の符号化テーブルを作成 */
+static void NARURecursiveRice_MakeEncodeTable(
+        struct NARURecursiveRiceEncodeTable *table,
+        const NARURecursiveRiceParameter *rice_parameters, uint32_t num_params)
+{
+    uint32_t i;
+
+    NARU_ASSERT(table != NULL);
+    NARU_ASSERT(rice_parameters != NULL);
+    NARU_ASSERT(num_params <= NARUCODER_MAX_NUM_RECURSIVERICE_PARAMETER);
+
+    for (i = 0; i < num_params; i++) {
+        NARURecursiveRice_SetEncodeTableStage(table, rice_parameters, i);
+    }
+}
+
+/* パラメータを更新し、2の冪の境界を跨いだ時だけ符号化テーブルの桁数を再計算 */
+#define NARURecursiveRice_UpdateParameterAndEncodeTable(table, rice_parameters, order, code)\
+    do {\
+        NARURICE_PARAMETER_UPDATE(rice_parameters, order, code);\
+        /* 下限を下回った場合も符号なし減算で大きな値になり範囲外と判定される */\
+        if (((rice_parameters)[(order)] - (table)->lower[(order)]) >= (table)->width[(order)]) {\
+            NARURecursiveRice_SetEncodeTableStage(table, rice_parameters, order);\
+        }\
+    } while (0)
+
+/* 符号化テーブルを使った再帰的ライス符号の出力 */
+static void NARURecursiveRice_PutCodeByTable(
+        struct NARUBitStream *stream, NARURecursiveRiceParameter* rice_parameters, uint32_t num_params,
+        struct NARURecursiveRiceEncodeTable *table, uint32_t val)
 {
     uint32_t i, reduced_val, k, param;
 
     NARU_ASSERT(stream != NULL);
     NARU_ASSERT(rice_parameters != NULL);
+    NARU_ASSERT(table != NULL);
     NARU_ASSERT(num_params != 0);
     NARU_ASSERT(NARUCODER_PARAMETER_GET(rice_parameters, 0) != 0);
 
     reduced_val = val;
     for (i = 0; i < (num_params - 1); i++) {
-        k = NARURICE_CALCULATE_LOG2_RICE_PARAMETER(rice_parameters, i);
+        k = table->k[i];
         param = (1U << k);
         /* 現在のパラメータ値よりも小さければ、符号化を行う */
         if (reduced_val < param) {
             /* 商部分としてはパラメータ段数 */
-            NARURecursiveRice_PutQuotPart(stream, i);
-            /* 剰余部分 */
-            NARURecursiveRice_PutRestPart(stream, reduced_val, k);
+            NARURecursiveRice_PutQuotAndRestPart(stream, i, reduced_val, k);
             /* パラメータ更新 */
-            NARURICE_PARAMETER_UPDATE(rice_parameters, i, reduced_val);
+            NARURecursiveRice_UpdateParameterAndEncodeTable(table, rice_parameters, i, reduced_val);
             /* これで終わり */
             return;
         }
         /* パラメータ更新 */
-        NARURICE_PARAMETER_UPDATE(rice_parameters, i, reduced_val);
+        NARURecursiveRice_UpdateParameterAndEncodeTable(table, rice_parameters, i, reduced_val);
         /* 現在のパラメータ値で減じる */
         reduced_val -= param;
     }
@@ -258,72 +233,898 @@ static void NARURecursiveRice_PutCode(
     NARU_ASSERT(i == (num_params - 1));
     {
         uint32_t quot;
-        k = NARURICE_CALCULATE_LOG2_RICE_PARAMETER(rice_parameters, i);
+        k = table->k[i];
         quot = i + (reduced_val >> k);
         /* 商が大きい場合はガンマ符号を使用する */
         if (quot < NARUCODER_QUOTPART_THRESHOULD) {
-            NARURecursiveRice_PutQuotPart(stream, quot);
+            NARURecursiveRice_PutQuotAndRestPart(stream, quot, reduced_val, k);
         } else {
             NARURecursiveRice_PutQuotPart(stream, NARUCODER_QUOTPART_THRESHOULD);
             NARUGamma_PutCode(stream, quot - NARUCODER_QUOTPART_THRESHOULD);
+            NARURecursiveRice_PutRestPart(stream, reduced_val, k);
         }
-        NARURecursiveRice_PutRestPart(stream, reduced_val, k);
         /* パラメータ更新 */
-        NARURICE_PARAMETER_UPDATE(rice_parameters, i, reduced_val);
+        NARURecursiveRice_UpdateParameterAndEncodeTable(table, rice_parameters, i, reduced_val);
     }
+}
+
+/* 符号化テーブルを使った再帰的ライス符号の符号長計算（パラメータとテーブルは出力時と同様に更新） */
+static uint32_t NARURecursiveRice_GetCodeLengthByTable(
+        NARURecursiveRiceParameter* rice_parameters, uint32_t num_params,
+        struct NARURecursiveRiceEncodeTable *table, uint32_t val)
+{
+    uint32_t i, reduced_val, k, quot;
+
+    NARU_ASSERT(rice_parameters != NULL);
+    NARU_ASSERT(table != NULL);
+    NARU_ASSERT(num_params != 0);
+
+    reduced_val = val;
+    for (i = 0; i < (num_params - 1); i++) {
+        k = table->k[i];
+        if (reduced_val < (1U << k)) {
+            NARURecursiveRice_UpdateParameterAndEncodeTable(table, rice_parameters, i, reduced_val);
+            /* 商部分（段数）+ 終端の1 + 剰余部 */
+            return i + 1 + k;
+        }
+        NARURecursiveRice_UpdateParameterAndEncodeTable(table, rice_parameters, i, reduced_val);
+        reduced_val -= (1U << k);
+    }
+
+    /* 末尾のパラメータに達した */
+    k = table->k[i];
+    quot = i + (reduced_val >> k);
+    NARURecursiveRice_UpdateParameterAndEncodeTable(table, rice_parameters, i, reduced_val);
+    if (quot < NARUCODER_QUOTPART_THRESHOULD) {
+        return quot + 1 + k;
+    }
+    return NARUCODER_QUOTPART_THRESHOULD + 1 + NARUGamma_GetCodeLength(quot - NARUCODER_QUOTPART_THRESHOULD) + k;
+}
 
+/* 先読みビットバッファにビットストリームの読み出し状態を移す */
+static void NARUCoderBitPeeker_Load(struct NARUCoderBitPeeker *peeker, const struct NARUBitStream *stream)
+{
+    NARU_ASSERT(peeker != NULL);
+    NARU_ASSERT(stream != NULL);
+
+#if defined(NARUBITSTREAM_USE_64BIT_BUFFER)
+    /* 同じ形式の64bitバッファなのでそのまま引き継ぐ */
+    peeker->buffer = stream->bit_buffer;
+    peeker->num_bits = stream->bit_count;
+#else
+    NARU_ASSERT(stream->bit_count <= 8);
+    /* バッファに残っているビットを上位に詰める */
+    peeker->num_bits = stream->bit_count;
+    peeker->buffer = 0;
+    if (peeker->num_bits > 0) {
+        peeker->buffer = (uint64_t)(stream->bit_buffer & ((1U << stream->bit_count) - 1)) << (64 - peeker->num_bits);
+    }
+#endif
+    peeker->num_pad_bits = 0;
+    peeker->is_corrupted = 0;
+    peeker->ptr = stream->memory_p;
+    peeker->end = stream->memory_image + stream->memory_size;
 }
 
-/* 再帰的ライス符号の取得 */
-static uint32_t NARURecursiveRice_GetCode(
-        struct NARUBitStream *stream, NARURecursiveRiceParameter* rice_parameters, uint32_t num_params)
+/* 終端以降に補った0まで読み込んだか？ */
+#define NARUCoderBitPeeker_IsOverrun(peeker) ((peeker)->num_pad_bits > (peeker)->num_bits)
+
+/* 先読みビットバッファの読み出し状態をビットストリームに書き戻す */
+static void NARUCoderBitPeeker_Store(const struct NARUCoderBitPeeker *peeker, struct NARUBitStream *stream)
 {
-    uint32_t i, quot, val;
-    uint32_t k, param, tmp_val;
-    uint32_t param_cache[NARUCODER_MAX_NUM_RECURSIVERICE_PARAMETER];
+    uint32_t num_bits;
+#if !defined(NARUBITSTREAM_USE_64BIT_BUFFER)
+    uint32_t num_bytes, num_rest_bits;
+#endif
 
+    NARU_ASSERT(peeker != NULL);
     NARU_ASSERT(stream != NULL);
+
+    /* 補った0を除いた未読ビット数 読み過ぎていたらビットストリームに記録 */
+    num_bits = 0;
+    if (NARUCoderBitPeeker_IsOverrun(peeker)) {
+        stream->flags |= (uint8_t)NARUBITSTREAM_FLAGS_OVERRUN;
+    } else {
+        num_bits = peeker->num_bits - peeker->num_pad_bits;
+    }
+
+#if defined(NARUBITSTREAM_USE_64BIT_BUFFER)
+    /* 補った0は有効ビットの下位にあるので、有効ビット数を減らせば取り除ける */
+    stream->bit_buffer = peeker->buffer;
+    stream->bit_count = num_bits;
+    stream->memory_p = (uint8_t *)peeker->ptr;
+#else
+    /* 未読のビットは、読み込み済みバイト列の末尾num_bitsビット */
+    num_bytes = num_bits / 8;
+    num_rest_bits = num_bits % 8;
+    stream->memory_p = (uint8_t *)(peeker->ptr - num_bytes);
+    stream->bit_count = num_rest_bits;
+    if (num_rest_bits > 0) {
+        stream->bit_buffer = stream->memory_p[-1];
+    }
+#endif
+}
+
+/* 有効ビット数が56を超えるまで補充（終端付近ではバイト単位で補充する）
+* 補足）終端以降は0を補い、読み過ぎたかは復号後にNARUCoderBitPeeker_IsOverrunでまとめて検査する
+*       補充の度に終端を検査しなくてよいので、通常の補充の速度は変わらない */
+#define NARUCoderBitPeeker_Refill(peeker)\
+    do {\
+        if ((peeker)->ptr + 8 <= (peeker)->end) {\
+            const uint8_t *p__ = (peeker)->ptr;\
+            const uint64_t word__\
+                = ((uint64_t)p__[0] << 56) | ((uint64_t)p__[1] << 48) | ((uint64_t)p__[2] << 40) | ((uint64_t)p__[3] << 32)\
+                | ((uint64_t)p__[4] << 24) | ((uint64_t)p__[5] << 16) | ((uint64_t)p__[6] <<  8) | ((uint64_t)p__[7] <<  0);\
+            (peeker)->buffer |= word__ >> (peeker)->num_bits;\
+            (peeker)->ptr += (63 - (peeker)->num_bits) >> 3;\
+            (peeker)->num_bits |= 56;\
+        } else {\
+            while ((peeker)->num_bits <= 56) {\
+                if ((peeker)->ptr < (peeker)->end) {\
+                    (peeker)->buffer |= (uint64_t)(*(peeker)->ptr) << (56 - (peeker)->num_bits);\
+                    (peeker)->ptr++;\
+                } else {\
+                    (peeker)->num_pad_bits += 8;\
+                }\
+                (peeker)->num_bits += 8;\
+            }\
+        }\
+    } while (0)
+
+/* nbitsを読み捨てる（壊れたデータで有効ビットを越えても破綻させない） */
+#define NARUCoderBitPeeker_Skip(peeker, nbits)\
+    do {\
+        NARU_ASSERT((nbits) < 64);\
+        (peeker)->buffer <<= (nbits);\
+        (peeker)->num_bits -= NARUUTILITY_MIN((nbits), (peeker)->num_bits);\
+    } while (0)
+
+/* 先頭のnbits(1以上32以下)を右詰めで取得 */
+#define NARUCoderBitPeeker_Peek(peeker, nbits) ((uint32_t)((peeker)->buffer >> (64 - (nbits))))
+
+/* 次の1までの0のラン長を取得し、続く1を読み捨てる */
+static uint32_t NARUCoderBitPeeker_GetZeroRunLength(struct NARUCoderBitPeeker *peeker)
+{
+    uint32_t run, tmp_run;
+
+    NARU_ASSERT(peeker != NULL);
+
+    NARUCoderBitPeeker_Refill(peeker);
+
+    /* 32bit以上の0の連続はまれなので32bitずつ読み進める */
+    run = 0;
+    while ((tmp_run = NARUUTILITY_NLZ(NARUCoderBitPeeker_Peek(peeker, 32))) == 32) {
+        /* 残りのデータが全て0で補った0に達している場合は、読み過ぎとして打ち切る */
+        if ((peeker->num_pad_bits + 32) > peeker->num_bits) {
+            peeker->buffer = 0;
+            peeker->num_bits = 0;
+            return run;
+        }
+        NARUCoderBitPeeker_Skip(peeker, 32);
+        NARUCoderBitPeeker_Refill(peeker);
+        run += 32;
+    }
+    NARUCoderBitPeeker_Skip(peeker, tmp_run + 1);
+
+    return run + tmp_run;
+}
+
+/* nbits(32以下)を取得し右詰めで返す */
+static uint32_t NARUCoderBitPeeker_GetBits(struct NARUCoderBitPeeker *peeker, uint32_t nbits)
+{
+    uint32_t val;
+
+    NARU_ASSERT(peeker != NULL);
+    NARU_ASSERT(nbits <= 32);
+
+    if (nbits == 0) {
+        return 0;
+    }
+
+    NARUCoderBitPeeker_Refill(peeker);
+    val = NARUCoderBitPeeker_Peek(peeker, nbits);
+    NARUCoderBitPeeker_Skip(peeker, nbits);
+
+    return val;
+}
+
+/* 現在のパラメータから再帰的ライス符号の復号テーブルを作成 */
+static void NARURecursiveRice_MakeDecodeTable(
+        struct NARURecursiveRiceDecodeTable *table,
+        const NARURecursiveRiceParameter *rice_parameters, uint32_t num_params)
+{
+    uint32_t i;
+
+    NARU_ASSERT(table != NULL);
     NARU_ASSERT(rice_parameters != NULL);
     NARU_ASSERT(num_params != 0);
-    NARU_ASSERT(NARUCODER_PARAMETER_GET(rice_parameters, 0) != 0);
     NARU_ASSERT(num_params <= NARUCODER_MAX_NUM_RECURSIVERICE_PARAMETER);
-
-    /* 商部分を取得 */
-    quot = NARURecursiveRice_GetQuotPart(stream);
-
-    /* 得られたパラメータ段数までのパラメータを加算 */
-    val = 0;
-    for (i = 0; (i < quot) && (i < (num_params - 1)); i++) {
-        param = NARURICE_CALCULATE_RICE_PARAMETER(rice_parameters, i);
-        val += param;
-        param_cache[i] = param;
+    /* 末尾のパラメータに達する商はガンマ符号への切り替えより小さい */
+    NARU_ASSERT((num_params - 1) < NARUCODER_QUOTPART_THRESHOULD);
+
+    table->base[0] = 0;
+    for (i = 0; i < num_params; i++) {
+        table->k[i] = NARURICE_CALCULATE_LOG2_RICE_PARAMETER(rice_parameters, i);
+        if (i > 0) {
+            table->base[i] = table->base[i - 1] + (1U << table->k[i - 1]);
+        }
     }
+}
 
-    /* ライス符号の剰余部を使うためlog2でパラメータ取得 */
-    k = NARURICE_CALCULATE_LOG2_RICE_PARAMETER(rice_parameters, i);
-    param_cache[i] = (1U << k);
+/* 復号テーブルを使った再帰的ライス符号の取得 */
+static uint32_t NARURecursiveRice_GetCodeByTable(
+        struct NARUCoderBitPeeker *peeker, NARURecursiveRiceParameter *rice_parameters, uint32_t num_params,
+        struct NARURecursiveRiceDecodeTable *table)
+{
+    uint32_t i, k, quot, stage, val, tmp_val;
+    const uint32_t last = num_params - 1;
+
+    NARU_ASSERT(peeker != NULL);
+    NARU_ASSERT(rice_parameters != NULL);
+    NARU_ASSERT(table != NULL);
+    NARU_ASSERT(num_params != 0);
 
-    /* 剰余部を取得 */
-    if (quot >= (num_params - 1)) {
-        /* 末尾のパラメータに達している */
+    NARUCoderBitPeeker_Refill(peeker);
+
+    /* 商部分を先読みで取得 */
+    quot = NARUUTILITY_NLZ(NARUCoderBitPeeker_Peek(peeker, 32));
+    if (quot < NARUCODER_QUOTPART_THRESHOULD) {
+        /* 商と剰余部の合計は高々47bitなので、補充済みのビットで足りる */
+        /* 商で分岐させず、達した段のテーブル値から復号値を作る */
+        NARUCoderBitPeeker_Skip(peeker, quot + 1);
+        stage = NARUUTILITY_MIN(quot, last);
+        k = table->k[stage];
+        val = table->base[stage] + ((quot - stage) << k);
+        /* k == 0でも正しく0を取り出すため2回に分けてシフト */
+        val += (uint32_t)((peeker->buffer >> 1) >> (63 - k));
+        NARUCoderBitPeeker_Skip(peeker, k);
+    } else {
+        /* 商が大きい: ガンマ符号で表された商の続きを取得 */
+        k = table->k[last];
+        quot = NARUCoderBitPeeker_GetZeroRunLength(peeker);
         if (quot == NARUCODER_QUOTPART_THRESHOULD) {
-            quot += NARUGamma_GetCode(stream);
+            uint32_t ndigit = NARUCoderBitPeeker_GetZeroRunLength(peeker) + 1;
+            /* 32bitに収まらない桁数は壊れたデータ 記録して以降は値を読まずに続ける */
+            if (ndigit > 32) {
+                peeker->is_corrupted = 1;
+                ndigit = 1;
+            }
+            if (ndigit > 1) {
+                quot += (uint32_t)((1UL << (ndigit - 1)) + NARUCoderBitPeeker_GetBits(peeker, ndigit - 1) - 1);
+            }
         }
-        val += ((quot - (num_params - 1)) << k);
+        val = table->base[last] + ((quot - last) << k);
+        val += NARUCoderBitPeeker_GetBits(peeker, k);
     }
-    val += NARURecursiveRice_GetRestPart(stream, k);
 
-    /* パラメータ更新 */
-    /* 補足）符号語が分かってからでないと更新できない */
+    /* パラメータとテーブルの更新 */
+    /* 補足）符号語が分かってからでないと更新できない
+    * 商の大きさで反復回数が変わると分岐予測が外れやすいので、全段を計算して達した段だけ反映 */
     tmp_val = val;
-    for (i = 0; (i <= quot) && (i < num_params); i++) {
+    for (i = 0; i < num_params; i++) {
+        const NARURecursiveRiceParameter prev = rice_parameters[i];
+        const NARURecursiveRiceParameter mask = (NARURecursiveRiceParameter)0 - (NARURecursiveRiceParameter)(i <= quot);
         NARURICE_PARAMETER_UPDATE(rice_parameters, i, tmp_val);
-        tmp_val -= param_cache[i];
+        rice_parameters[i] = (rice_parameters[i] & mask) | (prev & ~mask);
+        tmp_val -= (1U << table->k[i]);
+        table->k[i] = NARURICE_CALCULATE_LOG2_RICE_PARAMETER(rice_parameters, i);
+        if (i < last) {
+            table->base[i + 1] = table->base[i] + (1U << table->k[i]);
+        }
     }
 
     return val;
 }
 
+/* 一括で符号化・復号するサンプル数 */
+#define NARUGOLOMB_NUM_CHUNK_SAMPLES 64
+
+/* 32bit整数同士の積の上位32bit */
+#define NARUGOLOMB_MULHI32(a, b) ((uint32_t)(((uint64_t)(a) * (b)) >> 32))
+
+/* ゴロム符号のパラメータ設定 */
+static void NARUGolombParameter_Set(struct NARUGolombParameter *gp, uint32_t m)
+{
+    NARU_ASSERT(gp != NULL);
+    NARU_ASSERT(m != 0);
+
+    gp->m = m;
+    gp->k = NARUUTILITY_LOG2CEIL(m);
+    gp->threshold = (uint32_t)(((uint64_t)1 << gp->k) - m);
+    gp->is_power_of_2 = NARUUTILITY_IS_POWERED_OF_2(m) ? 1 : 0;
+
+    /* 不変な整数による除算の乗算への置き換え（Granlund-Montgomery）
+    * q = (t + ((n - t) >> shift1)) >> shift2, t = mulhi(n, reciprocal) が全ての32bit整数nで厳密に成立 */
+    gp->reciprocal = (uint32_t)((((uint64_t)gp->threshold) << 32) / m + 1);
+    gp->shift1 = NARUUTILITY_MIN(gp->k, 1);
+    gp->shift2 = (gp->k > 0) ? (gp->k - 1) : 0;
+}
+
+/* ゴロム符号の商の計算 */
+#define NARUGolombParameter_Divide(gp, val)\
+    (((gp)->is_power_of_2) ? ((val) >> (gp)->k)\
+     : ((NARUGOLOMB_MULHI32((val), (gp)->reciprocal)\
+         + (((val) - NARUGOLOMB_MULHI32((val), (gp)->reciprocal)) >> (gp)->shift1)) >> (gp)->shift2))
+
+/* 固定パラメータのゴロム符号で1チャンネル分の符号語を計算
+* 商の長さと、商部分の終端の1と剰余部分をつなげた符号語・その長さを求める */
+static void NARUGolomb_CalculateCodes(
+        const struct NARUGolombParameter *gp, const int32_t *data, uint32_t num_samples,
+        uint32_t *quots, uint32_t *codes, uint32_t *code_lengths)
+{
+    uint32_t smpl;
+
+    NARU_ASSERT(gp != NULL);
+    NARU_ASSERT(data != NULL);
+    NARU_ASSERT(quots != NULL);
+    NARU_ASSERT(codes != NULL);
+    NARU_ASSERT(code_lengths != NULL);
+    NARU_ASSERT(num_samples <= NARUGOLOMB_NUM_CHUNK_SAMPLES);
+
+    /* パラメータごとにループを分けて、ループ内に分岐を残さない */
+    if (gp->is_power_of_2) {
+        /* ライス符号: 剰余部は常にk桁 */
+        const uint32_t mask = (1U << gp->k) - 1;
+        for (smpl = 0; smpl < num_samples; smpl++) {
+            const uint32_t val = NARUUTILITY_SINT32_TO_UINT32(data[smpl]);
+            quots[smpl] = val >> gp->k;
+            codes[smpl] = (1U << gp->k) | (val & mask);
+            code_lengths[smpl] = gp->k + 1;
+        }
+    } else {
+        /* ゴロム符号: 剰余部が閾値未満ならばk-1桁、それ以外はk桁 */
+        for (smpl = 0; smpl < num_samples; smpl++) {
+            const uint32_t val = NARUUTILITY_SINT32_TO_UINT32(data[smpl]);
+            const uint32_t quot = NARUGolombParameter_Divide(gp, val);
+            const uint32_t rest = val - quot * gp->m;
+            const uint32_t is_long = (rest >= gp->threshold) ? 1 : 0;
+            const uint32_t nbits = gp->k - 1 + is_long;
+            quots[smpl] = quot;
+            codes[smpl] = (1U << nbits) | (rest + (gp->threshold & (0U - is_long)));
+            code_lengths[smpl] = nbits + 1;
+        }
+    }
+}
+
+/* 固定パラメータのゴロム符号の符号長計算
+* 補足）サンプル間に依存がないので、分岐のない加算にしてベクトル化させる */
+static uint64_t NARUGolomb_CalculateCodeLength(
+        const struct NARUGolombParameter *gp, const int32_t *data, uint32_t num_samples)
+{
+    uint32_t smpl;
+    uint64_t length;
+
+    NARU_ASSERT(gp != NULL);
+    NARU_ASSERT(data != NULL);
+
+    length = 0;
+    if (gp->is_power_of_2) {
+        /* ライス符号: 商 + 終端の1 + k桁 */
+        for (smpl = 0; smpl < num_samples; smpl++) {
+            length += NARUUTILITY_SINT32_TO_UINT32(data[smpl]) >> gp->k;
+        }
+        length += (uint64_t)(gp->k + 1) * num_samples;
+    } else {
+        /* ゴロム符号: 商 + 終端の1 + 剰余部が閾値以上ならばk桁、それ以外はk-1桁 */
+        for (smpl = 0; smpl < num_samples; smpl++) {
+            const uint32_t val = NARUUTILITY_SINT32_TO_UINT32(data[smpl]);
+            const uint32_t quot = NARUGolombParameter_Divide(gp, val);
+            length += quot + (((val - quot * gp->m) >= gp->threshold) ? 1U : 0U);
+        }
+        length += (uint64_t)gp->k * num_samples;
+    }
+
+    return length;
+}
+
+/* 固定パラメータのゴロム符号による符号付き整数配列の符号化 */
+static void NARUGolomb_PutDataArray(
+        struct NARUBitStream *stream, const uint32_t *m,
+        const int32_t **data, uint32_t num_channels, uint32_t num_samples)
+{
+    uint32_t ch, smpl, i, num_chunk_samples;
+    struct NARUGolombParameter gp[NARU_MAX_NUM_CHANNELS];
+    uint32_t quots[NARU_MAX_NUM_CHANNELS][NARUGOLOMB_NUM_CHUNK_SAMPLES];
+    uint32_t codes[NARU_MAX_NUM_CHANNELS][NARUGOLOMB_NUM_CHUNK_SAMPLES];
+    uint32_t code_lengths[NARU_MAX_NUM_CHANNELS][NARUGOLOMB_NUM_CHUNK_SAMPLES];
+
+    NARU_ASSERT(stream != NULL);
+    NARU_ASSERT(m != NULL);
+    NARU_ASSERT(data != NULL);
+    NARU_ASSERT(num_channels <= NARU_MAX_NUM_CHANNELS);
+
+    for (ch = 0; ch < num_channels; ch++) {
+        NARUGolombParameter_Set(&gp[ch], m[ch]);
+    }
+
+    for (smpl = 0; smpl < num_samples; smpl += num_chunk_samples) {
+        num_chunk_samples = NARUUTILITY_MIN(NARUGOLOMB_NUM_CHUNK_SAMPLES, num_samples - smpl);
+
+        /* チャンネル毎に符号語をまとめて計算 */
+        for (ch = 0; ch < num_channels; ch++) {
+            NARUGolomb_CalculateCodes(&gp[ch], &data[ch][smpl], num_chunk_samples,
+                    quots[ch], codes[ch], code_lengths[ch]);
+        }
+
+        /* チャンネルインターリーブしつつ出力 */
+        for (i = 0; i < num_chunk_samples; i++) {
+            for (ch = 0; ch < num_channels; ch++) {
+                const uint32_t quot = quots[ch][i];
+                const uint32_t length = code_lengths[ch][i];
+                if ((quot + length) <= 32) {
+                    /* 商の0の並びも含めて1回で出力 */
+                    NARUBitWriter_PutBits(stream, codes[ch][i], quot + length);
+                } else {
+                    NARUBitWriter_PutZeroRun(stream, quot);
+                    NARUBitWriter_PutBits(stream, codes[ch][i], length);
+                }
+            }
+        }
+    }
+}
+
+/* 固定パラメータのゴロム符号の取得 */
+static uint32_t NARUGolomb_GetCode(struct NARUCoderBitPeeker *peeker, const struct NARUGolombParameter *gp)
+{
+    uint32_t quot, rest;
+
+    NARU_ASSERT(peeker != NULL);
+    NARU_ASSERT(gp != NULL);
+
+    NARUCoderBitPeeker_Refill(peeker);
+
+    /* 商部分 */
+    quot = NARUUTILITY_NLZ(NARUCoderBitPeeker_Peek(peeker, 32));
+    if (quot < 32) {
+        NARUCoderBitPeeker_Skip(peeker, quot + 1);
+        /* 剰余部が短ければ商と剰余部の合計は高々56bitなので、補充済みのビットで足りる */
+        if (gp->k > 24) {
+            NARUCoderBitPeeker_Refill(peeker);
+        }
+    } else {
+        quot = NARUCoderBitPeeker_GetZeroRunLength(peeker);
+        NARUCoderBitPeeker_Refill(peeker);
+    }
+
+    /* 剰余部分 */
+    if (gp->is_power_of_2) {
+        /* k == 0でも正しく0を取り出すため2回に分けてシフト */
+        rest = (uint32_t)((peeker->buffer >> 1) >> (63 - gp->k));
+        NARUCoderBitPeeker_Skip(peeker, gp->k);
+        return (quot << gp->k) + rest;
+    }
+    /* k-1桁で表されているか先頭k-1桁で判定 */
+    rest = (uint32_t)((peeker->buffer >> 1) >> (64 - gp->k));
+    if (rest < gp->threshold) {
+        NARUCoderBitPeeker_Skip(peeker, gp->k - 1);
+        return quot * gp->m + rest;
+    }
+    rest = NARUCoderBitPeeker_Peek(peeker, gp->k);
+    NARUCoderBitPeeker_Skip(peeker, gp->k);
+    return quot * gp->m + rest - gp->threshold;
+}
+
+/* 固定パラメータのゴロム符号による符号付き整数配列の復号 */
+static void NARUGolomb_GetDataArray(
+        struct NARUBitStream *stream, const uint32_t *m,
+        int32_t **data, uint32_t num_channels, uint32_t num_samples)
+{
+    uint32_t ch, smpl;
+    struct NARUCoderBitPeeker peeker;
+    struct NARUGolombParameter gp[NARU_MAX_NUM_CHANNELS];
+
+    NARU_ASSERT(stream != NULL);
+    NARU_ASSERT(m != NULL);
+    NARU_ASSERT(data != NULL);
+    NARU_ASSERT(num_channels <= NARU_MAX_NUM_CHANNELS);
+
+    for (ch = 0; ch < num_channels; ch++) {
+        NARUGolombParameter_Set(&gp[ch], m[ch]);
+    }
+
+    NARUCoderBitPeeker_Load(&peeker, stream);
+    for (smpl = 0; smpl < num_samples; smpl++) {
+        for (ch = 0; ch < num_channels; ch++) {
+            const uint32_t abs = NARUGolomb_GetCode(&peeker, &gp[ch]);
+            data[ch][smpl] = NARUUTILITY_UINT32_TO_SINT32(abs);
+        }
+    }
+    NARUCoderBitPeeker_Store(&peeker, stream);
+}
+
+/* rANS符号の確率の精度ビット数 */
+#define NARURANS_PROBABILITY_BITS       12
+/* rANS符号の確率の分母 */
+#define NARURANS_PROBABILITY_SCALE      (1U << NARURANS_PROBABILITY_BITS)
+/* 頻度モデルの記号数（最後の記号は大きな値のエスケープ） */
+#define NARURANS_NUM_SYMBOLS            32
+/* エスケープ記号 */
+#define NARURANS_ESCAPE_SYMBOL          (NARURANS_NUM_SYMBOLS - 1)
+/* 状態あたりの頻度モデルのコンテキスト数 */
+#define NARURANS_NUM_CONTEXTS           8
+/* 記号探索の開始位置を引くバケット数のビット数 */
+#define NARURANS_BUCKET_BITS            6
+/* インターリーブする状態数
+* 補足）各状態は平均値推定と頻度モデルを専有し、復号時に互いに独立な依存チェーンになる */
+#define NARURANS_NUM_STATES             4
+/* 状態の正規化で入出力するビット数 */
+#define NARURANS_RENORM_BITS            16
+/* 状態の下限 状態は[下限, 下限 * 2^16)に保つ
+* 補足）確率の精度が16bit以下なので、正規化の入出力は1記号あたり高々1回で済む */
+#define NARURANS_STATE_LOWER_BOUND      (1U << 16)
+/* 記号1回の出現で加えるカウント */
+#define NARURANS_COUNT_INCREMENT        32
+/* カウント合計がこれを超えたら半減させて古い統計を忘れる */
+#define NARURANS_MAX_TOTAL_COUNT        (1U << 16)
+/* 頻度表を作り直す間隔の初期値と最大値 */
+#define NARURANS_INITIAL_UPDATE_INTERVAL 16
+#define NARURANS_MAX_UPDATE_INTERVAL    512
+/* 平均値推定の固定小数の小数部ビット数（=指数平滑の減衰のシフト量） */
+#define NARURANS_MEAN_SHIFT             5
+/* 平均値推定に入れる値の上限（平均値の桁あふれ防止） */
+#define NARURANS_MAX_MEAN_INPUT         (1U << 26)
+/* 符号化時の作業領域に記録する値のパック */
+#define NARURANS_PACK_SYMBOL_INFO(cumfreq, freq, k) ((uint32_t)(cumfreq) | ((uint32_t)(freq) << 12) | ((uint32_t)(k) << 25))
+
+/* 平均値推定から剰余部の桁数とコンテキストを計算
+* 補足）4 * 平均値 の桁数から、剰余部を除いた値の平均が2以上4未満になるように剰余部の桁数を決め、
+*       残りのスケールした平均値の範囲でコンテキストを分ける */
+#define NARURANS_CALCULATE_K_AND_CONTEXT(mean, k, context)\
+    do {\
+        const uint32_t t__ = (mean) >> (NARURANS_MEAN_SHIFT - 2);\
+        const uint32_t len__ = 32U - NARUUTILITY_NLZ(t__);\
+        (k) = NARUUTILITY_MAX(len__, 4U) - 4U;\
+        (context) = st_narurans_context_table[t__ >> (k)];\
+    } while (0)
+
+/* 平均値推定の更新 */
+#define NARURANS_UPDATE_MEAN(mean, uval)\
+    do {\
+        (mean) = (mean) - ((mean) >> NARURANS_MEAN_SHIFT) + NARUUTILITY_MIN((uval), NARURANS_MAX_MEAN_INPUT);\
+    } while (0)
+
+/* rANS符号の適応的頻度モデル */
+struct NARURANSModel {
+    uint32_t count[NARURANS_NUM_SYMBOLS];           /* 記号の出現カウント */
+    uint32_t total;                                 /* カウントの合計 */
+    uint32_t num_updates;                           /* 頻度表を作ってからの更新回数 */
+    uint32_t update_interval;                       /* 頻度表を作り直す間隔 */
+    uint32_t freq[NARURANS_NUM_SYMBOLS];            /* 頻度表（合計はNARURANS_PROBABILITY_SCALE） */
+    uint32_t cumfreq[NARURANS_NUM_SYMBOLS + 1];     /* 累積頻度表 */
+    uint8_t bucket[1 << NARURANS_BUCKET_BITS];      /* 確率区間の上位ビットから引く探索開始記号 */
+};
+
+/* スケールした平均値（4倍）からコンテキストへの変換表 */
+static const uint8_t st_narurans_context_table[16] = {
+    0, 1, 2, 3, 4, 4, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7
+};
+
+/* コンテキスト毎の事前分布（幾何分布）の公比 16bit固定小数 */
+static const uint32_t st_narurans_prior_ratio[NARURANS_NUM_CONTEXTS] = {
+    5958, 16990, 25080, 30490, 36409, 41704, 46811, 50972
+};
+
+/* カウントから頻度表を作成 */
+static void NARURANSModel_Rebuild(struct NARURANSModel *model)
+{
+    uint32_t s, b, sum, max_symbol, scale;
+
+    NARU_ASSERT(model != NULL);
+    NARU_ASSERT(model->total >= NARURANS_NUM_SYMBOLS);
+
+    /* 全記号に最低1を割り当て、残りをカウントに比例して配分
+    * 補足）除算は配分率の計算1回だけにする。カウントは合計以下なので積は2^28以下に収まる */
+    scale = ((NARURANS_PROBABILITY_SCALE - NARURANS_NUM_SYMBOLS) << 16) / model->total;
+    sum = 0;
+    max_symbol = 0;
+    for (s = 0; s < NARURANS_NUM_SYMBOLS; s++) {
+        model->freq[s] = 1 + ((model->count[s] * scale) >> 16);
+        sum += model->freq[s];
+        if (model->count[s] > model->count[max_symbol]) {
+            max_symbol = s;
+        }
+    }
+    /* 切り捨ての端数は最頻記号に与える */
+    NARU_ASSERT(sum <= NARURANS_PROBABILITY_SCALE);
+    model->freq[max_symbol] += NARURANS_PROBABILITY_SCALE - sum;
+
+    /* 累積頻度表 */
+    model->cumfreq[0] = 0;
+    for (s = 0; s < NARURANS_NUM_SYMBOLS; s++) {
+        model->cumfreq[s + 1] = model->cumfreq[s] + model->freq[s];
+    }
+
+    /* 各バケット先頭の確率区間を含む記号 */
+    s = 0;
+    for (b = 0; b < (1 << NARURANS_BUCKET_BITS); b++) {
+        while (model->cumfreq[s + 1] <= (b << (NARURANS_PROBABILITY_BITS - NARURANS_BUCKET_BITS))) {
+            s++;
+        }
+        model->bucket[b] = (uint8_t)s;
+    }
+
+    /* カウントが大きくなったら半減 */
+    if (model->total > NARURANS_MAX_TOTAL_COUNT) {
+        model->total = 0;
+        for (s = 0; s < NARURANS_NUM_SYMBOLS; s++) {
+            model->count[s] = (model->count[s] + 1) >> 1;
+            model->total += model->count[s];
+        }
+    }
+
+    /* 統計が安定するにつれて作り直す間隔を広げる */
+    model->num_updates = 0;
+    model->update_interval = NARUUTILITY_MIN(2 * model->update_interval, NARURANS_MAX_UPDATE_INTERVAL);
+}
+
+/* 事前分布でモデルを初期化 */
+static void NARURANSModel_Initialize(struct NARURANSModel *model, uint32_t prior_ratio)
+{
+    uint32_t s, q;
+
+    NARU_ASSERT(model != NULL);
+    NARU_ASSERT(prior_ratio < (1U << 16));
+
+    /* 幾何分布の確率（16bit固定小数）を約16回分の出現カウントとして与える */
+    q = (1U << 16) - prior_ratio;
+    model->total = 0;
+    for (s = 0; s < NARURANS_NUM_SYMBOLS; s++) {
+        model->count[s] = (q >> 7) + 1;
+        model->total += model->count[s];
+        q = (q * prior_ratio) >> 16;
+    }
+
+    model->update_interval = NARURANS_INITIAL_UPDATE_INTERVAL / 2;
+    NARURANSModel_Rebuild(model);
+}
+
+/* 記号の出現をモデルに反映 */
+#define NARURANSModel_Update(model, symbol)\
+    do {\
+        (model)->count[(symbol)] += NARURANS_COUNT_INCREMENT;\
+        (model)->total += NARURANS_COUNT_INCREMENT;\
+        if (++(model)->num_updates >= (model)->update_interval) {\
+            NARURANSModel_Rebuild(model);\
+        }\
+    } while (0)
+
+/* 全状態・全コンテキストのモデルと平均値推定を初期化 */
+static void NARURANS_InitializeModels(
+        const NARURecursiveRiceParameter *init_rice_parameter,
+        struct NARURANSModel model[NARURANS_NUM_STATES][NARURANS_NUM_CONTEXTS], uint32_t *mean)
+{
+    uint32_t i;
+    const uint32_t init_param = (uint32_t)NARUCODER_PARAMETER_GET(init_rice_parameter, 0);
+
+    NARU_ASSERT(init_rice_parameter != NULL);
+    NARU_ASSERT(model != NULL);
+    NARU_ASSERT(mean != NULL);
+
+    /* 先頭の状態のモデルを事前分布で作り、残りの状態には複製 */
+    for (i = 0; i < NARURANS_NUM_CONTEXTS; i++) {
+        NARURANSModel_Initialize(&model[0][i], st_narurans_prior_ratio[i]);
+    }
+    for (i = 1; i < NARURANS_NUM_STATES; i++) {
+        memcpy(model[i], model[0], sizeof(struct NARURANSModel) * NARURANS_NUM_CONTEXTS);
+    }
+
+    /* 平均値推定の初期値は初期パラメータから */
+    for (i = 0; i < NARURANS_NUM_STATES; i++) {
+        mean[i] = (uint32_t)NARUUTILITY_MIN(init_param, NARURANS_MAX_MEAN_INPUT) << NARURANS_MEAN_SHIFT;
+    }
+}
+
+/* rANS符号による1チャンネル分の符号付き整数配列の符号化
+* 出力は 生ビット列のサイズ(4byte) + 生ビット列（剰余部とエスケープ値） + rANS符号列（状態の初期値から） */
+static NARUError NARURANS_PutDataArray(
+        const NARURecursiveRiceParameter *init_rice_parameter,
+        const int32_t *data, uint32_t num_samples, uint32_t *work,
+        uint8_t *output, uint32_t output_size, uint32_t *encoded_size)
+{
+    uint32_t smpl, i, k, context, num_raw_bits, raw_size, rans_size;
+    uint32_t state[NARURANS_NUM_STATES], mean[NARURANS_NUM_STATES];
+    uint8_t *ptr, *raw_end;
+    struct NARUBitStream stream;
+    struct NARURANSModel model[NARURANS_NUM_STATES][NARURANS_NUM_CONTEXTS];
+
+    NARU_ASSERT(init_rice_parameter != NULL);
+    NARU_ASSERT(data != NULL);
+    NARU_ASSERT(work != NULL);
+    NARU_ASSERT(output != NULL);
+    NARU_ASSERT(encoded_size != NULL);
+
+    /* 1. 順方向に頻度モデルを更新しながら、各サンプルの記号の確率区間を記録 */
+    /* 補足）サンプルは状態に巡回して割り当て、状態毎のモデルと平均値推定だけを使う */
+    NARURANS_InitializeModels(init_rice_parameter, model, mean);
+    num_raw_bits = 0;
+    for (smpl = 0; smpl < num_samples; smpl++) {
+        const uint32_t lane = smpl % NARURANS_NUM_STATES;
+        const uint32_t uval = NARUUTILITY_SINT32_TO_UINT32(data[smpl]);
+        uint32_t quot, symbol;
+        struct NARURANSModel *pmodel;
+        NARURANS_CALCULATE_K_AND_CONTEXT(mean[lane], k, context);
+        pmodel = &model[lane][context];
+        quot = uval >> k;
+        symbol = NARUUTILITY_MIN(quot, NARURANS_ESCAPE_SYMBOL);
+        num_raw_bits += k;
+        if (symbol == NARURANS_ESCAPE_SYMBOL) {
+            num_raw_bits += NARUGamma_GetCodeLength(quot - NARURANS_ESCAPE_SYMBOL);
+        }
+        work[smpl] = NARURANS_PACK_SYMBOL_INFO(pmodel->cumfreq[symbol], pmodel->freq[symbol], k);
+        NARURANSModel_Update(pmodel, symbol);
+        NARURANS_UPDATE_MEAN(mean[lane], uval);
+    }
+
+    /* 生ビット列と状態の初期値が入らなければ諦める */
+    raw_size = (num_raw_bits + 7) / 8;
+    if ((4 + raw_size + 4 * NARURANS_NUM_STATES) > output_size) {
+        return NARU_ERROR_INSUFFICIENT_BUFFER;
+    }
+
+    /* 2. 剰余部とエスケープ値を生ビット列として出力 */
+    if (raw_size > 0) {
+        NARUBitWriter_Open(&stream, &output[4], raw_size);
+        for (smpl = 0; smpl < num_samples; smpl++) {
+            const uint32_t uval = NARUUTILITY_SINT32_TO_UINT32(data[smpl]);
+            k = work[smpl] >> 25;
+            if ((uval >> k) >= NARURANS_ESCAPE_SYMBOL) {
+                NARUGamma_PutCode(&stream, (uval >> k) - NARURANS_ESCAPE_SYMBOL);
+            }
+            if (k > 0) {
+                NARUBitWriter_PutBits(&stream, uval, k);
+            }
+        }
+        NARUBitStream_Flush(&stream);
+        NARUBitStream_Close(&stream);
+    }
+    ByteArray_WriteUint32BE(&output[0], raw_size);
+
+    /* 3. 逆順にrANS符号化 出力は領域末尾から前に向かって書く */
+    raw_end = &output[4 + raw_size];
+    ptr = &output[output_size];
+    for (i = 0; i < NARURANS_NUM_STATES; i++) {
+        state[i] = NARURANS_STATE_LOWER_BOUND;
+    }
+    for (smpl = num_samples; smpl > 0; smpl--) {
+        const uint32_t info = work[smpl - 1];
+        const uint32_t cumfreq = info & 0xFFF;
+        const uint32_t freq = (info >> 12) & 0x1FFF;
+        const uint32_t max_state = ((NARURANS_STATE_LOWER_BOUND >> NARURANS_PROBABILITY_BITS) << NARURANS_RENORM_BITS) * freq;
+        uint32_t x = state[(smpl - 1) % NARURANS_NUM_STATES];
+        /* 状態が上限を越えないように下位16bitを掃き出す */
+        if (x >= max_state) {
+            if ((uint32_t)(ptr - raw_end) < 2) {
+                return NARU_ERROR_INSUFFICIENT_BUFFER;
+            }
+            ptr -= 2;
+            ByteArray_WriteUint16BE(ptr, x & 0xFFFF);
+            x >>= NARURANS_RENORM_BITS;
+        }
+        NARU_ASSERT(x < max_state);
+        state[(smpl - 1) % NARURANS_NUM_STATES] = ((x / freq) << NARURANS_PROBABILITY_BITS) + (x % freq) + cumfreq;
+    }
+
+    /* 最終状態を書き出し（復号時は先頭の状態から読む） */
+    if ((uint32_t)(ptr - raw_end) < (4 * NARURANS_NUM_STATES)) {
+        return NARU_ERROR_INSUFFICIENT_BUFFER;
+    }
+    for (i = NARURANS_NUM_STATES; i > 0; i--) {
+        ptr -= 4;
+        ByteArray_WriteUint32BE(ptr, state[i - 1]);
+    }
+
+    /* 生ビット列の直後に詰める */
+    rans_size = (uint32_t)(&output[output_size] - ptr);
+    memmove(raw_end, ptr, rans_size);
+
+    (*encoded_size) = 4 + raw_size + rans_size;
+
+    return NARU_ERROR_OK;
+}
+
+/* rANS符号による1チャンネル分の符号付き整数配列の復号 */
+static NARUError NARURANS_GetDataArray(
+        const NARURecursiveRiceParameter *init_rice_parameter,
+        const uint8_t *input, uint32_t input_size,
+        int32_t *data, uint32_t num_samples, uint32_t *decoded_size)
+{
+    uint32_t smpl, i, k, context, raw_size, rans_size, rans_pos;
+    uint32_t state[NARURANS_NUM_STATES], mean[NARURANS_NUM_STATES];
+    uint8_t is_corrupted;
+    const uint8_t *rans_data;
+    struct NARUCoderBitPeeker peeker;
+    struct NARURANSModel model[NARURANS_NUM_STATES][NARURANS_NUM_CONTEXTS];
+
+    NARU_ASSERT(init_rice_parameter != NULL);
+    NARU_ASSERT(input != NULL);
+    NARU_ASSERT(data != NULL);
+    NARU_ASSERT(decoded_size != NULL);
+
+    /* 生ビット列のサイズと状態の初期値 */
+    if (input_size < 4) {
+        return NARU_ERROR_INSUFFICIENT_DATA;
+    }
+    raw_size = ByteArray_ReadUint32BE(&input[0]);
+    if ((raw_size > (input_size - 4)) || ((input_size - 4 - raw_size) < (4 * NARURANS_NUM_STATES))) {
+        return NARU_ERROR_INSUFFICIENT_DATA;
+    }
+    for (i = 0; i < NARURANS_NUM_STATES; i++) {
+        state[i] = ByteArray_ReadUint32BE(&input[4 + raw_size + 4 * i]);
+    }
+    rans_data = &input[4 + raw_size + 4 * NARURANS_NUM_STATES];
+    rans_size = input_size - 4 - raw_size - 4 * NARURANS_NUM_STATES;
+    rans_pos = 0;
+
+    /* 生ビット列の読み出し */
+    peeker.buffer = 0;
+    peeker.num_bits = 0;
+    peeker.num_pad_bits = 0;
+    peeker.is_corrupted = 0;
+    peeker.ptr = &input[4];
+    peeker.end = &input[4 + raw_size];
+
+    NARURANS_InitializeModels(init_rice_parameter, model, mean);
+    is_corrupted = 0;
+    for (smpl = 0; smpl < num_samples; smpl++) {
+        const uint32_t lane = smpl % NARURANS_NUM_STATES;
+        struct NARURANSModel *pmodel;
+        uint32_t x, slot, symbol, uval, word, renorm;
+
+        NARURANS_CALCULATE_K_AND_CONTEXT(mean[lane], k, context);
+        pmodel = &model[lane][context];
+
+        /* 状態の下位ビットが指す確率区間から記号を特定 */
+        x = state[lane];
+        slot = x & (NARURANS_PROBABILITY_SCALE - 1);
+        symbol = pmodel->bucket[slot >> (NARURANS_PROBABILITY_BITS - NARURANS_BUCKET_BITS)];
+        while (slot >= pmodel->cumfreq[symbol + 1]) {
+            symbol++;
+        }
+        x = pmodel->freq[symbol] * (x >> NARURANS_PROBABILITY_BITS) + slot - pmodel->cumfreq[symbol];
+        /* 状態が下限を下回ったら16bitを読み込む
+        * 補足）分岐予測が効かないので読み込みは条件選択で行い、終端越えは復号後にまとめて検査する */
+        renorm = (x < NARURANS_STATE_LOWER_BOUND) ? 1 : 0;
+        word = ((rans_pos + 2) <= rans_size) ? ByteArray_ReadUint16BE(&rans_data[rans_pos]) : 0;
+        state[lane] = renorm ? ((x << NARURANS_RENORM_BITS) | word) : x;
+        rans_pos += renorm << 1;
+
+        /* エスケープ値と剰余部を生ビット列から取得 */
+        uval = symbol;
+        if (symbol == NARURANS_ESCAPE_SYMBOL) {
+            const uint32_t ndigit = NARUCoderBitPeeker_GetZeroRunLength(&peeker);
+            if (ndigit >= 32) {
+                is_corrupted = 1;
+                break;
+            }
+            uval += (1U << ndigit) + NARUCoderBitPeeker_GetBits(&peeker, ndigit) - 1;
+        }
+        uval = (uval << k) | NARUCoderBitPeeker_GetBits(&peeker, k);
+        data[smpl] = NARUUTILITY_UINT32_TO_SINT32(uval);
+
+        NARURANSModel_Update(pmodel, symbol);
+        NARURANS_UPDATE_MEAN(mean[lane], uval);
+    }
+
+    /* 生ビット列・rANS符号列の終端を越えて読み込んでいたらデータ不足 */
+    if ((rans_pos > rans_size) || NARUCoderBitPeeker_IsOverrun(&peeker)) {
+        return NARU_ERROR_INSUFFICIENT_DATA;
+    }
+
+    /* 正しく復号できていれば状態は符号化開始時の値に戻っている */
+    for (i = 0; i < NARURANS_NUM_STATES; i++) {
+        if (state[i] != NARURANS_STATE_LOWER_BOUND) {
+            is_corrupted = 1;
+        }
+    }
+    if (is_corrupted) {
+        return NARU_ERROR_INVALID_FORMAT;
+    }
+
+    (*decoded_size) = 4 + raw_size + 4 * NARURANS_NUM_STATES + rans_pos;
+
+    return NARU_ERROR_OK;
+}
+
 /* 符号化ハンドルの作成に必要なワークサイズの計算 */
 int32_t NARUCoder_CalculateWorkSize(uint32_t max_num_channels, uint32_t max_num_parameters)
 {
@@ -493,79 +1294,243 @@ void NARUCoder_GetInitialRecursiveRiceParameter(
     }
 }
 
-/* 符号付き整数配列の符号化 */
-void NARUCoder_PutDataArray(
-        struct NARUCoder *coder, struct NARUBitStream *stream,
+/* 1チャンネル分の符号付き整数配列の符号長[bit]の計算 */
+uint64_t NARUCoder_CalculateChannelCodeLength(
+        uint32_t num_parameters, uint32_t log2_init_parameter, const int32_t *data, uint32_t num_samples)
+{
+    uint32_t i, smpl;
+    uint64_t length;
+    NARURecursiveRiceParameter rice_parameter[NARUCODER_MAX_NUM_RECURSIVERICE_PARAMETER];
+
+    NARU_ASSERT(data != NULL);
+    NARU_ASSERT(num_parameters != 0);
+    NARU_ASSERT(num_parameters <= NARUCODER_MAX_NUM_RECURSIVERICE_PARAMETER);
+    NARU_ASSERT(log2_init_parameter < 32);
+
+    /* 符号化と同じく、初期パラメータが小さい場合はパラメータ固定のゴロム符号 */
+    if ((1U << log2_init_parameter) <= NARUCODER_LOW_THRESHOULD_PARAMETER) {
+        struct NARUGolombParameter gp;
+        NARUGolombParameter_Set(&gp, 1U << log2_init_parameter);
+        return NARUGolomb_CalculateCodeLength(&gp, data, num_samples);
+    }
+
+    /* パラメータの複製を符号化と同様に更新しながら符号長を積算 */
+    for (i = 0; i < num_parameters; i++) {
+        NARUCODER_PARAMETER_SET(rice_parameter, i, 1U << log2_init_parameter);
+    }
+    length = 0;
+    {
+        struct NARURecursiveRiceEncodeTable table;
+        NARURecursiveRice_MakeEncodeTable(&table, rice_parameter, num_parameters);
+        if (num_parameters == NARUCODER_NUM_RECURSIVERICE_PARAMETER) {
+            /* 既定のパラメータ数は定数として渡し、段のループを展開させる */
+            for (smpl = 0; smpl < num_samples; smpl++) {
+                length += NARURecursiveRice_GetCodeLengthByTable(rice_parameter,
+                        NARUCODER_NUM_RECURSIVERICE_PARAMETER, &table, NARUUTILITY_SINT32_TO_UINT32(data[smpl]));
+            }
+        } else {
+            for (smpl = 0; smpl < num_samples; smpl++) {
+                length += NARURecursiveRice_GetCodeLengthByTable(rice_parameter,
+                        num_parameters, &table, NARUUTILITY_SINT32_TO_UINT32(data[smpl]));
+            }
+        }
+    }
+
+    return length;
+}
+
+/* 指定したパラメータ列を使った符号付き整数配列の符号化 */
+static void NARUCoder_PutDataArrayByParameters(
+        NARURecursiveRiceParameter **rice_parameter, NARURecursiveRiceParameter **init_rice_parameter,
+        struct NARUBitStream *stream,
         uint32_t num_parameters, const int32_t **data, uint32_t num_channels, uint32_t num_samples)
 {
     uint32_t smpl, ch;
     uint32_t param_ch_avg;
 
-    NARU_ASSERT((stream != NULL) && (data != NULL) && (coder != NULL));
-    NARU_ASSERT((num_parameters != 0) && (num_parameters <= coder->max_num_parameters));
+    NARU_ASSERT((stream != NULL) && (data != NULL));
+    NARU_ASSERT((rice_parameter != NULL) && (init_rice_parameter != NULL));
+    NARU_ASSERT(num_parameters != 0);
     NARU_ASSERT(num_samples != 0);
     NARU_ASSERT(num_channels != 0);
 
     /* 全チャンネルでのパラメータ平均を算出 */
     param_ch_avg = 0;
     for (ch = 0; ch < num_channels; ch++) {
-        param_ch_avg += NARUCODER_PARAMETER_GET(coder->init_rice_parameter[ch], 0);
+        param_ch_avg += NARUCODER_PARAMETER_GET(init_rice_parameter[ch], 0);
     }
     param_ch_avg /= num_channels;
 
     /* チャンネルインターリーブしつつ符号化 */
     if (param_ch_avg > NARUCODER_LOW_THRESHOULD_PARAMETER) {
-        for (smpl = 0; smpl < num_samples; smpl++) {
-            for (ch = 0; ch < num_channels; ch++) {
-                NARURecursiveRice_PutCode(stream,
-                        coder->rice_parameter[ch], num_parameters, NARUUTILITY_SINT32_TO_UINT32(data[ch][smpl]));
+        /* 剰余部の桁数をキャッシュしつつ符号化 */
+        struct NARURecursiveRiceEncodeTable table[NARU_MAX_NUM_CHANNELS];
+        NARU_ASSERT(num_channels <= NARU_MAX_NUM_CHANNELS);
+        NARU_ASSERT(num_parameters <= NARUCODER_MAX_NUM_RECURSIVERICE_PARAMETER);
+        for (ch = 0; ch < num_channels; ch++) {
+            NARURecursiveRice_MakeEncodeTable(&table[ch], rice_parameter[ch], num_parameters);
+        }
+        if (num_parameters == NARUCODER_NUM_RECURSIVERICE_PARAMETER) {
+            /* 既定のパラメータ数は定数として渡し、段のループを展開させる */
+            for (smpl = 0; smpl < num_samples; smpl++) {
+                for (ch = 0; ch < num_channels; ch++) {
+                    NARURecursiveRice_PutCodeByTable(stream,
+                            rice_parameter[ch], NARUCODER_NUM_RECURSIVERICE_PARAMETER, &table[ch], NARUUTILITY_SINT32_TO_UINT32(data[ch][smpl]));
+                }
+            }
+        } else {
+            for (smpl = 0; smpl < num_samples; smpl++) {
+                for (ch = 0; ch < num_channels; ch++) {
+                    NARURecursiveRice_PutCodeByTable(stream,
+                            rice_parameter[ch], num_parameters, &table[ch], NARUUTILITY_SINT32_TO_UINT32(data[ch][smpl]));
+                }
             }
         }
     } else {
         /* パラメータが小さい場合はパラメータ固定で符号 */
-        for (smpl = 0; smpl < num_samples; smpl++) {
-            for (ch = 0; ch < num_channels; ch++) {
-                NARUGolomb_PutCode(stream, NARUCODER_PARAMETER_GET(coder->init_rice_parameter[ch], 0), NARUUTILITY_SINT32_TO_UINT32(data[ch][smpl]));
-            }
+        uint32_t m[NARU_MAX_NUM_CHANNELS];
+        NARU_ASSERT(num_channels <= NARU_MAX_NUM_CHANNELS);
+        for (ch = 0; ch < num_channels; ch++) {
+            m[ch] = (uint32_t)NARUCODER_PARAMETER_GET(init_rice_parameter[ch], 0);
         }
+        NARUGolomb_PutDataArray(stream, m, data, num_channels, num_samples);
     }
 
 }
 
-/* 符号付き整数配列の復号 */
-void NARUCoder_GetDataArray(
-        struct NARUCoder *coder, struct NARUBitStream *stream,
+/* 指定したパラメータ列を使った符号付き整数配列の復号 */
+static NARUError NARUCoder_GetDataArrayByParameters(
+        NARURecursiveRiceParameter **rice_parameter, NARURecursiveRiceParameter **init_rice_parameter,
+        struct NARUBitStream *stream,
         uint32_t num_parameters, int32_t **data, uint32_t num_channels, uint32_t num_samples)
 {
     uint32_t ch, smpl, abs;
     uint32_t param_ch_avg;
 
-    NARU_ASSERT((stream != NULL) && (data != NULL) && (coder != NULL));
+    NARU_ASSERT((stream != NULL) && (data != NULL));
+    NARU_ASSERT((rice_parameter != NULL) && (init_rice_parameter != NULL));
     NARU_ASSERT((num_parameters != 0) && (num_samples != 0));
 
     /* 全チャンネルでのパラメータ平均を算出 */
     param_ch_avg = 0;
     for (ch = 0; ch < num_channels; ch++) {
-        param_ch_avg += NARUCODER_PARAMETER_GET(coder->init_rice_parameter[ch], 0);
+        param_ch_avg += NARUCODER_PARAMETER_GET(init_rice_parameter[ch], 0);
     }
     param_ch_avg /= num_channels;
 
     /* パラメータを適応的に変更しつつ符号化 */
 
     if (param_ch_avg > NARUCODER_LOW_THRESHOULD_PARAMETER) {
-        /* パラメータが小さい場合はパラメータ固定でゴロム符号化 */
+        /* 先読みビットバッファと復号テーブルを使って復号 */
+        struct NARUCoderBitPeeker peeker;
+        struct NARURecursiveRiceDecodeTable table[NARU_MAX_NUM_CHANNELS];
+        NARU_ASSERT(num_channels <= NARU_MAX_NUM_CHANNELS);
+        NARU_ASSERT(num_parameters <= NARUCODER_MAX_NUM_RECURSIVERICE_PARAMETER);
+        for (ch = 0; ch < num_channels; ch++) {
+            NARURecursiveRice_MakeDecodeTable(&table[ch], rice_parameter[ch], num_parameters);
+        }
+        NARUCoderBitPeeker_Load(&peeker, stream);
         for (smpl = 0; smpl < num_samples; smpl++) {
             for (ch = 0; ch < num_channels; ch++) {
-                abs = NARURecursiveRice_GetCode(stream, coder->rice_parameter[ch], num_parameters);
+                abs = NARURecursiveRice_GetCodeByTable(&peeker, rice_parameter[ch], num_parameters, &table[ch]);
                 data[ch][smpl] = NARUUTILITY_UINT32_TO_SINT32(abs);
             }
         }
+        NARUCoderBitPeeker_Store(&peeker, stream);
+        if (peeker.is_corrupted) {
+            return NARU_ERROR_INVALID_FORMAT;
+        }
     } else {
-        for (smpl = 0; smpl < num_samples; smpl++) {
-            for (ch = 0; ch < num_channels; ch++) {
-                abs = NARUGolomb_GetCode(stream, NARUCODER_PARAMETER_GET(coder->init_rice_parameter[ch], 0));
-                data[ch][smpl] = NARUUTILITY_UINT32_TO_SINT32(abs);
-            }
+        /* パラメータが小さい場合はパラメータ固定でゴロム符号化 */
+        uint32_t m[NARU_MAX_NUM_CHANNELS];
+        NARU_ASSERT(num_channels <= NARU_MAX_NUM_CHANNELS);
+        for (ch = 0; ch < num_channels; ch++) {
+            m[ch] = (uint32_t)NARUCODER_PARAMETER_GET(init_rice_parameter[ch], 0);
         }
+        NARUGolomb_GetDataArray(stream, m, data, num_channels, num_samples);
     }
+
+    return NARU_ERROR_OK;
+}
+
+/* 符号付き整数配列の符号化 */
+void NARUCoder_PutDataArray(
+        struct NARUCoder *coder, struct NARUBitStream *stream,
+        uint32_t num_parameters, const int32_t **data, uint32_t num_channels, uint32_t num_samples)
+{
+    NARU_ASSERT((stream != NULL) && (data != NULL) && (coder != NULL));
+    NARU_ASSERT(num_parameters <= coder->max_num_parameters);
+    NARU_ASSERT(num_channels <= coder->max_num_channels);
+
+    NARUCoder_PutDataArrayByParameters(coder->rice_parameter, coder->init_rice_parameter,
+            stream, num_parameters, data, num_channels, num_samples);
+}
+
+/* 1チャンネル分の符号付き整数配列の符号化 */
+void NARUCoder_PutChannelDataArray(
+        struct NARUCoder *coder, struct NARUBitStream *stream,
+        uint32_t num_parameters, uint32_t channel_index, const int32_t *data, uint32_t num_samples)
+{
+    NARU_ASSERT((stream != NULL) && (data != NULL) && (coder != NULL));
+    NARU_ASSERT(num_parameters <= coder->max_num_parameters);
+    NARU_ASSERT(channel_index < coder->max_num_channels);
+
+    /* 指定チャンネルのパラメータだけを使い、1チャンネルとして符号化 */
+    NARUCoder_PutDataArrayByParameters(
+            &coder->rice_parameter[channel_index], &coder->init_rice_parameter[channel_index],
+            stream, num_parameters, &data, 1, num_samples);
+}
+
+/* 符号付き整数配列の復号 */
+NARUError NARUCoder_GetDataArray(
+        struct NARUCoder *coder, struct NARUBitStream *stream,
+        uint32_t num_parameters, int32_t **data, uint32_t num_channels, uint32_t num_samples)
+{
+    NARU_ASSERT((stream != NULL) && (data != NULL) && (coder != NULL));
+    NARU_ASSERT(num_parameters <= coder->max_num_parameters);
+    NARU_ASSERT(num_channels <= coder->max_num_channels);
+
+    return NARUCoder_GetDataArrayByParameters(coder->rice_parameter, coder->init_rice_parameter,
+            stream, num_parameters, data, num_channels, num_samples);
+}
+
+/* 1チャンネル分の符号付き整数配列の復号 */
+NARUError NARUCoder_GetChannelDataArray(
+        struct NARUCoder *coder, struct NARUBitStream *stream,
+        uint32_t num_parameters, uint32_t channel_index, int32_t *data, uint32_t num_samples)
+{
+    NARU_ASSERT((stream != NULL) && (data != NULL) && (coder != NULL));
+    NARU_ASSERT(num_parameters <= coder->max_num_parameters);
+    NARU_ASSERT(channel_index < coder->max_num_channels);
+
+    return NARUCoder_GetDataArrayByParameters(
+            &coder->rice_parameter[channel_index], &coder->init_rice_parameter[channel_index],
+            stream, num_parameters, &data, 1, num_samples);
+}
+
+/* 1チャンネル分の符号付き整数配列のrANS符号化 */
+NARUError NARUCoder_PutChannelDataArrayRANS(
+        struct NARUCoder *coder, uint32_t channel_index, const int32_t *data, uint32_t num_samples,
+        uint32_t *work, uint8_t *output, uint32_t output_size, uint32_t *encoded_size)
+{
+    NARU_ASSERT((coder != NULL) && (data != NULL) && (work != NULL));
+    NARU_ASSERT((output != NULL) && (encoded_size != NULL));
+    NARU_ASSERT(channel_index < coder->max_num_channels);
+
+    /* 平均値推定の初期値には再帰的ライス符号の初期パラメータを使う */
+    return NARURANS_PutDataArray(coder->init_rice_parameter[channel_index],
+            data, num_samples, work, output, output_size, encoded_size);
+}
+
+/* 1チャンネル分の符号付き整数配列のrANS復号 */
+NARUError NARUCoder_GetChannelDataArrayRANS(
+        struct NARUCoder *coder, uint32_t channel_index, const uint8_t *input, uint32_t input_size,
+        int32_t *data, uint32_t num_samples, uint32_t *decoded_size)
+{
+    NARU_ASSERT((coder != NULL) && (input != NULL) && (data != NULL));
+    NARU_ASSERT(decoded_size != NULL);
+    NARU_ASSERT(channel_index < coder->max_num_channels);
+
+    return NARURANS_GetDataArray(coder->init_rice_parameter[channel_index],
+            input, input_size, data, num_samples, decoded_size);
 }
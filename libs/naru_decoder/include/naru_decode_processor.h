@@ -38,6 +38,11 @@ void NARUDecodeProcessor_GetFilterState(
 void NARUDecodeProcessor_Synthesize(
         struct NARUDecodeProcessor *processor, int32_t *buffer, uint32_t num_samples);
 
+/* 複数チャンネルの合成（可能ならばチャンネルをSIMDレーンに並べて一括処理） */
+void NARUDecodeProcessor_SynthesizeMultiChannel(
+        struct NARUDecodeProcessor *const *processors, struct NARUFilterLanes *lanes,
+        int32_t *const *buffer, uint32_t num_channels, uint32_t num_samples);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
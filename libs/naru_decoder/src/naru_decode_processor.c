@@ -37,16 +37,12 @@ struct NARUDecodeProcessor {
     int32_t deemphasis_prev;
 };
 
-/* NGSAフィルタの1サンプル合成処理 */
-static int32_t NARUNGSAFilter_Synthesize(struct NARUNGSAFilter *filter, int32_t residual);
 /* NGSAフィルタの状態取得 */
 static void NARUNGSAFilter_GetFilterState(struct NARUNGSAFilter *filter, struct NARUBitStream *stream);
-/* SAフィルタの1サンプル合成処理 */
-static int32_t NARUSAFilter_Synthesize(struct NARUSAFilter *filter, int32_t residual);
 /* SAフィルタの状態取得 */
 static void NARUSAFilter_GetFilterState(struct NARUSAFilter *filter, struct NARUBitStream *stream);
-/* 1サンプルをデエンファシス */
-static int32_t NARUDecodeProcessor_DeEmphasis(struct NARUDecodeProcessor *processor, int32_t residual);
+/* SA・NGSA・デエンファシスを1サンプル毎に連結して合成 */
+static void NARUDecodeProcessor_SynthesizeCascade(struct NARUDecodeProcessor *processor, int32_t *buffer, uint32_t num_samples);
 
 /* プロセッサ作成に必要なワークサイズ計算 */
 int32_t NARUDecodeProcessor_CalculateWorkSize(uint8_t max_filter_order)
@@ -185,6 +181,8 @@ static void NARUNGSAFilter_GetFilterState(
         /* 履歴アクセス高速化のために、次数だけ離れた位置にも記録 */
         filter->history[filter->filter_order + ord] = filter->history[ord];
     }
+    /* 履歴は先頭から並んでいるので参照位置を戻す */
+    filter->buffer_pos = 0;
 }
 
 /* SAフィルタの状態取得 */
@@ -215,6 +213,8 @@ static void NARUSAFilter_GetFilterState(
         /* 履歴アクセス高速化のために、次数だけ離れた位置にも記録 */
         filter->history[filter->filter_order + ord] = filter->history[ord];
     }
+    /* 履歴は先頭から並んでいるので参照位置を戻す */
+    filter->buffer_pos = 0;
 }
 
 /* プロセッサの状態を取得 */
@@ -235,131 +235,260 @@ void NARUDecodeProcessor_GetFilterState(
     NARUSAFilter_GetFilterState(processor->sa, stream);
 }
 
-/* 1サンプルをデエンファシス */
-static int32_t NARUDecodeProcessor_DeEmphasis(struct NARUDecodeProcessor *processor, int32_t residual)
+/* SA・NGSA・デエンファシスを1サンプル毎に連結して合成
+* 補足）フィルタの状態はブロック先頭でローカル変数に受け、末尾で書き戻す */
+static void NARUDecodeProcessor_SynthesizeCascade(
+        struct NARUDecodeProcessor *processor, int32_t *buffer, uint32_t num_samples)
 {
+    uint32_t smpl;
+    int32_t ord, deemphasis_prev;
+    int32_t *ngsa_history, *ngsa_ngrad, *ngsa_weight, *sa_history, *sa_weight;
+    int32_t ngsa_pos, sa_pos;
     const int32_t coef_numer = ((1 << NARU_EMPHASIS_FILTER_SHIFT) - 1);
+    struct NARUNGSAFilter *ngsa = processor->ngsa;
+    struct NARUSAFilter *sa = processor->sa;
+    const int32_t ngsa_order = ngsa->filter_order;
+    const int32_t ngsa_mask = ngsa->buffer_pos_mask;
+    const int32_t ar_order = ngsa->ar_order;
+    const int32_t *ar_coef = ngsa->ar_coef;
+    const int32_t *pdelta_table = ngsa->pdelta_table;
+    const int32_t delta_rshift = ngsa->delta_rshift;
+    const struct NARUFilterFunctions *ngsa_functions = ngsa->functions;
+    const int32_t sa_order = sa->filter_order;
+    const int32_t sa_mask = sa->buffer_pos_mask;
+    const struct NARUFilterFunctions *sa_functions = sa->functions;
 
     NARU_ASSERT(processor != NULL);
-
-    /* 直前の値に固定フィルタ出力を加算 */
-    residual += (int32_t)NARUUTILITY_SHIFT_RIGHT_ARITHMETIC(processor->deemphasis_prev * coef_numer, NARU_EMPHASIS_FILTER_SHIFT);
-
-    /* 直前の値を更新 */
-    processor->deemphasis_prev = residual;
-
-    return residual;
-}
-
-/* NGSAフィルタの1サンプル合成処理 */
-static int32_t NARUNGSAFilter_Synthesize(struct NARUNGSAFilter *filter, int32_t residual)
-{
-    int32_t ord, synth, predict;
-    int32_t *ngrad, *history, *ar_coef, *weight;
-    const int32_t filter_order = filter->filter_order;
-    const int32_t ar_order = filter->ar_order;
-
-    NARU_ASSERT(filter != NULL);
+    NARU_ASSERT(buffer != NULL);
+    NARU_ASSERT(pdelta_table == &ngsa->delta_table[1]);
 
     /* ローカル変数に受けとく */
-    history = &filter->history[filter->buffer_pos];
-    ar_coef = &filter->ar_coef[0];
-    weight = &filter->weight[0];
-
-    /* フィルタ予測 */
-    predict = NARU_FIXEDPOINT_0_5;
-    for (ord = 0; ord < filter_order; ord++) {
-        predict += weight[ord] * history[ord];
-    }
-    predict = NARUUTILITY_SHIFT_RIGHT_ARITHMETIC(predict, NARU_FIXEDPOINT_DIGITS);
-
-    /* 合成復元 */
-    synth = residual + predict;
+    deemphasis_prev = processor->deemphasis_prev;
+    ngsa_history = ngsa->history;
+    ngsa_ngrad = ngsa->ngrad;
+    ngsa_weight = ngsa->weight;
+    ngsa_pos = ngsa->buffer_pos;
+    sa_history = sa->history;
+    sa_weight = sa->weight;
+    sa_pos = sa->buffer_pos;
 
-    /* バッファ参照位置更新 */
-    filter->buffer_pos = (filter->buffer_pos - 1) & filter->buffer_pos_mask;
-
-    /* 自然勾配更新 */
-    ngrad = &filter->ngrad[filter->buffer_pos];
-    for (ord = 0; ord < ar_order; ord++) {
-        const int32_t pos = (filter->buffer_pos + filter_order - 1 - ord) & filter->buffer_pos_mask;
-        filter->ngrad[pos] += NARUUTILITY_SHIFT_RIGHT_ARITHMETIC(ar_coef[ord] * ngrad[filter_order], NARU_FIXEDPOINT_DIGITS);
-        filter->ngrad[pos + filter_order] = filter->ngrad[pos];
-    }
-    ngrad[0] = 0;
-    for (ord = 0; ord < ar_order; ord++) {
-        ngrad[0] -= ar_coef[ord] * history[ord + 1];
-    }
-    ngrad[0] = NARUUTILITY_SHIFT_RIGHT_ARITHMETIC(ngrad[0], NARU_FIXEDPOINT_DIGITS);
-    ngrad[0] += history[0];
-    for (ord = 0; ord < ar_order; ord++) {
-        const int32_t pos = (filter->buffer_pos + ord + 1) & filter->buffer_pos_mask;
-        filter->ngrad[pos] -= NARUUTILITY_SHIFT_RIGHT_ARITHMETIC(ar_coef[ord] * ngrad[0], NARU_FIXEDPOINT_DIGITS);
-        filter->ngrad[pos + filter_order] = filter->ngrad[pos];
-    }
-
-    /* フィルタ係数更新 */
-    NARU_ASSERT(filter->pdelta_table == &filter->delta_table[1]);
-    {
-        const int32_t half = (1 << (filter->delta_rshift - 1));
-        const int32_t delta = filter->pdelta_table[NARUUTILITY_SIGN(residual)];
-        for (ord = 0; ord < filter_order; ord++) {
-            int32_t mul = delta * ngrad[ord];
-            mul += half;
-            mul = NARUUTILITY_SHIFT_RIGHT_ARITHMETIC(mul, filter->delta_rshift);
-            weight[ord] += mul;
+    for (smpl = 0; smpl < num_samples; smpl++) {
+        int32_t residual, synth, predict, ngrad0;
+        const int32_t *phistory;
+        int32_t *pngrad;
+
+        residual = buffer[smpl];
+
+        /* SA: フィルタ予測 */
+        phistory = &sa_history[sa_pos];
+        predict = NARU_FIXEDPOINT_0_5 + sa_functions->dot_product(sa_weight, phistory, sa_order);
+        predict = NARUUTILITY_SHIFT_RIGHT_ARITHMETIC(predict, NARU_FIXEDPOINT_DIGITS);
+        synth = residual + predict;
+
+        /* SA: 係数更新 */
+        sa_functions->update_sa_weight(sa_weight, phistory, NARUUTILITY_SIGN(residual), sa_order);
+
+        /* SA: 入力データ履歴更新 */
+        sa_pos = (sa_pos - 1) & sa_mask;
+        sa_history[sa_pos] = sa_history[sa_pos + sa_order] = synth;
+        residual = synth;
+
+        /* NGSA: フィルタ予測 */
+        phistory = &ngsa_history[ngsa_pos];
+        predict = NARU_FIXEDPOINT_0_5 + ngsa_functions->dot_product(ngsa_weight, phistory, ngsa_order);
+        predict = NARUUTILITY_SHIFT_RIGHT_ARITHMETIC(predict, NARU_FIXEDPOINT_DIGITS);
+        synth = residual + predict;
+
+        /* NGSA: バッファ参照位置更新 */
+        ngsa_pos = (ngsa_pos - 1) & ngsa_mask;
+
+        /* NGSA: 自然勾配更新 */
+        pngrad = &ngsa_ngrad[ngsa_pos];
+        for (ord = 0; ord < ar_order; ord++) {
+            const int32_t pos = (ngsa_pos + ngsa_order - 1 - ord) & ngsa_mask;
+            ngsa_ngrad[pos] += NARUUTILITY_SHIFT_RIGHT_ARITHMETIC(ar_coef[ord] * pngrad[ngsa_order], NARU_FIXEDPOINT_DIGITS);
+            ngsa_ngrad[pos + ngsa_order] = ngsa_ngrad[pos];
+        }
+        ngrad0 = 0;
+        for (ord = 0; ord < ar_order; ord++) {
+            ngrad0 -= ar_coef[ord] * phistory[ord + 1];
+        }
+        pngrad[0] = NARUUTILITY_SHIFT_RIGHT_ARITHMETIC(ngrad0, NARU_FIXEDPOINT_DIGITS) + phistory[0];
+        for (ord = 0; ord < ar_order; ord++) {
+            const int32_t pos = (ngsa_pos + ord + 1) & ngsa_mask;
+            ngsa_ngrad[pos] -= NARUUTILITY_SHIFT_RIGHT_ARITHMETIC(ar_coef[ord] * pngrad[0], NARU_FIXEDPOINT_DIGITS);
+            ngsa_ngrad[pos + ngsa_order] = ngsa_ngrad[pos];
         }
-    }
-
-    /* 入力データ履歴更新 */
-    filter->history[filter->buffer_pos]
-        = filter->history[filter->buffer_pos + filter_order] = synth;
-
-    return synth;
-}
-
-/* SAフィルタの1サンプル合成処理 */
-static int32_t NARUSAFilter_Synthesize(struct NARUSAFilter *filter, int32_t residual)
-{
-    int32_t ord, synth, predict, sign;
-    int32_t *history, *weight;
-    const int32_t filter_order = filter->filter_order;
-
-    NARU_ASSERT(filter != NULL);
 
-    /* ローカル変数に受けとく */
-    history = &filter->history[filter->buffer_pos];
-    weight = &filter->weight[0];
+        /* NGSA: フィルタ係数更新 */
+        ngsa_functions->update_ngsa_weight(ngsa_weight, pngrad,
+                pdelta_table[NARUUTILITY_SIGN(residual)], delta_rshift, ngsa_order);
 
-    /* フィルタ予測 */
-    predict = NARU_FIXEDPOINT_0_5;
-    for (ord = 0; ord < filter_order; ord++) {
-        predict += weight[ord] * history[ord];
-    }
-    predict = NARUUTILITY_SHIFT_RIGHT_ARITHMETIC(predict, NARU_FIXEDPOINT_DIGITS);
+        /* NGSA: 入力データ履歴更新 */
+        ngsa_history[ngsa_pos] = ngsa_history[ngsa_pos + ngsa_order] = synth;
 
-    /* 合成復元 */
-    synth = residual + predict;
+        /* デエンファシス */
+        synth += (int32_t)NARUUTILITY_SHIFT_RIGHT_ARITHMETIC(deemphasis_prev * coef_numer, NARU_EMPHASIS_FILTER_SHIFT);
+        deemphasis_prev = synth;
 
-    /* 係数更新 */
-    sign = NARUUTILITY_SIGN(residual);
-    for (ord = 0; ord < filter_order; ord++) {
-        weight[ord] += sign * history[ord];
+        buffer[smpl] = synth;
     }
 
-    /* 入力データ履歴更新 */
-    filter->buffer_pos = (filter->buffer_pos - 1) & filter->buffer_pos_mask;
-    filter->history[filter->buffer_pos]
-        = filter->history[filter->buffer_pos + filter_order] = synth;
+    /* 状態を書き戻し */
+    processor->deemphasis_prev = deemphasis_prev;
+    ngsa->buffer_pos = ngsa_pos;
+    sa->buffer_pos = sa_pos;
+}
 
-    return synth;
+/* AR次数1のNGSAフィルタの1サンプル合成処理（次数は定数, 状態はローカル変数で受け渡し）
+* 補足）次数が定数なのでループの展開とリングバッファのマスク計算の畳み込みを期待 */
+#define NARUNGSAFILTER_SYNTHESIZE_SAMPLE_AR1(order, history, ngrad, weight, pos, ar_coef, pdelta_table, delta_rshift, residual, synth)\
+    do {\
+        int32_t ord_, predict_, delta_;\
+        const int32_t *phistory_ = &(history)[(pos)];\
+        int32_t *pngrad_;\
+        \
+        /* フィルタ予測 */\
+        predict_ = NARU_FIXEDPOINT_0_5;\
+        for (ord_ = 0; ord_ < (order); ord_++) {\
+            predict_ += (weight)[ord_] * phistory_[ord_];\
+        }\
+        predict_ = NARUUTILITY_SHIFT_RIGHT_ARITHMETIC(predict_, NARU_FIXEDPOINT_DIGITS);\
+        \
+        /* 合成復元 */\
+        (synth) = (residual) + predict_;\
+        \
+        /* バッファ参照位置更新 */\
+        (pos) = ((pos) - 1) & ((order) - 1);\
+        \
+        /* 自然勾配更新 */\
+        pngrad_ = &(ngrad)[(pos)];\
+        {\
+            const int32_t tail_ = ((pos) + (order) - 1) & ((order) - 1);\
+            const int32_t head_ = ((pos) + 1) & ((order) - 1);\
+            (ngrad)[tail_] += NARUUTILITY_SHIFT_RIGHT_ARITHMETIC((ar_coef) * pngrad_[(order)], NARU_FIXEDPOINT_DIGITS);\
+            (ngrad)[tail_ + (order)] = (ngrad)[tail_];\
+            pngrad_[0] = NARUUTILITY_SHIFT_RIGHT_ARITHMETIC(-((ar_coef) * phistory_[1]), NARU_FIXEDPOINT_DIGITS);\
+            pngrad_[0] += phistory_[0];\
+            (ngrad)[head_] -= NARUUTILITY_SHIFT_RIGHT_ARITHMETIC((ar_coef) * pngrad_[0], NARU_FIXEDPOINT_DIGITS);\
+            (ngrad)[head_ + (order)] = (ngrad)[head_];\
+        }\
+        \
+        /* フィルタ係数更新 */\
+        delta_ = (pdelta_table)[NARUUTILITY_SIGN((residual))];\
+        for (ord_ = 0; ord_ < (order); ord_++) {\
+            (weight)[ord_] += NARUUTILITY_SHIFT_RIGHT_ARITHMETIC(delta_ * pngrad_[ord_] + (1 << ((delta_rshift) - 1)), (delta_rshift));\
+        }\
+        \
+        /* 入力データ履歴更新 */\
+        (history)[(pos)] = (history)[(pos) + (order)] = (synth);\
+    } while (0)
+
+/* SAフィルタの1サンプル合成処理（次数は定数, 状態はローカル変数で受け渡し） */
+#define NARUSAFILTER_SYNTHESIZE_SAMPLE(order, history, weight, pos, residual, synth)\
+    do {\
+        int32_t ord_, predict_, sign_;\
+        const int32_t *phistory_ = &(history)[(pos)];\
+        \
+        /* フィルタ予測 */\
+        predict_ = NARU_FIXEDPOINT_0_5;\
+        for (ord_ = 0; ord_ < (order); ord_++) {\
+            predict_ += (weight)[ord_] * phistory_[ord_];\
+        }\
+        predict_ = NARUUTILITY_SHIFT_RIGHT_ARITHMETIC(predict_, NARU_FIXEDPOINT_DIGITS);\
+        \
+        /* 係数更新 */\
+        sign_ = NARUUTILITY_SIGN((residual));\
+        for (ord_ = 0; ord_ < (order); ord_++) {\
+            (weight)[ord_] += sign_ * phistory_[ord_];\
+        }\
+        \
+        /* 合成復元 */\
+        (synth) = (residual) + predict_;\
+        \
+        /* 入力データ履歴更新 */\
+        (pos) = ((pos) - 1) & ((order) - 1);\
+        (history)[(pos)] = (history)[(pos) + (order)] = (synth);\
+    } while (0)
+
+/* SA・AR次数1のNGSA・デエンファシスを連結したブロック合成処理を次数を定数として定義
+* 補足）全段の状態をローカル変数に置いたまま1サンプル毎に各段を処理する */
+#define NARUDECODEPROCESSOR_DEFINE_SYNTHESIZE_CASCADE_AR1(ngsa_order, sa_order)\
+static void NARUDecodeProcessor_SynthesizeCascadeAR1Order##ngsa_order##x##sa_order(\
+        struct NARUDecodeProcessor *processor, int32_t *buffer, uint32_t num_samples)\
+{\
+    uint32_t smpl;\
+    int32_t deemphasis_prev, ngsa_pos, sa_pos;\
+    int32_t *ngsa_history, *ngsa_ngrad, *ngsa_weight, *sa_history, *sa_weight;\
+    const int32_t coef_numer = ((1 << NARU_EMPHASIS_FILTER_SHIFT) - 1);\
+    struct NARUNGSAFilter *ngsa = processor->ngsa;\
+    struct NARUSAFilter *sa = processor->sa;\
+    const int32_t ar_coef = ngsa->ar_coef[0];\
+    const int32_t delta_rshift = ngsa->delta_rshift;\
+    const int32_t *pdelta_table = ngsa->pdelta_table;\
+    \
+    NARU_ASSERT(ngsa->filter_order == (ngsa_order));\
+    NARU_ASSERT(ngsa->ar_order == 1);\
+    NARU_ASSERT(sa->filter_order == (sa_order));\
+    NARU_ASSERT(pdelta_table == &ngsa->delta_table[1]);\
+    \
+    /* ローカル変数に受けとく */\
+    deemphasis_prev = processor->deemphasis_prev;\
+    ngsa_history = ngsa->history;\
+    ngsa_ngrad = ngsa->ngrad;\
+    ngsa_weight = ngsa->weight;\
+    ngsa_pos = ngsa->buffer_pos;\
+    sa_history = sa->history;\
+    sa_weight = sa->weight;\
+    sa_pos = sa->buffer_pos;\
+    \
+    for (smpl = 0; smpl < num_samples; smpl++) {\
+        int32_t sa_synth, ngsa_synth;\
+        const int32_t residual = buffer[smpl];\
+        \
+        /* SA */\
+        NARUSAFILTER_SYNTHESIZE_SAMPLE(sa_order, sa_history, sa_weight, sa_pos, residual, sa_synth);\
+        /* NGSA */\
+        NARUNGSAFILTER_SYNTHESIZE_SAMPLE_AR1(ngsa_order, ngsa_history, ngsa_ngrad, ngsa_weight, ngsa_pos,\
+                ar_coef, pdelta_table, delta_rshift, sa_synth, ngsa_synth);\
+        /* デエンファシス */\
+        ngsa_synth += (int32_t)NARUUTILITY_SHIFT_RIGHT_ARITHMETIC(deemphasis_prev * coef_numer, NARU_EMPHASIS_FILTER_SHIFT);\
+        deemphasis_prev = ngsa_synth;\
+        buffer[smpl] = ngsa_synth;\
+    }\
+    \
+    /* 状態を書き戻し */\
+    processor->deemphasis_prev = deemphasis_prev;\
+    ngsa->buffer_pos = ngsa_pos;\
+    sa->buffer_pos = sa_pos;\
 }
 
+/* エンコードプリセットで使う次数の組み合わせに対して連結合成処理を定義 */
+NARUDECODEPROCESSOR_DEFINE_SYNTHESIZE_CASCADE_AR1(4, 4)
+NARUDECODEPROCESSOR_DEFINE_SYNTHESIZE_CASCADE_AR1(8, 8)
+NARUDECODEPROCESSOR_DEFINE_SYNTHESIZE_CASCADE_AR1(16, 8)
+NARUDECODEPROCESSOR_DEFINE_SYNTHESIZE_CASCADE_AR1(32, 8)
+NARUDECODEPROCESSOR_DEFINE_SYNTHESIZE_CASCADE_AR1(64, 8)
+
+/* 連結合成関数テーブル */
+static const struct {
+    int32_t ngsa_order;   /* NGSAフィルタ次数 */
+    int32_t sa_order;     /* SAフィルタ次数 */
+    void (*synthesize)(struct NARUDecodeProcessor *, int32_t *, uint32_t);
+} st_synthesize_cascade_ar1_functions[] = {
+    {  4, 4, NARUDecodeProcessor_SynthesizeCascadeAR1Order4x4 },
+    {  8, 8, NARUDecodeProcessor_SynthesizeCascadeAR1Order8x8 },
+    { 16, 8, NARUDecodeProcessor_SynthesizeCascadeAR1Order16x8 },
+    { 32, 8, NARUDecodeProcessor_SynthesizeCascadeAR1Order32x8 },
+    { 64, 8, NARUDecodeProcessor_SynthesizeCascadeAR1Order64x8 },
+};
+
 /* 合成 */
 void NARUDecodeProcessor_Synthesize(
         struct NARUDecodeProcessor *processor, int32_t *buffer, uint32_t num_samples)
 {
-    uint32_t smpl;
+    uint32_t i;
+    void (*cascade_synthesize)(struct NARUDecodeProcessor *, int32_t *, uint32_t);
 
     /* 引数チェック */
     NARU_ASSERT(processor != NULL);
@@ -373,17 +502,87 @@ void NARUDecodeProcessor_Synthesize(
                 || (processor->ngsa->filter_order > (2 * processor->ngsa->ar_order)));
     NARU_ASSERT(processor->sa->filter_order <= processor->sa->max_filter_order);
 
+    /* 次数特化版の連結合成関数を探す */
+    cascade_synthesize = NULL;
+    if ((processor->ngsa->ar_order == 1)
+            && NARUFilter_IsUnrolledKernelPreferred(processor->ngsa->functions, processor->ngsa->filter_order)
+            && NARUFilter_IsUnrolledKernelPreferred(processor->sa->functions, processor->sa->filter_order)) {
+        for (i = 0; i < sizeof(st_synthesize_cascade_ar1_functions) / sizeof(st_synthesize_cascade_ar1_functions[0]); i++) {
+            if ((st_synthesize_cascade_ar1_functions[i].ngsa_order == processor->ngsa->filter_order)
+                    && (st_synthesize_cascade_ar1_functions[i].sa_order == processor->sa->filter_order)) {
+                cascade_synthesize = st_synthesize_cascade_ar1_functions[i].synthesize;
+                break;
+            }
+        }
+    }
+
     /* 自然勾配の初期化 */
     NARUNGSAFilter_InitializeNaturalGradient(processor->ngsa);
 
-    /* 1サンプル毎に合成
-    * 補足）static関数なので、最適化時に展開されることを期待 */
-    for (smpl = 0; smpl < num_samples; smpl++) {
-        /* SA */
-        buffer[smpl] = NARUSAFilter_Synthesize(processor->sa, buffer[smpl]);
-        /* NGSA */
-        buffer[smpl] = NARUNGSAFilter_Synthesize(processor->ngsa, buffer[smpl]);
-        /* デエンファシス */
-        buffer[smpl] = NARUDecodeProcessor_DeEmphasis(processor, buffer[smpl]);
+    if (cascade_synthesize != NULL) {
+        /* 次数特化版の連結合成 */
+        cascade_synthesize(processor, buffer, num_samples);
+    } else {
+        /* 各段を1サンプル毎に連結して合成 */
+        NARUDecodeProcessor_SynthesizeCascade(processor, buffer, num_samples);
+    }
+}
+
+/* 複数チャンネルの合成（可能ならばチャンネルをSIMDレーンに並べて一括処理） */
+void NARUDecodeProcessor_SynthesizeMultiChannel(
+        struct NARUDecodeProcessor *const *processors, struct NARUFilterLanes *lanes,
+        int32_t *const *buffer, uint32_t num_channels, uint32_t num_samples)
+{
+    uint32_t ch, base, num_lanes;
+    int32_t use_lanes;
+    struct NARUNGSAFilter *ngsa[NARU_MAX_NUM_CHANNELS];
+    struct NARUSAFilter *sa[NARU_MAX_NUM_CHANNELS];
+    int32_t deemphasis_prev[NARU_MAX_NUM_CHANNELS];
+
+    /* 引数チェック */
+    NARU_ASSERT(processors != NULL);
+    NARU_ASSERT(buffer != NULL);
+    NARU_ASSERT((num_channels > 0) && (num_channels <= NARU_MAX_NUM_CHANNELS));
+    NARU_ASSERT(num_samples > 0);
+
+    for (ch = 0; ch < num_channels; ch++) {
+        ngsa[ch] = processors[ch]->ngsa;
+        sa[ch] = processors[ch]->sa;
+    }
+
+    /* レーン並列処理できるか判定 */
+    use_lanes = ((lanes != NULL)
+            && NARUFilterLanes_IsPreferred(lanes, num_channels, processors[0]->ngsa->filter_order)) ? 1 : 0;
+    for (base = 0; use_lanes && (base < num_channels); base += NARUFILTER_NUM_LANES) {
+        num_lanes = NARUUTILITY_MIN(num_channels - base, NARUFILTER_NUM_LANES);
+        use_lanes = NARUFilterLanes_IsLoadable(lanes, &ngsa[base], &sa[base], num_lanes);
+    }
+
+    /* できない場合はチャンネル毎に合成 */
+    if (!use_lanes) {
+        for (ch = 0; ch < num_channels; ch++) {
+            NARUDecodeProcessor_Synthesize(processors[ch], buffer[ch], num_samples);
+        }
+        return;
+    }
+
+    /* 自然勾配の初期化 */
+    for (ch = 0; ch < num_channels; ch++) {
+        NARU_ASSERT(processors[ch]->ngsa->filter_order <= processors[ch]->ngsa->max_filter_order);
+        NARU_ASSERT(processors[ch]->sa->filter_order <= processors[ch]->sa->max_filter_order);
+        NARUNGSAFilter_InitializeNaturalGradient(processors[ch]->ngsa);
+        deemphasis_prev[ch] = processors[ch]->deemphasis_prev;
+    }
+
+    /* レーン数分ずつ一括で合成 */
+    for (base = 0; base < num_channels; base += NARUFILTER_NUM_LANES) {
+        num_lanes = NARUUTILITY_MIN(num_channels - base, NARUFILTER_NUM_LANES);
+        NARUFilterLanes_Load(lanes, &ngsa[base], &sa[base], &deemphasis_prev[base], num_lanes);
+        lanes->functions->synthesize_lanes(lanes, &buffer[base], num_samples);
+        NARUFilterLanes_Store(lanes, &ngsa[base], &sa[base], &deemphasis_prev[base], num_lanes);
+    }
+
+    for (ch = 0; ch < num_channels; ch++) {
+        processors[ch]->deemphasis_prev = deemphasis_prev[ch];
     }
 }
@@ -7,23 +7,49 @@
 #include "naru_decode_processor.h"
 
 #include <stdlib.h>
+#include <string.h>
 
 /* 内部状態フラグ */
 #define NARUDECODER_STATUS_FLAG_ALLOCED_BY_OWN  (1 << 0)  /* 領域を自己割当した */
 #define NARUDECODER_STATUS_FLAG_SET_HEADER      (1 << 1)  /* ヘッダセット済み */
-#define NARUDECODER_STATUS_FLAG_CRC16_CHECK     (1 << 2)  /* CRC16の検査を行う */
+#define NARUDECODER_STATUS_FLAG_CRC_CHECK       (1 << 2)  /* チェックサムの検査を行う */
+#define NARUDECODER_STATUS_FLAG_STREAMING       (1 << 3)  /* ストリーミングデコード中 */
+#define NARUDECODER_STATUS_FLAG_STREAM_HEADER   (1 << 4)  /* ストリームのヘッダ取得済み */
+#define NARUDECODER_STATUS_FLAG_STREAM_END      (1 << 5)  /* ストリームの全ブロックを出力済み */
 
 /* 内部状態フラグ操作マクロ */
 #define NARUDECODER_SET_STATUS_FLAG(decoder, flag)    ((decoder->status_flags) |= (flag))
-#define NARUDECODER_CLEAR_STATUS_FLAG(decoder, flag)  ((decoder->status_flags) &= ~(flag))
+#define NARUDECODER_CLEAR_STATUS_FLAG(decoder, flag)  ((decoder->status_flags) &= (uint8_t)~(flag))
 #define NARUDECODER_GET_STATUS_FLAG(decoder, flag)    ((decoder->status_flags) & (flag))
 
+/* 並列デコードのワーカー */
+struct NARUDecodeWorker {
+    struct NARUDecoder *decoder;            /* ワーカー専用のデコーダ（先頭はハンドル自身） */
+    const uint8_t *data;                    /* 担当ブロックの先頭 */
+    uint32_t data_size;                     /* 担当ブロックのサイズ */
+    uint32_t sample_offset;                 /* 担当ブロックの先頭サンプル位置 */
+    NARUApiResult result;                   /* デコード結果 */
+};
+
 /* デコーダハンドル */
 struct NARUDecoder {
     struct NARUHeader header;               /* ヘッダ */
     struct NARUDecodeProcessor *processor[NARU_MAX_NUM_CHANNELS];  /* 信号処理ハンドル */
+    struct NARUFilterLanes *lanes;          /* チャンネル並列処理用のレーン */
     struct NARUCoder *coder;                /* 符号化ハンドル */
+    NARUUtilityCRC16Function crc16;         /* CRC16計算関数 */
+    NARUUtilityCRC32CFunction crc32c;       /* CRC32C計算関数 */
     uint32_t max_num_channels;              /* デコード可能な最大チャンネル数 */
+    uint8_t max_num_threads;                /* 最大スレッド数 */
+    uint32_t max_num_samples_per_block;     /* ブロックバッファのサンプル数 */
+    int32_t *block_buffer[NARU_MAX_NUM_CHANNELS];  /* 範囲デコードで両端のブロックを受けるバッファ */
+    struct NARUDecodeWorker *worker;        /* 並列デコードのワーカー */
+    uint8_t *stream_data;                   /* ストリーミングデコードで未完了のヘッダ・ブロックを溜める領域 */
+    uint32_t stream_data_size;              /* ストリーミングデコードの領域サイズ */
+    uint32_t stream_num_buffered_bytes;     /* ストリーミングデコードで溜めているバイト数 */
+    uint32_t stream_num_decoded_samples;    /* ストリーミングデコードで出力済みのサンプル数 */
+    NARUDecoderWriteCallback stream_callback;  /* ストリーミングデコードの出力コールバック */
+    void *stream_user_data;                 /* 出力コールバックに渡すユーザデータ */
     uint8_t status_flags;                   /* 内部状態フラグ */
     void *work;                             /* ワーク領域先頭ポインタ */
 };
@@ -36,10 +62,45 @@ static NARUApiResult NARUDecoder_DecodeRawData(
         uint32_t *decode_size);
 /* 圧縮データブロックデコード */
 static NARUApiResult NARUDecoder_DecodeCompressData(
-        struct NARUDecoder *decoder,
+        struct NARUDecoder *decoder, NARUBlockDataType block_type,
         const uint8_t *data, uint32_t data_size,
         int32_t **buffer, uint32_t num_channels, uint32_t num_decode_samples,
         uint32_t *decode_size);
+/* チャンネル毎のサブストリームから残差を復号 */
+static NARUApiResult NARUDecoder_DecodeResidualSubstreams(
+        struct NARUDecoder *decoder, NARUBlockDataType block_type,
+        const uint8_t *data, uint32_t data_size,
+        int32_t **buffer, uint32_t num_decode_samples,
+        uint32_t *decode_size);
+/* ブロックヘッダに記録されたブロックサイズの検査 */
+static NARUApiResult NARUDecoder_CheckBlockSizeField(uint32_t block_size_field, NARUBlockChecksumType checksum_type);
+/* ブロックヘッダからブロックサイズとサンプル数を取得 */
+static NARUApiResult NARUDecoder_GetBlockSizeInformation(
+        const uint8_t *data, uint32_t data_size, NARUBlockChecksumType checksum_type,
+        uint32_t *block_size, uint32_t *num_block_samples);
+/* ブロックのチェックサムを検査 */
+static NARUApiResult NARUDecoder_CheckBlockChecksum(
+        const struct NARUDecoder *decoder, const uint8_t *data, uint32_t block_size);
+/* データ末尾のシークテーブルを取得 */
+static NARUApiResult NARUDecoder_GetSeekTable(
+        const struct NARUDecoder *decoder, const uint8_t *data, uint32_t data_size,
+        const uint8_t **seek_points, uint32_t *num_seek_points, uint32_t *table_offset);
+/* 複数スレッドで全ブロックデコード */
+static NARUApiResult NARUDecoder_DecodeBlocksParallel(
+        struct NARUDecoder *decoder,
+        const uint8_t *data, uint32_t data_size,
+        int32_t **buffer, uint32_t buffer_num_channels, uint32_t buffer_num_samples);
+/* ブロックバッファにブロックをデコードし、その一部を出力 */
+static NARUApiResult NARUDecoder_DecodePartOfBlock(
+        struct NARUDecoder *decoder,
+        const uint8_t *data, uint32_t data_size, uint32_t num_skip_samples, uint32_t num_max_output_samples,
+        int32_t **buffer, uint32_t *num_output_samples);
+/* ストリーミングデコードで次に処理するヘッダ・ブロックのサイズを取得 */
+static NARUApiResult NARUDecoder_GetStreamUnitSize(
+        const struct NARUDecoder *decoder, const uint8_t *data, uint32_t data_size, uint32_t *unit_size);
+/* ストリーミングデコードで揃ったヘッダ・ブロックを処理 */
+static NARUApiResult NARUDecoder_ProcessStreamUnit(
+        struct NARUDecoder *decoder, const uint8_t *data, uint32_t data_size);
 
 /* ヘッダデコード */
 NARUApiResult NARUDecoder_DecodeHeader(
@@ -97,9 +158,17 @@ NARUApiResult NARUDecoder_DecodeHeader(
     /* サンプルあたりビット数 */
     ByteArray_GetUint16BE(data_pos, &u16buf);
     tmp_header.bits_per_sample = u16buf;
+    /* ブロックのチェックサム種別 */
+    /* 補足）旧フォーマットでは最大ブロックあたりサンプル数の上位8bitの位置にあり、常に0（CRC16）になる */
+    ByteArray_GetUint8(data_pos, &u8buf);
+    tmp_header.block_checksum_type = (NARUBlockChecksumType)u8buf;
+    /* シークテーブルの有無 */
+    /* 補足）旧フォーマットでは最大ブロックあたりサンプル数の上位8bitの位置にあり、常に0（なし）になる */
+    ByteArray_GetUint8(data_pos, &u8buf);
+    tmp_header.has_seek_table = u8buf;
     /* 最大ブロックあたりサンプル数 */
-    ByteArray_GetUint32BE(data_pos, &u32buf);
-    tmp_header.max_num_samples_per_block = u32buf;
+    ByteArray_GetUint16BE(data_pos, &u16buf);
+    tmp_header.max_num_samples_per_block = u16buf;
     /* フィルタ次数 */
     ByteArray_GetUint8(data_pos, &u8buf);
     tmp_header.filter_order = u8buf;
@@ -128,8 +197,10 @@ static NARUError NARUDecoder_CheckHeaderFormat(const struct NARUHeader *header)
     NARU_ASSERT(header != NULL);
 
     /* フォーマットバージョン */
-    /* 補足）今のところは不一致なら無条件でエラー */
-    if (header->format_version != NARU_FORMAT_VERSION) {
+    /* 補足）残差をチャンネルインターリーブしていた旧バージョンまではデコード可能 */
+    if ((header->format_version != NARU_FORMAT_VERSION)
+            && (header->format_version != NARU_FORMAT_VERSION_CRC16_CHECKSUM)
+            && (header->format_version != NARU_FORMAT_VERSION_INTERLEAVED_RESIDUAL)) {
         return NARU_ERROR_INVALID_FORMAT;
     }
     /* コーデックバージョン */
@@ -179,6 +250,21 @@ static NARUError NARUDecoder_CheckHeaderFormat(const struct NARUHeader *header)
             && (header->num_channels == 1)) {
         return NARU_ERROR_INVALID_FORMAT;
     }
+    /* ブロックのチェックサム種別: 旧バージョンではCRC16のみ */
+    if (header->block_checksum_type >= NARU_BLOCK_CHECKSUM_TYPE_INVALID) {
+        return NARU_ERROR_INVALID_FORMAT;
+    }
+    if ((header->format_version != NARU_FORMAT_VERSION)
+            && (header->block_checksum_type != NARU_BLOCK_CHECKSUM_TYPE_CRC16)) {
+        return NARU_ERROR_INVALID_FORMAT;
+    }
+    /* シークテーブルの有無: 旧バージョンではなしのみ */
+    if (header->has_seek_table > 1) {
+        return NARU_ERROR_INVALID_FORMAT;
+    }
+    if ((header->format_version != NARU_FORMAT_VERSION) && (header->has_seek_table != 0)) {
+        return NARU_ERROR_INVALID_FORMAT;
+    }
 
     return NARU_ERROR_OK;
 }
@@ -193,6 +279,13 @@ int32_t NARUDecoder_CalculateWorkSize(const struct NARUDecoderConfig *config)
         return -1;
     }
 
+    /* スレッド数0は単一スレッドとして扱う */
+    if (config->max_num_threads == 0) {
+        struct NARUDecoderConfig single_config = (*config);
+        single_config.max_num_threads = 1;
+        return NARUDecoder_CalculateWorkSize(&single_config);
+    }
+
     /* コンフィグチェック */
     if ((config->max_num_channels == 0)
             || (config->max_filter_order == 0)
@@ -216,6 +309,31 @@ int32_t NARUDecoder_CalculateWorkSize(const struct NARUDecoderConfig *config)
     }
     work_size += tmp_work_size * (int32_t)config->max_num_channels;
 
+    /* チャンネル並列処理用のレーン */
+    if ((tmp_work_size = NARUFilterLanes_CalculateWorkSize(config->max_filter_order)) < 0) {
+        return -1;
+    }
+    work_size += tmp_work_size;
+
+    /* ブロックバッファ */
+    if (config->max_num_samples_per_block > 0) {
+        work_size += (int32_t)config->max_num_channels
+            * ((int32_t)sizeof(int32_t) * (int32_t)config->max_num_samples_per_block + NARU_MEMORY_ALIGNMENT);
+    }
+
+    /* ワーカー */
+    work_size += (int32_t)sizeof(struct NARUDecodeWorker) * config->max_num_threads + NARU_MEMORY_ALIGNMENT;
+    if (config->max_num_threads > 1) {
+        /* 2番目以降のワーカーは専用のデコーダを持つ */
+        struct NARUDecoderConfig worker_config = (*config);
+        worker_config.max_num_threads = 1;
+        worker_config.max_num_samples_per_block = 0;
+        if ((tmp_work_size = NARUDecoder_CalculateWorkSize(&worker_config)) < 0) {
+            return -1;
+        }
+        work_size += tmp_work_size * (config->max_num_threads - 1);
+    }
+
     return work_size;
 }
 
@@ -227,6 +345,13 @@ struct NARUDecoder *NARUDecoder_Create(const struct NARUDecoderConfig *config, v
     uint8_t *work_ptr;
     uint8_t tmp_alloc_by_own = 0;
 
+    /* スレッド数0は単一スレッドとして扱う */
+    if ((config != NULL) && (config->max_num_threads == 0)) {
+        struct NARUDecoderConfig single_config = (*config);
+        single_config.max_num_threads = 1;
+        return NARUDecoder_Create(&single_config, work, work_size);
+    }
+
     /* 領域自前確保の場合 */
     if ((work == NULL) && (work_size == 0)) {
         if ((work_size = NARUDecoder_CalculateWorkSize(config)) < 0) {
@@ -260,12 +385,16 @@ struct NARUDecoder *NARUDecoder_Create(const struct NARUDecoderConfig *config, v
     /* 構造体メンバセット */
     decoder->work = work;
     decoder->max_num_channels = config->max_num_channels;
+    decoder->max_num_threads = config->max_num_threads;
+    decoder->max_num_samples_per_block = config->max_num_samples_per_block;
+    decoder->stream_data = NULL;
+    decoder->stream_callback = NULL;
     decoder->status_flags = 0;  /* 状態クリア */
     if (tmp_alloc_by_own == 1) {
         NARUDECODER_SET_STATUS_FLAG(decoder, NARUDECODER_STATUS_FLAG_ALLOCED_BY_OWN);
     }
     if (config->check_crc == 1) {
-        NARUDECODER_SET_STATUS_FLAG(decoder, NARUDECODER_STATUS_FLAG_CRC16_CHECK);
+        NARUDECODER_SET_STATUS_FLAG(decoder, NARUDECODER_STATUS_FLAG_CRC_CHECK);
     }
 
     /* コーダーハンドルの作成 */
@@ -279,6 +408,13 @@ struct NARUDecoder *NARUDecoder_Create(const struct NARUDecoderConfig *config, v
         work_ptr += coder_size;
     }
 
+    /* 実行環境で最速のCRC16計算関数を選択 */
+    decoder->crc16 = NARUUtility_GetCRC16Function(NARUUtility_GetAvailableCRC16Implementation());
+    NARU_ASSERT(decoder->crc16 != NULL);
+    /* CRC32Cも同様 */
+    decoder->crc32c = NARUUtility_GetCRC32CFunction(NARUUtility_GetAvailableCRC32CImplementation());
+    NARU_ASSERT(decoder->crc32c != NULL);
+
     /* 信号処理ハンドルの作成 */
     {
         int32_t processor_size = NARUDecodeProcessor_CalculateWorkSize(config->max_filter_order);
@@ -291,6 +427,49 @@ struct NARUDecoder *NARUDecoder_Create(const struct NARUDecoderConfig *config, v
         }
     }
 
+    /* チャンネル並列処理用のレーンの作成 */
+    {
+        int32_t lanes_size = NARUFilterLanes_CalculateWorkSize(config->max_filter_order);
+        if ((decoder->lanes = NARUFilterLanes_Create(config->max_filter_order, work_ptr, lanes_size)) == NULL) {
+            return NULL;
+        }
+        work_ptr += lanes_size;
+    }
+
+    /* ブロックバッファの割当 */
+    for (ch = 0; ch < NARU_MAX_NUM_CHANNELS; ch++) {
+        decoder->block_buffer[ch] = NULL;
+    }
+    if (config->max_num_samples_per_block > 0) {
+        for (ch = 0; ch < config->max_num_channels; ch++) {
+            work_ptr = (uint8_t *)NARUUTILITY_ROUNDUP((uintptr_t)work_ptr, NARU_MEMORY_ALIGNMENT);
+            decoder->block_buffer[ch] = (int32_t *)work_ptr;
+            work_ptr += sizeof(int32_t) * config->max_num_samples_per_block;
+        }
+    }
+
+    /* ワーカーの作成 */
+    work_ptr = (uint8_t *)NARUUTILITY_ROUNDUP((uintptr_t)work_ptr, NARU_MEMORY_ALIGNMENT);
+    decoder->worker = (struct NARUDecodeWorker *)work_ptr;
+    work_ptr += sizeof(struct NARUDecodeWorker) * config->max_num_threads;
+    /* 先頭のワーカーはハンドル自身を使う */
+    decoder->worker[0].decoder = decoder;
+    if (config->max_num_threads > 1) {
+        uint32_t thrd;
+        struct NARUDecoderConfig worker_config = (*config);
+        int32_t worker_size;
+        worker_config.max_num_threads = 1;
+        worker_config.max_num_samples_per_block = 0;
+        worker_size = NARUDecoder_CalculateWorkSize(&worker_config);
+        for (thrd = 1; thrd < config->max_num_threads; thrd++) {
+            if ((decoder->worker[thrd].decoder
+                        = NARUDecoder_Create(&worker_config, work_ptr, worker_size)) == NULL) {
+                return NULL;
+            }
+            work_ptr += worker_size;
+        }
+    }
+
     /* バッファオーバーランチェック */
     /* 補足）既にメモリを破壊している可能性があるので、チェックに失敗したら落とす */
     NARU_ASSERT((work_ptr - (uint8_t *)work) <= work_size);
@@ -307,6 +486,10 @@ struct NARUDecoder *NARUDecoder_Create(const struct NARUDecoderConfig *config, v
 void NARUDecoder_Destroy(struct NARUDecoder *decoder)
 {
     if (decoder != NULL) {
+        uint32_t thrd;
+        for (thrd = 1; thrd < decoder->max_num_threads; thrd++) {
+            NARUDecoder_Destroy(decoder->worker[thrd].decoder);
+        }
         NARUCoder_Destroy(decoder->coder);
         if (NARUDECODER_GET_STATUS_FLAG(decoder, NARUDECODER_STATUS_FLAG_ALLOCED_BY_OWN)) {
             free(decoder->work);
@@ -345,6 +528,17 @@ NARUApiResult NARUDecoder_SetHeader(
     decoder->header = (*header);
     NARUDECODER_SET_STATUS_FLAG(decoder, NARUDECODER_STATUS_FLAG_SET_HEADER);
 
+    /* ワーカーのデコーダにもセット */
+    {
+        uint32_t thrd;
+        NARUApiResult ret;
+        for (thrd = 1; thrd < decoder->max_num_threads; thrd++) {
+            if ((ret = NARUDecoder_SetHeader(decoder->worker[thrd].decoder, header)) != NARU_APIRESULT_OK) {
+                return ret;
+            }
+        }
+    }
+
     return NARU_APIRESULT_OK;
 }
 
@@ -419,7 +613,7 @@ static NARUApiResult NARUDecoder_DecodeRawData(
 
 /* 圧縮データブロックデコード */
 static NARUApiResult NARUDecoder_DecodeCompressData(
-        struct NARUDecoder *decoder,
+        struct NARUDecoder *decoder, NARUBlockDataType block_type,
         const uint8_t *data, uint32_t data_size,
         int32_t **buffer, uint32_t num_channels, uint32_t num_decode_samples,
         uint32_t *decode_size)
@@ -457,25 +651,67 @@ static NARUApiResult NARUDecoder_DecodeCompressData(
                 &stream, NARUCODER_NUM_RECURSIVERICE_PARAMETER, ch);
     }
 
-    /* 残差復号 */
-    NARUCoder_GetDataArray(decoder->coder, &stream,
-            NARUCODER_NUM_RECURSIVERICE_PARAMETER,
-            buffer, header->num_channels, num_decode_samples);
+    /* ブロック末尾を越えて読み込んでいたらデータ不足 */
+    if (NARUBitReader_IsOverrun(&stream)) {
+        NARUBitStream_Close(&stream);
+        return NARU_APIRESULT_INSUFFICIENT_DATA;
+    }
 
-    /* バイト境界に揃える */
-    NARUBitStream_Flush(&stream);
+    if (header->format_version == NARU_FORMAT_VERSION_INTERLEAVED_RESIDUAL) {
+        NARUError err;
+        NARU_ASSERT(block_type == NARU_BLOCK_DATA_TYPE_COMPRESSDATA);
 
-    /* 読み出しサイズの取得 */
-    NARUBitStream_Tell(&stream, (int32_t *)decode_size);
+        /* 旧フォーマット: 全チャンネルインターリーブされた残差を続けて復号 */
+        err = NARUCoder_GetDataArray(decoder->coder, &stream,
+                NARUCODER_NUM_RECURSIVERICE_PARAMETER,
+                buffer, header->num_channels, num_decode_samples);
 
-    /* ビットライタ破棄 */
-    NARUBitStream_Close(&stream);
+        /* バイト境界に揃える */
+        NARUBitStream_Flush(&stream);
 
-    /* チャンネル毎に合成処理 */
-    for (ch = 0; ch < header->num_channels; ch++) {
-        NARUDecodeProcessor_Synthesize(decoder->processor[ch], buffer[ch], num_decode_samples);
+        /* 符号として解釈できないビット列があれば破損している
+        * 補足）正しい符号列の途中で途切れても起こらないので、データ不足より先に判定する */
+        if (err != NARU_ERROR_OK) {
+            NARUBitStream_Close(&stream);
+            return NARU_APIRESULT_INVALID_FORMAT;
+        }
+        /* ブロック末尾を越えて読み込んでいたらデータ不足 */
+        if (NARUBitReader_IsOverrun(&stream)) {
+            NARUBitStream_Close(&stream);
+            return NARU_APIRESULT_INSUFFICIENT_DATA;
+        }
+
+        /* 読み出しサイズの取得 */
+        NARUBitStream_Tell(&stream, (int32_t *)decode_size);
+
+        /* ビットリーダ破棄 */
+        NARUBitStream_Close(&stream);
+    } else {
+        uint32_t read_offset, residual_size;
+        NARUApiResult ret;
+
+        /* バイト境界に揃える */
+        NARUBitStream_Flush(&stream);
+
+        /* 読み出しサイズの取得 */
+        NARUBitStream_Tell(&stream, (int32_t *)&read_offset);
+
+        /* ビットリーダ破棄 */
+        NARUBitStream_Close(&stream);
+
+        /* チャンネル毎のサブストリームから残差復号 */
+        if ((ret = NARUDecoder_DecodeResidualSubstreams(decoder, block_type,
+                        &data[read_offset], data_size - read_offset,
+                        buffer, num_decode_samples, &residual_size)) != NARU_APIRESULT_OK) {
+            return ret;
+        }
+        (*decode_size) = read_offset + residual_size;
     }
 
+    /* 全チャンネルの合成処理 */
+    NARUDecodeProcessor_SynthesizeMultiChannel(
+            decoder->processor, decoder->lanes, buffer, header->num_channels, num_decode_samples);
+
     /* MS -> LR */
     if (header->ch_process_method == NARU_CH_PROCESS_METHOD_MS) {
         /* チャンネル数チェック */
@@ -489,6 +725,108 @@ static NARUApiResult NARUDecoder_DecodeCompressData(
     return NARU_APIRESULT_OK;
 }
 
+/* チャンネル毎のサブストリームから残差を復号 */
+static NARUApiResult NARUDecoder_DecodeResidualSubstreams(
+        struct NARUDecoder *decoder, NARUBlockDataType block_type,
+        const uint8_t *data, uint32_t data_size,
+        int32_t **buffer, uint32_t num_decode_samples,
+        uint32_t *decode_size)
+{
+    int32_t ch, num_channels;
+    uint32_t table_size;
+    uint32_t offset[NARU_MAX_NUM_CHANNELS + 1];
+    NARUApiResult result[NARU_MAX_NUM_CHANNELS];
+    const uint8_t *read_ptr;
+
+    /* 内部関数なので不正な引数はアサートで落とす */
+    NARU_ASSERT(decoder != NULL);
+    NARU_ASSERT(data != NULL);
+    NARU_ASSERT(buffer != NULL);
+    NARU_ASSERT(decode_size != NULL);
+
+    num_channels = (int32_t)decoder->header.num_channels;
+
+    /* サブストリームのサイズ表を読み、各チャンネルの開始位置を確定 */
+    table_size = NARU_BLOCK_SUBSTREAM_SIZE_BYTES * (uint32_t)(num_channels - 1);
+    if (table_size > data_size) {
+        return NARU_APIRESULT_INSUFFICIENT_DATA;
+    }
+    read_ptr = data;
+    offset[0] = table_size;
+    for (ch = 0; ch < (num_channels - 1); ch++) {
+        uint32_t substream_size;
+        ByteArray_GetUint32BE(read_ptr, &substream_size);
+        if (substream_size > (data_size - offset[ch])) {
+            return NARU_APIRESULT_INSUFFICIENT_DATA;
+        }
+        offset[ch + 1] = offset[ch] + substream_size;
+    }
+    /* 末尾チャンネルは残り全てを読み出し範囲とする */
+    offset[num_channels] = data_size;
+    if (offset[num_channels - 1] >= data_size) {
+        return NARU_APIRESULT_INSUFFICIENT_DATA;
+    }
+
+    /* チャンネル毎に独立して復号 */
+    /* 補足）サブストリームとパラメータはチャンネル間で共有しないので、複数スレッドを使えるならば並列に復号
+    *       ブロック単位の並列デコード中はネストした並列領域になるため単一スレッドで実行される */
+#if defined(_OPENMP)
+#pragma omp parallel for num_threads(NARUUTILITY_MIN(decoder->max_num_threads, num_channels)) if (decoder->max_num_threads > 1) schedule(static, 1)
+#endif
+    for (ch = 0; ch < num_channels; ch++) {
+        uint32_t read_size;
+        result[ch] = NARU_APIRESULT_OK;
+        if (block_type == NARU_BLOCK_DATA_TYPE_COMPRESSDATA_RANS) {
+            const NARUError err = NARUCoder_GetChannelDataArrayRANS(decoder->coder, (uint32_t)ch,
+                    &data[offset[ch]], offset[ch + 1] - offset[ch],
+                    buffer[ch], num_decode_samples, &read_size);
+            if (err != NARU_ERROR_OK) {
+                /* データが尽きた場合はデータ不足、復号後の状態が一致しない場合は破損している */
+                result[ch] = (err == NARU_ERROR_INSUFFICIENT_DATA)
+                    ? NARU_APIRESULT_INSUFFICIENT_DATA : NARU_APIRESULT_INVALID_FORMAT;
+                continue;
+            }
+        } else {
+            struct NARUBitStream stream;
+            NARUError err;
+            NARUBitReader_Open(&stream, (uint8_t *)&data[offset[ch]], offset[ch + 1] - offset[ch]);
+            err = NARUCoder_GetChannelDataArray(decoder->coder, &stream,
+                    NARUCODER_NUM_RECURSIVERICE_PARAMETER, (uint32_t)ch, buffer[ch], num_decode_samples);
+            NARUBitStream_Flush(&stream);
+            NARUBitStream_Tell(&stream, (int32_t *)&read_size);
+            /* 符号として解釈できなければ破損している、サブストリーム末尾を越えて読み込んでいたらデータ不足 */
+            if (err != NARU_ERROR_OK) {
+                result[ch] = NARU_APIRESULT_INVALID_FORMAT;
+            } else if (NARUBitReader_IsOverrun(&stream)) {
+                result[ch] = NARU_APIRESULT_INSUFFICIENT_DATA;
+            }
+            NARUBitStream_Close(&stream);
+            if (result[ch] != NARU_APIRESULT_OK) {
+                continue;
+            }
+        }
+        if (ch < (num_channels - 1)) {
+            /* 記録されたサイズと読み出したサイズが一致しなければ破損している */
+            if (read_size != (offset[ch + 1] - offset[ch])) {
+                result[ch] = NARU_APIRESULT_INVALID_FORMAT;
+            }
+        } else {
+            offset[num_channels] = offset[ch] + read_size;
+        }
+    }
+
+    for (ch = 0; ch < num_channels; ch++) {
+        if (result[ch] != NARU_APIRESULT_OK) {
+            return result[ch];
+        }
+    }
+
+    /* 読み出しサイズ */
+    (*decode_size) = offset[num_channels];
+
+    return NARU_APIRESULT_OK;
+}
+
 /* 単一データブロックデコード */
 NARUApiResult NARUDecoder_DecodeBlock(
         struct NARUDecoder *decoder,
@@ -500,7 +838,7 @@ NARUApiResult NARUDecoder_DecodeBlock(
     uint16_t buf16;
     uint32_t buf32;
     uint16_t num_block_samples;
-    uint32_t block_header_size, block_data_size;
+    uint32_t block_header_size, block_data_size, checksum_size;
     NARUApiResult ret;
     NARUBlockDataType block_type;
     const struct NARUHeader *header;
@@ -526,6 +864,12 @@ NARUApiResult NARUDecoder_DecodeBlock(
         return NARU_APIRESULT_INSUFFICIENT_BUFFER;
     }
 
+    /* ブロックヘッダ分のデータがない */
+    checksum_size = NARU_BLOCK_CHECKSUM_SIZE(header->block_checksum_type);
+    if (data_size < NARU_BLOCK_HEADER_SIZE_FOR_CHECKSUM(header->block_checksum_type)) {
+        return NARU_APIRESULT_INSUFFICIENT_DATA;
+    }
+
     /* ブロックヘッダデコード */
     read_ptr = data;
 
@@ -537,41 +881,52 @@ NARUApiResult NARUDecoder_DecodeBlock(
     }
     /* ブロックサイズ */
     ByteArray_GetUint32BE(read_ptr, &buf32);
-    NARU_ASSERT(buf32 > 0);
+    if ((ret = NARUDecoder_CheckBlockSizeField(buf32, header->block_checksum_type)) != NARU_APIRESULT_OK) {
+        return ret;
+    }
     /* データサイズ不足 */
-    if ((buf32 + 6) > data_size) {
+    if (buf32 > (data_size - 6)) {
         return NARU_APIRESULT_INSUFFICIENT_DATA;
     }
-    /* ブロックCRC16 */
-    ByteArray_GetUint16BE(read_ptr, &buf16);
-    /* チェックするならばCRC16計算を行い取得値との一致を確認 */
-    if (NARUDECODER_GET_STATUS_FLAG(decoder, NARUDECODER_STATUS_FLAG_CRC16_CHECK)) {
-        /* CRC16自体の領域は外すために-2 */
-        uint16_t crc16 = NARUUtility_CalculateCRC16(read_ptr, buf32 - 2);
-        if (crc16 != buf16) {
-            return NARU_APIRESULT_DETECT_DATA_CORRUPTION;
+    /* ブロックチェックサム
+    * チェックするならばチェックサム計算を行い取得値との一致を確認 */
+    if (NARUDECODER_GET_STATUS_FLAG(decoder, NARUDECODER_STATUS_FLAG_CRC_CHECK)) {
+        if ((ret = NARUDecoder_CheckBlockChecksum(decoder, data, buf32 + 6)) != NARU_APIRESULT_OK) {
+            return ret;
         }
     }
+    read_ptr += checksum_size;
     /* ブロックデータタイプ */
     ByteArray_GetUint8(read_ptr, &buf8);
     block_type = (NARUBlockDataType)buf8;
     /* ブロックチャンネルあたりサンプル数 */
     ByteArray_GetUint16BE(read_ptr, &num_block_samples);
+    if (num_block_samples == 0) {
+        return NARU_APIRESULT_INVALID_FORMAT;
+    }
     if (num_block_samples > buffer_num_samples) {
         return NARU_APIRESULT_INSUFFICIENT_BUFFER;
     }
     /* ブロックヘッダサイズ */
     block_header_size = (uint32_t)(read_ptr - data);
 
-    /* データ部のデコード */
+    /* rANS符号化ブロックは現行バージョンで追加したので、旧バージョンのストリームには現れない */
+    if ((block_type == NARU_BLOCK_DATA_TYPE_COMPRESSDATA_RANS)
+            && (header->format_version != NARU_FORMAT_VERSION)) {
+        return NARU_APIRESULT_INVALID_FORMAT;
+    }
+
+    /* データ部のデコード
+    * 補足）読み出し範囲はブロックサイズで区切り、後続のブロックや入力の終端を越えて読まない */
     switch (block_type) {
     case NARU_BLOCK_DATA_TYPE_RAWDATA:
         ret = NARUDecoder_DecodeRawData(decoder,
-                read_ptr, data_size - block_header_size, buffer, header->num_channels, num_block_samples, &block_data_size);
+                read_ptr, buf32 + 6 - block_header_size, buffer, header->num_channels, num_block_samples, &block_data_size);
         break;
     case NARU_BLOCK_DATA_TYPE_COMPRESSDATA:
-        ret = NARUDecoder_DecodeCompressData(decoder,
-                read_ptr, data_size - block_header_size, buffer, header->num_channels, num_block_samples, &block_data_size);
+    case NARU_BLOCK_DATA_TYPE_COMPRESSDATA_RANS:
+        ret = NARUDecoder_DecodeCompressData(decoder, block_type,
+                read_ptr, buf32 + 6 - block_header_size, buffer, header->num_channels, num_block_samples, &block_data_size);
         break;
     default:
         return NARU_APIRESULT_INVALID_FORMAT;
@@ -592,6 +947,173 @@ NARUApiResult NARUDecoder_DecodeBlock(
     return NARU_APIRESULT_OK;
 }
 
+/* ブロックヘッダに記録されたブロックサイズの検査
+* 補足）記録値は同期コード(2byte)とブロックサイズ(4byte)自体を含まない */
+static NARUApiResult NARUDecoder_CheckBlockSizeField(uint32_t block_size_field, NARUBlockChecksumType checksum_type)
+{
+    /* チェックサム + データタイプ(1byte) + サンプル数(2byte) に加えて、1byte以上のデータ部を含む */
+    if (block_size_field <= (NARU_BLOCK_CHECKSUM_SIZE(checksum_type) + 3)) {
+        return NARU_APIRESULT_INVALID_FORMAT;
+    }
+    /* 同期コードとブロックサイズの分を加えると桁あふれする値 */
+    if (block_size_field > (0xFFFFFFFFUL - 6)) {
+        return NARU_APIRESULT_INVALID_FORMAT;
+    }
+
+    return NARU_APIRESULT_OK;
+}
+
+/* ブロックヘッダからブロックサイズとサンプル数を取得 */
+static NARUApiResult NARUDecoder_GetBlockSizeInformation(
+        const uint8_t *data, uint32_t data_size, NARUBlockChecksumType checksum_type,
+        uint32_t *block_size, uint32_t *num_block_samples)
+{
+    uint16_t buf16;
+    uint32_t buf32, checksum_size;
+    const uint8_t *read_ptr;
+    NARUApiResult ret;
+
+    /* 内部関数なので不正な引数はアサートで落とす */
+    NARU_ASSERT(data != NULL);
+    NARU_ASSERT(block_size != NULL);
+    NARU_ASSERT(num_block_samples != NULL);
+
+    checksum_size = NARU_BLOCK_CHECKSUM_SIZE(checksum_type);
+
+    /* ブロックヘッダ分のデータがない */
+    if (data_size < NARU_BLOCK_HEADER_SIZE_FOR_CHECKSUM(checksum_type)) {
+        return NARU_APIRESULT_INSUFFICIENT_DATA;
+    }
+
+    read_ptr = data;
+
+    /* 同期コード */
+    ByteArray_GetUint16BE(read_ptr, &buf16);
+    if (buf16 != NARU_BLOCK_SYNC_CODE) {
+        return NARU_APIRESULT_INVALID_FORMAT;
+    }
+    /* ブロックサイズ */
+    ByteArray_GetUint32BE(read_ptr, &buf32);
+    if ((ret = NARUDecoder_CheckBlockSizeField(buf32, checksum_type)) != NARU_APIRESULT_OK) {
+        return ret;
+    }
+    if (buf32 > (data_size - 6)) {
+        return NARU_APIRESULT_INSUFFICIENT_DATA;
+    }
+    /* チェックサムとブロックデータタイプは読み飛ばす */
+    read_ptr += checksum_size + 1;
+    /* ブロックチャンネルあたりサンプル数 */
+    ByteArray_GetUint16BE(read_ptr, &buf16);
+
+    /* 同期コードとブロックサイズ自体の領域を加える */
+    (*block_size) = buf32 + 6;
+    (*num_block_samples) = buf16;
+
+    return NARU_APIRESULT_OK;
+}
+
+/* ブロックのチェックサムを検査 */
+static NARUApiResult NARUDecoder_CheckBlockChecksum(
+        const struct NARUDecoder *decoder, const uint8_t *data, uint32_t block_size)
+{
+    uint32_t checksum_size;
+    const struct NARUHeader *header;
+
+    /* 内部関数なので不正な引数はアサートで落とす */
+    NARU_ASSERT(decoder != NULL);
+    NARU_ASSERT(data != NULL);
+
+    header = &(decoder->header);
+    checksum_size = NARU_BLOCK_CHECKSUM_SIZE(header->block_checksum_type);
+    NARU_ASSERT(block_size >= (6 + checksum_size));
+
+    /* 同期コードとブロックサイズの直後にあるチェックサムと、それ以降の計算値を比較 */
+    if (header->block_checksum_type == NARU_BLOCK_CHECKSUM_TYPE_CRC32C) {
+        if (decoder->crc32c(&data[6 + checksum_size], block_size - 6 - checksum_size)
+                != ByteArray_ReadUint32BE(&data[6])) {
+            return NARU_APIRESULT_DETECT_DATA_CORRUPTION;
+        }
+    } else {
+        if (decoder->crc16(&data[6 + checksum_size], block_size - 6 - checksum_size)
+                != ByteArray_ReadUint16BE(&data[6])) {
+            return NARU_APIRESULT_DETECT_DATA_CORRUPTION;
+        }
+    }
+
+    return NARU_APIRESULT_OK;
+}
+
+/* 複数スレッドで全ブロックデコード */
+static NARUApiResult NARUDecoder_DecodeBlocksParallel(
+        struct NARUDecoder *decoder,
+        const uint8_t *data, uint32_t data_size,
+        int32_t **buffer, uint32_t buffer_num_channels, uint32_t buffer_num_samples)
+{
+    NARUApiResult ret;
+    uint32_t progress, read_offset, block_size, num_block_samples, thrd;
+    int32_t num_batch_blocks, i;
+    const struct NARUHeader *header;
+
+    /* 内部関数なので不正な引数はアサートで落とす */
+    NARU_ASSERT(decoder != NULL);
+    NARU_ASSERT(data != NULL);
+    NARU_ASSERT(buffer != NULL);
+
+    header = &(decoder->header);
+
+    progress = 0;
+    read_offset = 0;
+    while ((progress < header->num_samples) && (read_offset < data_size)) {
+        /* ブロックヘッダを辿り、スレッド数分のブロック位置を確定 */
+        num_batch_blocks = 0;
+        while ((num_batch_blocks < decoder->max_num_threads)
+                && (progress < header->num_samples) && (read_offset < data_size)) {
+            struct NARUDecodeWorker *worker = &decoder->worker[num_batch_blocks];
+            if ((ret = NARUDecoder_GetBlockSizeInformation(&data[read_offset], data_size - read_offset,
+                            header->block_checksum_type,
+                            &block_size, &num_block_samples)) != NARU_APIRESULT_OK) {
+                return ret;
+            }
+            if (num_block_samples > (buffer_num_samples - progress)) {
+                return NARU_APIRESULT_INSUFFICIENT_BUFFER;
+            }
+            worker->data = &data[read_offset];
+            worker->data_size = block_size;
+            worker->sample_offset = progress;
+            read_offset += block_size;
+            progress += num_block_samples;
+            num_batch_blocks++;
+        }
+
+        /* 各ワーカーが担当ブロックを出力バッファに直接デコード */
+#if defined(_OPENMP)
+#pragma omp parallel for num_threads(num_batch_blocks) schedule(static, 1)
+#endif
+        for (i = 0; i < num_batch_blocks; i++) {
+            uint32_t ch, decode_size, num_decode_samples;
+            int32_t *buffer_ptr[NARU_MAX_NUM_CHANNELS];
+            struct NARUDecodeWorker *worker = &decoder->worker[i];
+            for (ch = 0; ch < header->num_channels; ch++) {
+                buffer_ptr[ch] = &buffer[ch][worker->sample_offset];
+            }
+            worker->result = NARUDecoder_DecodeBlock(worker->decoder,
+                    worker->data, worker->data_size,
+                    buffer_ptr, buffer_num_channels, buffer_num_samples - worker->sample_offset,
+                    &decode_size, &num_decode_samples);
+        }
+
+        /* ブロック順に結果を確認 */
+        for (thrd = 0; thrd < (uint32_t)num_batch_blocks; thrd++) {
+            if (decoder->worker[thrd].result != NARU_APIRESULT_OK) {
+                return decoder->worker[thrd].result;
+            }
+        }
+    }
+
+    /* 成功終了 */
+    return NARU_APIRESULT_OK;
+}
+
 /* ヘッダを含めて全ブロックデコード */
 NARUApiResult NARUDecoder_DecodeWhole(
         struct NARUDecoder *decoder,
@@ -627,6 +1149,13 @@ NARUApiResult NARUDecoder_DecodeWhole(
         return NARU_APIRESULT_INSUFFICIENT_BUFFER;
     }
 
+    /* 複数スレッドを使えるならばブロック単位で並列にデコード */
+    if (decoder->max_num_threads > 1) {
+        return NARUDecoder_DecodeBlocksParallel(decoder,
+                data + NARU_HEADER_SIZE, data_size - NARU_HEADER_SIZE,
+                buffer, buffer_num_channels, buffer_num_samples);
+    }
+
     progress = 0;
     read_offset = NARU_HEADER_SIZE;
     read_pos = data + NARU_HEADER_SIZE;
@@ -657,3 +1186,687 @@ NARUApiResult NARUDecoder_DecodeWhole(
     /* 成功終了 */
     return NARU_APIRESULT_OK;
 }
+
+/* ヘッダを含むデータからデコードせずに全ブロックの位置を取得 */
+NARUApiResult NARUDecoder_ScanBlocks(
+        struct NARUDecoder *decoder,
+        const uint8_t *data, uint32_t data_size,
+        struct NARUBlockInformation *block_info, uint32_t max_num_blocks, uint32_t *num_blocks)
+{
+    NARUApiResult ret;
+    uint32_t progress, read_offset, block_size, num_block_samples, checksum_size, count, blk;
+    int32_t num_batch_blocks, i;
+    uint8_t block_type;
+    struct NARUHeader tmp_header;
+    const struct NARUHeader *header;
+
+    /* 引数チェック */
+    if ((decoder == NULL) || (data == NULL) || (num_blocks == NULL)) {
+        return NARU_APIRESULT_INVALID_ARGUMENT;
+    }
+
+    (*num_blocks) = 0;
+
+    /* ヘッダデコードとデコーダへのセット */
+    if ((ret = NARUDecoder_DecodeHeader(data, data_size, &tmp_header))
+            != NARU_APIRESULT_OK) {
+        return ret;
+    }
+    if ((ret = NARUDecoder_SetHeader(decoder, &tmp_header))
+            != NARU_APIRESULT_OK) {
+        return ret;
+    }
+    header = &(decoder->header);
+    checksum_size = NARU_BLOCK_CHECKSUM_SIZE(header->block_checksum_type);
+
+    /* ブロックヘッダのみを辿って位置を記録 */
+    count = 0;
+    progress = 0;
+    read_offset = NARU_HEADER_SIZE;
+    while (progress < header->num_samples) {
+        if ((ret = NARUDecoder_GetBlockSizeInformation(&data[read_offset], data_size - read_offset,
+                        header->block_checksum_type, &block_size, &num_block_samples)) != NARU_APIRESULT_OK) {
+            (*num_blocks) = count;
+            return ret;
+        }
+        /* サンプル数が0のブロックや総サンプル数を超えるブロックは不正 */
+        block_type = ByteArray_ReadUint8(&data[read_offset + 6 + checksum_size]);
+        if ((num_block_samples == 0) || (num_block_samples > (header->num_samples - progress))
+                || (block_type >= NARU_BLOCK_DATA_TYPE_SEEKTABLE)) {
+            (*num_blocks) = count;
+            return NARU_APIRESULT_INVALID_FORMAT;
+        }
+        if (block_info != NULL) {
+            if (count >= max_num_blocks) {
+                (*num_blocks) = count;
+                return NARU_APIRESULT_INSUFFICIENT_BUFFER;
+            }
+            block_info[count].byte_offset = read_offset;
+            block_info[count].block_size = block_size;
+            block_info[count].sample_offset = progress;
+            block_info[count].num_samples = num_block_samples;
+            block_info[count].block_type = block_type;
+        }
+        read_offset += block_size;
+        progress += num_block_samples;
+        count++;
+    }
+
+    /* チェックサム検査: スレッド数分のブロック毎に並列に検査し、ブロック順に結果を確認 */
+    if ((block_info != NULL)
+            && NARUDECODER_GET_STATUS_FLAG(decoder, NARUDECODER_STATUS_FLAG_CRC_CHECK)) {
+        for (blk = 0; blk < count; blk += (uint32_t)num_batch_blocks) {
+            num_batch_blocks = (int32_t)NARUUTILITY_MIN(count - blk, decoder->max_num_threads);
+#if defined(_OPENMP)
+#pragma omp parallel for num_threads(num_batch_blocks) schedule(static, 1)
+#endif
+            for (i = 0; i < num_batch_blocks; i++) {
+                const struct NARUBlockInformation *info = &block_info[blk + (uint32_t)i];
+                decoder->worker[i].result
+                    = NARUDecoder_CheckBlockChecksum(decoder, &data[info->byte_offset], info->block_size);
+            }
+            for (i = 0; i < num_batch_blocks; i++) {
+                if (decoder->worker[i].result != NARU_APIRESULT_OK) {
+                    (*num_blocks) = blk + (uint32_t)i;
+                    return decoder->worker[i].result;
+                }
+            }
+        }
+    }
+
+    (*num_blocks) = count;
+
+    /* 成功終了 */
+    return NARU_APIRESULT_OK;
+}
+
+/* データ末尾のシークテーブルを取得 */
+static NARUApiResult NARUDecoder_GetSeekTable(
+        const struct NARUDecoder *decoder, const uint8_t *data, uint32_t data_size,
+        const uint8_t **seek_points, uint32_t *num_seek_points, uint32_t *table_offset)
+{
+    NARUApiResult ret;
+    uint32_t table_size, block_size, num_block_samples, checksum_size, points_offset, num_points;
+    const uint8_t *table;
+    const struct NARUHeader *header;
+
+    /* 内部関数なので不正な引数はアサートで落とす */
+    NARU_ASSERT(decoder != NULL);
+    NARU_ASSERT(data != NULL);
+    NARU_ASSERT(seek_points != NULL);
+    NARU_ASSERT(num_seek_points != NULL);
+    NARU_ASSERT(table_offset != NULL);
+
+    header = &(decoder->header);
+    NARU_ASSERT(header->has_seek_table == 1);
+    checksum_size = NARU_BLOCK_CHECKSUM_SIZE(header->block_checksum_type);
+    points_offset = NARU_BLOCK_HEADER_SIZE_FOR_CHECKSUM(header->block_checksum_type) + 4;
+
+    /* データ末尾の4byteがシークテーブルブロックのサイズ */
+    if (data_size < (NARU_HEADER_SIZE + NARU_SEEKTABLE_BLOCK_SIZE(header->block_checksum_type, 0))) {
+        return NARU_APIRESULT_INSUFFICIENT_DATA;
+    }
+    table_size = ByteArray_ReadUint32BE(&data[data_size - 4]);
+    if ((table_size < NARU_SEEKTABLE_BLOCK_SIZE(header->block_checksum_type, 0))
+            || (table_size > (data_size - NARU_HEADER_SIZE))) {
+        return NARU_APIRESULT_INVALID_FORMAT;
+    }
+    table = &data[data_size - table_size];
+
+    /* ブロックヘッダとシークポイント数の整合を確認 */
+    if ((ret = NARUDecoder_GetBlockSizeInformation(table, table_size,
+                    header->block_checksum_type, &block_size, &num_block_samples)) != NARU_APIRESULT_OK) {
+        return NARU_APIRESULT_INVALID_FORMAT;
+    }
+    num_points = ByteArray_ReadUint32BE(&table[points_offset - 4]);
+    if ((block_size != table_size) || (num_block_samples != 0)
+            || (ByteArray_ReadUint8(&table[6 + checksum_size]) != NARU_BLOCK_DATA_TYPE_SEEKTABLE)
+            || (num_points == 0)
+            || (num_points != ((table_size - NARU_SEEKTABLE_BLOCK_SIZE(header->block_checksum_type, 0)) / NARU_SEEKPOINT_SIZE))
+            || (table_size != NARU_SEEKTABLE_BLOCK_SIZE(header->block_checksum_type, num_points))) {
+        return NARU_APIRESULT_INVALID_FORMAT;
+    }
+
+    /* チェックサム検査 */
+    if (NARUDECODER_GET_STATUS_FLAG(decoder, NARUDECODER_STATUS_FLAG_CRC_CHECK)) {
+        if ((ret = NARUDecoder_CheckBlockChecksum(decoder, table, table_size)) != NARU_APIRESULT_OK) {
+            return ret;
+        }
+    }
+
+    (*seek_points) = &table[points_offset];
+    (*num_seek_points) = num_points;
+    (*table_offset) = data_size - table_size;
+
+    return NARU_APIRESULT_OK;
+}
+
+/* 指定サンプルを含むブロックの位置を取得 */
+NARUApiResult NARUDecoder_FindBlock(
+        struct NARUDecoder *decoder,
+        const uint8_t *data, uint32_t data_size,
+        uint32_t sample_position, struct NARUBlockInformation *block_info)
+{
+    NARUApiResult ret;
+    uint32_t progress, read_offset, end_offset, block_size, num_block_samples, checksum_size;
+    uint8_t block_type;
+    struct NARUHeader tmp_header;
+    const struct NARUHeader *header;
+
+    /* 引数チェック */
+    if ((decoder == NULL) || (data == NULL) || (block_info == NULL)) {
+        return NARU_APIRESULT_INVALID_ARGUMENT;
+    }
+
+    /* ヘッダデコードとデコーダへのセット */
+    if ((ret = NARUDecoder_DecodeHeader(data, data_size, &tmp_header))
+            != NARU_APIRESULT_OK) {
+        return ret;
+    }
+    if ((ret = NARUDecoder_SetHeader(decoder, &tmp_header))
+            != NARU_APIRESULT_OK) {
+        return ret;
+    }
+    header = &(decoder->header);
+    checksum_size = NARU_BLOCK_CHECKSUM_SIZE(header->block_checksum_type);
+
+    /* 範囲外のサンプル */
+    if (sample_position >= header->num_samples) {
+        return NARU_APIRESULT_INVALID_ARGUMENT;
+    }
+
+    /* 探索開始位置: シークテーブルがなければ先頭ブロック */
+    progress = 0;
+    read_offset = NARU_HEADER_SIZE;
+    end_offset = data_size;
+    if (header->has_seek_table == 1) {
+        const uint8_t *points;
+        uint32_t num_points, table_offset, point_progress, point_offset, low, high;
+        /* シークテーブルが壊れている・欠けている場合は使わずに先頭から辿る */
+        if (NARUDecoder_GetSeekTable(decoder, data, data_size,
+                    &points, &num_points, &table_offset) == NARU_APIRESULT_OK) {
+            /* 指定サンプル以前で最も後ろのシークポイントを二分探索 */
+            low = 0;
+            high = num_points;
+            while ((high - low) > 1) {
+                const uint32_t mid = low + (high - low) / 2;
+                if (ByteArray_ReadUint32BE(&points[NARU_SEEKPOINT_SIZE * mid]) <= sample_position) {
+                    low = mid;
+                } else {
+                    high = mid;
+                }
+            }
+            point_progress = ByteArray_ReadUint32BE(&points[NARU_SEEKPOINT_SIZE * low]);
+            point_offset = ByteArray_ReadUint32BE(&points[NARU_SEEKPOINT_SIZE * low + 4]);
+            if ((point_progress <= sample_position)
+                    && (point_offset >= NARU_HEADER_SIZE) && (point_offset < table_offset)) {
+                progress = point_progress;
+                read_offset = point_offset;
+                end_offset = table_offset;
+            }
+        }
+    }
+
+    /* 指定サンプルを含むブロックまでブロックヘッダを辿る
+    * 補足）シークテーブルのシークポイントが間引かれている時のみ複数のブロックを辿る */
+    while (1) {
+        if ((ret = NARUDecoder_GetBlockSizeInformation(&data[read_offset], end_offset - read_offset,
+                        header->block_checksum_type, &block_size, &num_block_samples)) != NARU_APIRESULT_OK) {
+            return ret;
+        }
+        block_type = ByteArray_ReadUint8(&data[read_offset + 6 + checksum_size]);
+        if ((num_block_samples == 0) || (num_block_samples > (header->num_samples - progress))
+                || (block_type >= NARU_BLOCK_DATA_TYPE_SEEKTABLE)) {
+            return NARU_APIRESULT_INVALID_FORMAT;
+        }
+        if (sample_position < (progress + num_block_samples)) {
+            break;
+        }
+        read_offset += block_size;
+        progress += num_block_samples;
+    }
+
+    block_info->byte_offset = read_offset;
+    block_info->block_size = block_size;
+    block_info->sample_offset = progress;
+    block_info->num_samples = num_block_samples;
+    block_info->block_type = block_type;
+
+    return NARU_APIRESULT_OK;
+}
+
+/* 指定サンプルを含むブロックのみをデコードし、指定サンプルからブロック末尾までを出力 */
+NARUApiResult NARUDecoder_DecodeBlockFromSample(
+        struct NARUDecoder *decoder,
+        const uint8_t *data, uint32_t data_size, uint32_t sample_position,
+        int32_t **buffer, uint32_t buffer_num_channels, uint32_t buffer_num_samples,
+        uint32_t *num_decode_samples)
+{
+    NARUApiResult ret;
+    uint32_t ch, num_skip_samples, decode_size, num_block_samples;
+    struct NARUBlockInformation block_info;
+
+    /* 引数チェック */
+    if ((decoder == NULL) || (data == NULL)
+            || (buffer == NULL) || (num_decode_samples == NULL)) {
+        return NARU_APIRESULT_INVALID_ARGUMENT;
+    }
+
+    /* ブロック位置の取得 */
+    if ((ret = NARUDecoder_FindBlock(decoder, data, data_size, sample_position, &block_info)) != NARU_APIRESULT_OK) {
+        return ret;
+    }
+
+    /* ブロック全体をデコード */
+    if ((ret = NARUDecoder_DecodeBlock(decoder,
+                    &data[block_info.byte_offset], block_info.block_size,
+                    buffer, buffer_num_channels, buffer_num_samples,
+                    &decode_size, &num_block_samples)) != NARU_APIRESULT_OK) {
+        return ret;
+    }
+    NARU_ASSERT(num_block_samples == block_info.num_samples);
+
+    /* 指定サンプルより前を捨てる */
+    num_skip_samples = sample_position - block_info.sample_offset;
+    if (num_skip_samples > 0) {
+        for (ch = 0; ch < decoder->header.num_channels; ch++) {
+            memmove(&buffer[ch][0], &buffer[ch][num_skip_samples],
+                    sizeof(int32_t) * (num_block_samples - num_skip_samples));
+        }
+    }
+
+    (*num_decode_samples) = num_block_samples - num_skip_samples;
+
+    return NARU_APIRESULT_OK;
+}
+
+/* ブロックバッファにブロックをデコードし、その一部を出力 */
+static NARUApiResult NARUDecoder_DecodePartOfBlock(
+        struct NARUDecoder *decoder,
+        const uint8_t *data, uint32_t data_size, uint32_t num_skip_samples, uint32_t num_max_output_samples,
+        int32_t **buffer, uint32_t *num_output_samples)
+{
+    NARUApiResult ret;
+    uint32_t ch, decode_size, num_block_samples;
+
+    /* 内部関数なので不正な引数はアサートで落とす */
+    NARU_ASSERT(decoder != NULL);
+    NARU_ASSERT(data != NULL);
+    NARU_ASSERT(buffer != NULL);
+    NARU_ASSERT(num_output_samples != NULL);
+
+    /* ブロックバッファがない（サンプル数0）ならばここで容量不足になる */
+    if ((ret = NARUDecoder_DecodeBlock(decoder, data, data_size,
+                    decoder->block_buffer, decoder->header.num_channels, decoder->max_num_samples_per_block,
+                    &decode_size, &num_block_samples)) != NARU_APIRESULT_OK) {
+        return ret;
+    }
+    NARU_ASSERT(num_skip_samples < num_block_samples);
+
+    /* 必要な部分のみを出力 */
+    (*num_output_samples) = NARUUTILITY_MIN(num_block_samples - num_skip_samples, num_max_output_samples);
+    for (ch = 0; ch < decoder->header.num_channels; ch++) {
+        memcpy(buffer[ch], &decoder->block_buffer[ch][num_skip_samples], sizeof(int32_t) * (*num_output_samples));
+    }
+
+    return NARU_APIRESULT_OK;
+}
+
+/* ヘッダを含むデータから範囲[start_sample, end_sample)のサンプルのみをデコード */
+NARUApiResult NARUDecoder_DecodeRange(
+        struct NARUDecoder *decoder,
+        const uint8_t *data, uint32_t data_size, uint32_t start_sample, uint32_t end_sample,
+        int32_t **buffer, uint32_t buffer_num_channels, uint32_t buffer_num_samples)
+{
+    NARUApiResult ret;
+    uint32_t ch, progress, read_offset, span_offset, span_sample, block_size, num_block_samples, num_output_samples;
+    int32_t *buffer_ptr[NARU_MAX_NUM_CHANNELS];
+    struct NARUBlockInformation block_info;
+    const struct NARUHeader *header;
+
+    /* 引数チェック */
+    if ((decoder == NULL) || (data == NULL) || (buffer == NULL)
+            || (start_sample >= end_sample)) {
+        return NARU_APIRESULT_INVALID_ARGUMENT;
+    }
+
+    /* 先頭サンプルを含むブロック位置の取得（ヘッダもセットされる） */
+    if ((ret = NARUDecoder_FindBlock(decoder, data, data_size, start_sample, &block_info)) != NARU_APIRESULT_OK) {
+        return ret;
+    }
+    header = &(decoder->header);
+
+    /* 範囲外のサンプル */
+    if (end_sample > header->num_samples) {
+        return NARU_APIRESULT_INVALID_ARGUMENT;
+    }
+
+    /* バッファサイズチェック */
+    if ((buffer_num_channels < header->num_channels)
+            || (buffer_num_samples < (end_sample - start_sample))) {
+        return NARU_APIRESULT_INSUFFICIENT_BUFFER;
+    }
+
+    progress = start_sample;
+    read_offset = block_info.byte_offset;
+
+    /* 先頭サンプルがブロック途中にある、または範囲がブロック内で終わるならばブロックバッファを介して切り出す */
+    if ((block_info.sample_offset < start_sample)
+            || ((block_info.sample_offset + block_info.num_samples) > end_sample)) {
+        if ((ret = NARUDecoder_DecodePartOfBlock(decoder,
+                        &data[read_offset], block_info.block_size,
+                        start_sample - block_info.sample_offset, end_sample - start_sample,
+                        buffer, &num_output_samples)) != NARU_APIRESULT_OK) {
+            return ret;
+        }
+        progress += num_output_samples;
+        read_offset += block_info.block_size;
+    }
+
+    /* 範囲に全体が含まれるブロックの区間をブロックヘッダを辿って確定 */
+    span_offset = read_offset;
+    span_sample = progress;
+    while (progress < end_sample) {
+        if ((ret = NARUDecoder_GetBlockSizeInformation(&data[read_offset], data_size - read_offset,
+                        header->block_checksum_type,
+                        &block_size, &num_block_samples)) != NARU_APIRESULT_OK) {
+            return ret;
+        }
+        if (num_block_samples == 0) {
+            return NARU_APIRESULT_INVALID_FORMAT;
+        }
+        if ((progress + num_block_samples) > end_sample) {
+            break;
+        }
+        read_offset += block_size;
+        progress += num_block_samples;
+    }
+
+    /* 区間内のブロックは出力バッファに直接デコード */
+    if (read_offset > span_offset) {
+        for (ch = 0; ch < header->num_channels; ch++) {
+            buffer_ptr[ch] = &buffer[ch][span_sample - start_sample];
+        }
+        if ((ret = NARUDecoder_DecodeBlocksParallel(decoder,
+                        &data[span_offset], read_offset - span_offset,
+                        buffer_ptr, buffer_num_channels, progress - span_sample)) != NARU_APIRESULT_OK) {
+            return ret;
+        }
+    }
+
+    /* 末尾サンプルを含むブロックはブロックバッファを介して切り出す */
+    if (progress < end_sample) {
+        for (ch = 0; ch < header->num_channels; ch++) {
+            buffer_ptr[ch] = &buffer[ch][progress - start_sample];
+        }
+        if ((ret = NARUDecoder_DecodePartOfBlock(decoder,
+                        &data[read_offset], data_size - read_offset, 0, end_sample - progress,
+                        buffer_ptr, &num_output_samples)) != NARU_APIRESULT_OK) {
+            return ret;
+        }
+        progress += num_output_samples;
+    }
+    NARU_ASSERT(progress == end_sample);
+
+    return NARU_APIRESULT_OK;
+}
+
+/* ストリーミングデコードの開始 */
+NARUApiResult NARUDecoder_BeginStreaming(
+        struct NARUDecoder *decoder,
+        uint8_t *data, uint32_t data_size,
+        NARUDecoderWriteCallback callback, void *user_data)
+{
+    /* 引数チェック */
+    if ((decoder == NULL) || (data == NULL) || (callback == NULL)) {
+        return NARU_APIRESULT_INVALID_ARGUMENT;
+    }
+
+    /* ヘッダも溜められない */
+    if (data_size < NARU_HEADER_SIZE) {
+        return NARU_APIRESULT_INSUFFICIENT_BUFFER;
+    }
+
+    decoder->stream_data = data;
+    decoder->stream_data_size = data_size;
+    decoder->stream_num_buffered_bytes = 0;
+    decoder->stream_num_decoded_samples = 0;
+    decoder->stream_callback = callback;
+    decoder->stream_user_data = user_data;
+    NARUDECODER_CLEAR_STATUS_FLAG(decoder,
+            NARUDECODER_STATUS_FLAG_STREAM_HEADER | NARUDECODER_STATUS_FLAG_STREAM_END);
+    NARUDECODER_SET_STATUS_FLAG(decoder, NARUDECODER_STATUS_FLAG_STREAMING);
+
+    return NARU_APIRESULT_OK;
+}
+
+/* ストリーミングデコードで次に処理するヘッダ・ブロックのサイズを取得
+* 補足）ブロックヘッダが揃っておらずサイズが未確定の時は、ブロックヘッダのサイズを設定してNARU_APIRESULT_INSUFFICIENT_DATAを返す */
+static NARUApiResult NARUDecoder_GetStreamUnitSize(
+        const struct NARUDecoder *decoder, const uint8_t *data, uint32_t data_size, uint32_t *unit_size)
+{
+    uint32_t block_size, checksum_size;
+    NARUApiResult ret;
+
+    /* 内部関数なので不正な引数はアサートで落とす */
+    NARU_ASSERT(decoder != NULL);
+    NARU_ASSERT(data != NULL);
+    NARU_ASSERT(unit_size != NULL);
+
+    /* 先頭はヘッダ */
+    if (!NARUDECODER_GET_STATUS_FLAG(decoder, NARUDECODER_STATUS_FLAG_STREAM_HEADER)) {
+        (*unit_size) = NARU_HEADER_SIZE;
+        return NARU_APIRESULT_OK;
+    }
+
+    /* ブロックヘッダが揃うまではサイズ不明 */
+    checksum_size = NARU_BLOCK_CHECKSUM_SIZE(decoder->header.block_checksum_type);
+    if (data_size < NARU_BLOCK_HEADER_SIZE_FOR_CHECKSUM(decoder->header.block_checksum_type)) {
+        (*unit_size) = NARU_BLOCK_HEADER_SIZE_FOR_CHECKSUM(decoder->header.block_checksum_type);
+        return NARU_APIRESULT_INSUFFICIENT_DATA;
+    }
+    if (ByteArray_ReadUint16BE(&data[0]) != NARU_BLOCK_SYNC_CODE) {
+        return NARU_APIRESULT_INVALID_FORMAT;
+    }
+    block_size = ByteArray_ReadUint32BE(&data[2]);
+    if ((ret = NARUDecoder_CheckBlockSizeField(block_size, decoder->header.block_checksum_type)) != NARU_APIRESULT_OK) {
+        return ret;
+    }
+    /* シークテーブルは読み捨てるので、ブロックヘッダのみを処理する */
+    if (ByteArray_ReadUint8(&data[6 + checksum_size]) == NARU_BLOCK_DATA_TYPE_SEEKTABLE) {
+        (*unit_size) = NARU_BLOCK_HEADER_SIZE_FOR_CHECKSUM(decoder->header.block_checksum_type);
+        return NARU_APIRESULT_OK;
+    }
+    /* 分割されて届いた時に溜められないブロックは、分割の仕方に依らず受け付けない */
+    if (block_size > (decoder->stream_data_size - 6)) {
+        return NARU_APIRESULT_INSUFFICIENT_BUFFER;
+    }
+
+    (*unit_size) = block_size + 6;
+    return NARU_APIRESULT_OK;
+}
+
+/* ストリーミングデコードで揃ったヘッダ・ブロックを処理 */
+static NARUApiResult NARUDecoder_ProcessStreamUnit(
+        struct NARUDecoder *decoder, const uint8_t *data, uint32_t data_size)
+{
+    NARUApiResult ret;
+    uint32_t decode_size, num_block_samples;
+    const struct NARUHeader *header;
+
+    /* 内部関数なので不正な引数はアサートで落とす */
+    NARU_ASSERT(decoder != NULL);
+    NARU_ASSERT(data != NULL);
+
+    /* ヘッダデコードとデコーダへのセット */
+    if (!NARUDECODER_GET_STATUS_FLAG(decoder, NARUDECODER_STATUS_FLAG_STREAM_HEADER)) {
+        struct NARUHeader tmp_header;
+        if ((ret = NARUDecoder_DecodeHeader(data, data_size, &tmp_header)) != NARU_APIRESULT_OK) {
+            return ret;
+        }
+        if ((ret = NARUDecoder_SetHeader(decoder, &tmp_header)) != NARU_APIRESULT_OK) {
+            return ret;
+        }
+        /* ブロックバッファに1ブロックが収まらない */
+        if (decoder->max_num_samples_per_block < tmp_header.max_num_samples_per_block) {
+            return NARU_APIRESULT_INSUFFICIENT_BUFFER;
+        }
+        NARUDECODER_SET_STATUS_FLAG(decoder, NARUDECODER_STATUS_FLAG_STREAM_HEADER);
+        return NARU_APIRESULT_OK;
+    }
+    header = &(decoder->header);
+
+    /* 総サンプル数が未確定のストリームはシークテーブルで終わる */
+    if (ByteArray_ReadUint8(&data[6 + NARU_BLOCK_CHECKSUM_SIZE(header->block_checksum_type)])
+            == NARU_BLOCK_DATA_TYPE_SEEKTABLE) {
+        NARUDECODER_SET_STATUS_FLAG(decoder, NARUDECODER_STATUS_FLAG_STREAM_END);
+        return NARU_APIRESULT_OK;
+    }
+
+    /* ブロックバッファにデコードして出力 */
+    if ((ret = NARUDecoder_DecodeBlock(decoder, data, data_size,
+                    decoder->block_buffer, header->num_channels, decoder->max_num_samples_per_block,
+                    &decode_size, &num_block_samples)) != NARU_APIRESULT_OK) {
+        return ret;
+    }
+    if (num_block_samples > (header->num_samples - decoder->stream_num_decoded_samples)) {
+        return NARU_APIRESULT_INVALID_FORMAT;
+    }
+    if ((ret = decoder->stream_callback(header, (const int32_t *const *)decoder->block_buffer,
+                    num_block_samples, decoder->stream_user_data)) != NARU_APIRESULT_OK) {
+        return ret;
+    }
+    decoder->stream_num_decoded_samples += num_block_samples;
+
+    if (decoder->stream_num_decoded_samples == header->num_samples) {
+        NARUDECODER_SET_STATUS_FLAG(decoder, NARUDECODER_STATUS_FLAG_STREAM_END);
+    }
+
+    return NARU_APIRESULT_OK;
+}
+
+/* ストリーミングデコードにデータを供給 */
+NARUApiResult NARUDecoder_PushData(
+        struct NARUDecoder *decoder, const uint8_t *data, uint32_t data_size)
+{
+    NARUApiResult ret;
+    uint32_t unit_size, copy_size;
+
+    /* 引数チェック */
+    if ((decoder == NULL) || ((data == NULL) && (data_size > 0))) {
+        return NARU_APIRESULT_INVALID_ARGUMENT;
+    }
+
+    /* ストリーミングデコード中でない */
+    if (!NARUDECODER_GET_STATUS_FLAG(decoder, NARUDECODER_STATUS_FLAG_STREAMING)) {
+        return NARU_APIRESULT_PARAMETER_NOT_SET;
+    }
+
+    while ((data_size > 0)
+            && !NARUDECODER_GET_STATUS_FLAG(decoder, NARUDECODER_STATUS_FLAG_STREAM_END)) {
+        /* 何も溜めておらず、供給データにヘッダ・ブロックがまるごと含まれていればコピーせずに処理 */
+        if (decoder->stream_num_buffered_bytes == 0) {
+            ret = NARUDecoder_GetStreamUnitSize(decoder, data, data_size, &unit_size);
+            if ((ret == NARU_APIRESULT_OK) && (unit_size <= data_size)) {
+                if ((ret = NARUDecoder_ProcessStreamUnit(decoder, data, unit_size)) != NARU_APIRESULT_OK) {
+                    return ret;
+                }
+                data += unit_size;
+                data_size -= unit_size;
+                continue;
+            }
+            if ((ret != NARU_APIRESULT_OK) && (ret != NARU_APIRESULT_INSUFFICIENT_DATA)) {
+                return ret;
+            }
+        }
+
+        /* 溜めているデータからサイズを確定させる
+        * 補足）サイズが未確定ならば、ブロックヘッダまでを溜める */
+        ret = NARUDecoder_GetStreamUnitSize(decoder,
+                decoder->stream_data, decoder->stream_num_buffered_bytes, &unit_size);
+        if ((ret != NARU_APIRESULT_OK) && (ret != NARU_APIRESULT_INSUFFICIENT_DATA)) {
+            return ret;
+        }
+        NARU_ASSERT(unit_size <= decoder->stream_data_size);
+        NARU_ASSERT(decoder->stream_num_buffered_bytes < unit_size);
+
+        copy_size = NARUUTILITY_MIN(unit_size - decoder->stream_num_buffered_bytes, data_size);
+        memcpy(&decoder->stream_data[decoder->stream_num_buffered_bytes], data, copy_size);
+        decoder->stream_num_buffered_bytes += copy_size;
+        data += copy_size;
+        data_size -= copy_size;
+
+        /* ヘッダ・ブロックが揃った */
+        if ((ret == NARU_APIRESULT_OK) && (decoder->stream_num_buffered_bytes == unit_size)) {
+            decoder->stream_num_buffered_bytes = 0;
+            if ((ret = NARUDecoder_ProcessStreamUnit(decoder, decoder->stream_data, unit_size)) != NARU_APIRESULT_OK) {
+                return ret;
+            }
+        }
+    }
+
+    return NARU_APIRESULT_OK;
+}
+
+/* ストリーミングデコードで次の出力までに必要なデータサイズを取得 */
+NARUApiResult NARUDecoder_GetStreamRequiredSize(
+        struct NARUDecoder *decoder, uint32_t *required_size)
+{
+    NARUApiResult ret;
+    uint32_t unit_size;
+
+    /* 引数チェック */
+    if ((decoder == NULL) || (required_size == NULL)) {
+        return NARU_APIRESULT_INVALID_ARGUMENT;
+    }
+
+    /* ストリーミングデコード中でない */
+    if (!NARUDECODER_GET_STATUS_FLAG(decoder, NARUDECODER_STATUS_FLAG_STREAMING)) {
+        return NARU_APIRESULT_PARAMETER_NOT_SET;
+    }
+
+    /* 全ブロックを出力済み */
+    if (NARUDECODER_GET_STATUS_FLAG(decoder, NARUDECODER_STATUS_FLAG_STREAM_END)) {
+        (*required_size) = 0;
+        return NARU_APIRESULT_OK;
+    }
+
+    ret = NARUDecoder_GetStreamUnitSize(decoder,
+            decoder->stream_data, decoder->stream_num_buffered_bytes, &unit_size);
+    if ((ret != NARU_APIRESULT_OK) && (ret != NARU_APIRESULT_INSUFFICIENT_DATA)) {
+        return ret;
+    }
+    NARU_ASSERT(decoder->stream_num_buffered_bytes < unit_size);
+
+    (*required_size) = unit_size - decoder->stream_num_buffered_bytes;
+    return NARU_APIRESULT_OK;
+}
+
+/* ストリーミングデコードの終了 */
+NARUApiResult NARUDecoder_FinishStreaming(struct NARUDecoder *decoder)
+{
+    /* 引数チェック */
+    if (decoder == NULL) {
+        return NARU_APIRESULT_INVALID_ARGUMENT;
+    }
+
+    /* ストリーミングデコード中でない */
+    if (!NARUDECODER_GET_STATUS_FLAG(decoder, NARUDECODER_STATUS_FLAG_STREAMING)) {
+        return NARU_APIRESULT_PARAMETER_NOT_SET;
+    }
+    NARUDECODER_CLEAR_STATUS_FLAG(decoder, NARUDECODER_STATUS_FLAG_STREAMING);
+
+    /* ヘッダやブロックの途中で途切れている */
+    if (!NARUDECODER_GET_STATUS_FLAG(decoder, NARUDECODER_STATUS_FLAG_STREAM_HEADER)
+            || (decoder->stream_num_buffered_bytes > 0)) {
+        return NARU_APIRESULT_INSUFFICIENT_DATA;
+    }
+
+    /* ヘッダの総サンプル数に満たない */
+    if (!NARUDECODER_GET_STATUS_FLAG(decoder, NARUDECODER_STATUS_FLAG_STREAM_END)
+            && (decoder->header.num_samples != NARU_UNDETERMINED_NUM_SAMPLES)) {
+        return NARU_APIRESULT_INSUFFICIENT_DATA;
+    }
+
+    return NARU_APIRESULT_OK;
+}
@@ -6,7 +6,6 @@
 #include "naru_stdint.h"
 #include "naru_filter.h"
 #include "naru_bit_stream.h"
-#include "lpc_calculator.h"
 
 /* 1chあたりの信号処理を担うプロセッサハンドル */
 struct NARUEncodeProcessor;
@@ -32,19 +31,26 @@ void NARUEncodeProcessor_SetFilterOrder(
         struct NARUEncodeProcessor *processor, int32_t filter_order,
         int32_t ar_order, int32_t second_filter_order);
 
-/* AR係数の計算とプロセッサへの設定 */
-void NARUEncodeProcessor_CalculateARCoef(
-        struct NARUEncodeProcessor *processor, struct LPCCalculator *lpcc,
-        const double *input, uint32_t num_samples);
+/* AR係数の量子化とプロセッサへの設定（係数coefはAR次数+1個の配列で、先頭の1.0は読まない） */
+void NARUEncodeProcessor_SetARCoef(
+        struct NARUEncodeProcessor *processor, const double *coef);
 
 /* 現在のプロセッサの状態を出力（注意: 係数は丸め等の副作用を受ける） */
 void NARUEncodeProcessor_PutFilterState(
         struct NARUEncodeProcessor *processor, struct NARUBitStream *stream);
 
+/* 状態出力時と同じ丸めのみを適用（出力を捨てるエンコードで使用） */
+void NARUEncodeProcessor_QuantizeFilterState(struct NARUEncodeProcessor *processor);
+
 /* 予測 */
 void NARUEncodeProcessor_Predict(
         struct NARUEncodeProcessor *processor, int32_t *buffer, uint32_t num_samples);
 
+/* 複数チャンネルの予測（可能ならばチャンネルをSIMDレーンに並べて一括処理） */
+void NARUEncodeProcessor_PredictMultiChannel(
+        struct NARUEncodeProcessor *const *processors, struct NARUFilterLanes *lanes,
+        int32_t *const *buffer, uint32_t num_channels, uint32_t num_samples);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
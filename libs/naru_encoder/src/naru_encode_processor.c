@@ -20,13 +20,9 @@ struct NARUEncodeProcessor {
     struct NARUSAFilter *sa;
 };
 
-/* NGSAフィルタの1サンプル予測処理 */
-static int32_t NARUNGSAFilter_Predict(struct NARUNGSAFilter *filter, int32_t input);
-/* NGSAフィルタの状態出力 */
+/* NGSAフィルタの状態出力（streamがNULLの場合は丸めのみ行う） */
 static void NARUNGSAFilter_PutFilterState(struct NARUNGSAFilter *filter, struct NARUBitStream *stream);
-/* SAフィルタの1サンプル予測処理 */
-static int32_t NARUSAFilter_Predict(struct NARUSAFilter *filter, int32_t input);
-/* SAフィルタの状態出力 */
+/* SAフィルタの状態出力（streamがNULLの場合は丸めのみ行う） */
 static void NARUSAFilter_PutFilterState(struct NARUSAFilter *filter, struct NARUBitStream *stream);
 /* dataをmaxbit内に収めるために必要な右シフト数計算 */
 static uint32_t NARUEncodeProcessor_CalculateBitShift(const int32_t *data, int32_t num_data, int32_t maxbit);
@@ -34,6 +30,8 @@ static uint32_t NARUEncodeProcessor_CalculateBitShift(const int32_t *data, int32
 static void NARUEncodeProcessor_ClippingFilterWeight(int32_t *weight, int32_t filter_order, int32_t bitwidth);
 /* 符号付き整数pvalをrshiftした値を出力 その後シフトしたビット数だけpvalの下位bitをクリア */
 static void NARUEncodeProcessor_RoundAndPutSint(struct NARUBitStream *stream, uint32_t bitwidth, int32_t *pval, uint32_t rshift);
+/* プリエンファシス・NGSA・SAを1サンプル毎に連結して予測 */
+static void NARUEncodeProcessor_PredictCascade(struct NARUEncodeProcessor *processor, int32_t *buffer, uint32_t num_samples);
 
 /* dataをmaxbit内に収めるために必要な右シフト数計算 */
 static uint32_t NARUEncodeProcessor_CalculateBitShift(const int32_t *data, int32_t num_data, int32_t maxbit)
@@ -87,14 +85,14 @@ static void NARUEncodeProcessor_ClippingFilterWeight(
     }
 }
 
-/* 符号付き整数pvalをrshiftした値を出力 その後シフトしたビット数だけpvalの下位bitをクリア */
+/* 符号付き整数pvalをrshiftした値を出力 その後シフトしたビット数だけpvalの下位bitをクリア
+* 補足）streamがNULLの場合は出力せず丸めのみ行う */
 static void NARUEncodeProcessor_RoundAndPutSint(
         struct NARUBitStream *stream, uint32_t bitwidth, int32_t *pval, uint32_t rshift)
 {
     uint32_t putval;
     int32_t roundval;
 
-    NARU_ASSERT(stream != NULL);
     NARU_ASSERT(pval != NULL);
 
     /* 右シフト値を取得 */
@@ -105,7 +103,9 @@ static void NARUEncodeProcessor_RoundAndPutSint(
 
     /* 出力 */
     NARU_ASSERT(putval < (1U << bitwidth));
-    NARUBitWriter_PutBits(stream, putval, bitwidth);
+    if (stream != NULL) {
+        NARUBitWriter_PutBits(stream, putval, bitwidth);
+    }
 
     /* 左シフトして戻す（シフトしたビットをクリア） */
     (*pval) = roundval << rshift;
@@ -211,48 +211,42 @@ void NARUEncodeProcessor_SetFilterOrder(
     NARUSAFilter_SetFilterOrder(processor->sa, second_filter_order);
 }
 
-/* AR係数の計算 */
-void NARUEncodeProcessor_CalculateARCoef(
-        struct NARUEncodeProcessor *processor, struct LPCCalculator *lpcc,
-        const double *input, uint32_t num_samples)
+/* AR係数の量子化とプロセッサへの設定 */
+void NARUEncodeProcessor_SetARCoef(
+        struct NARUEncodeProcessor *processor, const double *coef)
 {
     int32_t ord;
-    double coef_double[NARU_MAX_FILTER_ORDER + 1];
-    LPCCalculatorApiResult ret;
     int32_t ar_order;
 
     NARU_ASSERT(processor != NULL);
-    NARU_ASSERT(lpcc != NULL);
-    NARU_ASSERT(input != NULL);
-    NARU_ASSERT(num_samples > 0);
+    NARU_ASSERT(coef != NULL);
 
     ar_order = processor->ngsa->ar_order;
     NARU_ASSERT(ar_order <= NARU_MAX_AR_ORDER);
 
-    /* AR係数の計算 */
-    ret = LPCCalculator_CalculateLPCCoef(lpcc, input, num_samples, coef_double, (uint32_t)ar_order);
-    NARU_ASSERT(ret == LPCCALCULATOR_APIRESULT_OK);
-    /* 整数量子化: ar_coef_doubleのインデックスは1.0確定なのでスルー */
+    /* 整数量子化: coefのインデックス0は1.0確定なのでスルー */
     for (ord = 0; ord < ar_order; ord++) {
-        double tmp_coef = NARUUtility_Round(coef_double[ord + 1] * pow(2.0f, NARU_FIXEDPOINT_DIGITS));
+        double tmp_coef = NARUUtility_Round(coef[ord + 1] * pow(2.0f, NARU_FIXEDPOINT_DIGITS));
         processor->ngsa->ar_coef[ord] = (int32_t)tmp_coef;
     }
 }
 
-/* NGSAフィルタの状態出力 */
+/* NGSAフィルタの状態出力（streamがNULLの場合は丸めのみ行う） */
 static void NARUNGSAFilter_PutFilterState(
         struct NARUNGSAFilter *filter, struct NARUBitStream *stream)
 {
     int32_t ord;
     uint32_t shift;
+    int32_t history[NARU_MAX_FILTER_ORDER];
 
     NARU_ASSERT(filter != NULL);
-    NARU_ASSERT(stream != NULL);
 
     /* AR係数 */
     shift = NARUEncodeProcessor_CalculateBitShift(filter->ar_coef, filter->ar_order, NARU_BLOCKHEADER_ARCOEF_BITWIDTH);
     NARU_ASSERT(shift < (1 << NARU_BLOCKHEADER_ARCOEFSHIFT_BITWIDTH));
-    NARUBitWriter_PutBits(stream, shift, NARU_BLOCKHEADER_ARCOEFSHIFT_BITWIDTH);
+    if (stream != NULL) {
+        NARUBitWriter_PutBits(stream, shift, NARU_BLOCKHEADER_ARCOEFSHIFT_BITWIDTH);
+    }
     for (ord = 0; ord < filter->ar_order; ord++) {
         NARUEncodeProcessor_RoundAndPutSint(stream, NARU_BLOCKHEADER_ARCOEF_BITWIDTH, &filter->ar_coef[ord], shift);
     }
@@ -263,7 +257,9 @@ static void NARUNGSAFilter_PutFilterState(
     /* フィルタ係数シフト量 */
     shift = NARUEncodeProcessor_CalculateBitShift(filter->weight, filter->filter_order, NARU_BLOCKHEADER_DATA_BITWIDTH);
     NARU_ASSERT(shift < (1 << NARU_BLOCKHEADER_SHIFT_BITWIDTH));
-    NARUBitWriter_PutBits(stream, shift, NARU_BLOCKHEADER_SHIFT_BITWIDTH);
+    if (stream != NULL) {
+        NARUBitWriter_PutBits(stream, shift, NARU_BLOCKHEADER_SHIFT_BITWIDTH);
+    }
 
     /* フィルタ係数 */
     for (ord = 0; ord < filter->filter_order; ord++) {
@@ -273,27 +269,36 @@ static void NARUNGSAFilter_PutFilterState(
     /* フィルタ履歴シフト量 */
     shift = NARUEncodeProcessor_CalculateBitShift(filter->history, filter->filter_order, NARU_BLOCKHEADER_DATA_BITWIDTH);
     NARU_ASSERT(shift < (1 << NARU_BLOCKHEADER_SHIFT_BITWIDTH));
-    NARUBitWriter_PutBits(stream, shift, NARU_BLOCKHEADER_SHIFT_BITWIDTH);
+    if (stream != NULL) {
+        NARUBitWriter_PutBits(stream, shift, NARU_BLOCKHEADER_SHIFT_BITWIDTH);
+    }
 
     /* フィルタ履歴 */
     for (ord = 0; ord < filter->filter_order; ord++) {
         /* デコード時にbuffer_pos == 0で処理できるように、ずらして記録 */
         int32_t pos = (filter->buffer_pos + ord) & filter->buffer_pos_mask;
         NARUEncodeProcessor_RoundAndPutSint(stream, NARU_BLOCKHEADER_DATA_BITWIDTH, &filter->history[pos], shift);
+        history[ord] = filter->history[pos];
+    }
+
+    /* デコーダと状態を揃えるため、buffer_pos == 0となるように履歴を並べ直す */
+    for (ord = 0; ord < filter->filter_order; ord++) {
+        filter->history[ord] = history[ord];
         /* 履歴アクセス高速化のために、次数だけ離れた位置にも記録 */
-        filter->history[pos + filter->filter_order] = filter->history[pos];
+        filter->history[ord + filter->filter_order] = history[ord];
     }
+    filter->buffer_pos = 0;
 }
 
-/* SAフィルタの状態出力 */
+/* SAフィルタの状態出力（streamがNULLの場合は丸めのみ行う） */
 static void NARUSAFilter_PutFilterState(
         struct NARUSAFilter *filter, struct NARUBitStream *stream)
 {
     int32_t ord;
     uint32_t shift;
+    int32_t history[NARU_MAX_FILTER_ORDER];
 
     NARU_ASSERT(filter != NULL);
-    NARU_ASSERT(stream != NULL);
 
     /* フィルタ係数値を固定bit幅に制限 */
     NARUEncodeProcessor_ClippingFilterWeight(filter->weight, filter->filter_order, NARU_FILTER_WEIGHT_RANGE_BITWIDTH);
@@ -301,7 +306,9 @@ static void NARUSAFilter_PutFilterState(
     /* フィルタ係数シフト量 */
     shift = NARUEncodeProcessor_CalculateBitShift(filter->weight, filter->filter_order, NARU_BLOCKHEADER_DATA_BITWIDTH);
     NARU_ASSERT(shift < (1 << NARU_BLOCKHEADER_SHIFT_BITWIDTH));
-    NARUBitWriter_PutBits(stream, shift, NARU_BLOCKHEADER_SHIFT_BITWIDTH);
+    if (stream != NULL) {
+        NARUBitWriter_PutBits(stream, shift, NARU_BLOCKHEADER_SHIFT_BITWIDTH);
+    }
 
     /* フィルタ係数 */
     for (ord = 0; ord < filter->filter_order; ord++) {
@@ -311,16 +318,25 @@ static void NARUSAFilter_PutFilterState(
     /* フィルタ履歴シフト量 */
     shift = NARUEncodeProcessor_CalculateBitShift(filter->history, filter->filter_order, NARU_BLOCKHEADER_DATA_BITWIDTH);
     NARU_ASSERT(shift < (1 << NARU_BLOCKHEADER_SHIFT_BITWIDTH));
-    NARUBitWriter_PutBits(stream, shift, NARU_BLOCKHEADER_SHIFT_BITWIDTH);
+    if (stream != NULL) {
+        NARUBitWriter_PutBits(stream, shift, NARU_BLOCKHEADER_SHIFT_BITWIDTH);
+    }
 
     /* フィルタ履歴 */
     for (ord = 0; ord < filter->filter_order; ord++) {
         /* デコード時にbuffer_pos == 0で処理できるように、ずらして記録 */
         int32_t pos = (filter->buffer_pos + ord) & filter->buffer_pos_mask;
         NARUEncodeProcessor_RoundAndPutSint(stream, NARU_BLOCKHEADER_DATA_BITWIDTH, &filter->history[pos], shift);
+        history[ord] = filter->history[pos];
+    }
+
+    /* デコーダと状態を揃えるため、buffer_pos == 0となるように履歴を並べ直す */
+    for (ord = 0; ord < filter->filter_order; ord++) {
+        filter->history[ord] = history[ord];
         /* 履歴アクセス高速化のために、次数だけ離れた位置にも記録 */
-        filter->history[pos + filter->filter_order] = filter->history[pos];
+        filter->history[ord + filter->filter_order] = history[ord];
     }
+    filter->buffer_pos = 0;
 }
 
 /* プロセッサの状態出力 */
@@ -344,133 +360,270 @@ void NARUEncodeProcessor_PutFilterState(
     NARUSAFilter_PutFilterState(processor->sa, stream);
 }
 
-/* プリエンファシス */
-static int32_t NARUEncodeProcessor_PreEmphasis(struct NARUEncodeProcessor *processor, int32_t input)
+/* 状態出力時と同じ丸めのみを適用 */
+void NARUEncodeProcessor_QuantizeFilterState(struct NARUEncodeProcessor *processor)
 {
-    int32_t tmp;
-    const int32_t coef_numer = ((1 << NARU_EMPHASIS_FILTER_SHIFT) - 1);
-
-    NARU_STATIC_ASSERT(NARU_FIXEDPOINT_DIGITS >= NARU_EMPHASIS_FILTER_SHIFT);
-
     NARU_ASSERT(processor != NULL);
 
-    /* フィルタ適用 */
-    tmp = input;
-    input -= (int32_t)NARUUTILITY_SHIFT_RIGHT_ARITHMETIC(processor->preemphasis_prev * coef_numer, NARU_EMPHASIS_FILTER_SHIFT);
-    processor->preemphasis_prev = tmp;
-
-    return input;
+    NARUNGSAFilter_PutFilterState(processor->ngsa, NULL);
+    NARUSAFilter_PutFilterState(processor->sa, NULL);
 }
 
-/* NGSAフィルタの1サンプル予測処理 */
-static int32_t NARUNGSAFilter_Predict(struct NARUNGSAFilter *filter, int32_t input)
+/* プリエンファシス・NGSA・SAを1サンプル毎に連結して予測
+* 補足）フィルタの状態はブロック先頭でローカル変数に受け、末尾で書き戻す */
+static void NARUEncodeProcessor_PredictCascade(
+        struct NARUEncodeProcessor *processor, int32_t *buffer, uint32_t num_samples)
 {
-    int32_t ord, residual, predict;
-    int32_t *ngrad, *history, *ar_coef, *weight;
-    const int32_t filter_order = filter->filter_order;
-    const int32_t ar_order = filter->ar_order;
-
-    NARU_ASSERT(filter != NULL);
-
-    /* ローカル変数に受けとく */
-    history = &filter->history[filter->buffer_pos];
-    ar_coef = &filter->ar_coef[0];
-    weight = &filter->weight[0];
+    uint32_t smpl;
+    int32_t ord, preemphasis_prev;
+    int32_t *ngsa_history, *ngsa_ngrad, *ngsa_weight, *sa_history, *sa_weight;
+    int32_t ngsa_pos, sa_pos;
+    const int32_t coef_numer = ((1 << NARU_EMPHASIS_FILTER_SHIFT) - 1);
+    struct NARUNGSAFilter *ngsa = processor->ngsa;
+    struct NARUSAFilter *sa = processor->sa;
+    const int32_t ngsa_order = ngsa->filter_order;
+    const int32_t ngsa_mask = ngsa->buffer_pos_mask;
+    const int32_t ar_order = ngsa->ar_order;
+    const int32_t *ar_coef = ngsa->ar_coef;
+    const int32_t *pdelta_table = ngsa->pdelta_table;
+    const int32_t delta_rshift = ngsa->delta_rshift;
+    const struct NARUFilterFunctions *ngsa_functions = ngsa->functions;
+    const int32_t sa_order = sa->filter_order;
+    const int32_t sa_mask = sa->buffer_pos_mask;
+    const struct NARUFilterFunctions *sa_functions = sa->functions;
 
-    /* フィルタ予測 */
-    predict = NARU_FIXEDPOINT_0_5;
-    for (ord = 0; ord < filter_order; ord++) {
-        predict += weight[ord] * history[ord];
-    }
-    predict = NARUUTILITY_SHIFT_RIGHT_ARITHMETIC(predict, NARU_FIXEDPOINT_DIGITS);
+    NARU_STATIC_ASSERT(NARU_FIXEDPOINT_DIGITS >= NARU_EMPHASIS_FILTER_SHIFT);
 
-    /* 差分 */
-    residual = input - predict;
+    NARU_ASSERT(processor != NULL);
+    NARU_ASSERT(buffer != NULL);
+    NARU_ASSERT(pdelta_table == &ngsa->delta_table[1]);
 
-    /* バッファ参照位置更新 */
-    filter->buffer_pos = (filter->buffer_pos - 1) & filter->buffer_pos_mask;
+    /* ローカル変数に受けとく */
+    preemphasis_prev = processor->preemphasis_prev;
+    ngsa_history = ngsa->history;
+    ngsa_ngrad = ngsa->ngrad;
+    ngsa_weight = ngsa->weight;
+    ngsa_pos = ngsa->buffer_pos;
+    sa_history = sa->history;
+    sa_weight = sa->weight;
+    sa_pos = sa->buffer_pos;
 
-    /* 自然勾配更新 */
-    ngrad = &filter->ngrad[filter->buffer_pos];
-    for (ord = 0; ord < ar_order; ord++) {
-        const int32_t pos = (filter->buffer_pos + filter_order - 1 - ord) & filter->buffer_pos_mask;
-        filter->ngrad[pos] += NARUUTILITY_SHIFT_RIGHT_ARITHMETIC(ar_coef[ord] * ngrad[filter_order], NARU_FIXEDPOINT_DIGITS);
-        filter->ngrad[pos + filter_order] = filter->ngrad[pos];
-    }
-    ngrad[0] = 0;
-    for (ord = 0; ord < ar_order; ord++) {
-        ngrad[0] -= ar_coef[ord] * history[ord + 1];
-    }
-    ngrad[0] = NARUUTILITY_SHIFT_RIGHT_ARITHMETIC(ngrad[0], NARU_FIXEDPOINT_DIGITS);
-    ngrad[0] += history[0];
-    for (ord = 0; ord < ar_order; ord++) {
-        const int32_t pos = (filter->buffer_pos + ord + 1) & filter->buffer_pos_mask;
-        filter->ngrad[pos] -= NARUUTILITY_SHIFT_RIGHT_ARITHMETIC(ar_coef[ord] * ngrad[0], NARU_FIXEDPOINT_DIGITS);
-        filter->ngrad[pos + filter_order] = filter->ngrad[pos];
-    }
+    for (smpl = 0; smpl < num_samples; smpl++) {
+        int32_t input, residual, predict, ngrad0;
+        const int32_t *phistory;
+        int32_t *pngrad;
 
-    /* フィルタ係数更新 */
-    NARU_ASSERT(filter->pdelta_table == &filter->delta_table[1]);
-    {
-        const int32_t half = (1 << (filter->delta_rshift - 1));
-        const int32_t delta = filter->pdelta_table[NARUUTILITY_SIGN(residual)];
-        for (ord = 0; ord < filter_order; ord++) {
-            int32_t mul = delta * ngrad[ord];
-            mul += half;
-            mul = NARUUTILITY_SHIFT_RIGHT_ARITHMETIC(mul, filter->delta_rshift);
-            weight[ord] += mul;
+        /* プリエンファシス */
+        input = buffer[smpl];
+        residual = input - (int32_t)NARUUTILITY_SHIFT_RIGHT_ARITHMETIC(preemphasis_prev * coef_numer, NARU_EMPHASIS_FILTER_SHIFT);
+        preemphasis_prev = input;
+        input = residual;
+
+        /* NGSA: フィルタ予測 */
+        phistory = &ngsa_history[ngsa_pos];
+        predict = NARU_FIXEDPOINT_0_5 + ngsa_functions->dot_product(ngsa_weight, phistory, ngsa_order);
+        predict = NARUUTILITY_SHIFT_RIGHT_ARITHMETIC(predict, NARU_FIXEDPOINT_DIGITS);
+        residual = input - predict;
+
+        /* NGSA: バッファ参照位置更新 */
+        ngsa_pos = (ngsa_pos - 1) & ngsa_mask;
+
+        /* NGSA: 自然勾配更新 */
+        pngrad = &ngsa_ngrad[ngsa_pos];
+        for (ord = 0; ord < ar_order; ord++) {
+            const int32_t pos = (ngsa_pos + ngsa_order - 1 - ord) & ngsa_mask;
+            ngsa_ngrad[pos] += NARUUTILITY_SHIFT_RIGHT_ARITHMETIC(ar_coef[ord] * pngrad[ngsa_order], NARU_FIXEDPOINT_DIGITS);
+            ngsa_ngrad[pos + ngsa_order] = ngsa_ngrad[pos];
+        }
+        ngrad0 = 0;
+        for (ord = 0; ord < ar_order; ord++) {
+            ngrad0 -= ar_coef[ord] * phistory[ord + 1];
+        }
+        pngrad[0] = NARUUTILITY_SHIFT_RIGHT_ARITHMETIC(ngrad0, NARU_FIXEDPOINT_DIGITS) + phistory[0];
+        for (ord = 0; ord < ar_order; ord++) {
+            const int32_t pos = (ngsa_pos + ord + 1) & ngsa_mask;
+            ngsa_ngrad[pos] -= NARUUTILITY_SHIFT_RIGHT_ARITHMETIC(ar_coef[ord] * pngrad[0], NARU_FIXEDPOINT_DIGITS);
+            ngsa_ngrad[pos + ngsa_order] = ngsa_ngrad[pos];
         }
-    }
 
-    /* 入力データ履歴更新 */
-    filter->history[filter->buffer_pos]
-        = filter->history[filter->buffer_pos + filter_order] = input;
+        /* NGSA: フィルタ係数更新 */
+        ngsa_functions->update_ngsa_weight(ngsa_weight, pngrad,
+                pdelta_table[NARUUTILITY_SIGN(residual)], delta_rshift, ngsa_order);
 
-    return residual;
-}
+        /* NGSA: 入力データ履歴更新 */
+        ngsa_history[ngsa_pos] = ngsa_history[ngsa_pos + ngsa_order] = input;
+        input = residual;
 
-/* SAフィルタの1サンプル予測処理 */
-static int32_t NARUSAFilter_Predict(struct NARUSAFilter *filter, int32_t input)
-{
-    int32_t ord, residual, predict, sign;
-    int32_t *history, *weight;
-    const int32_t filter_order = filter->filter_order;
+        /* SA: フィルタ予測 */
+        phistory = &sa_history[sa_pos];
+        predict = NARU_FIXEDPOINT_0_5 + sa_functions->dot_product(sa_weight, phistory, sa_order);
+        predict = NARUUTILITY_SHIFT_RIGHT_ARITHMETIC(predict, NARU_FIXEDPOINT_DIGITS);
+        residual = input - predict;
 
-    NARU_ASSERT(filter != NULL);
-
-    /* ローカル変数に受けとく */
-    history = &filter->history[filter->buffer_pos];
-    weight = &filter->weight[0];
-
-    /* フィルタ予測 */
-    predict = NARU_FIXEDPOINT_0_5;
-    for (ord = 0; ord < filter_order; ord++) {
-        predict += weight[ord] * history[ord];
-    }
-    predict = NARUUTILITY_SHIFT_RIGHT_ARITHMETIC(predict, NARU_FIXEDPOINT_DIGITS);
+        /* SA: 係数更新 */
+        sa_functions->update_sa_weight(sa_weight, phistory, NARUUTILITY_SIGN(residual), sa_order);
 
-    /* 差分 */
-    residual = input - predict;
+        /* SA: 入力データ履歴更新 */
+        sa_pos = (sa_pos - 1) & sa_mask;
+        sa_history[sa_pos] = sa_history[sa_pos + sa_order] = input;
 
-    /* 係数更新 */
-    sign = NARUUTILITY_SIGN(residual);
-    for (ord = 0; ord < filter_order; ord++) {
-        weight[ord] += sign * history[ord];
+        buffer[smpl] = residual;
     }
 
-    /* 入力データ履歴更新 */
-    filter->buffer_pos = (filter->buffer_pos - 1) & filter->buffer_pos_mask;
-    filter->history[filter->buffer_pos]
-        = filter->history[filter->buffer_pos + filter_order] = input;
+    /* 状態を書き戻し */
+    processor->preemphasis_prev = preemphasis_prev;
+    ngsa->buffer_pos = ngsa_pos;
+    sa->buffer_pos = sa_pos;
+}
 
-    return residual;
+/* AR次数1のNGSAフィルタの1サンプル予測処理（次数は定数, 状態はローカル変数で受け渡し）
+* 補足）次数が定数なのでループの展開とリングバッファのマスク計算の畳み込みを期待 */
+#define NARUNGSAFILTER_PREDICT_SAMPLE_AR1(order, history, ngrad, weight, pos, ar_coef, pdelta_table, delta_rshift, input, residual)\
+    do {\
+        int32_t ord_, predict_, delta_;\
+        const int32_t *phistory_ = &(history)[(pos)];\
+        int32_t *pngrad_;\
+        \
+        /* フィルタ予測 */\
+        predict_ = NARU_FIXEDPOINT_0_5;\
+        for (ord_ = 0; ord_ < (order); ord_++) {\
+            predict_ += (weight)[ord_] * phistory_[ord_];\
+        }\
+        predict_ = NARUUTILITY_SHIFT_RIGHT_ARITHMETIC(predict_, NARU_FIXEDPOINT_DIGITS);\
+        \
+        /* 差分 */\
+        (residual) = (input) - predict_;\
+        \
+        /* バッファ参照位置更新 */\
+        (pos) = ((pos) - 1) & ((order) - 1);\
+        \
+        /* 自然勾配更新 */\
+        pngrad_ = &(ngrad)[(pos)];\
+        {\
+            const int32_t tail_ = ((pos) + (order) - 1) & ((order) - 1);\
+            const int32_t head_ = ((pos) + 1) & ((order) - 1);\
+            (ngrad)[tail_] += NARUUTILITY_SHIFT_RIGHT_ARITHMETIC((ar_coef) * pngrad_[(order)], NARU_FIXEDPOINT_DIGITS);\
+            (ngrad)[tail_ + (order)] = (ngrad)[tail_];\
+            pngrad_[0] = NARUUTILITY_SHIFT_RIGHT_ARITHMETIC(-((ar_coef) * phistory_[1]), NARU_FIXEDPOINT_DIGITS);\
+            pngrad_[0] += phistory_[0];\
+            (ngrad)[head_] -= NARUUTILITY_SHIFT_RIGHT_ARITHMETIC((ar_coef) * pngrad_[0], NARU_FIXEDPOINT_DIGITS);\
+            (ngrad)[head_ + (order)] = (ngrad)[head_];\
+        }\
+        \
+        /* フィルタ係数更新 */\
+        delta_ = (pdelta_table)[NARUUTILITY_SIGN((residual))];\
+        for (ord_ = 0; ord_ < (order); ord_++) {\
+            (weight)[ord_] += NARUUTILITY_SHIFT_RIGHT_ARITHMETIC(delta_ * pngrad_[ord_] + (1 << ((delta_rshift) - 1)), (delta_rshift));\
+        }\
+        \
+        /* 入力データ履歴更新 */\
+        (history)[(pos)] = (history)[(pos) + (order)] = (input);\
+    } while (0)
+
+/* SAフィルタの1サンプル予測処理（次数は定数, 状態はローカル変数で受け渡し） */
+#define NARUSAFILTER_PREDICT_SAMPLE(order, history, weight, pos, input, residual)\
+    do {\
+        int32_t ord_, predict_, sign_;\
+        const int32_t *phistory_ = &(history)[(pos)];\
+        \
+        /* フィルタ予測 */\
+        predict_ = NARU_FIXEDPOINT_0_5;\
+        for (ord_ = 0; ord_ < (order); ord_++) {\
+            predict_ += (weight)[ord_] * phistory_[ord_];\
+        }\
+        predict_ = NARUUTILITY_SHIFT_RIGHT_ARITHMETIC(predict_, NARU_FIXEDPOINT_DIGITS);\
+        \
+        /* 差分 */\
+        (residual) = (input) - predict_;\
+        \
+        /* 係数更新 */\
+        sign_ = NARUUTILITY_SIGN((residual));\
+        for (ord_ = 0; ord_ < (order); ord_++) {\
+            (weight)[ord_] += sign_ * phistory_[ord_];\
+        }\
+        \
+        /* 入力データ履歴更新 */\
+        (pos) = ((pos) - 1) & ((order) - 1);\
+        (history)[(pos)] = (history)[(pos) + (order)] = (input);\
+    } while (0)
+
+/* プリエンファシス・AR次数1のNGSA・SAを連結したブロック予測処理を次数を定数として定義
+* 補足）全段の状態をローカル変数に置いたまま1サンプル毎に各段を処理する */
+#define NARUENCODEPROCESSOR_DEFINE_PREDICT_CASCADE_AR1(ngsa_order, sa_order)\
+static void NARUEncodeProcessor_PredictCascadeAR1Order##ngsa_order##x##sa_order(\
+        struct NARUEncodeProcessor *processor, int32_t *buffer, uint32_t num_samples)\
+{\
+    uint32_t smpl;\
+    int32_t preemphasis_prev, ngsa_pos, sa_pos;\
+    int32_t *ngsa_history, *ngsa_ngrad, *ngsa_weight, *sa_history, *sa_weight;\
+    const int32_t coef_numer = ((1 << NARU_EMPHASIS_FILTER_SHIFT) - 1);\
+    struct NARUNGSAFilter *ngsa = processor->ngsa;\
+    struct NARUSAFilter *sa = processor->sa;\
+    const int32_t ar_coef = ngsa->ar_coef[0];\
+    const int32_t delta_rshift = ngsa->delta_rshift;\
+    const int32_t *pdelta_table = ngsa->pdelta_table;\
+    \
+    NARU_ASSERT(ngsa->filter_order == (ngsa_order));\
+    NARU_ASSERT(ngsa->ar_order == 1);\
+    NARU_ASSERT(sa->filter_order == (sa_order));\
+    NARU_ASSERT(pdelta_table == &ngsa->delta_table[1]);\
+    \
+    /* ローカル変数に受けとく */\
+    preemphasis_prev = processor->preemphasis_prev;\
+    ngsa_history = ngsa->history;\
+    ngsa_ngrad = ngsa->ngrad;\
+    ngsa_weight = ngsa->weight;\
+    ngsa_pos = ngsa->buffer_pos;\
+    sa_history = sa->history;\
+    sa_weight = sa->weight;\
+    sa_pos = sa->buffer_pos;\
+    \
+    for (smpl = 0; smpl < num_samples; smpl++) {\
+        int32_t input, emphasized, residual;\
+        \
+        /* プリエンファシス */\
+        input = buffer[smpl];\
+        emphasized = input - (int32_t)NARUUTILITY_SHIFT_RIGHT_ARITHMETIC(preemphasis_prev * coef_numer, NARU_EMPHASIS_FILTER_SHIFT);\
+        preemphasis_prev = input;\
+        /* NGSA */\
+        NARUNGSAFILTER_PREDICT_SAMPLE_AR1(ngsa_order, ngsa_history, ngsa_ngrad, ngsa_weight, ngsa_pos,\
+                ar_coef, pdelta_table, delta_rshift, emphasized, residual);\
+        /* SA */\
+        NARUSAFILTER_PREDICT_SAMPLE(sa_order, sa_history, sa_weight, sa_pos, residual, buffer[smpl]);\
+    }\
+    \
+    /* 状態を書き戻し */\
+    processor->preemphasis_prev = preemphasis_prev;\
+    ngsa->buffer_pos = ngsa_pos;\
+    sa->buffer_pos = sa_pos;\
 }
 
+/* エンコードプリセットで使う次数の組み合わせに対して連結予測処理を定義 */
+NARUENCODEPROCESSOR_DEFINE_PREDICT_CASCADE_AR1(4, 4)
+NARUENCODEPROCESSOR_DEFINE_PREDICT_CASCADE_AR1(8, 8)
+NARUENCODEPROCESSOR_DEFINE_PREDICT_CASCADE_AR1(16, 8)
+NARUENCODEPROCESSOR_DEFINE_PREDICT_CASCADE_AR1(32, 8)
+NARUENCODEPROCESSOR_DEFINE_PREDICT_CASCADE_AR1(64, 8)
+
+/* 連結予測関数テーブル */
+static const struct {
+    int32_t ngsa_order;   /* NGSAフィルタ次数 */
+    int32_t sa_order;     /* SAフィルタ次数 */
+    void (*predict)(struct NARUEncodeProcessor *, int32_t *, uint32_t);
+} st_predict_cascade_ar1_functions[] = {
+    {  4, 4, NARUEncodeProcessor_PredictCascadeAR1Order4x4 },
+    {  8, 8, NARUEncodeProcessor_PredictCascadeAR1Order8x8 },
+    { 16, 8, NARUEncodeProcessor_PredictCascadeAR1Order16x8 },
+    { 32, 8, NARUEncodeProcessor_PredictCascadeAR1Order32x8 },
+    { 64, 8, NARUEncodeProcessor_PredictCascadeAR1Order64x8 },
+};
+
 /* 予測 */
 void NARUEncodeProcessor_Predict(
         struct NARUEncodeProcessor *processor, int32_t *buffer, uint32_t num_samples)
 {
-    uint32_t smpl;
+    uint32_t i;
+    void (*cascade_predict)(struct NARUEncodeProcessor *, int32_t *, uint32_t);
 
     /* 引数チェック */
     NARU_ASSERT(processor != NULL);
@@ -484,17 +637,87 @@ void NARUEncodeProcessor_Predict(
                 || (processor->ngsa->filter_order > (2 * processor->ngsa->ar_order)));
     NARU_ASSERT(processor->sa->filter_order <= processor->sa->max_filter_order);
 
+    /* 次数特化版の連結予測関数を探す */
+    cascade_predict = NULL;
+    if ((processor->ngsa->ar_order == 1)
+            && NARUFilter_IsUnrolledKernelPreferred(processor->ngsa->functions, processor->ngsa->filter_order)
+            && NARUFilter_IsUnrolledKernelPreferred(processor->sa->functions, processor->sa->filter_order)) {
+        for (i = 0; i < sizeof(st_predict_cascade_ar1_functions) / sizeof(st_predict_cascade_ar1_functions[0]); i++) {
+            if ((st_predict_cascade_ar1_functions[i].ngsa_order == processor->ngsa->filter_order)
+                    && (st_predict_cascade_ar1_functions[i].sa_order == processor->sa->filter_order)) {
+                cascade_predict = st_predict_cascade_ar1_functions[i].predict;
+                break;
+            }
+        }
+    }
+
     /* 自然勾配の初期化 */
     NARUNGSAFilter_InitializeNaturalGradient(processor->ngsa);
 
-    /* 1サンプル毎に予測
-    * 補足）static関数なので、最適化時に展開されることを期待 */
-    for (smpl = 0; smpl < num_samples; smpl++) {
-        /* プリエンファシス */
-        buffer[smpl] = NARUEncodeProcessor_PreEmphasis(processor, buffer[smpl]);
-        /* NGSA */
-        buffer[smpl] = NARUNGSAFilter_Predict(processor->ngsa, buffer[smpl]);
-        /* SA */
-        buffer[smpl] = NARUSAFilter_Predict(processor->sa, buffer[smpl]);
+    if (cascade_predict != NULL) {
+        /* 次数特化版の連結予測 */
+        cascade_predict(processor, buffer, num_samples);
+    } else {
+        /* 各段を1サンプル毎に連結して予測 */
+        NARUEncodeProcessor_PredictCascade(processor, buffer, num_samples);
+    }
+}
+
+/* 複数チャンネルの予測（可能ならばチャンネルをSIMDレーンに並べて一括処理） */
+void NARUEncodeProcessor_PredictMultiChannel(
+        struct NARUEncodeProcessor *const *processors, struct NARUFilterLanes *lanes,
+        int32_t *const *buffer, uint32_t num_channels, uint32_t num_samples)
+{
+    uint32_t ch, base, num_lanes;
+    int32_t use_lanes;
+    struct NARUNGSAFilter *ngsa[NARU_MAX_NUM_CHANNELS];
+    struct NARUSAFilter *sa[NARU_MAX_NUM_CHANNELS];
+    int32_t preemphasis_prev[NARU_MAX_NUM_CHANNELS];
+
+    /* 引数チェック */
+    NARU_ASSERT(processors != NULL);
+    NARU_ASSERT(buffer != NULL);
+    NARU_ASSERT((num_channels > 0) && (num_channels <= NARU_MAX_NUM_CHANNELS));
+    NARU_ASSERT(num_samples > 0);
+
+    for (ch = 0; ch < num_channels; ch++) {
+        ngsa[ch] = processors[ch]->ngsa;
+        sa[ch] = processors[ch]->sa;
+    }
+
+    /* レーン並列処理できるか判定 */
+    use_lanes = ((lanes != NULL)
+            && NARUFilterLanes_IsPreferred(lanes, num_channels, processors[0]->ngsa->filter_order)) ? 1 : 0;
+    for (base = 0; use_lanes && (base < num_channels); base += NARUFILTER_NUM_LANES) {
+        num_lanes = NARUUTILITY_MIN(num_channels - base, NARUFILTER_NUM_LANES);
+        use_lanes = NARUFilterLanes_IsLoadable(lanes, &ngsa[base], &sa[base], num_lanes);
+    }
+
+    /* できない場合はチャンネル毎に予測 */
+    if (!use_lanes) {
+        for (ch = 0; ch < num_channels; ch++) {
+            NARUEncodeProcessor_Predict(processors[ch], buffer[ch], num_samples);
+        }
+        return;
+    }
+
+    /* 自然勾配の初期化 */
+    for (ch = 0; ch < num_channels; ch++) {
+        NARU_ASSERT(processors[ch]->ngsa->filter_order <= processors[ch]->ngsa->max_filter_order);
+        NARU_ASSERT(processors[ch]->sa->filter_order <= processors[ch]->sa->max_filter_order);
+        NARUNGSAFilter_InitializeNaturalGradient(processors[ch]->ngsa);
+        preemphasis_prev[ch] = processors[ch]->preemphasis_prev;
+    }
+
+    /* レーン数分ずつ一括で予測 */
+    for (base = 0; base < num_channels; base += NARUFILTER_NUM_LANES) {
+        num_lanes = NARUUTILITY_MIN(num_channels - base, NARUFILTER_NUM_LANES);
+        NARUFilterLanes_Load(lanes, &ngsa[base], &sa[base], &preemphasis_prev[base], num_lanes);
+        lanes->functions->predict_lanes(lanes, &buffer[base], num_samples);
+        NARUFilterLanes_Store(lanes, &ngsa[base], &sa[base], &preemphasis_prev[base], num_lanes);
+    }
+
+    for (ch = 0; ch < num_channels; ch++) {
+        processors[ch]->preemphasis_prev = preemphasis_prev[ch];
     }
 }
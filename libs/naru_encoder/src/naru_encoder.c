@@ -11,19 +11,74 @@
 #include <string.h>
 #include <math.h>
 
+/* 窓キャッシュのエントリ数
+* 補足）ブロック独立エンコードでは先行サンプル長とブロック長の窓を交互に使う */
+#define NARUENCODER_NUM_CACHED_WINDOWS 2
+
+/* シークテーブルに記録する最大シークポイント数
+* 補足）超えたらシークポイントを1つおきに間引いてブロック間隔を倍にし、総サンプル数に依らず一定のメモリで作る */
+#define NARUENCODER_MAX_NUM_SEEK_POINTS 8192
+
+/* rANS符号化の一時出力先サイズ計算: サブストリームのサイズ表 + 1サンプルあたり入力(32bit)
+* 補足）これに収まらないブロックは再帰的ライス符号を使う */
+#define NARUENCODER_CALCULATE_RANS_BUFFER_SIZE(num_channels, num_samples)\
+    ((int32_t)((num_channels) * (NARU_BLOCK_SUBSTREAM_SIZE_BYTES + sizeof(int32_t) * (num_samples))))
+
+/* ブロック解析結果（同一ブロックの試行間で使い回す） */
+struct NARUBlockAnalysis {
+    NARUBlockDataType block_type;                                   /* ブロックデータタイプ */
+    double ar_coef[NARU_MAX_NUM_CHANNELS][NARU_MAX_AR_ORDER + 1];   /* チャンネル毎のAR係数 */
+};
+
+/* 並列エンコードのワーカー */
+struct NARUEncodeWorker {
+    struct NARUEncoder *encoder;    /* ワーカー専用のエンコーダ（先頭はハンドル自身） */
+    uint8_t *buffer;                /* 出力バッファ */
+    uint32_t buffer_size;           /* 出力バッファサイズ */
+    uint32_t output_size;           /* 出力サイズ */
+    NARUApiResult result;           /* エンコード結果 */
+};
+
 /* エンコーダハンドル */
 struct NARUEncoder {
     struct NARUHeader header;               /* ヘッダ */
     struct LPCCalculator *lpcc;             /* LPC計算ハンドル */
     struct NARUEncodeProcessor *processor[NARU_MAX_NUM_CHANNELS];  /* 信号処理ハンドル */
+    struct NARUFilterLanes *lanes;          /* チャンネル並列処理用のレーン */
     struct NARUCoder *coder;                /* 符号化ハンドル */
+    NARUUtilityCRC16Function crc16;         /* CRC16計算関数 */
+    NARUUtilityCRC32CFunction crc32c;       /* CRC32C計算関数 */
     uint32_t max_num_channels;              /* バッファチャンネル数 */
     uint32_t max_num_samples_per_block;     /* バッファサンプル数 */
     uint8_t num_encode_trials;              /* エンコード繰り返し回数 */
+    uint8_t max_num_threads;                /* 最大スレッド数 */
+    uint8_t num_threads;                    /* エンコードスレッド数 */
+    uint32_t num_preroll_samples;           /* ブロック独立エンコード時の先行サンプル数 */
+    uint8_t use_rans;                       /* rANS符号を使うか？ */
+    struct NARUEncodeWorker *worker;        /* 並列エンコードのワーカー */
     uint8_t set_parameter;                  /* パラメータセット済み？ */
+    struct NARUBlockAnalysis analysis;      /* エンコード対象ブロックの解析結果 */
+    struct NARUBlockAnalysis prev_analysis; /* 直前ブロック（ブロック独立エンコードでは先行サンプル）の解析結果 */
+    uint8_t streaming;                      /* ストリーミングエンコード中？ */
+    int32_t **stream_buffer;                /* ストリーミング入力バッファ（直前ブロック+現在ブロック、ワーカーはNULL） */
+    uint32_t stream_num_buffered_samples;   /* 現在ブロックに蓄積済みのサンプル数 */
+    uint32_t stream_num_encoded_samples;    /* エンコード済みの総サンプル数 */
+    uint8_t *stream_data;                   /* ブロックの出力先 */
+    uint32_t stream_data_size;              /* ブロックの出力先サイズ */
+    NARUEncoderWriteCallback stream_callback;   /* ブロック出力コールバック */
+    void *stream_callback_user_data;        /* コールバックに渡す任意データ */
+    uint64_t stream_output_size;            /* ヘッダを含めて出力済みのバイト数 */
+    uint8_t *seek_table;                    /* シークテーブルブロックの作成先（ワーカーはNULL） */
+    uint32_t num_seek_points;               /* 記録済みのシークポイント数 */
+    uint32_t seek_point_interval;           /* シークポイントを置くブロック間隔 */
+    uint32_t num_seek_blocks;               /* シークポイントの対象として数えたブロック数 */
     int32_t **buffer;                       /* 信号バッファ */
-    double *window;                         /* 窓 */
+    double *window[NARUENCODER_NUM_CACHED_WINDOWS];         /* 窓キャッシュ */
+    uint32_t window_size[NARUENCODER_NUM_CACHED_WINDOWS];   /* 窓キャッシュの各窓の長さ（0は未作成） */
+    uint32_t last_window_index;             /* 最後に使った窓キャッシュのインデックス */
     double *buffer_double;                  /* 信号処理バッファ（浮動小数） */
+    uint32_t *rans_work;                    /* rANS符号化の作業領域 */
+    uint8_t *rans_buffer;                   /* rANS符号化したサイズ表とサブストリームの一時出力先 */
     uint8_t alloced_by_own;                 /* 領域を自前確保しているか？ */
     void *work;                             /* ワーク領域先頭ポインタ */
 };
@@ -32,15 +87,54 @@ struct NARUEncoder {
 static NARUError NARUEncoder_ConvertParameterToHeader(
         const struct NARUEncodeParameter *parameter, uint32_t num_samples,
         struct NARUHeader *header);
-/* 単一データブロックエンコード */
-/* 補足）実装の簡略化のため、ストリーミングエンコードには対応しない。そのため非公開。 */
+/* エンコーダハンドル作成に必要なワークサイズ計算（ワーカー用はストリーミング入力バッファを持たない） */
+static int32_t NARUEncoder_CalculateWorkSizeInternal(const struct NARUEncoderConfig *config, uint8_t is_worker);
+/* エンコーダハンドル作成（ワーカー用はストリーミング入力バッファを持たない） */
+static struct NARUEncoder *NARUEncoder_CreateInternal(
+        const struct NARUEncoderConfig *config, void *work, int32_t work_size, uint8_t is_worker);
+/* 解析済みの単一データブロックエンコード */
+/* 補足）前後のブロックを参照して繰り返しエンコードするため非公開。ストリーミングエンコードはNARUEncoder_PushSamplesを使う */
 static NARUApiResult NARUEncoder_EncodeBlock(
+        struct NARUEncoder *encoder, const struct NARUBlockAnalysis *analysis,
+        const int32_t *const *input, uint32_t num_samples,
+        uint8_t *data, uint32_t data_size, uint32_t *output_size);
+/* 出力を捨てる試行向けに、予測のみ行ってフィルタ状態を進める */
+static NARUApiResult NARUEncoder_WarmUpBlock(
+        struct NARUEncoder *encoder, const struct NARUBlockAnalysis *analysis,
+        const int32_t *const *input, uint32_t num_samples);
+/* 直前ブロックと共に繰り返して時系列順に単一データブロックエンコード */
+static NARUApiResult NARUEncoder_EncodeSequentialBlock(
+        struct NARUEncoder *encoder,
+        const int32_t *const *prev_input, uint32_t prev_num_samples,
+        const int32_t *const *input, uint32_t num_samples,
+        uint8_t *data, uint32_t data_size, uint32_t *output_size);
+/* 先行サンプルでフィルタを慣らした上で単一データブロックエンコード */
+static NARUApiResult NARUEncoder_EncodeBlockWithPreroll(
+        struct NARUEncoder *encoder,
+        const int32_t *const *input, uint32_t block_offset, uint32_t num_samples,
+        uint8_t *data, uint32_t data_size, uint32_t *output_size);
+/* ブロック独立にデータブロック列をエンコード */
+static NARUApiResult NARUEncoder_EncodeBlocksIndependently(
         struct NARUEncoder *encoder,
         const int32_t *const *input, uint32_t num_samples,
         uint8_t *data, uint32_t data_size, uint32_t *output_size);
-/* ブロックデータタイプの判定 */
-static NARUBlockDataType NARUEncoder_DecideBlockDataType(
-        struct NARUEncoder *encoder, const int32_t *const *input, uint32_t num_samples);
+/* ストリーミング入力バッファに揃ったブロックをエンコードして出力 */
+static NARUApiResult NARUEncoder_EncodeStreamBlock(struct NARUEncoder *encoder, uint32_t num_samples);
+/* シークテーブルの初期化 */
+static void NARUEncoder_ResetSeekTable(struct NARUEncoder *encoder);
+/* シークテーブルにブロックの位置を追加 */
+static NARUApiResult NARUEncoder_AddSeekPoint(struct NARUEncoder *encoder, uint32_t sample_offset, uint64_t byte_offset);
+/* シークテーブルブロックを完成させてサイズを返す */
+static uint32_t NARUEncoder_FinishSeekTable(struct NARUEncoder *encoder);
+/* 出力済みのブロックを辿ってシークテーブルを作成し、末尾に付加 */
+static NARUApiResult NARUEncoder_AppendSeekTable(
+        struct NARUEncoder *encoder, uint8_t *data, uint32_t data_size, uint32_t *output_size);
+/* ブロック解析: データタイプの判定とAR係数の計算 */
+static NARUApiResult NARUEncoder_AnalyzeBlock(
+        struct NARUEncoder *encoder, const int32_t *const *input, uint32_t num_samples,
+        struct NARUBlockAnalysis *analysis);
+/* 指定した長さの窓を取得 */
+static const double *NARUEncoder_GetWindow(struct NARUEncoder *encoder, uint32_t window_size);
 /* 解析用のdouble信号作成 */
 static void NARUEncoder_MakeAnalyzingSignal(
         const double *window, const int32_t *data_int, uint32_t num_samples,
@@ -80,8 +174,8 @@ NARUApiResult NARUEncoder_EncodeHeader(
     if (header->bits_per_sample == 0) {
         return NARU_APIRESULT_INVALID_FORMAT;
     }
-    /* ブロックあたりサンプル数 */
-    if (header->max_num_samples_per_block == 0) {
+    /* ブロックあたりサンプル数: ブロックヘッダには16bitで記録する */
+    if ((header->max_num_samples_per_block == 0) || (header->max_num_samples_per_block > 0xFFFFU)) {
         return NARU_APIRESULT_INVALID_FORMAT;
     }
     /* フィルタ次数: 2の冪数限定 */
@@ -102,6 +196,14 @@ NARUApiResult NARUEncoder_EncodeHeader(
             && (header->num_channels == 1)) {
         return NARU_APIRESULT_INVALID_FORMAT;
     }
+    /* ブロックのチェックサム種別 */
+    if (header->block_checksum_type >= NARU_BLOCK_CHECKSUM_TYPE_INVALID) {
+        return NARU_APIRESULT_INVALID_FORMAT;
+    }
+    /* シークテーブルの有無 */
+    if (header->has_seek_table > 1) {
+        return NARU_APIRESULT_INVALID_FORMAT;
+    }
 
     /* 書き出し用ポインタ設定 */
     data_pos = data;
@@ -125,8 +227,12 @@ NARUApiResult NARUEncoder_EncodeHeader(
     ByteArray_PutUint32BE(data_pos, header->sampling_rate);
     /* サンプルあたりビット数 */
     ByteArray_PutUint16BE(data_pos, header->bits_per_sample);
+    /* ブロックのチェックサム種別 */
+    ByteArray_PutUint8(data_pos, header->block_checksum_type);
+    /* シークテーブルの有無 */
+    ByteArray_PutUint8(data_pos, header->has_seek_table);
     /* 最大ブロックあたりサンプル数 */
-    ByteArray_PutUint32BE(data_pos, header->max_num_samples_per_block);
+    ByteArray_PutUint16BE(data_pos, header->max_num_samples_per_block);
     /* フィルタ次数 */
     ByteArray_PutUint8(data_pos, header->filter_order);
     /* AR次数 */
@@ -181,6 +287,9 @@ static NARUError NARUEncoder_ConvertParameterToHeader(
     if (parameter->ch_process_method >= NARU_CH_PROCESS_METHOD_INVALID) {
         return NARU_ERROR_INVALID_FORMAT;
     }
+    if (parameter->block_checksum_type >= NARU_BLOCK_CHECKSUM_TYPE_INVALID) {
+        return NARU_ERROR_INVALID_FORMAT;
+    }
 
     /* 総サンプル数 */
     tmp_header.num_samples = num_samples;
@@ -194,6 +303,8 @@ static NARUError NARUEncoder_ConvertParameterToHeader(
     tmp_header.ar_order = parameter->ar_order;
     tmp_header.second_filter_order = parameter->second_filter_order;
     tmp_header.ch_process_method = parameter->ch_process_method;
+    tmp_header.block_checksum_type = parameter->block_checksum_type;
+    tmp_header.has_seek_table = (parameter->use_seek_table == 1) ? 1 : 0;
 
     /* 成功終了 */
     (*header) = tmp_header;
@@ -202,6 +313,12 @@ static NARUError NARUEncoder_ConvertParameterToHeader(
 
 /* エンコーダハンドル作成に必要なワークサイズ計算 */
 int32_t NARUEncoder_CalculateWorkSize(const struct NARUEncoderConfig *config)
+{
+    return NARUEncoder_CalculateWorkSizeInternal(config, 0);
+}
+
+/* エンコーダハンドル作成に必要なワークサイズ計算（ワーカー用はストリーミング入力バッファを持たない） */
+static int32_t NARUEncoder_CalculateWorkSizeInternal(const struct NARUEncoderConfig *config, uint8_t is_worker)
 {
     int32_t work_size, tmp_work_size;
 
@@ -210,6 +327,13 @@ int32_t NARUEncoder_CalculateWorkSize(const struct NARUEncoderConfig *config)
         return -1;
     }
 
+    /* スレッド数0は単一スレッドとして扱う */
+    if (config->max_num_threads == 0) {
+        struct NARUEncoderConfig single_config = (*config);
+        single_config.max_num_threads = 1;
+        return NARUEncoder_CalculateWorkSizeInternal(&single_config, is_worker);
+    }
+
     /* コンフィグチェック */
     if ((config->max_num_channels == 0)
             || (config->max_num_samples_per_block == 0)
@@ -240,27 +364,79 @@ int32_t NARUEncoder_CalculateWorkSize(const struct NARUEncoderConfig *config)
     }
     work_size += tmp_work_size * config->max_num_channels;
 
-    /* 窓と信号処理バッファのサイズ */
-    work_size += 2 * ((int32_t)sizeof(double) * config->max_num_samples_per_block + NARU_MEMORY_ALIGNMENT);
+    /* チャンネル並列処理用のレーンのサイズ */
+    if ((tmp_work_size = NARUFilterLanes_CalculateWorkSize(config->max_filter_order)) < 0) {
+        return -1;
+    }
+    work_size += tmp_work_size;
+
+    /* 窓キャッシュと信号処理バッファのサイズ */
+    work_size += (NARUENCODER_NUM_CACHED_WINDOWS + 1) * ((int32_t)sizeof(double) * config->max_num_samples_per_block + NARU_MEMORY_ALIGNMENT);
 
     /* 信号処理バッファのサイズ */
     work_size += (int32_t)sizeof(int32_t *) * config->max_num_channels + NARU_MEMORY_ALIGNMENT;
     work_size += config->max_num_channels * ((int32_t)sizeof(int32_t) * config->max_num_samples_per_block + NARU_MEMORY_ALIGNMENT);
 
+    /* rANS符号化の作業領域と一時出力先のサイズ */
+    if (config->enable_rans == 1) {
+        work_size += (int32_t)sizeof(uint32_t) * config->max_num_samples_per_block + NARU_MEMORY_ALIGNMENT;
+        work_size += NARUENCODER_CALCULATE_RANS_BUFFER_SIZE(config->max_num_channels, config->max_num_samples_per_block) + NARU_MEMORY_ALIGNMENT;
+    }
+
+    if (is_worker == 0) {
+        /* ストリーミング入力バッファのサイズ: 直前ブロックと現在ブロックの2ブロック分 */
+        if (config->enable_streaming == 1) {
+            work_size += (int32_t)sizeof(int32_t *) * config->max_num_channels + NARU_MEMORY_ALIGNMENT;
+            work_size += config->max_num_channels * (2 * (int32_t)sizeof(int32_t) * config->max_num_samples_per_block + NARU_MEMORY_ALIGNMENT);
+        }
+        /* シークテーブルブロック: チェックサムが最も大きい場合を見込む */
+        if (config->enable_seek_table == 1) {
+            work_size += (int32_t)NARU_SEEKTABLE_BLOCK_SIZE(NARU_BLOCK_CHECKSUM_TYPE_CRC32C, NARUENCODER_MAX_NUM_SEEK_POINTS) + NARU_MEMORY_ALIGNMENT;
+        }
+    }
+
+    /* ワーカーのサイズ */
+    work_size += (int32_t)sizeof(struct NARUEncodeWorker) * config->max_num_threads + NARU_MEMORY_ALIGNMENT;
+    if (config->max_num_threads > 1) {
+        /* 2番目以降のワーカーは専用のエンコーダと出力バッファを持つ */
+        struct NARUEncoderConfig worker_config = (*config);
+        worker_config.max_num_threads = 1;
+        if ((tmp_work_size = NARUEncoder_CalculateWorkSizeInternal(&worker_config, 1)) < 0) {
+            return -1;
+        }
+        work_size += (config->max_num_threads - 1) * (tmp_work_size
+                + (int32_t)NARUENCODER_CALCULATE_MAX_BLOCK_SIZE(config->max_num_channels, config->max_num_samples_per_block)
+                + NARU_MEMORY_ALIGNMENT);
+    }
+
     return work_size;
 }
 
 /* エンコーダハンドル作成 */
 struct NARUEncoder *NARUEncoder_Create(const struct NARUEncoderConfig *config, void *work, int32_t work_size)
 {
-    uint32_t ch;
+    return NARUEncoder_CreateInternal(config, work, work_size, 0);
+}
+
+/* エンコーダハンドル作成（ワーカー用はストリーミング入力バッファを持たない） */
+static struct NARUEncoder *NARUEncoder_CreateInternal(
+        const struct NARUEncoderConfig *config, void *work, int32_t work_size, uint8_t is_worker)
+{
+    uint32_t ch, i;
     struct NARUEncoder *encoder;
     uint8_t tmp_alloc_by_own = 0;
     uint8_t *work_ptr;
 
+    /* スレッド数0は単一スレッドとして扱う */
+    if ((config != NULL) && (config->max_num_threads == 0)) {
+        struct NARUEncoderConfig single_config = (*config);
+        single_config.max_num_threads = 1;
+        return NARUEncoder_CreateInternal(&single_config, work, work_size, is_worker);
+    }
+
     /* ワーク領域時前確保の場合 */
     if ((work == NULL) && (work_size == 0)) {
-        if ((work_size = NARUEncoder_CalculateWorkSize(config)) < 0) {
+        if ((work_size = NARUEncoder_CalculateWorkSizeInternal(config, is_worker)) < 0) {
             return NULL;
         }
         work = malloc((uint32_t)work_size);
@@ -269,7 +445,7 @@ struct NARUEncoder *NARUEncoder_Create(const struct NARUEncoderConfig *config, v
 
     /* 引数チェック */
     if ((config == NULL) || (work == NULL)
-            || (work_size < NARUEncoder_CalculateWorkSize(config))) {
+            || (work_size < NARUEncoder_CalculateWorkSizeInternal(config, is_worker))) {
         return NULL;
     }
 
@@ -291,10 +467,12 @@ struct NARUEncoder *NARUEncoder_Create(const struct NARUEncoderConfig *config, v
 
     /* エンコーダメンバ設定 */
     encoder->set_parameter = 0;
+    encoder->streaming = 0;
     encoder->alloced_by_own = tmp_alloc_by_own;
     encoder->work = work;
     encoder->max_num_channels = config->max_num_channels;
     encoder->max_num_samples_per_block = config->max_num_samples_per_block;
+    encoder->max_num_threads = config->max_num_threads;
 
     /* LPC計算ハンドルの作成 */
     {
@@ -317,6 +495,13 @@ struct NARUEncoder *NARUEncoder_Create(const struct NARUEncoderConfig *config, v
         work_ptr += coder_size;
     }
 
+    /* 実行環境で最速のCRC16計算関数を選択 */
+    encoder->crc16 = NARUUtility_GetCRC16Function(NARUUtility_GetAvailableCRC16Implementation());
+    NARU_ASSERT(encoder->crc16 != NULL);
+    /* CRC32Cも同様 */
+    encoder->crc32c = NARUUtility_GetCRC32CFunction(NARUUtility_GetAvailableCRC32CImplementation());
+    NARU_ASSERT(encoder->crc32c != NULL);
+
     /* 信号処理ハンドルの作成 */
     {
         int32_t processor_size = NARUEncodeProcessor_CalculateWorkSize(config->max_filter_order);
@@ -329,11 +514,24 @@ struct NARUEncoder *NARUEncoder_Create(const struct NARUEncoderConfig *config, v
         }
     }
 
+    /* チャンネル並列処理用のレーンの作成 */
+    {
+        int32_t lanes_size = NARUFilterLanes_CalculateWorkSize(config->max_filter_order);
+        if ((encoder->lanes = NARUFilterLanes_Create(config->max_filter_order, work_ptr, lanes_size)) == NULL) {
+            return NULL;
+        }
+        work_ptr += lanes_size;
+    }
+
     /* バッファ領域の確保 全てのポインタをアラインメント */
 
-    work_ptr = (uint8_t *)NARUUTILITY_ROUNDUP((uintptr_t)work_ptr, NARU_MEMORY_ALIGNMENT);
-    encoder->window = (double *)work_ptr;
-    work_ptr += sizeof(double) * config->max_num_samples_per_block;
+    for (i = 0; i < NARUENCODER_NUM_CACHED_WINDOWS; i++) {
+        work_ptr = (uint8_t *)NARUUTILITY_ROUNDUP((uintptr_t)work_ptr, NARU_MEMORY_ALIGNMENT);
+        encoder->window[i] = (double *)work_ptr;
+        encoder->window_size[i] = 0;
+        work_ptr += sizeof(double) * config->max_num_samples_per_block;
+    }
+    encoder->last_window_index = 0;
 
     work_ptr = (uint8_t *)NARUUTILITY_ROUNDUP((uintptr_t)work_ptr, NARU_MEMORY_ALIGNMENT);
     encoder->buffer_double = (double *)work_ptr;
@@ -348,6 +546,68 @@ struct NARUEncoder *NARUEncoder_Create(const struct NARUEncoderConfig *config, v
         work_ptr += sizeof(int32_t) * config->max_num_samples_per_block;
     }
 
+    /* rANS符号化の作業領域と一時出力先の確保 */
+    encoder->rans_work = NULL;
+    encoder->rans_buffer = NULL;
+    if (config->enable_rans == 1) {
+        work_ptr = (uint8_t *)NARUUTILITY_ROUNDUP((uintptr_t)work_ptr, NARU_MEMORY_ALIGNMENT);
+        encoder->rans_work = (uint32_t *)work_ptr;
+        work_ptr += sizeof(uint32_t) * config->max_num_samples_per_block;
+
+        work_ptr = (uint8_t *)NARUUTILITY_ROUNDUP((uintptr_t)work_ptr, NARU_MEMORY_ALIGNMENT);
+        encoder->rans_buffer = work_ptr;
+        work_ptr += NARUENCODER_CALCULATE_RANS_BUFFER_SIZE(config->max_num_channels, config->max_num_samples_per_block);
+    }
+
+    /* ストリーミング入力バッファとシークテーブルの確保 */
+    encoder->stream_buffer = NULL;
+    encoder->seek_table = NULL;
+    if (is_worker == 0) {
+        if (config->enable_streaming == 1) {
+            work_ptr = (uint8_t *)NARUUTILITY_ROUNDUP((uintptr_t)work_ptr, NARU_MEMORY_ALIGNMENT);
+            encoder->stream_buffer = (int32_t **)work_ptr;
+            work_ptr += sizeof(int32_t *) * config->max_num_channels;
+            for (ch = 0; ch < config->max_num_channels; ch++) {
+                work_ptr = (uint8_t *)NARUUTILITY_ROUNDUP((uintptr_t)work_ptr, NARU_MEMORY_ALIGNMENT);
+                encoder->stream_buffer[ch] = (int32_t *)work_ptr;
+                work_ptr += 2 * sizeof(int32_t) * config->max_num_samples_per_block;
+            }
+        }
+        if (config->enable_seek_table == 1) {
+            work_ptr = (uint8_t *)NARUUTILITY_ROUNDUP((uintptr_t)work_ptr, NARU_MEMORY_ALIGNMENT);
+            encoder->seek_table = work_ptr;
+            work_ptr += NARU_SEEKTABLE_BLOCK_SIZE(NARU_BLOCK_CHECKSUM_TYPE_CRC32C, NARUENCODER_MAX_NUM_SEEK_POINTS);
+        }
+    }
+
+    /* ワーカーの作成 */
+    work_ptr = (uint8_t *)NARUUTILITY_ROUNDUP((uintptr_t)work_ptr, NARU_MEMORY_ALIGNMENT);
+    encoder->worker = (struct NARUEncodeWorker *)work_ptr;
+    work_ptr += sizeof(struct NARUEncodeWorker) * config->max_num_threads;
+    /* 先頭のワーカーはハンドル自身を使い、出力先に直接書き込む */
+    encoder->worker[0].encoder = encoder;
+    encoder->worker[0].buffer = NULL;
+    encoder->worker[0].buffer_size = 0;
+    if (config->max_num_threads > 1) {
+        uint32_t thrd;
+        struct NARUEncoderConfig worker_config = (*config);
+        int32_t worker_size, buffer_size;
+        worker_config.max_num_threads = 1;
+        worker_size = NARUEncoder_CalculateWorkSizeInternal(&worker_config, 1);
+        buffer_size = (int32_t)NARUENCODER_CALCULATE_MAX_BLOCK_SIZE(config->max_num_channels, config->max_num_samples_per_block);
+        for (thrd = 1; thrd < config->max_num_threads; thrd++) {
+            struct NARUEncodeWorker *worker = &encoder->worker[thrd];
+            if ((worker->encoder = NARUEncoder_CreateInternal(&worker_config, work_ptr, worker_size, 1)) == NULL) {
+                return NULL;
+            }
+            work_ptr += worker_size;
+            work_ptr = (uint8_t *)NARUUTILITY_ROUNDUP((uintptr_t)work_ptr, NARU_MEMORY_ALIGNMENT);
+            worker->buffer = work_ptr;
+            worker->buffer_size = (uint32_t)buffer_size;
+            work_ptr += buffer_size;
+        }
+    }
+
     /* バッファオーバーランチェック */
     /* 補足）既にメモリを破壊している可能性があるので、チェックに失敗したら落とす */
     NARU_ASSERT((work_ptr - (uint8_t *)work) <= work_size);
@@ -364,6 +624,10 @@ struct NARUEncoder *NARUEncoder_Create(const struct NARUEncoderConfig *config, v
 void NARUEncoder_Destroy(struct NARUEncoder *encoder)
 {
     if (encoder != NULL) {
+        uint32_t thrd;
+        for (thrd = 1; thrd < encoder->max_num_threads; thrd++) {
+            NARUEncoder_Destroy(encoder->worker[thrd].encoder);
+        }
         LPCCalculator_Destroy(encoder->lpcc);
         NARUCoder_Destroy(encoder->coder);
         if (encoder->alloced_by_own == 1) {
@@ -395,9 +659,25 @@ NARUApiResult NARUEncoder_SetEncodeParameter(
         return NARU_APIRESULT_INVALID_FORMAT;
     }
 
+    /* 複数スレッドでのエンコードはブロック独立（先行サンプル数が正）である必要がある */
+    if ((parameter->num_threads > 1) && (parameter->num_preroll_samples == 0)) {
+        return NARU_APIRESULT_INVALID_FORMAT;
+    }
+
     /* エンコーダの容量を越えてないかチェック */
     if ((encoder->max_num_samples_per_block < parameter->num_samples_per_block)
-            || (encoder->max_num_channels < parameter->num_channels)) {
+            || (encoder->max_num_channels < parameter->num_channels)
+            || (encoder->max_num_threads < parameter->num_threads)) {
+        return NARU_APIRESULT_INSUFFICIENT_BUFFER;
+    }
+
+    /* rANS符号を使うのに作業領域を確保していない */
+    if ((parameter->use_rans == 1) && (encoder->rans_buffer == NULL)) {
+        return NARU_APIRESULT_INSUFFICIENT_BUFFER;
+    }
+
+    /* シークテーブルを付加するのに作成先を確保していない */
+    if ((parameter->use_seek_table == 1) && (encoder->seek_table == NULL)) {
         return NARU_APIRESULT_INSUFFICIENT_BUFFER;
     }
 
@@ -407,6 +687,29 @@ NARUApiResult NARUEncoder_SetEncodeParameter(
     /* エンコード繰り返し回数設定 */
     encoder->num_encode_trials = parameter->num_encode_trials;
 
+    /* 並列化パラメータ設定 */
+    encoder->num_threads = (uint8_t)NARUUTILITY_MAX(1, parameter->num_threads);
+    encoder->num_preroll_samples = parameter->num_preroll_samples;
+
+    /* rANS符号の使用有無 */
+    encoder->use_rans = (parameter->use_rans == 1) ? 1 : 0;
+
+    /* ワーカーのエンコーダにも同一のパラメータを設定 */
+    {
+        uint32_t thrd;
+        NARUApiResult ret;
+        struct NARUEncodeParameter worker_parameter = (*parameter);
+        worker_parameter.num_threads = 1;
+        /* シークテーブルはハンドル自身が作るのでワーカーには不要 */
+        worker_parameter.use_seek_table = 0;
+        for (thrd = 1; thrd < encoder->max_num_threads; thrd++) {
+            if ((ret = NARUEncoder_SetEncodeParameter(encoder->worker[thrd].encoder, &worker_parameter))
+                    != NARU_APIRESULT_OK) {
+                return ret;
+            }
+        }
+    }
+
     /* フィルタパラメータ設定 */
     for (ch = 0; ch < tmp_header.num_channels; ch++) {
         NARUEncodeProcessor_SetFilterOrder(encoder->processor[ch],
@@ -416,56 +719,37 @@ NARUApiResult NARUEncoder_SetEncodeParameter(
     /* パラメータ設定済みフラグを立てる */
     encoder->set_parameter = 1;
 
+    /* 実行中のストリーミングエンコードは破棄 */
+    encoder->streaming = 0;
+
     return NARU_APIRESULT_OK;
 }
 
-/* ブロックデータタイプの判定 */
-static NARUBlockDataType NARUEncoder_DecideBlockDataType(
-        struct NARUEncoder *encoder, const int32_t *const *input, uint32_t num_samples)
+/* 指定した長さの窓を取得
+* 補足）ブロック長はほぼ一定なので、キャッシュに無い長さのときだけ作成する */
+static const double *NARUEncoder_GetWindow(struct NARUEncoder *encoder, uint32_t window_size)
 {
-    uint32_t ch, smpl;
-    double parcor_coef[NARU_MAX_AR_ORDER + 1], mean_length;
-    const struct NARUHeader *header;
-    LPCCalculatorApiResult ret;
+    uint32_t i;
 
     NARU_ASSERT(encoder != NULL);
-    NARU_ASSERT(input != NULL);
-
-    header = &encoder->header;
-
-    /* 平均符号長の計算 */
-    mean_length = 0.0f;
-    for (ch = 0; ch < header->num_channels; ch++) {
-        double tmp_length;
-        /* 入力をdouble化 */
-        for (smpl = 0; smpl < num_samples; smpl++) {
-            encoder->buffer_double[smpl] = input[ch][smpl] * pow(2.0f, -(int32_t)(header->bits_per_sample - 1));
-        }
-        /* 推定符号長計算 */
-        ret = LPCCalculator_CalculatePARCORCoef(
-                encoder->lpcc, encoder->buffer_double, num_samples, parcor_coef, header->ar_order);
-        NARU_ASSERT(ret == LPCCALCULATOR_APIRESULT_OK);
-        ret = LPCCalculator_EstimateCodeLength(
-                encoder->buffer_double, num_samples, header->bits_per_sample, parcor_coef, header->ar_order, &tmp_length);
-        NARU_ASSERT(ret == LPCCALCULATOR_APIRESULT_OK);
-        mean_length += tmp_length;
-    }
-    mean_length /= header->num_channels;
-
-    /* ビット幅に占める比に変換 */
-    mean_length /= header->bits_per_sample;
-
-    /* データタイプ判定 */
-
-    /* 圧縮が効きにくい: 生データ出力 */
-    if ((header->ar_order > 0) && (mean_length >= NARU_ESTIMATED_CODELENGTH_THRESHOLD)) {
-        return NARU_BLOCK_DATA_TYPE_RAWDATA;
+    NARU_ASSERT(window_size > 0);
+    NARU_ASSERT(window_size <= encoder->max_num_samples_per_block);
+
+    /* キャッシュにあればそのまま使う */
+    for (i = 0; i < NARUENCODER_NUM_CACHED_WINDOWS; i++) {
+        if (encoder->window_size[i] == window_size) {
+            encoder->last_window_index = i;
+            return encoder->window[i];
+        }
     }
 
-    /* TODO: 無音判定 */
+    /* 無ければ最後に使った窓の次のエントリを置き換える */
+    i = (encoder->last_window_index + 1) % NARUENCODER_NUM_CACHED_WINDOWS;
+    NARUUtility_MakeSinWindow(encoder->window[i], window_size);
+    encoder->window_size[i] = window_size;
+    encoder->last_window_index = i;
 
-    /* それ以外は圧縮データ */
-    return NARU_BLOCK_DATA_TYPE_COMPRESSDATA;
+    return encoder->window[i];
 }
 
 /* 解析用のdouble信号作成 */
@@ -474,6 +758,7 @@ static void NARUEncoder_MakeAnalyzingSignal(
         uint32_t bits_per_sample, double *data_double)
 {
     uint32_t smpl;
+    double scale;
 
     NARU_ASSERT(window != NULL);
     NARU_ASSERT(data_int != NULL);
@@ -481,8 +766,9 @@ static void NARUEncoder_MakeAnalyzingSignal(
     NARU_ASSERT(bits_per_sample > 0);
 
     /* [-1, 1]の範囲に丸め込む */
+    scale = pow(2.0f, -(double)(bits_per_sample - 1));
     for (smpl = 0; smpl < num_samples; smpl++) {
-        data_double[smpl] = (double)data_int[smpl] * pow(2.0f, -(double)(bits_per_sample - 1));
+        data_double[smpl] = (double)data_int[smpl] * scale;
     }
 
     /* プリエンファシス */
@@ -492,6 +778,111 @@ static void NARUEncoder_MakeAnalyzingSignal(
     NARUUtility_ApplyWindow(window, data_double, num_samples);
 }
 
+/* 入力をバッファにコピーしてマルチチャンネル処理を行う */
+static NARUApiResult NARUEncoder_CopyInputToBuffer(
+        struct NARUEncoder *encoder,
+        const int32_t *const *input, uint32_t num_samples, int32_t **buffer)
+{
+    uint32_t ch;
+    const struct NARUHeader *header;
+
+    /* 内部関数なので不正な引数はアサートで落とす */
+    NARU_ASSERT(encoder != NULL);
+    NARU_ASSERT(input != NULL);
+    NARU_ASSERT(num_samples > 0);
+    NARU_ASSERT(buffer != NULL);
+
+    header = &(encoder->header);
+
+    /* 入力をバッファにコピー */
+    for (ch = 0; ch < header->num_channels; ch++) {
+        /* ポインタ取得 */
+        buffer[ch] = encoder->buffer[ch];
+        memcpy(buffer[ch], input[ch], sizeof(int32_t) * num_samples);
+    }
+
+    /* マルチチャンネル処理 */
+    if (header->ch_process_method == NARU_CH_PROCESS_METHOD_MS) {
+        /* チャンネル数チェック */
+        if (header->num_channels < 2) {
+            return NARU_APIRESULT_INVALID_FORMAT;
+        }
+        /* LR -> MS */
+        NARUUtility_LRtoMSInt32(buffer, num_samples);
+    }
+
+    return NARU_APIRESULT_OK;
+}
+
+/* ブロック解析: データタイプの判定とAR係数の計算
+* 補足）チャンネル毎に自己相関を1回だけ計算し、AR係数と推定符号長を同時に得る */
+static NARUApiResult NARUEncoder_AnalyzeBlock(
+        struct NARUEncoder *encoder, const int32_t *const *input, uint32_t num_samples,
+        struct NARUBlockAnalysis *analysis)
+{
+    uint32_t ch;
+    int32_t *buffer[NARU_MAX_NUM_CHANNELS];
+    double lpc_coef[NARU_MAX_AR_ORDER + 1], mean_length;
+    const double *window;
+    const struct NARUHeader *header;
+    NARUApiResult ret;
+
+    /* 内部関数なので不正な引数はアサートで落とす */
+    NARU_ASSERT(encoder != NULL);
+    NARU_ASSERT(input != NULL);
+    NARU_ASSERT(num_samples > 0);
+    NARU_ASSERT(analysis != NULL);
+
+    header = &encoder->header;
+
+    /* 予測と同じマルチチャンネル処理を施した信号を解析する */
+    if ((ret = NARUEncoder_CopyInputToBuffer(encoder, input, num_samples, buffer)) != NARU_APIRESULT_OK) {
+        return ret;
+    }
+
+    /* 窓取得 */
+    window = NARUEncoder_GetWindow(encoder, num_samples);
+
+    /* チャンネル毎にAR係数と推定符号長を計算 */
+    mean_length = 0.0f;
+    for (ch = 0; ch < header->num_channels; ch++) {
+        double tmp_length;
+        LPCCalculatorApiResult lpcc_ret;
+        /* 解析用double信号生成 */
+        NARUEncoder_MakeAnalyzingSignal(window,
+                buffer[ch], num_samples, header->bits_per_sample, encoder->buffer_double);
+        /* 係数と推定符号長の計算
+        * 補足）AR係数には従来通りPARCOR係数を使う（LPCCalculator_CalculateLPCCoefの出力と同一） */
+        lpcc_ret = LPCCalculator_CalculateCoefAndCodeLength(encoder->lpcc,
+                encoder->buffer_double, num_samples, header->bits_per_sample,
+                lpc_coef, analysis->ar_coef[ch], header->ar_order, &tmp_length);
+        NARU_ASSERT(lpcc_ret == LPCCALCULATOR_APIRESULT_OK);
+        /* 窓掛けで減った信号パワー（サイン窓で平均1/2）の分だけ符号長を補正 */
+        if (tmp_length > 0.0f) {
+            tmp_length += 0.5f;
+        }
+        mean_length += tmp_length;
+    }
+    mean_length /= header->num_channels;
+
+    /* ビット幅に占める比に変換 */
+    mean_length /= header->bits_per_sample;
+
+    /* データタイプ判定 */
+
+    /* 圧縮が効きにくい: 生データ出力 */
+    if ((header->ar_order > 0) && (mean_length >= NARU_ESTIMATED_CODELENGTH_THRESHOLD)) {
+        analysis->block_type = NARU_BLOCK_DATA_TYPE_RAWDATA;
+        return NARU_APIRESULT_OK;
+    }
+
+    /* TODO: 無音判定 */
+
+    /* それ以外は圧縮データ */
+    analysis->block_type = NARU_BLOCK_DATA_TYPE_COMPRESSDATA;
+    return NARU_APIRESULT_OK;
+}
+
 /* 生データブロックエンコード */
 static NARUApiResult NARUEncoder_EncodeRawData(
         struct NARUEncoder *encoder,
@@ -537,16 +928,94 @@ static NARUApiResult NARUEncoder_EncodeRawData(
     return NARU_APIRESULT_OK;
 }
 
+/* 圧縮データブロックの予測前処理: 入力をバッファにコピーしてマルチチャンネル処理を行い、解析済みのAR係数を設定 */
+static NARUApiResult NARUEncoder_PrepareCompressData(
+        struct NARUEncoder *encoder, const struct NARUBlockAnalysis *analysis,
+        const int32_t *const *input, uint32_t num_samples, int32_t **buffer)
+{
+    uint32_t ch;
+    NARUApiResult ret;
+
+    /* 内部関数なので不正な引数はアサートで落とす */
+    NARU_ASSERT(encoder != NULL);
+    NARU_ASSERT(analysis != NULL);
+
+    /* 入力のコピーとマルチチャンネル処理 */
+    if ((ret = NARUEncoder_CopyInputToBuffer(encoder, input, num_samples, buffer)) != NARU_APIRESULT_OK) {
+        return ret;
+    }
+
+    /* AR係数の設定 */
+    for (ch = 0; ch < encoder->header.num_channels; ch++) {
+        NARUEncodeProcessor_SetARCoef(encoder->processor[ch], analysis->ar_coef[ch]);
+    }
+
+    return NARU_APIRESULT_OK;
+}
+
+/* 残差をrANS符号化してサイズ表とサブストリームを一時出力先に書き込む
+* 補足）max_sizeより小さく収まらなければNARU_APIRESULT_INSUFFICIENT_BUFFERを返す */
+static NARUApiResult NARUEncoder_EncodeResidualRANS(
+        struct NARUEncoder *encoder, const int32_t *const *residual, uint32_t num_samples,
+        uint32_t max_size, uint32_t *output_size)
+{
+    uint32_t ch, write_offset, buffer_size;
+    uint8_t *size_table_ptr;
+    const struct NARUHeader *header;
+
+    /* 内部関数なので不正な引数はアサートで落とす */
+    NARU_ASSERT(encoder != NULL);
+    NARU_ASSERT(residual != NULL);
+    NARU_ASSERT(max_size > 0);
+    NARU_ASSERT(output_size != NULL);
+
+    header = &(encoder->header);
+
+    /* 出力サイズの上限: 元の符号より小さく、かつ一時出力先に収まる
+    * 補足）コンフィグによらず同じ出力になるよう、一時出力先のサイズは現在のブロックから計算 */
+    buffer_size = (uint32_t)NARUENCODER_CALCULATE_RANS_BUFFER_SIZE(header->num_channels, num_samples);
+    buffer_size = NARUUTILITY_MIN(buffer_size, max_size - 1);
+
+    size_table_ptr = encoder->rans_buffer;
+    write_offset = NARU_BLOCK_SUBSTREAM_SIZE_BYTES * (header->num_channels - 1U);
+    for (ch = 0; ch < header->num_channels; ch++) {
+        uint32_t substream_size;
+
+        if (write_offset >= buffer_size) {
+            return NARU_APIRESULT_INSUFFICIENT_BUFFER;
+        }
+
+        /* 残差符号化 */
+        if (NARUCoder_PutChannelDataArrayRANS(encoder->coder, ch, residual[ch], num_samples,
+                    encoder->rans_work, &encoder->rans_buffer[write_offset], buffer_size - write_offset,
+                    &substream_size) != NARU_ERROR_OK) {
+            return NARU_APIRESULT_INSUFFICIENT_BUFFER;
+        }
+
+        /* サイズ表に記録 */
+        if (ch < (header->num_channels - 1U)) {
+            ByteArray_PutUint32BE(size_table_ptr, substream_size);
+        }
+        write_offset += substream_size;
+    }
+
+    (*output_size) = write_offset;
+
+    return NARU_APIRESULT_OK;
+}
+
 /* 圧縮データブロックエンコード */
 static NARUApiResult NARUEncoder_EncodeCompressData(
-        struct NARUEncoder *encoder,
+        struct NARUEncoder *encoder, const struct NARUBlockAnalysis *analysis,
         const int32_t *const *input, uint32_t num_samples,
-        uint8_t *data, uint32_t data_size, uint32_t *output_size)
+        uint8_t *data, uint32_t data_size, uint32_t *output_size, NARUBlockDataType *block_type)
 {
-    uint32_t ch;
+    uint32_t ch, write_offset, residual_offset;
+    uint8_t *size_table_ptr;
     struct NARUBitStream stream;
     int32_t *buffer[NARU_MAX_NUM_CHANNELS];
     const struct NARUHeader *header;
+    NARUApiResult ret;
 
     /* 内部関数なので不正な引数はアサートで落とす */
     NARU_ASSERT(encoder != NULL);
@@ -555,37 +1024,13 @@ static NARUApiResult NARUEncoder_EncodeCompressData(
     NARU_ASSERT(data != NULL);
     NARU_ASSERT(data_size > 0);
     NARU_ASSERT(output_size != NULL);
+    NARU_ASSERT(block_type != NULL);
 
     header = &(encoder->header);
 
-    /* 入力をバッファにコピー */
-    for (ch = 0; ch < header->num_channels; ch++) {
-        /* ポインタ取得 */
-        buffer[ch] = encoder->buffer[ch];
-        memcpy(buffer[ch], input[ch], sizeof(int32_t) * num_samples);
-    }
-
-    /* マルチチャンネル処理 */
-    if (header->ch_process_method == NARU_CH_PROCESS_METHOD_MS) {
-        /* チャンネル数チェック */
-        if (header->num_channels < 2) {
-            return NARU_APIRESULT_INVALID_FORMAT;
-        }
-        /* LR -> MS */
-        NARUUtility_LRtoMSInt32(buffer, num_samples);
-    }
-
-    /* 窓作成 */
-    NARUUtility_MakeSinWindow(encoder->window, num_samples);
-
-    /* チャンネル毎にパラメータ計算 */
-    for (ch = 0; ch < header->num_channels; ch++) {
-        /* 解析用double信号生成 */
-        NARUEncoder_MakeAnalyzingSignal(encoder->window,
-                buffer[ch], num_samples, header->bits_per_sample, encoder->buffer_double);
-        /* AR係数計算 */
-        NARUEncodeProcessor_CalculateARCoef(encoder->processor[ch],
-                encoder->lpcc, encoder->buffer_double, num_samples);
+    /* 予測前処理 */
+    if ((ret = NARUEncoder_PrepareCompressData(encoder, analysis, input, num_samples, buffer)) != NARU_APIRESULT_OK) {
+        return ret;
     }
 
     /* ビットライタ作成 */
@@ -596,10 +1041,9 @@ static NARUApiResult NARUEncoder_EncodeCompressData(
         NARUEncodeProcessor_PutFilterState(encoder->processor[ch], &stream);
     }
 
-    /* チャンネル毎に予測 */
-    for (ch = 0; ch < header->num_channels; ch++) {
-        NARUEncodeProcessor_Predict(encoder->processor[ch], buffer[ch], num_samples);
-    }
+    /* 全チャンネルの予測 */
+    NARUEncodeProcessor_PredictMultiChannel(
+            encoder->processor, encoder->lanes, buffer, header->num_channels, num_samples);
 
     /* 符号化初期パラメータ計算 */
     NARUCoder_CalculateInitialRecursiveRiceParameter(encoder->coder,
@@ -612,38 +1056,76 @@ static NARUApiResult NARUEncoder_EncodeCompressData(
                 &stream, NARUCODER_NUM_RECURSIVERICE_PARAMETER, ch);
     }
 
-    /* 残差符号化 */
-    NARUCoder_PutDataArray(encoder->coder, &stream,
-            NARUCODER_NUM_RECURSIVERICE_PARAMETER,
-            (const int32_t **)buffer, header->num_channels, num_samples);
-
     /* バイト境界に揃える */
     NARUBitStream_Flush(&stream);
 
     /* 書き込みサイズの取得 */
-    NARUBitStream_Tell(&stream, (int32_t *)output_size);
+    NARUBitStream_Tell(&stream, (int32_t *)&write_offset);
 
     /* ビットライタ破棄 */
     NARUBitStream_Close(&stream);
 
-    return NARU_APIRESULT_OK;
-}
+    /* 残差はチャンネル毎にバイト境界から始まるサブストリームに符号化
+    * 先頭にサブストリームのサイズ表を置く（末尾チャンネルのサイズはブロックサイズから決まるので省く） */
+    residual_offset = write_offset;
+    size_table_ptr = &data[write_offset];
+    write_offset += NARU_BLOCK_SUBSTREAM_SIZE_BYTES * (header->num_channels - 1U);
+    for (ch = 0; ch < header->num_channels; ch++) {
+        uint32_t substream_size;
 
-/* 単一データブロックエンコード */
-static NARUApiResult NARUEncoder_EncodeBlock(
-        struct NARUEncoder *encoder,
+        /* 書き込み先のバッファサイズチェック */
+        if (write_offset >= data_size) {
+            return NARU_APIRESULT_INSUFFICIENT_BUFFER;
+        }
+
+        /* 残差符号化 */
+        NARUBitWriter_Open(&stream, &data[write_offset], data_size - write_offset);
+        NARUCoder_PutChannelDataArray(encoder->coder, &stream,
+                NARUCODER_NUM_RECURSIVERICE_PARAMETER, ch, buffer[ch], num_samples);
+        NARUBitStream_Flush(&stream);
+        NARUBitStream_Tell(&stream, (int32_t *)&substream_size);
+        NARUBitStream_Close(&stream);
+
+        /* サイズ表に記録 */
+        if (ch < (header->num_channels - 1U)) {
+            ByteArray_PutUint32BE(size_table_ptr, substream_size);
+        }
+        write_offset += substream_size;
+    }
+    (*block_type) = NARU_BLOCK_DATA_TYPE_COMPRESSDATA;
+
+    /* rANS符号化した方が小さくなるならば置き換える */
+    if (encoder->use_rans == 1) {
+        uint32_t rans_size;
+        if (NARUEncoder_EncodeResidualRANS(encoder, (const int32_t **)buffer, num_samples,
+                    write_offset - residual_offset, &rans_size) == NARU_APIRESULT_OK) {
+            memcpy(&data[residual_offset], encoder->rans_buffer, rans_size);
+            write_offset = residual_offset + rans_size;
+            (*block_type) = NARU_BLOCK_DATA_TYPE_COMPRESSDATA_RANS;
+        }
+    }
+
+    /* 書き込みサイズ */
+    (*output_size) = write_offset;
+
+    return NARU_APIRESULT_OK;
+}
+
+/* 解析済みの単一データブロックエンコード */
+static NARUApiResult NARUEncoder_EncodeBlock(
+        struct NARUEncoder *encoder, const struct NARUBlockAnalysis *analysis,
         const int32_t *const *input, uint32_t num_samples,
         uint8_t *data, uint32_t data_size, uint32_t *output_size)
 {
     uint8_t *data_ptr;
     const struct NARUHeader *header;
-    NARUBlockDataType block_type;
     NARUApiResult ret;
-    uint32_t block_header_size, block_data_size;
+    uint32_t block_header_size, block_data_size, checksum_size;
 
     /* 引数チェック */
     if ((encoder == NULL) || (input == NULL) || (num_samples == 0)
-            || (data == NULL) || (data_size == 0) || (output_size == NULL)) {
+            || (data == NULL) || (data_size == 0) || (output_size == NULL)
+            || (analysis == NULL) || (analysis->block_type >= NARU_BLOCK_DATA_TYPE_INVALID)) {
         return NARU_APIRESULT_INVALID_ARGUMENT;
     }
     header = &(encoder->header);
@@ -658,20 +1140,21 @@ static NARUApiResult NARUEncoder_EncodeBlock(
         return NARU_APIRESULT_INSUFFICIENT_BUFFER;
     }
 
-    /* 圧縮手法の判定 */
-    block_type = NARUEncoder_DecideBlockDataType(encoder, input, num_samples);
-    NARU_ASSERT(block_type != NARU_BLOCK_DATA_TYPE_INVALID);
-
     /* ブロックヘッダをエンコード */
     data_ptr = data;
+    checksum_size = NARU_BLOCK_CHECKSUM_SIZE(header->block_checksum_type);
     /* ブロック先頭の同期コード */
     ByteArray_PutUint16BE(data_ptr, NARU_BLOCK_SYNC_CODE);
     /* ブロックサイズ: 仮値で埋めておく */
     ByteArray_PutUint32BE(data_ptr, 0);
-    /* ブロックCRC16: 仮値で埋めておく */
-    ByteArray_PutUint16BE(data_ptr, 0);
+    /* ブロックチェックサム: 仮値で埋めておく */
+    if (checksum_size == 4) {
+        ByteArray_PutUint32BE(data_ptr, 0);
+    } else {
+        ByteArray_PutUint16BE(data_ptr, 0);
+    }
     /* ブロックデータタイプ */
-    ByteArray_PutUint8(data_ptr, block_type);
+    ByteArray_PutUint8(data_ptr, analysis->block_type);
     /* ブロックチャンネルあたりサンプル数 */
     ByteArray_PutUint16BE(data_ptr, num_samples);
     /* ブロックヘッダサイズ */
@@ -679,14 +1162,19 @@ static NARUApiResult NARUEncoder_EncodeBlock(
 
     /* データ部のエンコード */
     /* 手法によりエンコードする関数を呼び分け */
-    switch (block_type) {
+    switch (analysis->block_type) {
     case NARU_BLOCK_DATA_TYPE_RAWDATA:
         ret = NARUEncoder_EncodeRawData(encoder, input, num_samples,
                 data_ptr, data_size - block_header_size, &block_data_size);
         break;
     case NARU_BLOCK_DATA_TYPE_COMPRESSDATA:
-        ret = NARUEncoder_EncodeCompressData(encoder, input, num_samples,
-                data_ptr, data_size - block_header_size, &block_data_size);
+        {
+            /* 残差の符号化法によりデータタイプが変わるので書き直す */
+            NARUBlockDataType block_type = NARU_BLOCK_DATA_TYPE_COMPRESSDATA;
+            ret = NARUEncoder_EncodeCompressData(encoder, analysis, input, num_samples,
+                    data_ptr, data_size - block_header_size, &block_data_size, &block_type);
+            ByteArray_WriteUint8(&data[6 + checksum_size], (uint8_t)block_type);
+        }
         break;
     default:
         ret = NARU_APIRESULT_INVALID_FORMAT;
@@ -699,13 +1187,16 @@ static NARUApiResult NARUEncoder_EncodeBlock(
     }
 
     /* ブロックサイズ書き込み:
-    * CRC16(2byte) + ブロックチャンネルあたりサンプル数(2byte) + ブロックデータタイプ(1byte) */
-    ByteArray_WriteUint32BE(&data[2], block_data_size + 5);
-
-    /* CRC16の領域以降のCRC16を計算し書き込み */
-    {
-        /* ブロックチャンネルあたりサンプル数(2byte) + ブロックデータタイプ(1byte) を加算 */
-        const uint16_t crc16 = NARUUtility_CalculateCRC16(&data[8], block_data_size + 3);
+    * チェックサム + ブロックチャンネルあたりサンプル数(2byte) + ブロックデータタイプ(1byte) */
+    ByteArray_WriteUint32BE(&data[2], block_data_size + checksum_size + 3);
+
+    /* チェックサムの領域以降のチェックサムを計算し書き込み */
+    /* ブロックチャンネルあたりサンプル数(2byte) + ブロックデータタイプ(1byte) を加算 */
+    if (header->block_checksum_type == NARU_BLOCK_CHECKSUM_TYPE_CRC32C) {
+        const uint32_t crc32c = encoder->crc32c(&data[10], block_data_size + 3);
+        ByteArray_WriteUint32BE(&data[6], crc32c);
+    } else {
+        const uint16_t crc16 = encoder->crc16(&data[8], block_data_size + 3);
         ByteArray_WriteUint16BE(&data[6], crc16);
     }
 
@@ -716,6 +1207,370 @@ static NARUApiResult NARUEncoder_EncodeBlock(
     return NARU_APIRESULT_OK;
 }
 
+/* 出力を捨てる試行向けに、予測のみ行ってフィルタ状態を進める
+* 補足）NARUEncoder_EncodeBlockと同一のフィルタ状態になるが、ブロックヘッダ・残差符号化・CRCは省く */
+static NARUApiResult NARUEncoder_WarmUpBlock(
+        struct NARUEncoder *encoder, const struct NARUBlockAnalysis *analysis,
+        const int32_t *const *input, uint32_t num_samples)
+{
+    uint32_t ch;
+    int32_t *buffer[NARU_MAX_NUM_CHANNELS];
+    const struct NARUHeader *header;
+    NARUApiResult ret;
+
+    /* 内部関数なので不正な引数はアサートで落とす */
+    NARU_ASSERT(encoder != NULL);
+    NARU_ASSERT(input != NULL);
+    NARU_ASSERT(num_samples > 0);
+    NARU_ASSERT(analysis != NULL);
+    NARU_ASSERT(analysis->block_type != NARU_BLOCK_DATA_TYPE_INVALID);
+
+    header = &(encoder->header);
+
+    /* 圧縮データ以外はフィルタ状態に影響しない */
+    if (analysis->block_type != NARU_BLOCK_DATA_TYPE_COMPRESSDATA) {
+        return NARU_APIRESULT_OK;
+    }
+
+    /* 予測前処理 */
+    if ((ret = NARUEncoder_PrepareCompressData(encoder, analysis, input, num_samples, buffer)) != NARU_APIRESULT_OK) {
+        return ret;
+    }
+
+    /* 状態出力時と同じ丸めを適用 */
+    for (ch = 0; ch < header->num_channels; ch++) {
+        NARUEncodeProcessor_QuantizeFilterState(encoder->processor[ch]);
+    }
+
+    /* 全チャンネルの予測 */
+    NARUEncodeProcessor_PredictMultiChannel(
+            encoder->processor, encoder->lanes, buffer, header->num_channels, num_samples);
+
+    return NARU_APIRESULT_OK;
+}
+
+/* 直前ブロックと共に繰り返して時系列順に単一データブロックエンコード
+* 補足）prev_inputは直前の呼び出しでエンコードしたブロック（先頭ブロックではNULL）で、解析結果は直前の呼び出しのものを使う
+*       最終回以外の試行は出力を捨てるため、フィルタ状態を進めるだけにする */
+static NARUApiResult NARUEncoder_EncodeSequentialBlock(
+        struct NARUEncoder *encoder,
+        const int32_t *const *prev_input, uint32_t prev_num_samples,
+        const int32_t *const *input, uint32_t num_samples,
+        uint8_t *data, uint32_t data_size, uint32_t *output_size)
+{
+    NARUApiResult ret;
+    uint8_t trial;
+
+    /* 内部関数なので不正な引数はアサートで落とす */
+    NARU_ASSERT(encoder != NULL);
+    NARU_ASSERT(input != NULL);
+    NARU_ASSERT(encoder->num_encode_trials > 0);
+
+    /* 解析結果は入力のみで決まるので1回だけ計算 */
+    if ((ret = NARUEncoder_AnalyzeBlock(encoder, input, num_samples, &encoder->analysis)) != NARU_APIRESULT_OK) {
+        return ret;
+    }
+
+    for (trial = 0; trial < encoder->num_encode_trials; trial++) {
+        if (prev_input != NULL) {
+            if ((ret = NARUEncoder_WarmUpBlock(encoder,
+                            &encoder->prev_analysis, prev_input, prev_num_samples)) != NARU_APIRESULT_OK) {
+                return ret;
+            }
+        }
+        if (trial < (encoder->num_encode_trials - 1)) {
+            ret = NARUEncoder_WarmUpBlock(encoder, &encoder->analysis, input, num_samples);
+        } else {
+            ret = NARUEncoder_EncodeBlock(encoder, &encoder->analysis, input, num_samples, data, data_size, output_size);
+        }
+        if (ret != NARU_APIRESULT_OK) {
+            return ret;
+        }
+    }
+
+    /* 次のブロックの直前ブロックとして解析結果を引き継ぐ */
+    encoder->prev_analysis = encoder->analysis;
+
+    return NARU_APIRESULT_OK;
+}
+
+/* 先行サンプルでフィルタを慣らした上で単一データブロックエンコード */
+static NARUApiResult NARUEncoder_EncodeBlockWithPreroll(
+        struct NARUEncoder *encoder,
+        const int32_t *const *input, uint32_t block_offset, uint32_t num_samples,
+        uint8_t *data, uint32_t data_size, uint32_t *output_size)
+{
+    NARUApiResult ret;
+    uint32_t ch, preroll_offset, progress, num_encode_samples;
+    uint8_t trial, reuse_preroll_analysis;
+    const int32_t *input_ptr[NARU_MAX_NUM_CHANNELS];
+    const int32_t *preroll_ptr[NARU_MAX_NUM_CHANNELS];
+    const struct NARUHeader *header;
+
+    /* 内部関数なので不正な引数はアサートで落とす */
+    NARU_ASSERT(encoder != NULL);
+    NARU_ASSERT(input != NULL);
+    NARU_ASSERT(num_samples > 0);
+    NARU_ASSERT(data != NULL);
+    NARU_ASSERT(output_size != NULL);
+
+    header = &(encoder->header);
+
+    /* フィルタ状態を初期化し、直前のブロックに依存しないようにする */
+    for (ch = 0; ch < header->num_channels; ch++) {
+        NARUEncodeProcessor_Reset(encoder->processor[ch]);
+        NARUEncodeProcessor_SetFilterOrder(encoder->processor[ch],
+                header->filter_order, header->ar_order, header->second_filter_order);
+    }
+
+    /* 先行サンプルの開始位置 */
+    preroll_offset = block_offset - NARUUTILITY_MIN(block_offset, encoder->num_preroll_samples);
+
+    /* 先行サンプルが1ブロックに収まるときは、その解析結果を試行間で使い回す */
+    reuse_preroll_analysis = ((block_offset - preroll_offset) <= header->max_num_samples_per_block) ? 1 : 0;
+
+    /* 対象ブロックの解析 */
+    for (ch = 0; ch < header->num_channels; ch++) {
+        input_ptr[ch] = &input[ch][block_offset];
+    }
+    if ((ret = NARUEncoder_AnalyzeBlock(encoder, input_ptr, num_samples, &encoder->analysis)) != NARU_APIRESULT_OK) {
+        return ret;
+    }
+
+    /* ブロックエンコード フィルタの収束を早めるため繰り返す */
+    for (trial = 0; trial < encoder->num_encode_trials; trial++) {
+        /* 先行サンプルをエンコードしてフィルタを慣らす（出力は捨てる）
+        * 補足）逐次エンコードと揃えるため、端数は先頭で処理して直前はブロック長で区切る */
+        progress = preroll_offset;
+        while (progress < block_offset) {
+            num_encode_samples = (block_offset - progress) % header->max_num_samples_per_block;
+            if (num_encode_samples == 0) {
+                num_encode_samples = header->max_num_samples_per_block;
+            }
+            for (ch = 0; ch < header->num_channels; ch++) {
+                preroll_ptr[ch] = &input[ch][progress];
+            }
+            if ((trial == 0) || (reuse_preroll_analysis == 0)) {
+                if ((ret = NARUEncoder_AnalyzeBlock(encoder,
+                                preroll_ptr, num_encode_samples, &encoder->prev_analysis)) != NARU_APIRESULT_OK) {
+                    return ret;
+                }
+            }
+            if ((ret = NARUEncoder_WarmUpBlock(encoder,
+                            &encoder->prev_analysis, preroll_ptr, num_encode_samples)) != NARU_APIRESULT_OK) {
+                return ret;
+            }
+            progress += num_encode_samples;
+        }
+        /* 対象ブロックのエンコード 最終回以外は出力を捨てるので予測のみ */
+        if (trial < (encoder->num_encode_trials - 1)) {
+            ret = NARUEncoder_WarmUpBlock(encoder, &encoder->analysis, input_ptr, num_samples);
+        } else {
+            ret = NARUEncoder_EncodeBlock(encoder, &encoder->analysis, input_ptr, num_samples, data, data_size, output_size);
+        }
+        if (ret != NARU_APIRESULT_OK) {
+            return ret;
+        }
+    }
+
+    return NARU_APIRESULT_OK;
+}
+
+/* ブロック独立にデータブロック列をエンコード */
+static NARUApiResult NARUEncoder_EncodeBlocksIndependently(
+        struct NARUEncoder *encoder,
+        const int32_t *const *input, uint32_t num_samples,
+        uint8_t *data, uint32_t data_size, uint32_t *output_size)
+{
+    uint32_t num_blocks, block, write_offset, thrd;
+    int32_t num_batch_blocks, i;
+    const struct NARUHeader *header;
+
+    /* 内部関数なので不正な引数はアサートで落とす */
+    NARU_ASSERT(encoder != NULL);
+    NARU_ASSERT(input != NULL);
+    NARU_ASSERT(data != NULL);
+    NARU_ASSERT(output_size != NULL);
+    NARU_ASSERT(encoder->num_preroll_samples > 0);
+
+    header = &(encoder->header);
+
+    /* 総ブロック数 */
+    num_blocks = (num_samples + header->max_num_samples_per_block - 1) / header->max_num_samples_per_block;
+
+    /* スレッド数分のブロックをまとめてエンコード
+    * 補足）各ブロックの結果は入力のみで決まるため、出力はスレッド数に依存しない */
+    write_offset = 0;
+    for (block = 0; block < num_blocks; block += encoder->num_threads) {
+        num_batch_blocks = (int32_t)NARUUTILITY_MIN(encoder->num_threads, num_blocks - block);
+
+        /* 先頭のワーカーは出力先に直接書き込む */
+        encoder->worker[0].buffer = &data[write_offset];
+        encoder->worker[0].buffer_size = data_size - write_offset;
+
+#if defined(_OPENMP)
+#pragma omp parallel for num_threads(num_batch_blocks) schedule(static, 1)
+#endif
+        for (i = 0; i < num_batch_blocks; i++) {
+            struct NARUEncodeWorker *worker = &encoder->worker[i];
+            const uint32_t block_offset = (block + (uint32_t)i) * header->max_num_samples_per_block;
+            worker->result = NARUEncoder_EncodeBlockWithPreroll(worker->encoder, input, block_offset,
+                    NARUUTILITY_MIN(header->max_num_samples_per_block, num_samples - block_offset),
+                    worker->buffer, worker->buffer_size, &worker->output_size);
+        }
+
+        /* 結果をブロック順に連結 */
+        for (thrd = 0; thrd < (uint32_t)num_batch_blocks; thrd++) {
+            struct NARUEncodeWorker *worker = &encoder->worker[thrd];
+            if (worker->result != NARU_APIRESULT_OK) {
+                return worker->result;
+            }
+            if (thrd > 0) {
+                if (worker->output_size > (data_size - write_offset)) {
+                    return NARU_APIRESULT_INSUFFICIENT_BUFFER;
+                }
+                memcpy(&data[write_offset], worker->buffer, worker->output_size);
+            }
+            write_offset += worker->output_size;
+        }
+    }
+
+    /* ワーカーの出力先を無効化 */
+    encoder->worker[0].buffer = NULL;
+    encoder->worker[0].buffer_size = 0;
+
+    (*output_size) = write_offset;
+    return NARU_APIRESULT_OK;
+}
+
+/* シークテーブルの初期化 */
+static void NARUEncoder_ResetSeekTable(struct NARUEncoder *encoder)
+{
+    NARU_ASSERT(encoder != NULL);
+
+    encoder->num_seek_points = 0;
+    encoder->seek_point_interval = 1;
+    encoder->num_seek_blocks = 0;
+}
+
+/* シークテーブルにブロックの位置を追加 */
+static NARUApiResult NARUEncoder_AddSeekPoint(struct NARUEncoder *encoder, uint32_t sample_offset, uint64_t byte_offset)
+{
+    uint8_t *points;
+
+    /* 内部関数なので不正な引数はアサートで落とす */
+    NARU_ASSERT(encoder != NULL);
+    NARU_ASSERT(encoder->seek_table != NULL);
+
+    /* シークポイントはブロック先頭のバイト位置を32bitで記録する */
+    if (byte_offset > 0xFFFFFFFFUL) {
+        return NARU_APIRESULT_INVALID_FORMAT;
+    }
+
+    /* シークポイントはブロックヘッダとシークポイント数の直後から並べる */
+    points = &encoder->seek_table[NARU_BLOCK_HEADER_SIZE_FOR_CHECKSUM(encoder->header.block_checksum_type) + 4];
+
+    if ((encoder->num_seek_blocks % encoder->seek_point_interval) == 0) {
+        /* 一杯になったら1つおきに間引いてブロック間隔を倍にする */
+        if (encoder->num_seek_points == NARUENCODER_MAX_NUM_SEEK_POINTS) {
+            uint32_t i;
+            for (i = 1; i < NARUENCODER_MAX_NUM_SEEK_POINTS / 2; i++) {
+                memcpy(&points[NARU_SEEKPOINT_SIZE * i], &points[NARU_SEEKPOINT_SIZE * 2 * i], NARU_SEEKPOINT_SIZE);
+            }
+            encoder->num_seek_points = NARUENCODER_MAX_NUM_SEEK_POINTS / 2;
+            encoder->seek_point_interval *= 2;
+        }
+        if ((encoder->num_seek_blocks % encoder->seek_point_interval) == 0) {
+            uint8_t *point = &points[NARU_SEEKPOINT_SIZE * encoder->num_seek_points];
+            ByteArray_PutUint32BE(point, sample_offset);
+            ByteArray_PutUint32BE(point, (uint32_t)byte_offset);
+            encoder->num_seek_points++;
+        }
+    }
+    encoder->num_seek_blocks++;
+
+    return NARU_APIRESULT_OK;
+}
+
+/* シークテーブルブロックを完成させてサイズを返す */
+static uint32_t NARUEncoder_FinishSeekTable(struct NARUEncoder *encoder)
+{
+    uint8_t *data_ptr;
+    uint32_t table_size, checksum_size;
+    const struct NARUHeader *header;
+
+    /* 内部関数なので不正な引数はアサートで落とす */
+    NARU_ASSERT(encoder != NULL);
+    NARU_ASSERT(encoder->seek_table != NULL);
+
+    header = &(encoder->header);
+    checksum_size = NARU_BLOCK_CHECKSUM_SIZE(header->block_checksum_type);
+    table_size = NARU_SEEKTABLE_BLOCK_SIZE(header->block_checksum_type, encoder->num_seek_points);
+
+    /* ブロックヘッダ: サンプルを含まないのでサンプル数は0 */
+    data_ptr = encoder->seek_table;
+    ByteArray_PutUint16BE(data_ptr, NARU_BLOCK_SYNC_CODE);
+    ByteArray_PutUint32BE(data_ptr, table_size - 6);
+    data_ptr += checksum_size;
+    ByteArray_PutUint8(data_ptr, NARU_BLOCK_DATA_TYPE_SEEKTABLE);
+    ByteArray_PutUint16BE(data_ptr, 0);
+    /* シークポイント数 */
+    ByteArray_PutUint32BE(data_ptr, encoder->num_seek_points);
+    /* シークポイントの後ろに自身のサイズを置き、データ末尾から辿れるようにする */
+    data_ptr += NARU_SEEKPOINT_SIZE * encoder->num_seek_points;
+    ByteArray_PutUint32BE(data_ptr, table_size);
+    NARU_ASSERT((uint32_t)(data_ptr - encoder->seek_table) == table_size);
+
+    /* チェックサムの領域以降のチェックサムを計算し書き込み */
+    if (header->block_checksum_type == NARU_BLOCK_CHECKSUM_TYPE_CRC32C) {
+        const uint32_t crc32c = encoder->crc32c(&encoder->seek_table[10], table_size - 10);
+        ByteArray_WriteUint32BE(&encoder->seek_table[6], crc32c);
+    } else {
+        const uint16_t crc16 = encoder->crc16(&encoder->seek_table[8], table_size - 8);
+        ByteArray_WriteUint16BE(&encoder->seek_table[6], crc16);
+    }
+
+    return table_size;
+}
+
+/* 出力済みのブロックを辿ってシークテーブルを作成し、末尾に付加 */
+static NARUApiResult NARUEncoder_AppendSeekTable(
+        struct NARUEncoder *encoder, uint8_t *data, uint32_t data_size, uint32_t *output_size)
+{
+    NARUApiResult ret;
+    uint32_t read_offset, progress, table_size, checksum_size;
+
+    /* 内部関数なので不正な引数はアサートで落とす */
+    NARU_ASSERT(encoder != NULL);
+    NARU_ASSERT(data != NULL);
+    NARU_ASSERT(output_size != NULL);
+
+    checksum_size = NARU_BLOCK_CHECKSUM_SIZE(encoder->header.block_checksum_type);
+
+    /* ヘッダ直後のブロックから、ブロックサイズとサンプル数を読んで辿る */
+    NARUEncoder_ResetSeekTable(encoder);
+    progress = 0;
+    read_offset = NARU_HEADER_SIZE;
+    while (read_offset < (*output_size)) {
+        if ((ret = NARUEncoder_AddSeekPoint(encoder, progress, read_offset)) != NARU_APIRESULT_OK) {
+            return ret;
+        }
+        progress += ByteArray_ReadUint16BE(&data[read_offset + 6 + checksum_size + 1]);
+        read_offset += ByteArray_ReadUint32BE(&data[read_offset + 2]) + 6;
+    }
+    NARU_ASSERT(read_offset == (*output_size));
+
+    /* 出力先に付加 */
+    table_size = NARUEncoder_FinishSeekTable(encoder);
+    if (table_size > (data_size - (*output_size))) {
+        return NARU_APIRESULT_INSUFFICIENT_BUFFER;
+    }
+    memcpy(&data[*output_size], encoder->seek_table, table_size);
+    (*output_size) += table_size;
+
+    return NARU_APIRESULT_OK;
+}
+
 /* ヘッダ含めファイル全体をエンコード */
 NARUApiResult NARUEncoder_EncodeWhole(
         struct NARUEncoder *encoder,
@@ -726,7 +1581,6 @@ NARUApiResult NARUEncoder_EncodeWhole(
     uint32_t progress, ch, write_size, write_offset;
     uint32_t prev_num_encode_samples, num_encode_samples;
     uint8_t *data_pos;
-    uint8_t trial;
     const int32_t *input_ptr[NARU_MAX_NUM_CHANNELS];
     const int32_t *prev_input_ptr[NARU_MAX_NUM_CHANNELS];
     const struct NARUHeader *header;
@@ -753,8 +1607,25 @@ NARUApiResult NARUEncoder_EncodeWhole(
     }
     header = &(encoder->header);
 
+    /* ブロック独立エンコード */
+    if (encoder->num_preroll_samples > 0) {
+        if ((ret = NARUEncoder_EncodeBlocksIndependently(encoder, input, num_samples,
+                        data + NARU_HEADER_SIZE, data_size - NARU_HEADER_SIZE, &write_size)) != NARU_APIRESULT_OK) {
+            return ret;
+        }
+        write_offset = NARU_HEADER_SIZE + write_size;
+        if (header->has_seek_table == 1) {
+            if ((ret = NARUEncoder_AppendSeekTable(encoder, data, data_size, &write_offset)) != NARU_APIRESULT_OK) {
+                return ret;
+            }
+        }
+        (*output_size) = write_offset;
+        return NARU_APIRESULT_OK;
+    }
+
     /* 進捗状況初期化 */
     progress = 0;
+    prev_num_encode_samples = 0;
     write_offset = NARU_HEADER_SIZE;
     data_pos = data + NARU_HEADER_SIZE;
 
@@ -769,28 +1640,11 @@ NARUApiResult NARUEncoder_EncodeWhole(
         }
 
         /* ブロックエンコード フィルタの収束を早めるため繰り返す */
-        if (progress < header->max_num_samples_per_block) {
-            for (trial = 0; trial < encoder->num_encode_trials; trial++) {
-                if ((ret = NARUEncoder_EncodeBlock(encoder,
-                                input_ptr, num_encode_samples,
-                                data_pos, data_size - write_offset, &write_size)) != NARU_APIRESULT_OK) {
-                    return ret;
-                }
-            }
-        } else {
-            /* progress >= header->num_samples_per_block */
-            for (trial = 0; trial < encoder->num_encode_trials; trial++) {
-                if ((ret = NARUEncoder_EncodeBlock(encoder,
-                                prev_input_ptr, prev_num_encode_samples,
-                                data_pos, data_size - write_offset, &write_size)) != NARU_APIRESULT_OK) {
-                    return ret;
-                }
-                if ((ret = NARUEncoder_EncodeBlock(encoder,
-                                input_ptr, num_encode_samples,
-                                data_pos, data_size - write_offset, &write_size)) != NARU_APIRESULT_OK) {
-                    return ret;
-                }
-            }
+        if ((ret = NARUEncoder_EncodeSequentialBlock(encoder,
+                        (progress < header->max_num_samples_per_block) ? NULL : prev_input_ptr, prev_num_encode_samples,
+                        input_ptr, num_encode_samples,
+                        data_pos, data_size - write_offset, &write_size)) != NARU_APIRESULT_OK) {
+            return ret;
         }
 
         /* 進捗更新 */
@@ -806,7 +1660,254 @@ NARUApiResult NARUEncoder_EncodeWhole(
         prev_num_encode_samples = num_encode_samples;
     }
 
+    /* 全ブロックの後ろにシークテーブルを付加 */
+    if (header->has_seek_table == 1) {
+        if ((ret = NARUEncoder_AppendSeekTable(encoder, data, data_size, &write_offset)) != NARU_APIRESULT_OK) {
+            return ret;
+        }
+    }
+
     /* 成功終了 */
     (*output_size) = write_offset;
     return NARU_APIRESULT_OK;
 }
+
+/* ストリーミングエンコードの開始 */
+NARUApiResult NARUEncoder_BeginStreaming(
+        struct NARUEncoder *encoder,
+        uint8_t *data, uint32_t data_size,
+        NARUEncoderWriteCallback callback, void *user_data)
+{
+    uint32_t ch;
+    NARUApiResult ret;
+    struct NARUHeader *header;
+
+    /* 引数チェック */
+    if ((encoder == NULL) || (data == NULL) || (callback == NULL)) {
+        return NARU_APIRESULT_INVALID_ARGUMENT;
+    }
+
+    /* パラメータがセットされてない */
+    if (encoder->set_parameter != 1) {
+        return NARU_APIRESULT_PARAMETER_NOT_SET;
+    }
+    header = &(encoder->header);
+
+    /* ストリーミング入力バッファを確保していない */
+    if (encoder->stream_buffer == NULL) {
+        return NARU_APIRESULT_INSUFFICIENT_BUFFER;
+    }
+
+    /* 出力先に1ブロックが収まらない */
+    if (data_size < NARUENCODER_CALCULATE_MAX_BLOCK_SIZE(header->num_channels, header->max_num_samples_per_block)) {
+        return NARU_APIRESULT_INSUFFICIENT_BUFFER;
+    }
+
+    /* 先行サンプルとして保持できるのは直前の1ブロック分のみ */
+    if (encoder->num_preroll_samples > header->max_num_samples_per_block) {
+        return NARU_APIRESULT_INVALID_FORMAT;
+    }
+
+    /* フィルタ状態を初期化し、以前のエンコードに依存しないようにする */
+    for (ch = 0; ch < header->num_channels; ch++) {
+        NARUEncodeProcessor_Reset(encoder->processor[ch]);
+        NARUEncodeProcessor_SetFilterOrder(encoder->processor[ch],
+                header->filter_order, header->ar_order, header->second_filter_order);
+    }
+
+    /* 総サンプル数未確定のヘッダを出力 */
+    header->num_samples = NARU_UNDETERMINED_NUM_SAMPLES;
+    if ((ret = NARUEncoder_EncodeHeader(header, data, data_size)) != NARU_APIRESULT_OK) {
+        return ret;
+    }
+    if ((ret = callback(data, NARU_HEADER_SIZE, user_data)) != NARU_APIRESULT_OK) {
+        return ret;
+    }
+
+    /* ストリーミング状態の初期化 */
+    encoder->stream_num_buffered_samples = 0;
+    encoder->stream_num_encoded_samples = 0;
+    encoder->stream_data = data;
+    encoder->stream_data_size = data_size;
+    encoder->stream_callback = callback;
+    encoder->stream_callback_user_data = user_data;
+    encoder->stream_output_size = NARU_HEADER_SIZE;
+    NARUEncoder_ResetSeekTable(encoder);
+    encoder->streaming = 1;
+
+    return NARU_APIRESULT_OK;
+}
+
+/* ストリーミング入力バッファに揃ったブロックをエンコードして出力 */
+static NARUApiResult NARUEncoder_EncodeStreamBlock(struct NARUEncoder *encoder, uint32_t num_samples)
+{
+    NARUApiResult ret;
+    uint32_t ch, block_size, output_size;
+    const int32_t *input_ptr[NARU_MAX_NUM_CHANNELS];
+    const int32_t *prev_input_ptr[NARU_MAX_NUM_CHANNELS];
+    const struct NARUHeader *header;
+
+    /* 内部関数なので不正な引数はアサートで落とす */
+    NARU_ASSERT(encoder != NULL);
+    NARU_ASSERT(encoder->streaming == 1);
+    NARU_ASSERT(num_samples > 0);
+
+    header = &(encoder->header);
+    block_size = header->max_num_samples_per_block;
+
+    /* 直前ブロックはバッファの前半、現在ブロックは後半にある */
+    for (ch = 0; ch < header->num_channels; ch++) {
+        prev_input_ptr[ch] = &encoder->stream_buffer[ch][0];
+        input_ptr[ch] = &encoder->stream_buffer[ch][block_size];
+    }
+
+    if (encoder->num_preroll_samples > 0) {
+        /* ブロック独立エンコード: 直前ブロックの末尾を先行サンプルとして使う */
+        if (encoder->stream_num_encoded_samples == 0) {
+            ret = NARUEncoder_EncodeBlockWithPreroll(encoder, input_ptr, 0, num_samples,
+                    encoder->stream_data, encoder->stream_data_size, &output_size);
+        } else {
+            ret = NARUEncoder_EncodeBlockWithPreroll(encoder, prev_input_ptr, block_size, num_samples,
+                    encoder->stream_data, encoder->stream_data_size, &output_size);
+        }
+        if (ret != NARU_APIRESULT_OK) {
+            return ret;
+        }
+    } else {
+        /* 時系列順のエンコード */
+        if ((ret = NARUEncoder_EncodeSequentialBlock(encoder,
+                        (encoder->stream_num_encoded_samples == 0) ? NULL : prev_input_ptr, block_size,
+                        input_ptr, num_samples,
+                        encoder->stream_data, encoder->stream_data_size, &output_size)) != NARU_APIRESULT_OK) {
+            return ret;
+        }
+    }
+
+    /* ブロックの位置をシークテーブルに記録 */
+    if (header->has_seek_table == 1) {
+        if ((ret = NARUEncoder_AddSeekPoint(encoder,
+                        encoder->stream_num_encoded_samples, encoder->stream_output_size)) != NARU_APIRESULT_OK) {
+            return ret;
+        }
+    }
+
+    /* ブロックを出力 */
+    if ((ret = encoder->stream_callback(encoder->stream_data, output_size,
+                    encoder->stream_callback_user_data)) != NARU_APIRESULT_OK) {
+        return ret;
+    }
+    encoder->stream_output_size += output_size;
+
+    /* 現在ブロックを直前ブロックに移す（端数ブロックは最後なので不要） */
+    if (num_samples == block_size) {
+        for (ch = 0; ch < header->num_channels; ch++) {
+            memcpy(&encoder->stream_buffer[ch][0], &encoder->stream_buffer[ch][block_size], sizeof(int32_t) * block_size);
+        }
+    }
+    encoder->stream_num_encoded_samples += num_samples;
+
+    return NARU_APIRESULT_OK;
+}
+
+/* ストリーミングエンコードにサンプルを供給 */
+NARUApiResult NARUEncoder_PushSamples(
+        struct NARUEncoder *encoder,
+        const int32_t *const *input, uint32_t num_samples)
+{
+    NARUApiResult ret;
+    uint32_t ch, progress, num_copy_samples, block_size;
+    const struct NARUHeader *header;
+
+    /* 引数チェック */
+    if ((encoder == NULL) || (input == NULL)) {
+        return NARU_APIRESULT_INVALID_ARGUMENT;
+    }
+
+    /* ストリーミングエンコードが開始されていない */
+    if (encoder->streaming != 1) {
+        return NARU_APIRESULT_PARAMETER_NOT_SET;
+    }
+    header = &(encoder->header);
+    block_size = header->max_num_samples_per_block;
+
+    /* ヘッダに記録できる総サンプル数を超える */
+    if (num_samples >= (NARU_UNDETERMINED_NUM_SAMPLES
+                - encoder->stream_num_encoded_samples - encoder->stream_num_buffered_samples)) {
+        return NARU_APIRESULT_INVALID_FORMAT;
+    }
+
+    progress = 0;
+    while (progress < num_samples) {
+        /* 現在ブロックの空きに詰める */
+        num_copy_samples = NARUUTILITY_MIN(block_size - encoder->stream_num_buffered_samples, num_samples - progress);
+        for (ch = 0; ch < header->num_channels; ch++) {
+            memcpy(&encoder->stream_buffer[ch][block_size + encoder->stream_num_buffered_samples],
+                    &input[ch][progress], sizeof(int32_t) * num_copy_samples);
+        }
+        encoder->stream_num_buffered_samples += num_copy_samples;
+        progress += num_copy_samples;
+
+        /* ブロックが揃ったらエンコード */
+        if (encoder->stream_num_buffered_samples == block_size) {
+            if ((ret = NARUEncoder_EncodeStreamBlock(encoder, block_size)) != NARU_APIRESULT_OK) {
+                encoder->streaming = 0;
+                return ret;
+            }
+            encoder->stream_num_buffered_samples = 0;
+        }
+    }
+
+    return NARU_APIRESULT_OK;
+}
+
+/* ストリーミングエンコードの終了 */
+NARUApiResult NARUEncoder_FinishStreaming(
+        struct NARUEncoder *encoder, uint8_t *header_data, uint32_t header_data_size)
+{
+    NARUApiResult ret;
+
+    /* 引数チェック */
+    if ((encoder == NULL) || (header_data == NULL)) {
+        return NARU_APIRESULT_INVALID_ARGUMENT;
+    }
+
+    /* ストリーミングエンコードが開始されていない */
+    if (encoder->streaming != 1) {
+        return NARU_APIRESULT_PARAMETER_NOT_SET;
+    }
+
+    /* ヘッダの出力先サイズ不足 残りのサンプルを失わないよう先に確認 */
+    if (header_data_size < NARU_HEADER_SIZE) {
+        return NARU_APIRESULT_INSUFFICIENT_BUFFER;
+    }
+
+    /* 残りのサンプルを端数ブロックとしてエンコード */
+    if (encoder->stream_num_buffered_samples > 0) {
+        if ((ret = NARUEncoder_EncodeStreamBlock(encoder, encoder->stream_num_buffered_samples)) != NARU_APIRESULT_OK) {
+            encoder->streaming = 0;
+            return ret;
+        }
+        encoder->stream_num_buffered_samples = 0;
+    }
+
+    /* ストリーミングエンコードの終了 */
+    encoder->streaming = 0;
+
+    /* 1サンプルもエンコードしていない */
+    if (encoder->stream_num_encoded_samples == 0) {
+        return NARU_APIRESULT_INSUFFICIENT_DATA;
+    }
+
+    /* 全ブロックの後ろにシークテーブルを出力 */
+    if (encoder->header.has_seek_table == 1) {
+        const uint32_t table_size = NARUEncoder_FinishSeekTable(encoder);
+        if ((ret = encoder->stream_callback(encoder->seek_table, table_size,
+                        encoder->stream_callback_user_data)) != NARU_APIRESULT_OK) {
+            return ret;
+        }
+    }
+
+    /* 総サンプル数を確定したヘッダを出力 */
+    encoder->header.num_samples = encoder->stream_num_encoded_samples;
+    return NARUEncoder_EncodeHeader(&(encoder->header), header_data, header_data_size);
+}
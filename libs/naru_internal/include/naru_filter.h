@@ -4,6 +4,40 @@
 #include "naru.h"
 #include "naru_stdint.h"
 
+/* フィルタ演算の実装種別 */
+typedef enum NARUFilterImplementationTag {
+    NARUFILTER_IMPLEMENTATION_SCALAR = 0,   /* 汎用C実装 */
+    NARUFILTER_IMPLEMENTATION_SSE41,        /* SSE4.1実装 */
+    NARUFILTER_IMPLEMENTATION_AVX2,         /* AVX2実装 */
+    NARUFILTER_IMPLEMENTATION_NUM           /* 実装種別数 */
+} NARUFilterImplementation;
+
+/* SIMD実装を使う場合に次数特化の展開済みカーネルを優先する最大次数 */
+#define NARUFILTER_MAX_UNROLLED_ORDER_WITH_SIMD 16
+
+/* チャンネル方向に並べるSIMDレーン数 */
+#define NARUFILTER_NUM_LANES                    8
+/* レーン並列処理を常に使う最小チャンネル数 */
+#define NARUFILTERLANES_MIN_NUM_CHANNELS        3
+
+/* チャンネル方向に並べたフィルタ状態 */
+struct NARUFilterLanes;
+
+/* フィルタ演算関数テーブル
+* 補足）どの実装も汎用C実装とビット単位で一致する結果を返す */
+struct NARUFilterFunctions {
+    /* 係数と履歴の内積 */
+    int32_t (*dot_product)(const int32_t *weight, const int32_t *history, int32_t order);
+    /* NGSAの係数更新: weight[i] += (delta * ngrad[i] + 2^(rshift-1)) >> rshift */
+    void (*update_ngsa_weight)(int32_t *weight, const int32_t *ngrad, int32_t delta, int32_t rshift, int32_t order);
+    /* SAの係数更新: weight[i] += sign * history[i]（signは-1,0,1のいずれか） */
+    void (*update_sa_weight)(int32_t *weight, const int32_t *history, int32_t sign, int32_t order);
+    /* レーン（チャンネル）毎にプリエンファシス→NGSA→SAの順で予測 NULLは未対応 */
+    void (*predict_lanes)(struct NARUFilterLanes *lanes, int32_t *const *buffer, uint32_t num_samples);
+    /* レーン（チャンネル）毎にSA→NGSA→デエンファシスの順で合成 NULLは未対応 */
+    void (*synthesize_lanes)(struct NARUFilterLanes *lanes, int32_t *const *buffer, uint32_t num_samples);
+};
+
 /* NGSAフィルタ */
 struct NARUNGSAFilter {
     int32_t filter_order;         /* フィルタ次数 */
@@ -18,6 +52,7 @@ struct NARUNGSAFilter {
     int32_t buffer_pos;           /* バッファ参照位置 */
     int32_t buffer_pos_mask;      /* バッファ参照位置補正のためのビットマスク */
     int32_t delta_rshift;         /* 係数更新時の右シフト量 */
+    const struct NARUFilterFunctions *functions;  /* フィルタ演算関数テーブル */
 };
 
 /* SAフィルタ */
@@ -28,12 +63,72 @@ struct NARUSAFilter {
     int32_t *weight;          /* フィルタ係数 */
     int32_t buffer_pos;       /* バッファ参照位置 */
     int32_t buffer_pos_mask;  /* バッファ参照位置補正のためのビットマスク */
+    const struct NARUFilterFunctions *functions;  /* フィルタ演算関数テーブル */
+};
+
+/* チャンネル方向に並べたフィルタ状態
+* 補足）配列は全て[要素][レーン]の順に並べ、1要素分の全レーンを1つのSIMDレジスタで扱う
+*       フィルタ次数・AR次数・バッファ参照位置は全レーンで共通 */
+struct NARUFilterLanes {
+    int32_t max_filter_order;     /* 最大フィルタ次数 */
+    int32_t num_lanes;            /* 使用中のレーン数 */
+    int32_t ngsa_filter_order;    /* NGSAフィルタ次数 */
+    int32_t ngsa_ar_order;        /* NGSAのAR次数 */
+    int32_t ngsa_buffer_pos;      /* NGSAのバッファ参照位置 */
+    int32_t ngsa_delta_rshift;    /* NGSAの係数更新時の右シフト量 */
+    int32_t *ngsa_history;        /* NGSAの入力データ履歴（2倍確保） */
+    int32_t *ngsa_weight;         /* NGSAのフィルタ係数 */
+    int32_t *ngsa_ar_coef;        /* NGSAのAR係数 */
+    int32_t *ngsa_ngrad;          /* NGSAの自然勾配（2倍確保） */
+    int32_t *ngsa_stepsize;       /* NGSAのフィルタ係数の変更量（delta_table[2]） */
+    int32_t sa_filter_order;      /* SAフィルタ次数 */
+    int32_t sa_buffer_pos;        /* SAのバッファ参照位置 */
+    int32_t *sa_history;          /* SAの入力データ履歴（2倍確保） */
+    int32_t *sa_weight;           /* SAのフィルタ係数 */
+    int32_t *emphasis_prev;       /* プリ（デ）エンファシスの直前の入力 */
+    const struct NARUFilterFunctions *functions;  /* フィルタ演算関数テーブル */
 };
 
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
 
+/* 次数特化の展開済みカーネルを使うべきか判定
+* 補足）SIMD実装が使える場合、高次数ではSIMD演算を使う汎用処理の方が速い */
+int32_t NARUFilter_IsUnrolledKernelPreferred(const struct NARUFilterFunctions *functions, int32_t order);
+
+/* 実行環境で使用可能な最速の実装種別を取得 */
+NARUFilterImplementation NARUFilter_GetAvailableImplementation(void);
+
+/* 実装種別に対応する関数テーブルを取得 実行環境で使用できない場合はNULL */
+const struct NARUFilterFunctions *NARUFilter_GetFunctions(NARUFilterImplementation implementation);
+
+#if defined(NARU_ENABLE_SSE41)
+/* 係数と履歴の内積（SSE4.1） */
+int32_t NARUFilter_DotProductSSE41(const int32_t *weight, const int32_t *history, int32_t order);
+/* NGSAの係数更新（SSE4.1） */
+void NARUFilter_UpdateNGSAWeightSSE41(int32_t *weight, const int32_t *ngrad, int32_t delta, int32_t rshift, int32_t order);
+/* SAの係数更新（SSE4.1） */
+void NARUFilter_UpdateSAWeightSSE41(int32_t *weight, const int32_t *history, int32_t sign, int32_t order);
+/* レーン毎の予測（SSE4.1） */
+void NARUFilter_PredictLanesSSE41(struct NARUFilterLanes *lanes, int32_t *const *buffer, uint32_t num_samples);
+/* レーン毎の合成（SSE4.1） */
+void NARUFilter_SynthesizeLanesSSE41(struct NARUFilterLanes *lanes, int32_t *const *buffer, uint32_t num_samples);
+#endif
+
+#if defined(NARU_ENABLE_AVX2)
+/* 係数と履歴の内積（AVX2） */
+int32_t NARUFilter_DotProductAVX2(const int32_t *weight, const int32_t *history, int32_t order);
+/* NGSAの係数更新（AVX2） */
+void NARUFilter_UpdateNGSAWeightAVX2(int32_t *weight, const int32_t *ngrad, int32_t delta, int32_t rshift, int32_t order);
+/* SAの係数更新（AVX2） */
+void NARUFilter_UpdateSAWeightAVX2(int32_t *weight, const int32_t *history, int32_t sign, int32_t order);
+/* レーン毎の予測（AVX2） */
+void NARUFilter_PredictLanesAVX2(struct NARUFilterLanes *lanes, int32_t *const *buffer, uint32_t num_samples);
+/* レーン毎の合成（AVX2） */
+void NARUFilter_SynthesizeLanesAVX2(struct NARUFilterLanes *lanes, int32_t *const *buffer, uint32_t num_samples);
+#endif
+
 /* SAフィルタの作成に必要なワークサイズ計算 */
 int32_t NARUSAFilter_CalculateWorkSize(uint8_t max_filter_order);
 
@@ -61,6 +156,30 @@ void NARUNGSAFilter_SetFilterOrder(struct NARUNGSAFilter *filter, int32_t filter
 /* NGSAフィルタの自然勾配初期化 */
 void NARUNGSAFilter_InitializeNaturalGradient(struct NARUNGSAFilter *filter);
 
+/* レーン並列処理用フィルタ状態の作成に必要なワークサイズ計算 */
+int32_t NARUFilterLanes_CalculateWorkSize(uint8_t max_filter_order);
+
+/* レーン並列処理用フィルタ状態の作成（自己割当不可） */
+struct NARUFilterLanes *NARUFilterLanes_Create(uint8_t max_filter_order, void *work, int32_t work_size);
+
+/* レーン並列処理がチャンネル毎の処理より速いと見込まれるか判定
+* 補足）2chでは空きレーンが多く、低次数では展開済みカーネル、高次数ではSIMD内積の方が速い */
+int32_t NARUFilterLanes_IsPreferred(const struct NARUFilterLanes *lanes, uint32_t num_channels, int32_t ngsa_filter_order);
+
+/* 各チャンネルのフィルタをレーン並列処理できるか判定 */
+int32_t NARUFilterLanes_IsLoadable(const struct NARUFilterLanes *lanes,
+        struct NARUNGSAFilter *const *ngsa, struct NARUSAFilter *const *sa, uint32_t num_lanes);
+
+/* 各チャンネルのフィルタ状態をレーンに読み込み（NGSAの自然勾配は初期化済みであること） */
+void NARUFilterLanes_Load(struct NARUFilterLanes *lanes,
+        struct NARUNGSAFilter *const *ngsa, struct NARUSAFilter *const *sa,
+        const int32_t *emphasis_prev, uint32_t num_lanes);
+
+/* レーンのフィルタ状態を各チャンネルに書き戻し */
+void NARUFilterLanes_Store(const struct NARUFilterLanes *lanes,
+        struct NARUNGSAFilter *const *ngsa, struct NARUSAFilter *const *sa,
+        int32_t *emphasis_prev, uint32_t num_lanes);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
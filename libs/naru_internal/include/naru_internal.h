@@ -9,6 +9,27 @@
 /* 内部エンコードパラメータ */
 /* ブロック先頭の同期コード */
 #define NARU_BLOCK_SYNC_CODE                  0xFFFF
+/* ブロックヘッダサイズ: 同期コード(2byte) + ブロックサイズ(4byte) + CRC16(2byte) + データタイプ(1byte) + サンプル数(2byte) */
+#define NARU_BLOCK_HEADER_SIZE                11
+/* チェックサム種別に対応するブロックヘッダ中のチェックサムのバイト数 */
+#define NARU_BLOCK_CHECKSUM_SIZE(checksum_type) (((checksum_type) == NARU_BLOCK_CHECKSUM_TYPE_CRC32C) ? 4U : 2U)
+/* チェックサム種別に対応するブロックヘッダサイズ */
+#define NARU_BLOCK_HEADER_SIZE_FOR_CHECKSUM(checksum_type) (NARU_BLOCK_HEADER_SIZE - 2U + NARU_BLOCK_CHECKSUM_SIZE(checksum_type))
+/* 残差を全チャンネルインターリーブで1つのビット列に符号化していたフォーマットバージョン */
+#define NARU_FORMAT_VERSION_INTERLEAVED_RESIDUAL 3
+/* ブロックのチェックサムがCRC16に限られていたフォーマットバージョン
+* 補足）ヘッダの最大ブロックあたりサンプル数は32bitで記録していたが、上位16bitは常に0だった */
+#define NARU_FORMAT_VERSION_CRC16_CHECKSUM    4
+/* シークポイント1つのバイト数: サンプル位置(4byte) + ブロックのバイト位置(4byte) */
+#define NARU_SEEKPOINT_SIZE                   8
+/* シークテーブルブロックのサイズ
+* 補足）ブロックヘッダ + シークポイント数(4byte) + シークポイント + 末尾にシークテーブルブロック自体のサイズ(4byte) */
+#define NARU_SEEKTABLE_BLOCK_SIZE(checksum_type, num_seek_points)\
+    (NARU_BLOCK_HEADER_SIZE_FOR_CHECKSUM(checksum_type) + 4U + NARU_SEEKPOINT_SIZE * (num_seek_points) + 4U)
+/* ストリーミングエンコード中のヘッダに記録する総サンプル数（未確定を表す） */
+#define NARU_UNDETERMINED_NUM_SAMPLES         0xFFFFFFFFUL
+/* 圧縮ブロックに記録するチャンネル毎の残差サブストリームサイズのバイト数 */
+#define NARU_BLOCK_SUBSTREAM_SIZE_BYTES       4
 /* 再帰的ライス符号のパラメータ数 */
 #define NARUCODER_NUM_RECURSIVERICE_PARAMETER 2
 /* 再帰的ライス符号の商部分の閾値 これ以上の大きさの商はガンマ符号化 */
@@ -69,7 +90,9 @@ typedef enum NARUBlockDataTypeTag {
     NARU_BLOCK_DATA_TYPE_COMPRESSDATA  = 0,     /* 圧縮済みデータ */
     NARU_BLOCK_DATA_TYPE_SILENT        = 1,     /* 無音データ     */
     NARU_BLOCK_DATA_TYPE_RAWDATA       = 2,     /* 生データ       */
-    NARU_BLOCK_DATA_TYPE_INVALID       = 3      /* 無効           */
+    NARU_BLOCK_DATA_TYPE_COMPRESSDATA_RANS = 3, /* 残差をrANS符号化した圧縮済みデータ */
+    NARU_BLOCK_DATA_TYPE_SEEKTABLE     = 4,     /* シークテーブル（全ブロックの後ろに置く） */
+    NARU_BLOCK_DATA_TYPE_INVALID       = 5      /* 無効           */
 } NARUBlockDataType;
 
 /* 内部エラー型 */
@@ -53,6 +53,23 @@ __inline uint32_t NARUUTILITY_NLZ(uint32_t x)
 #define NARUUTILITY_NLZ(x) NARUUtility_NLZSoft(x)
 #endif
 
+/* 64bit整数のNLZの計算 */
+#if defined(__GNUC__)
+/* ビルトイン関数を使用 */
+#define NARUUTILITY_NLZ64(x) (((x) > 0) ? (uint32_t)__builtin_clzll(x) : 64U)
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+/* ビルトイン関数を使用 */
+__inline uint32_t NARUUTILITY_NLZ64(uint64_t x)
+{
+    unsigned long result;
+    return (_BitScanReverse64(&result, x) != 0) ? (63U - result) : 64U;
+}
+#else
+/* 上位・下位32bitのNLZから計算 */
+#define NARUUTILITY_NLZ64(x)\
+    ((((x) >> 32) > 0) ? NARUUTILITY_NLZ((uint32_t)((x) >> 32)) : (32U + NARUUTILITY_NLZ((uint32_t)(x))))
+#endif
+
 /* ceil(log2(val))の計算 */
 #define NARUUTILITY_LOG2CEIL(x) (32U - NARUUTILITY_NLZ((uint32_t)((x) - 1U)))
 /* floor(log2(val))の計算 */
@@ -67,6 +84,40 @@ __inline uint32_t NARUUTILITY_NLZ(uint32_t x)
 #define NARUUTILITY_ROUNDUP2POWERED(x) NARUUtility_RoundUp2PoweredSoft(x)
 #endif
 
+/* x86系アーキテクチャか？ */
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define NARUUTILITY_X86_ARCHITECTURE
+#endif
+
+/* CPUが対応する拡張命令セットを表すフラグ */
+#define NARUUTILITY_CPU_FEATURE_SSE41 (1U << 0) /* SSE4.1 */
+#define NARUUTILITY_CPU_FEATURE_AVX2  (1U << 1) /* AVX2 */
+#define NARUUTILITY_CPU_FEATURE_PCLMUL (1U << 2) /* PCLMULQDQ */
+#define NARUUTILITY_CPU_FEATURE_SSE42 (1U << 3) /* SSE4.2 */
+
+/* CRC16計算の実装種別 */
+typedef enum NARUUtilityCRC16ImplementationTag {
+    NARUUTILITY_CRC16_IMPLEMENTATION_BYTEWISE = 0,  /* 1バイトずつのテーブル参照 */
+    NARUUTILITY_CRC16_IMPLEMENTATION_SLICE8,        /* 8バイトずつのテーブル参照（slicing-by-8） */
+    NARUUTILITY_CRC16_IMPLEMENTATION_PCLMUL,        /* PCLMULQDQによる畳み込み */
+    NARUUTILITY_CRC16_IMPLEMENTATION_NUM            /* 実装種別数 */
+} NARUUtilityCRC16Implementation;
+
+/* CRC16計算関数
+* 補足）どの実装も同一のCRC16を返す */
+typedef uint16_t (*NARUUtilityCRC16Function)(const uint8_t *data, uint64_t data_size);
+
+/* CRC32C計算の実装種別 */
+typedef enum NARUUtilityCRC32CImplementationTag {
+    NARUUTILITY_CRC32C_IMPLEMENTATION_SLICE8 = 0,   /* 8バイトずつのテーブル参照（slicing-by-8） */
+    NARUUTILITY_CRC32C_IMPLEMENTATION_SSE42,        /* SSE4.2のcrc32命令 */
+    NARUUTILITY_CRC32C_IMPLEMENTATION_NUM           /* 実装種別数 */
+} NARUUtilityCRC32CImplementation;
+
+/* CRC32C計算関数
+* 補足）どの実装も同一のCRC32Cを返す */
+typedef uint32_t (*NARUUtilityCRC32CFunction)(const uint8_t *data, uint64_t data_size);
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -80,6 +131,34 @@ void NARUUtility_MakeSinWindow(double *window, uint32_t window_size);
 /* CRC16(IBM)の計算 */
 uint16_t NARUUtility_CalculateCRC16(const uint8_t *data, uint64_t data_size);
 
+/* CRC16(IBM)の途中結果に続くデータを加えたCRC16を計算 */
+uint16_t NARUUtility_UpdateCRC16(uint16_t crc16, const uint8_t *data, uint64_t data_size);
+
+/* 実行環境で使用可能な最速のCRC16計算の実装種別を取得 */
+NARUUtilityCRC16Implementation NARUUtility_GetAvailableCRC16Implementation(void);
+
+/* 実装種別に対応するCRC16計算関数を取得 実行環境で使用できない場合はNULL */
+NARUUtilityCRC16Function NARUUtility_GetCRC16Function(NARUUtilityCRC16Implementation implementation);
+
+#if defined(NARU_ENABLE_PCLMUL)
+/* CRC16(IBM)の計算（PCLMULQDQ） */
+uint16_t NARUUtility_CalculateCRC16PCLMUL(const uint8_t *data, uint64_t data_size);
+#endif
+
+/* CRC32Cの計算 */
+uint32_t NARUUtility_CalculateCRC32C(const uint8_t *data, uint64_t data_size);
+
+/* 実行環境で使用可能な最速のCRC32C計算の実装種別を取得 */
+NARUUtilityCRC32CImplementation NARUUtility_GetAvailableCRC32CImplementation(void);
+
+/* 実装種別に対応するCRC32C計算関数を取得 実行環境で使用できない場合はNULL */
+NARUUtilityCRC32CFunction NARUUtility_GetCRC32CFunction(NARUUtilityCRC32CImplementation implementation);
+
+#if defined(NARU_ENABLE_SSE42)
+/* CRC32Cの計算（SSE4.2） */
+uint32_t NARUUtility_CalculateCRC32CSSE42(const uint8_t *data, uint64_t data_size);
+#endif
+
 /* NLZ（最上位ビットから1に当たるまでのビット数）の計算 */
 uint32_t NARUUtility_NLZSoft(uint32_t val);
 
@@ -104,6 +183,9 @@ double NARUUtility_Log2(double x);
 /* 入力データをもれなく表現できるビット幅の取得 */
 uint32_t NARUUtility_GetDataBitWidth(const int32_t* data, uint32_t num_samples);
 
+/* 実行環境のCPUが対応する拡張命令セットのフラグ(NARUUTILITY_CPU_FEATURE_*の論理和)を取得 */
+uint32_t NARUUtility_GetCPUFeatures(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -6,6 +6,143 @@
 
 /* 固定小数点数の乗算（丸め対策込み） */
 #define NARUFILTER_FIXEDPOINT_MUL(a, b, shift) NARUUTILITY_SHIFT_RIGHT_ARITHMETIC((a) * (b) + (1 << ((shift) - 1)), (shift))
+/* レーン並列処理用の配列のアラインメント（AVX2レジスタ幅） */
+#define NARUFILTERLANES_ALIGNMENT 32
+
+/* 係数と履歴の内積（汎用C実装） */
+static int32_t NARUFilter_DotProduct(const int32_t *weight, const int32_t *history, int32_t order);
+/* NGSAの係数更新（汎用C実装） */
+static void NARUFilter_UpdateNGSAWeight(int32_t *weight, const int32_t *ngrad, int32_t delta, int32_t rshift, int32_t order);
+/* SAの係数更新（汎用C実装） */
+static void NARUFilter_UpdateSAWeight(int32_t *weight, const int32_t *history, int32_t sign, int32_t order);
+
+/* 汎用C実装の関数テーブル */
+static const struct NARUFilterFunctions st_scalar_functions = {
+    NARUFilter_DotProduct, NARUFilter_UpdateNGSAWeight, NARUFilter_UpdateSAWeight,
+    NULL, NULL
+};
+
+#if defined(NARU_ENABLE_SSE41)
+/* SSE4.1実装の関数テーブル */
+static const struct NARUFilterFunctions st_sse41_functions = {
+    NARUFilter_DotProductSSE41, NARUFilter_UpdateNGSAWeightSSE41, NARUFilter_UpdateSAWeightSSE41,
+    NARUFilter_PredictLanesSSE41, NARUFilter_SynthesizeLanesSSE41
+};
+#endif
+
+#if defined(NARU_ENABLE_AVX2)
+/* AVX2実装の関数テーブル */
+static const struct NARUFilterFunctions st_avx2_functions = {
+    NARUFilter_DotProductAVX2, NARUFilter_UpdateNGSAWeightAVX2, NARUFilter_UpdateSAWeightAVX2,
+    NARUFilter_PredictLanesAVX2, NARUFilter_SynthesizeLanesAVX2
+};
+#endif
+
+/* 係数と履歴の内積（汎用C実装） */
+static int32_t NARUFilter_DotProduct(const int32_t *weight, const int32_t *history, int32_t order)
+{
+    int32_t ord, sum;
+
+    NARU_ASSERT(weight != NULL);
+    NARU_ASSERT(history != NULL);
+
+    sum = 0;
+    for (ord = 0; ord < order; ord++) {
+        sum += weight[ord] * history[ord];
+    }
+
+    return sum;
+}
+
+/* NGSAの係数更新（汎用C実装） */
+static void NARUFilter_UpdateNGSAWeight(int32_t *weight, const int32_t *ngrad, int32_t delta, int32_t rshift, int32_t order)
+{
+    int32_t ord;
+    const int32_t half = (1 << (rshift - 1));
+
+    NARU_ASSERT(weight != NULL);
+    NARU_ASSERT(ngrad != NULL);
+    NARU_ASSERT(rshift > 0);
+
+    for (ord = 0; ord < order; ord++) {
+        int32_t mul = delta * ngrad[ord];
+        mul += half;
+        mul = NARUUTILITY_SHIFT_RIGHT_ARITHMETIC(mul, rshift);
+        weight[ord] += mul;
+    }
+}
+
+/* SAの係数更新（汎用C実装） */
+static void NARUFilter_UpdateSAWeight(int32_t *weight, const int32_t *history, int32_t sign, int32_t order)
+{
+    int32_t ord;
+
+    NARU_ASSERT(weight != NULL);
+    NARU_ASSERT(history != NULL);
+    NARU_ASSERT((sign >= -1) && (sign <= 1));
+
+    for (ord = 0; ord < order; ord++) {
+        weight[ord] += sign * history[ord];
+    }
+}
+
+/* 実行環境で使用可能な最速の実装種別を取得 */
+NARUFilterImplementation NARUFilter_GetAvailableImplementation(void)
+{
+    const uint32_t features = NARUUtility_GetCPUFeatures();
+
+#if defined(NARU_ENABLE_AVX2)
+    if (features & NARUUTILITY_CPU_FEATURE_AVX2) {
+        return NARUFILTER_IMPLEMENTATION_AVX2;
+    }
+#endif
+#if defined(NARU_ENABLE_SSE41)
+    if (features & NARUUTILITY_CPU_FEATURE_SSE41) {
+        return NARUFILTER_IMPLEMENTATION_SSE41;
+    }
+#endif
+
+    NARUUTILITY_UNUSED_ARGUMENT(features);
+    return NARUFILTER_IMPLEMENTATION_SCALAR;
+}
+
+/* 実装種別に対応する関数テーブルを取得 実行環境で使用できない場合はNULL */
+const struct NARUFilterFunctions *NARUFilter_GetFunctions(NARUFilterImplementation implementation)
+{
+    const uint32_t features = NARUUtility_GetCPUFeatures();
+
+    NARUUTILITY_UNUSED_ARGUMENT(features);
+
+    switch (implementation) {
+    case NARUFILTER_IMPLEMENTATION_SCALAR:
+        return &st_scalar_functions;
+#if defined(NARU_ENABLE_SSE41)
+    case NARUFILTER_IMPLEMENTATION_SSE41:
+        return (features & NARUUTILITY_CPU_FEATURE_SSE41) ? &st_sse41_functions : NULL;
+#endif
+#if defined(NARU_ENABLE_AVX2)
+    case NARUFILTER_IMPLEMENTATION_AVX2:
+        return (features & NARUUTILITY_CPU_FEATURE_AVX2) ? &st_avx2_functions : NULL;
+#endif
+    default:
+        break;
+    }
+
+    return NULL;
+}
+
+/* 次数特化の展開済みカーネルを使うべきか判定 */
+int32_t NARUFilter_IsUnrolledKernelPreferred(const struct NARUFilterFunctions *functions, int32_t order)
+{
+    NARU_ASSERT(functions != NULL);
+
+    /* 汎用C実装ならば展開済みカーネルの方が常に速い */
+    if (functions == &st_scalar_functions) {
+        return 1;
+    }
+
+    return (order <= NARUFILTER_MAX_UNROLLED_ORDER_WITH_SIMD) ? 1 : 0;
+}
 
 /* SAフィルタの作成に必要なワークサイズ計算 */
 int32_t NARUSAFilter_CalculateWorkSize(uint8_t max_filter_order)
@@ -54,6 +191,10 @@ struct NARUSAFilter* NARUSAFilter_Create(uint8_t max_filter_order, void *work, i
     /* 最大フィルタ次数設定 */
     filter->max_filter_order = max_filter_order;
 
+    /* 実行環境で最速の演算関数を選択 */
+    filter->functions = NARUFilter_GetFunctions(NARUFilter_GetAvailableImplementation());
+    NARU_ASSERT(filter->functions != NULL);
+
     /* 入力データ履歴配置 */
     filter->history = (int32_t *)work_ptr;
     work_ptr += sizeof(int32_t) * 2 * max_filter_order;
@@ -146,6 +287,10 @@ struct NARUNGSAFilter* NARUNGSAFilter_Create(uint8_t max_filter_order, void *wor
     /* 最大フィルタ次数設定 */
     filter->max_filter_order = max_filter_order;
 
+    /* 実行環境で最速の演算関数を選択 */
+    filter->functions = NARUFilter_GetFunctions(NARUFilter_GetAvailableImplementation());
+    NARU_ASSERT(filter->functions != NULL);
+
     /* 入力データ履歴配置 */
     filter->history = (int32_t *)work_ptr;
     work_ptr += sizeof(int32_t) * 2 * max_filter_order;
@@ -265,3 +410,249 @@ void NARUNGSAFilter_InitializeNaturalGradient(struct NARUNGSAFilter *filter)
     /* 参照位置をずらした位置にポインタをセット(signの値で参照するため) */
     filter->pdelta_table = &filter->delta_table[1];
 }
+
+/* レーン並列処理用フィルタ状態の作成に必要なワークサイズ計算 */
+int32_t NARUFilterLanes_CalculateWorkSize(uint8_t max_filter_order)
+{
+    int32_t work_size, num_elements;
+
+    /* 無効な次数 */
+    if ((max_filter_order == 0)
+            || !(NARUUTILITY_IS_POWERED_OF_2(max_filter_order))) {
+        return -1;
+    }
+
+    /* 構造体本体分のサイズ（+アラインメント） */
+    work_size = sizeof(struct NARUFilterLanes) + NARU_MEMORY_ALIGNMENT;
+    /* 配列先頭をSIMDレジスタ幅に揃える分 */
+    work_size += NARUFILTERLANES_ALIGNMENT;
+
+    /* レーンあたりの要素数 */
+    /* NGSA: 入力データ履歴, フィルタ係数, AR係数, 自然勾配, 係数の変更量 */
+    num_elements = 2 * max_filter_order + max_filter_order
+        + NARU_MAX_ARORDER_FOR_FILTERORDER(max_filter_order) + 2 * max_filter_order + 1;
+    /* SA: 入力データ履歴, フィルタ係数 */
+    num_elements += 2 * max_filter_order + max_filter_order;
+    /* エンファシスの直前値 */
+    num_elements += 1;
+
+    work_size += (int32_t)sizeof(int32_t) * NARUFILTER_NUM_LANES * num_elements;
+
+    return work_size;
+}
+
+/* レーン並列処理用フィルタ状態の作成（自己割当不可） */
+struct NARUFilterLanes *NARUFilterLanes_Create(uint8_t max_filter_order, void *work, int32_t work_size)
+{
+    uint8_t *work_ptr;
+    struct NARUFilterLanes *lanes;
+
+    /* 引数チェック */
+    if ((work == NULL)
+            || (work_size < NARUFilterLanes_CalculateWorkSize(max_filter_order))) {
+        return NULL;
+    }
+
+    /* 無効なフィルタ次数 */
+    if ((max_filter_order == 0)
+            || !(NARUUTILITY_IS_POWERED_OF_2(max_filter_order))) {
+        return NULL;
+    }
+
+    /* 構造体配置 */
+    work_ptr = (uint8_t *)NARUUTILITY_ROUNDUP((uintptr_t)work, NARU_MEMORY_ALIGNMENT);
+    lanes = (struct NARUFilterLanes *)work_ptr;
+    work_ptr += sizeof(struct NARUFilterLanes);
+
+    lanes->max_filter_order = max_filter_order;
+    lanes->num_lanes = 0;
+
+    /* 実行環境で最速の演算関数を選択 */
+    lanes->functions = NARUFilter_GetFunctions(NARUFilter_GetAvailableImplementation());
+    NARU_ASSERT(lanes->functions != NULL);
+
+    /* 以降の配列はSIMDレジスタ幅に揃える
+    * 補足）各配列の大きさはレーン数の倍数なので先頭を揃えれば全て揃う */
+    work_ptr = (uint8_t *)NARUUTILITY_ROUNDUP((uintptr_t)work_ptr, NARUFILTERLANES_ALIGNMENT);
+
+    /* NGSAの配列配置 */
+    lanes->ngsa_history = (int32_t *)work_ptr;
+    work_ptr += sizeof(int32_t) * NARUFILTER_NUM_LANES * 2 * max_filter_order;
+    lanes->ngsa_weight = (int32_t *)work_ptr;
+    work_ptr += sizeof(int32_t) * NARUFILTER_NUM_LANES * max_filter_order;
+    lanes->ngsa_ar_coef = (int32_t *)work_ptr;
+    work_ptr += sizeof(int32_t) * NARUFILTER_NUM_LANES * (uint32_t)NARU_MAX_ARORDER_FOR_FILTERORDER(max_filter_order);
+    lanes->ngsa_ngrad = (int32_t *)work_ptr;
+    work_ptr += sizeof(int32_t) * NARUFILTER_NUM_LANES * 2 * max_filter_order;
+    lanes->ngsa_stepsize = (int32_t *)work_ptr;
+    work_ptr += sizeof(int32_t) * NARUFILTER_NUM_LANES;
+
+    /* SAの配列配置 */
+    lanes->sa_history = (int32_t *)work_ptr;
+    work_ptr += sizeof(int32_t) * NARUFILTER_NUM_LANES * 2 * max_filter_order;
+    lanes->sa_weight = (int32_t *)work_ptr;
+    work_ptr += sizeof(int32_t) * NARUFILTER_NUM_LANES * max_filter_order;
+
+    /* エンファシスの直前値 */
+    lanes->emphasis_prev = (int32_t *)work_ptr;
+    work_ptr += sizeof(int32_t) * NARUFILTER_NUM_LANES;
+
+    /* オーバーフローチェック */
+    NARU_ASSERT((work_ptr - (uint8_t *)work) <= work_size);
+
+    return lanes;
+}
+
+/* レーン並列処理がチャンネル毎の処理より速いと見込まれるか判定 */
+int32_t NARUFilterLanes_IsPreferred(const struct NARUFilterLanes *lanes, uint32_t num_channels, int32_t ngsa_filter_order)
+{
+    NARU_ASSERT(lanes != NULL);
+
+    /* SIMD実装がない */
+    if ((lanes->functions->predict_lanes == NULL) || (lanes->functions->synthesize_lanes == NULL)) {
+        return 0;
+    }
+
+    /* 十分なチャンネル数がある */
+    if (num_channels >= NARUFILTERLANES_MIN_NUM_CHANNELS) {
+        return 1;
+    }
+
+    /* 2chでは中程度の次数に限り速い */
+    return ((num_channels == 2) && (ngsa_filter_order >= 8) && (ngsa_filter_order <= 32)) ? 1 : 0;
+}
+
+/* 各チャンネルのフィルタをレーン並列処理できるか判定 */
+int32_t NARUFilterLanes_IsLoadable(const struct NARUFilterLanes *lanes,
+        struct NARUNGSAFilter *const *ngsa, struct NARUSAFilter *const *sa, uint32_t num_lanes)
+{
+    uint32_t lane;
+
+    NARU_ASSERT(lanes != NULL);
+    NARU_ASSERT(ngsa != NULL);
+    NARU_ASSERT(sa != NULL);
+
+    /* レーン数が範囲外 */
+    if ((num_lanes == 0) || (num_lanes > NARUFILTER_NUM_LANES)) {
+        return 0;
+    }
+
+    /* 確保した領域に収まらない */
+    if ((ngsa[0]->filter_order > lanes->max_filter_order)
+            || (ngsa[0]->ar_order > NARU_MAX_ARORDER_FOR_FILTERORDER(lanes->max_filter_order))
+            || (sa[0]->filter_order > lanes->max_filter_order)) {
+        return 0;
+    }
+
+    /* 次数・参照位置が全レーンで揃っていること */
+    for (lane = 1; lane < num_lanes; lane++) {
+        if ((ngsa[lane]->filter_order != ngsa[0]->filter_order)
+                || (ngsa[lane]->ar_order != ngsa[0]->ar_order)
+                || (ngsa[lane]->buffer_pos != ngsa[0]->buffer_pos)
+                || (ngsa[lane]->delta_rshift != ngsa[0]->delta_rshift)
+                || (sa[lane]->filter_order != sa[0]->filter_order)
+                || (sa[lane]->buffer_pos != sa[0]->buffer_pos)) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/* 各チャンネルのフィルタ状態をレーンに読み込み（NGSAの自然勾配は初期化済みであること） */
+void NARUFilterLanes_Load(struct NARUFilterLanes *lanes,
+        struct NARUNGSAFilter *const *ngsa, struct NARUSAFilter *const *sa,
+        const int32_t *emphasis_prev, uint32_t num_lanes)
+{
+    uint32_t lane;
+    int32_t i;
+    int32_t ngsa_order, ar_order, sa_order;
+
+    NARU_ASSERT(lanes != NULL);
+    NARU_ASSERT(ngsa != NULL);
+    NARU_ASSERT(sa != NULL);
+    NARU_ASSERT(emphasis_prev != NULL);
+    NARU_ASSERT(NARUFilterLanes_IsLoadable(lanes, ngsa, sa, num_lanes) == 1);
+
+    ngsa_order = ngsa[0]->filter_order;
+    ar_order = ngsa[0]->ar_order;
+    sa_order = sa[0]->filter_order;
+
+    /* 共通パラメータ */
+    lanes->num_lanes = (int32_t)num_lanes;
+    lanes->ngsa_filter_order = ngsa_order;
+    lanes->ngsa_ar_order = ar_order;
+    lanes->ngsa_buffer_pos = ngsa[0]->buffer_pos;
+    lanes->ngsa_delta_rshift = ngsa[0]->delta_rshift;
+    lanes->sa_filter_order = sa_order;
+    lanes->sa_buffer_pos = sa[0]->buffer_pos;
+
+    /* 未使用のレーンは0で埋めておく */
+    memset(lanes->ngsa_history, 0, sizeof(int32_t) * NARUFILTER_NUM_LANES * 2 * (uint32_t)ngsa_order);
+    memset(lanes->ngsa_weight, 0, sizeof(int32_t) * NARUFILTER_NUM_LANES * (uint32_t)ngsa_order);
+    memset(lanes->ngsa_ar_coef, 0, sizeof(int32_t) * NARUFILTER_NUM_LANES * (uint32_t)ar_order);
+    memset(lanes->ngsa_ngrad, 0, sizeof(int32_t) * NARUFILTER_NUM_LANES * 2 * (uint32_t)ngsa_order);
+    memset(lanes->ngsa_stepsize, 0, sizeof(int32_t) * NARUFILTER_NUM_LANES);
+    memset(lanes->sa_history, 0, sizeof(int32_t) * NARUFILTER_NUM_LANES * 2 * (uint32_t)sa_order);
+    memset(lanes->sa_weight, 0, sizeof(int32_t) * NARUFILTER_NUM_LANES * (uint32_t)sa_order);
+    memset(lanes->emphasis_prev, 0, sizeof(int32_t) * NARUFILTER_NUM_LANES);
+
+    /* [要素][レーン]の順に転置して読み込み */
+    for (lane = 0; lane < num_lanes; lane++) {
+        NARU_ASSERT(ngsa[lane]->pdelta_table == &ngsa[lane]->delta_table[1]);
+        for (i = 0; i < 2 * ngsa_order; i++) {
+            lanes->ngsa_history[i * NARUFILTER_NUM_LANES + (int32_t)lane] = ngsa[lane]->history[i];
+            lanes->ngsa_ngrad[i * NARUFILTER_NUM_LANES + (int32_t)lane] = ngsa[lane]->ngrad[i];
+        }
+        for (i = 0; i < ngsa_order; i++) {
+            lanes->ngsa_weight[i * NARUFILTER_NUM_LANES + (int32_t)lane] = ngsa[lane]->weight[i];
+        }
+        for (i = 0; i < ar_order; i++) {
+            lanes->ngsa_ar_coef[i * NARUFILTER_NUM_LANES + (int32_t)lane] = ngsa[lane]->ar_coef[i];
+        }
+        lanes->ngsa_stepsize[lane] = ngsa[lane]->delta_table[2];
+        for (i = 0; i < 2 * sa_order; i++) {
+            lanes->sa_history[i * NARUFILTER_NUM_LANES + (int32_t)lane] = sa[lane]->history[i];
+        }
+        for (i = 0; i < sa_order; i++) {
+            lanes->sa_weight[i * NARUFILTER_NUM_LANES + (int32_t)lane] = sa[lane]->weight[i];
+        }
+        lanes->emphasis_prev[lane] = emphasis_prev[lane];
+    }
+}
+
+/* レーンのフィルタ状態を各チャンネルに書き戻し */
+void NARUFilterLanes_Store(const struct NARUFilterLanes *lanes,
+        struct NARUNGSAFilter *const *ngsa, struct NARUSAFilter *const *sa,
+        int32_t *emphasis_prev, uint32_t num_lanes)
+{
+    uint32_t lane;
+    int32_t i;
+
+    NARU_ASSERT(lanes != NULL);
+    NARU_ASSERT(ngsa != NULL);
+    NARU_ASSERT(sa != NULL);
+    NARU_ASSERT(emphasis_prev != NULL);
+    NARU_ASSERT((int32_t)num_lanes == lanes->num_lanes);
+
+    for (lane = 0; lane < num_lanes; lane++) {
+        NARU_ASSERT(ngsa[lane]->filter_order == lanes->ngsa_filter_order);
+        NARU_ASSERT(sa[lane]->filter_order == lanes->sa_filter_order);
+        for (i = 0; i < 2 * lanes->ngsa_filter_order; i++) {
+            ngsa[lane]->history[i] = lanes->ngsa_history[i * NARUFILTER_NUM_LANES + (int32_t)lane];
+            ngsa[lane]->ngrad[i] = lanes->ngsa_ngrad[i * NARUFILTER_NUM_LANES + (int32_t)lane];
+        }
+        for (i = 0; i < lanes->ngsa_filter_order; i++) {
+            ngsa[lane]->weight[i] = lanes->ngsa_weight[i * NARUFILTER_NUM_LANES + (int32_t)lane];
+        }
+        ngsa[lane]->buffer_pos = lanes->ngsa_buffer_pos;
+        for (i = 0; i < 2 * lanes->sa_filter_order; i++) {
+            sa[lane]->history[i] = lanes->sa_history[i * NARUFILTER_NUM_LANES + (int32_t)lane];
+        }
+        for (i = 0; i < lanes->sa_filter_order; i++) {
+            sa[lane]->weight[i] = lanes->sa_weight[i * NARUFILTER_NUM_LANES + (int32_t)lane];
+        }
+        sa[lane]->buffer_pos = lanes->sa_buffer_pos;
+        emphasis_prev[lane] = lanes->emphasis_prev[lane];
+    }
+}
@@ -0,0 +1,402 @@
+#include "naru_filter.h"
+#include "naru_internal.h"
+#include "naru_utility.h"
+
+#include <string.h>
+#include <immintrin.h>
+
+/* 係数と履歴の内積（AVX2） */
+int32_t NARUFilter_DotProductAVX2(const int32_t *weight, const int32_t *history, int32_t order)
+{
+    int32_t ord, sum;
+    __m256i vsum;
+    __m128i vsum128;
+
+    NARU_ASSERT(weight != NULL);
+    NARU_ASSERT(history != NULL);
+
+    /* 8要素ずつ積和 */
+    vsum = _mm256_setzero_si256();
+    for (ord = 0; (ord + 8) <= order; ord += 8) {
+        const __m256i vw = _mm256_loadu_si256((const __m256i *)&weight[ord]);
+        const __m256i vh = _mm256_loadu_si256((const __m256i *)&history[ord]);
+        vsum = _mm256_add_epi32(vsum, _mm256_mullo_epi32(vw, vh));
+    }
+    vsum128 = _mm_add_epi32(_mm256_castsi256_si128(vsum), _mm256_extracti128_si256(vsum, 1));
+
+    /* 4要素の端数 */
+    if ((ord + 4) <= order) {
+        const __m128i vw = _mm_loadu_si128((const __m128i *)&weight[ord]);
+        const __m128i vh = _mm_loadu_si128((const __m128i *)&history[ord]);
+        vsum128 = _mm_add_epi32(vsum128, _mm_mullo_epi32(vw, vh));
+        ord += 4;
+    }
+
+    /* 水平加算 */
+    vsum128 = _mm_add_epi32(vsum128, _mm_shuffle_epi32(vsum128, _MM_SHUFFLE(1, 0, 3, 2)));
+    vsum128 = _mm_add_epi32(vsum128, _mm_shuffle_epi32(vsum128, _MM_SHUFFLE(2, 3, 0, 1)));
+    sum = _mm_cvtsi128_si32(vsum128);
+
+    /* 端数分 */
+    for (; ord < order; ord++) {
+        sum += weight[ord] * history[ord];
+    }
+
+    return sum;
+}
+
+/* NGSAの係数更新（AVX2） */
+void NARUFilter_UpdateNGSAWeightAVX2(int32_t *weight, const int32_t *ngrad, int32_t delta, int32_t rshift, int32_t order)
+{
+    int32_t ord;
+    const int32_t half = (1 << (rshift - 1));
+    const __m256i vdelta = _mm256_set1_epi32(delta);
+    const __m256i vhalf = _mm256_set1_epi32(half);
+    const __m128i vshift = _mm_cvtsi32_si128(rshift);
+
+    NARU_ASSERT(weight != NULL);
+    NARU_ASSERT(ngrad != NULL);
+    NARU_ASSERT(rshift > 0);
+
+    /* 8要素ずつ更新 */
+    for (ord = 0; (ord + 8) <= order; ord += 8) {
+        const __m256i vg = _mm256_loadu_si256((const __m256i *)&ngrad[ord]);
+        __m256i vw = _mm256_loadu_si256((const __m256i *)&weight[ord]);
+        __m256i vmul = _mm256_add_epi32(_mm256_mullo_epi32(vdelta, vg), vhalf);
+        vmul = _mm256_sra_epi32(vmul, vshift);
+        vw = _mm256_add_epi32(vw, vmul);
+        _mm256_storeu_si256((__m256i *)&weight[ord], vw);
+    }
+
+    /* 4要素の端数 */
+    if ((ord + 4) <= order) {
+        const __m128i vg = _mm_loadu_si128((const __m128i *)&ngrad[ord]);
+        __m128i vw = _mm_loadu_si128((const __m128i *)&weight[ord]);
+        __m128i vmul = _mm_add_epi32(_mm_mullo_epi32(_mm256_castsi256_si128(vdelta), vg), _mm256_castsi256_si128(vhalf));
+        vmul = _mm_sra_epi32(vmul, vshift);
+        vw = _mm_add_epi32(vw, vmul);
+        _mm_storeu_si128((__m128i *)&weight[ord], vw);
+        ord += 4;
+    }
+
+    /* 端数分 */
+    for (; ord < order; ord++) {
+        int32_t mul = delta * ngrad[ord];
+        mul += half;
+        mul = NARUUTILITY_SHIFT_RIGHT_ARITHMETIC(mul, rshift);
+        weight[ord] += mul;
+    }
+}
+
+/* SAの係数更新（AVX2） */
+void NARUFilter_UpdateSAWeightAVX2(int32_t *weight, const int32_t *history, int32_t sign, int32_t order)
+{
+    int32_t ord;
+    const __m256i vsign = _mm256_set1_epi32(sign);
+
+    NARU_ASSERT(weight != NULL);
+    NARU_ASSERT(history != NULL);
+    NARU_ASSERT((sign >= -1) && (sign <= 1));
+
+    /* 8要素ずつ更新 符号の乗算はsign命令で代用 */
+    for (ord = 0; (ord + 8) <= order; ord += 8) {
+        const __m256i vh = _mm256_loadu_si256((const __m256i *)&history[ord]);
+        __m256i vw = _mm256_loadu_si256((const __m256i *)&weight[ord]);
+        vw = _mm256_add_epi32(vw, _mm256_sign_epi32(vh, vsign));
+        _mm256_storeu_si256((__m256i *)&weight[ord], vw);
+    }
+
+    /* 4要素の端数 */
+    if ((ord + 4) <= order) {
+        const __m128i vh = _mm_loadu_si128((const __m128i *)&history[ord]);
+        __m128i vw = _mm_loadu_si128((const __m128i *)&weight[ord]);
+        vw = _mm_add_epi32(vw, _mm_sign_epi32(vh, _mm256_castsi256_si128(vsign)));
+        _mm_storeu_si128((__m128i *)&weight[ord], vw);
+        ord += 4;
+    }
+
+    /* 端数分 */
+    for (; ord < order; ord++) {
+        weight[ord] += sign * history[ord];
+    }
+}
+
+/* レーン配列のidx番目の要素（全レーン分）の読み書き */
+#define NARUFILTERLANES_LOAD_AVX2(array, idx) _mm256_load_si256((const __m256i *)&(array)[(idx) * NARUFILTER_NUM_LANES])
+#define NARUFILTERLANES_STORE_AVX2(array, idx, v) _mm256_store_si256((__m256i *)&(array)[(idx) * NARUFILTER_NUM_LANES], (v))
+
+/* レーン毎の予測（AVX2） */
+void NARUFilter_PredictLanesAVX2(struct NARUFilterLanes *lanes, int32_t *const *buffer, uint32_t num_samples)
+{
+    uint32_t smpl;
+    int32_t ord, lane, ngsa_pos, sa_pos;
+    int32_t *ngsa_history, *ngsa_weight, *ngsa_ngrad, *sa_history, *sa_weight;
+    const int32_t *ngsa_ar_coef;
+    int32_t tmp[NARUFILTER_NUM_LANES];
+    __m256i vemphasis_prev;
+    const int32_t num_lanes = lanes->num_lanes;
+    const int32_t ngsa_order = lanes->ngsa_filter_order;
+    const int32_t ngsa_mask = (ngsa_order > 0) ? (ngsa_order - 1) : 0;
+    const int32_t ar_order = lanes->ngsa_ar_order;
+    const int32_t sa_order = lanes->sa_filter_order;
+    const int32_t sa_mask = (sa_order > 0) ? (sa_order - 1) : 0;
+    const __m256i vfixed_half = _mm256_set1_epi32(NARU_FIXEDPOINT_0_5);
+    const __m256i vemphasis_coef = _mm256_set1_epi32((1 << NARU_EMPHASIS_FILTER_SHIFT) - 1);
+    const __m256i vstepsize = _mm256_load_si256((const __m256i *)lanes->ngsa_stepsize);
+    const __m256i vdelta_half = _mm256_set1_epi32(1 << (lanes->ngsa_delta_rshift - 1));
+    const __m128i vdelta_rshift = _mm_cvtsi32_si128(lanes->ngsa_delta_rshift);
+
+    NARU_ASSERT(lanes != NULL);
+    NARU_ASSERT(buffer != NULL);
+    NARU_ASSERT((num_lanes > 0) && (num_lanes <= NARUFILTER_NUM_LANES));
+
+    /* ローカル変数に受けとく */
+    ngsa_history = lanes->ngsa_history;
+    ngsa_weight = lanes->ngsa_weight;
+    ngsa_ngrad = lanes->ngsa_ngrad;
+    ngsa_ar_coef = lanes->ngsa_ar_coef;
+    ngsa_pos = lanes->ngsa_buffer_pos;
+    sa_history = lanes->sa_history;
+    sa_weight = lanes->sa_weight;
+    sa_pos = lanes->sa_buffer_pos;
+    vemphasis_prev = _mm256_load_si256((const __m256i *)lanes->emphasis_prev);
+    memset(tmp, 0, sizeof(tmp));
+
+    for (smpl = 0; smpl < num_samples; smpl++) {
+        __m256i vinput, vemphasized, vresidual, vpredict, vngrad0, vdelta;
+        int32_t *pngsa_history, *pngsa_ngrad, *psa_history;
+
+        /* 各チャンネルのサンプルをレーンに集める */
+        for (lane = 0; lane < num_lanes; lane++) {
+            tmp[lane] = buffer[lane][smpl];
+        }
+        vinput = _mm256_loadu_si256((const __m256i *)tmp);
+
+        /* プリエンファシス */
+        vemphasized = _mm256_sub_epi32(vinput,
+                _mm256_srai_epi32(_mm256_mullo_epi32(vemphasis_prev, vemphasis_coef), NARU_EMPHASIS_FILTER_SHIFT));
+        vemphasis_prev = vinput;
+
+        /* NGSA: フィルタ予測 */
+        pngsa_history = &ngsa_history[ngsa_pos * NARUFILTER_NUM_LANES];
+        vpredict = vfixed_half;
+        for (ord = 0; ord < ngsa_order; ord++) {
+            vpredict = _mm256_add_epi32(vpredict,
+                    _mm256_mullo_epi32(NARUFILTERLANES_LOAD_AVX2(ngsa_weight, ord), NARUFILTERLANES_LOAD_AVX2(pngsa_history, ord)));
+        }
+        vpredict = _mm256_srai_epi32(vpredict, NARU_FIXEDPOINT_DIGITS);
+        vresidual = _mm256_sub_epi32(vemphasized, vpredict);
+
+        /* NGSA: バッファ参照位置更新 */
+        ngsa_pos = (ngsa_pos - 1) & ngsa_mask;
+
+        /* NGSA: 自然勾配更新 */
+        pngsa_ngrad = &ngsa_ngrad[ngsa_pos * NARUFILTER_NUM_LANES];
+        for (ord = 0; ord < ar_order; ord++) {
+            const int32_t pos = (ngsa_pos + ngsa_order - 1 - ord) & ngsa_mask;
+            __m256i vg = NARUFILTERLANES_LOAD_AVX2(ngsa_ngrad, pos);
+            vg = _mm256_add_epi32(vg, _mm256_srai_epi32(_mm256_mullo_epi32(
+                            NARUFILTERLANES_LOAD_AVX2(ngsa_ar_coef, ord), NARUFILTERLANES_LOAD_AVX2(pngsa_ngrad, ngsa_order)), NARU_FIXEDPOINT_DIGITS));
+            NARUFILTERLANES_STORE_AVX2(ngsa_ngrad, pos, vg);
+            NARUFILTERLANES_STORE_AVX2(ngsa_ngrad, pos + ngsa_order, vg);
+        }
+        vngrad0 = _mm256_setzero_si256();
+        for (ord = 0; ord < ar_order; ord++) {
+            vngrad0 = _mm256_sub_epi32(vngrad0,
+                    _mm256_mullo_epi32(NARUFILTERLANES_LOAD_AVX2(ngsa_ar_coef, ord), NARUFILTERLANES_LOAD_AVX2(pngsa_history, ord + 1)));
+        }
+        vngrad0 = _mm256_add_epi32(_mm256_srai_epi32(vngrad0, NARU_FIXEDPOINT_DIGITS), NARUFILTERLANES_LOAD_AVX2(pngsa_history, 0));
+        NARUFILTERLANES_STORE_AVX2(pngsa_ngrad, 0, vngrad0);
+        for (ord = 0; ord < ar_order; ord++) {
+            const int32_t pos = (ngsa_pos + ord + 1) & ngsa_mask;
+            __m256i vg = NARUFILTERLANES_LOAD_AVX2(ngsa_ngrad, pos);
+            vg = _mm256_sub_epi32(vg, _mm256_srai_epi32(_mm256_mullo_epi32(
+                            NARUFILTERLANES_LOAD_AVX2(ngsa_ar_coef, ord), vngrad0), NARU_FIXEDPOINT_DIGITS));
+            NARUFILTERLANES_STORE_AVX2(ngsa_ngrad, pos, vg);
+            NARUFILTERLANES_STORE_AVX2(ngsa_ngrad, pos + ngsa_order, vg);
+        }
+
+        /* NGSA: フィルタ係数更新 符号による変更量の選択はsign命令で代用 */
+        vdelta = _mm256_sign_epi32(vstepsize, vresidual);
+        for (ord = 0; ord < ngsa_order; ord++) {
+            __m256i vmul = _mm256_add_epi32(_mm256_mullo_epi32(vdelta, NARUFILTERLANES_LOAD_AVX2(pngsa_ngrad, ord)), vdelta_half);
+            vmul = _mm256_sra_epi32(vmul, vdelta_rshift);
+            NARUFILTERLANES_STORE_AVX2(ngsa_weight, ord, _mm256_add_epi32(NARUFILTERLANES_LOAD_AVX2(ngsa_weight, ord), vmul));
+        }
+
+        /* NGSA: 入力データ履歴更新 */
+        NARUFILTERLANES_STORE_AVX2(ngsa_history, ngsa_pos, vemphasized);
+        NARUFILTERLANES_STORE_AVX2(ngsa_history, ngsa_pos + ngsa_order, vemphasized);
+
+        /* SA: フィルタ予測 */
+        vinput = vresidual;
+        psa_history = &sa_history[sa_pos * NARUFILTER_NUM_LANES];
+        vpredict = vfixed_half;
+        for (ord = 0; ord < sa_order; ord++) {
+            vpredict = _mm256_add_epi32(vpredict,
+                    _mm256_mullo_epi32(NARUFILTERLANES_LOAD_AVX2(sa_weight, ord), NARUFILTERLANES_LOAD_AVX2(psa_history, ord)));
+        }
+        vpredict = _mm256_srai_epi32(vpredict, NARU_FIXEDPOINT_DIGITS);
+        vresidual = _mm256_sub_epi32(vinput, vpredict);
+
+        /* SA: 係数更新 */
+        for (ord = 0; ord < sa_order; ord++) {
+            NARUFILTERLANES_STORE_AVX2(sa_weight, ord, _mm256_add_epi32(NARUFILTERLANES_LOAD_AVX2(sa_weight, ord),
+                        _mm256_sign_epi32(NARUFILTERLANES_LOAD_AVX2(psa_history, ord), vresidual)));
+        }
+
+        /* SA: 入力データ履歴更新 */
+        sa_pos = (sa_pos - 1) & sa_mask;
+        NARUFILTERLANES_STORE_AVX2(sa_history, sa_pos, vinput);
+        NARUFILTERLANES_STORE_AVX2(sa_history, sa_pos + sa_order, vinput);
+
+        /* 残差を各チャンネルに書き戻し */
+        _mm256_storeu_si256((__m256i *)tmp, vresidual);
+        for (lane = 0; lane < num_lanes; lane++) {
+            buffer[lane][smpl] = tmp[lane];
+        }
+    }
+
+    /* 状態を書き戻し */
+    lanes->ngsa_buffer_pos = ngsa_pos;
+    lanes->sa_buffer_pos = sa_pos;
+    _mm256_store_si256((__m256i *)lanes->emphasis_prev, vemphasis_prev);
+}
+
+/* レーン毎の合成（AVX2） */
+void NARUFilter_SynthesizeLanesAVX2(struct NARUFilterLanes *lanes, int32_t *const *buffer, uint32_t num_samples)
+{
+    uint32_t smpl;
+    int32_t ord, lane, ngsa_pos, sa_pos;
+    int32_t *ngsa_history, *ngsa_weight, *ngsa_ngrad, *sa_history, *sa_weight;
+    const int32_t *ngsa_ar_coef;
+    int32_t tmp[NARUFILTER_NUM_LANES];
+    __m256i vemphasis_prev;
+    const int32_t num_lanes = lanes->num_lanes;
+    const int32_t ngsa_order = lanes->ngsa_filter_order;
+    const int32_t ngsa_mask = (ngsa_order > 0) ? (ngsa_order - 1) : 0;
+    const int32_t ar_order = lanes->ngsa_ar_order;
+    const int32_t sa_order = lanes->sa_filter_order;
+    const int32_t sa_mask = (sa_order > 0) ? (sa_order - 1) : 0;
+    const __m256i vfixed_half = _mm256_set1_epi32(NARU_FIXEDPOINT_0_5);
+    const __m256i vemphasis_coef = _mm256_set1_epi32((1 << NARU_EMPHASIS_FILTER_SHIFT) - 1);
+    const __m256i vstepsize = _mm256_load_si256((const __m256i *)lanes->ngsa_stepsize);
+    const __m256i vdelta_half = _mm256_set1_epi32(1 << (lanes->ngsa_delta_rshift - 1));
+    const __m128i vdelta_rshift = _mm_cvtsi32_si128(lanes->ngsa_delta_rshift);
+
+    NARU_ASSERT(lanes != NULL);
+    NARU_ASSERT(buffer != NULL);
+    NARU_ASSERT((num_lanes > 0) && (num_lanes <= NARUFILTER_NUM_LANES));
+
+    /* ローカル変数に受けとく */
+    ngsa_history = lanes->ngsa_history;
+    ngsa_weight = lanes->ngsa_weight;
+    ngsa_ngrad = lanes->ngsa_ngrad;
+    ngsa_ar_coef = lanes->ngsa_ar_coef;
+    ngsa_pos = lanes->ngsa_buffer_pos;
+    sa_history = lanes->sa_history;
+    sa_weight = lanes->sa_weight;
+    sa_pos = lanes->sa_buffer_pos;
+    vemphasis_prev = _mm256_load_si256((const __m256i *)lanes->emphasis_prev);
+    memset(tmp, 0, sizeof(tmp));
+
+    for (smpl = 0; smpl < num_samples; smpl++) {
+        __m256i vresidual, vsynth, vpredict, vngrad0, vdelta;
+        int32_t *pngsa_history, *pngsa_ngrad, *psa_history;
+
+        /* 各チャンネルの残差をレーンに集める */
+        for (lane = 0; lane < num_lanes; lane++) {
+            tmp[lane] = buffer[lane][smpl];
+        }
+        vresidual = _mm256_loadu_si256((const __m256i *)tmp);
+
+        /* SA: フィルタ予測 */
+        psa_history = &sa_history[sa_pos * NARUFILTER_NUM_LANES];
+        vpredict = vfixed_half;
+        for (ord = 0; ord < sa_order; ord++) {
+            vpredict = _mm256_add_epi32(vpredict,
+                    _mm256_mullo_epi32(NARUFILTERLANES_LOAD_AVX2(sa_weight, ord), NARUFILTERLANES_LOAD_AVX2(psa_history, ord)));
+        }
+        vpredict = _mm256_srai_epi32(vpredict, NARU_FIXEDPOINT_DIGITS);
+        vsynth = _mm256_add_epi32(vresidual, vpredict);
+
+        /* SA: 係数更新 */
+        for (ord = 0; ord < sa_order; ord++) {
+            NARUFILTERLANES_STORE_AVX2(sa_weight, ord, _mm256_add_epi32(NARUFILTERLANES_LOAD_AVX2(sa_weight, ord),
+                        _mm256_sign_epi32(NARUFILTERLANES_LOAD_AVX2(psa_history, ord), vresidual)));
+        }
+
+        /* SA: 入力データ履歴更新 */
+        sa_pos = (sa_pos - 1) & sa_mask;
+        NARUFILTERLANES_STORE_AVX2(sa_history, sa_pos, vsynth);
+        NARUFILTERLANES_STORE_AVX2(sa_history, sa_pos + sa_order, vsynth);
+
+        /* NGSA: フィルタ予測 */
+        vresidual = vsynth;
+        pngsa_history = &ngsa_history[ngsa_pos * NARUFILTER_NUM_LANES];
+        vpredict = vfixed_half;
+        for (ord = 0; ord < ngsa_order; ord++) {
+            vpredict = _mm256_add_epi32(vpredict,
+                    _mm256_mullo_epi32(NARUFILTERLANES_LOAD_AVX2(ngsa_weight, ord), NARUFILTERLANES_LOAD_AVX2(pngsa_history, ord)));
+        }
+        vpredict = _mm256_srai_epi32(vpredict, NARU_FIXEDPOINT_DIGITS);
+        vsynth = _mm256_add_epi32(vresidual, vpredict);
+
+        /* NGSA: バッファ参照位置更新 */
+        ngsa_pos = (ngsa_pos - 1) & ngsa_mask;
+
+        /* NGSA: 自然勾配更新 */
+        pngsa_ngrad = &ngsa_ngrad[ngsa_pos * NARUFILTER_NUM_LANES];
+        for (ord = 0; ord < ar_order; ord++) {
+            const int32_t pos = (ngsa_pos + ngsa_order - 1 - ord) & ngsa_mask;
+            __m256i vg = NARUFILTERLANES_LOAD_AVX2(ngsa_ngrad, pos);
+            vg = _mm256_add_epi32(vg, _mm256_srai_epi32(_mm256_mullo_epi32(
+                            NARUFILTERLANES_LOAD_AVX2(ngsa_ar_coef, ord), NARUFILTERLANES_LOAD_AVX2(pngsa_ngrad, ngsa_order)), NARU_FIXEDPOINT_DIGITS));
+            NARUFILTERLANES_STORE_AVX2(ngsa_ngrad, pos, vg);
+            NARUFILTERLANES_STORE_AVX2(ngsa_ngrad, pos + ngsa_order, vg);
+        }
+        vngrad0 = _mm256_setzero_si256();
+        for (ord = 0; ord < ar_order; ord++) {
+            vngrad0 = _mm256_sub_epi32(vngrad0,
+                    _mm256_mullo_epi32(NARUFILTERLANES_LOAD_AVX2(ngsa_ar_coef, ord), NARUFILTERLANES_LOAD_AVX2(pngsa_history, ord + 1)));
+        }
+        vngrad0 = _mm256_add_epi32(_mm256_srai_epi32(vngrad0, NARU_FIXEDPOINT_DIGITS), NARUFILTERLANES_LOAD_AVX2(pngsa_history, 0));
+        NARUFILTERLANES_STORE_AVX2(pngsa_ngrad, 0, vngrad0);
+        for (ord = 0; ord < ar_order; ord++) {
+            const int32_t pos = (ngsa_pos + ord + 1) & ngsa_mask;
+            __m256i vg = NARUFILTERLANES_LOAD_AVX2(ngsa_ngrad, pos);
+            vg = _mm256_sub_epi32(vg, _mm256_srai_epi32(_mm256_mullo_epi32(
+                            NARUFILTERLANES_LOAD_AVX2(ngsa_ar_coef, ord), vngrad0), NARU_FIXEDPOINT_DIGITS));
+            NARUFILTERLANES_STORE_AVX2(ngsa_ngrad, pos, vg);
+            NARUFILTERLANES_STORE_AVX2(ngsa_ngrad, pos + ngsa_order, vg);
+        }
+
+        /* NGSA: フィルタ係数更新 符号による変更量の選択はsign命令で代用 */
+        vdelta = _mm256_sign_epi32(vstepsize, vresidual);
+        for (ord = 0; ord < ngsa_order; ord++) {
+            __m256i vmul = _mm256_add_epi32(_mm256_mullo_epi32(vdelta, NARUFILTERLANES_LOAD_AVX2(pngsa_ngrad, ord)), vdelta_half);
+            vmul = _mm256_sra_epi32(vmul, vdelta_rshift);
+            NARUFILTERLANES_STORE_AVX2(ngsa_weight, ord, _mm256_add_epi32(NARUFILTERLANES_LOAD_AVX2(ngsa_weight, ord), vmul));
+        }
+
+        /* NGSA: 入力データ履歴更新 */
+        NARUFILTERLANES_STORE_AVX2(ngsa_history, ngsa_pos, vsynth);
+        NARUFILTERLANES_STORE_AVX2(ngsa_history, ngsa_pos + ngsa_order, vsynth);
+
+        /* デエンファシス */
+        vsynth = _mm256_add_epi32(vsynth,
+                _mm256_srai_epi32(_mm256_mullo_epi32(vemphasis_prev, vemphasis_coef), NARU_EMPHASIS_FILTER_SHIFT));
+        vemphasis_prev = vsynth;
+
+        /* 合成結果を各チャンネルに書き戻し */
+        _mm256_storeu_si256((__m256i *)tmp, vsynth);
+        for (lane = 0; lane < num_lanes; lane++) {
+            buffer[lane][smpl] = tmp[lane];
+        }
+    }
+
+    /* 状態を書き戻し */
+    lanes->ngsa_buffer_pos = ngsa_pos;
+    lanes->sa_buffer_pos = sa_pos;
+    _mm256_store_si256((__m256i *)lanes->emphasis_prev, vemphasis_prev);
+}
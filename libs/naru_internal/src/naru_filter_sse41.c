@@ -0,0 +1,413 @@
+#include "naru_filter.h"
+#include "naru_internal.h"
+#include "naru_utility.h"
+
+#include <string.h>
+#include <smmintrin.h>
+
+/* 係数と履歴の内積（SSE4.1） */
+int32_t NARUFilter_DotProductSSE41(const int32_t *weight, const int32_t *history, int32_t order)
+{
+    int32_t ord, sum;
+    __m128i vsum;
+
+    NARU_ASSERT(weight != NULL);
+    NARU_ASSERT(history != NULL);
+
+    /* 4要素ずつ積和 */
+    vsum = _mm_setzero_si128();
+    for (ord = 0; (ord + 4) <= order; ord += 4) {
+        const __m128i vw = _mm_loadu_si128((const __m128i *)&weight[ord]);
+        const __m128i vh = _mm_loadu_si128((const __m128i *)&history[ord]);
+        vsum = _mm_add_epi32(vsum, _mm_mullo_epi32(vw, vh));
+    }
+
+    /* 水平加算 */
+    vsum = _mm_add_epi32(vsum, _mm_shuffle_epi32(vsum, _MM_SHUFFLE(1, 0, 3, 2)));
+    vsum = _mm_add_epi32(vsum, _mm_shuffle_epi32(vsum, _MM_SHUFFLE(2, 3, 0, 1)));
+    sum = _mm_cvtsi128_si32(vsum);
+
+    /* 端数分 */
+    for (; ord < order; ord++) {
+        sum += weight[ord] * history[ord];
+    }
+
+    return sum;
+}
+
+/* NGSAの係数更新（SSE4.1） */
+void NARUFilter_UpdateNGSAWeightSSE41(int32_t *weight, const int32_t *ngrad, int32_t delta, int32_t rshift, int32_t order)
+{
+    int32_t ord;
+    const int32_t half = (1 << (rshift - 1));
+    const __m128i vdelta = _mm_set1_epi32(delta);
+    const __m128i vhalf = _mm_set1_epi32(half);
+    const __m128i vshift = _mm_cvtsi32_si128(rshift);
+
+    NARU_ASSERT(weight != NULL);
+    NARU_ASSERT(ngrad != NULL);
+    NARU_ASSERT(rshift > 0);
+
+    /* 4要素ずつ更新 */
+    for (ord = 0; (ord + 4) <= order; ord += 4) {
+        const __m128i vg = _mm_loadu_si128((const __m128i *)&ngrad[ord]);
+        __m128i vw = _mm_loadu_si128((const __m128i *)&weight[ord]);
+        __m128i vmul = _mm_add_epi32(_mm_mullo_epi32(vdelta, vg), vhalf);
+        vmul = _mm_sra_epi32(vmul, vshift);
+        vw = _mm_add_epi32(vw, vmul);
+        _mm_storeu_si128((__m128i *)&weight[ord], vw);
+    }
+
+    /* 端数分 */
+    for (; ord < order; ord++) {
+        int32_t mul = delta * ngrad[ord];
+        mul += half;
+        mul = NARUUTILITY_SHIFT_RIGHT_ARITHMETIC(mul, rshift);
+        weight[ord] += mul;
+    }
+}
+
+/* SAの係数更新（SSE4.1） */
+void NARUFilter_UpdateSAWeightSSE41(int32_t *weight, const int32_t *history, int32_t sign, int32_t order)
+{
+    int32_t ord;
+    const __m128i vsign = _mm_set1_epi32(sign);
+
+    NARU_ASSERT(weight != NULL);
+    NARU_ASSERT(history != NULL);
+    NARU_ASSERT((sign >= -1) && (sign <= 1));
+
+    /* 4要素ずつ更新 符号の乗算はsign命令で代用 */
+    for (ord = 0; (ord + 4) <= order; ord += 4) {
+        const __m128i vh = _mm_loadu_si128((const __m128i *)&history[ord]);
+        __m128i vw = _mm_loadu_si128((const __m128i *)&weight[ord]);
+        vw = _mm_add_epi32(vw, _mm_sign_epi32(vh, vsign));
+        _mm_storeu_si128((__m128i *)&weight[ord], vw);
+    }
+
+    /* 端数分 */
+    for (; ord < order; ord++) {
+        weight[ord] += sign * history[ord];
+    }
+}
+
+/* SSE4.1で1度に処理するレーン数 */
+#define NARUFILTERLANES_NUM_LANES_SSE41 4
+
+/* レーン配列のidx番目の要素（先頭レーンの位置はポインタに含める）の読み書き */
+#define NARUFILTERLANES_LOAD_SSE41(array, idx) _mm_load_si128((const __m128i *)&(array)[(idx) * NARUFILTER_NUM_LANES])
+#define NARUFILTERLANES_STORE_SSE41(array, idx, v) _mm_store_si128((__m128i *)&(array)[(idx) * NARUFILTER_NUM_LANES], (v))
+
+/* 先頭レーンから4レーン分の予測（SSE4.1） */
+static void NARUFilter_PredictLanesSSE41Group(
+        struct NARUFilterLanes *lanes, int32_t *const *buffer, uint32_t num_samples, int32_t base_lane)
+{
+    uint32_t smpl;
+    int32_t ord, lane, ngsa_pos, sa_pos;
+    int32_t *ngsa_history, *ngsa_weight, *ngsa_ngrad, *sa_history, *sa_weight;
+    const int32_t *ngsa_ar_coef;
+    int32_t tmp[NARUFILTERLANES_NUM_LANES_SSE41];
+    __m128i vemphasis_prev;
+    const int32_t num_lanes = NARUUTILITY_MIN(lanes->num_lanes - base_lane, NARUFILTERLANES_NUM_LANES_SSE41);
+    const int32_t ngsa_order = lanes->ngsa_filter_order;
+    const int32_t ngsa_mask = (ngsa_order > 0) ? (ngsa_order - 1) : 0;
+    const int32_t ar_order = lanes->ngsa_ar_order;
+    const int32_t sa_order = lanes->sa_filter_order;
+    const int32_t sa_mask = (sa_order > 0) ? (sa_order - 1) : 0;
+    const __m128i vfixed_half = _mm_set1_epi32(NARU_FIXEDPOINT_0_5);
+    const __m128i vemphasis_coef = _mm_set1_epi32((1 << NARU_EMPHASIS_FILTER_SHIFT) - 1);
+    const __m128i vstepsize = _mm_load_si128((const __m128i *)&lanes->ngsa_stepsize[base_lane]);
+    const __m128i vdelta_half = _mm_set1_epi32(1 << (lanes->ngsa_delta_rshift - 1));
+    const __m128i vdelta_rshift = _mm_cvtsi32_si128(lanes->ngsa_delta_rshift);
+
+    NARU_ASSERT(lanes != NULL);
+    NARU_ASSERT(buffer != NULL);
+    NARU_ASSERT((num_lanes > 0) && (num_lanes <= NARUFILTERLANES_NUM_LANES_SSE41));
+
+    /* ローカル変数に受けとく */
+    ngsa_history = &lanes->ngsa_history[base_lane];
+    ngsa_weight = &lanes->ngsa_weight[base_lane];
+    ngsa_ngrad = &lanes->ngsa_ngrad[base_lane];
+    ngsa_ar_coef = &lanes->ngsa_ar_coef[base_lane];
+    ngsa_pos = lanes->ngsa_buffer_pos;
+    sa_history = &lanes->sa_history[base_lane];
+    sa_weight = &lanes->sa_weight[base_lane];
+    sa_pos = lanes->sa_buffer_pos;
+    vemphasis_prev = _mm_load_si128((const __m128i *)&lanes->emphasis_prev[base_lane]);
+    memset(tmp, 0, sizeof(tmp));
+
+    for (smpl = 0; smpl < num_samples; smpl++) {
+        __m128i vinput, vemphasized, vresidual, vpredict, vngrad0, vdelta;
+        int32_t *pngsa_history, *pngsa_ngrad, *psa_history;
+
+        /* 各チャンネルのサンプルをレーンに集める */
+        for (lane = 0; lane < num_lanes; lane++) {
+            tmp[lane] = buffer[base_lane + lane][smpl];
+        }
+        vinput = _mm_loadu_si128((const __m128i *)tmp);
+
+        /* プリエンファシス */
+        vemphasized = _mm_sub_epi32(vinput,
+                _mm_srai_epi32(_mm_mullo_epi32(vemphasis_prev, vemphasis_coef), NARU_EMPHASIS_FILTER_SHIFT));
+        vemphasis_prev = vinput;
+
+        /* NGSA: フィルタ予測 */
+        pngsa_history = &ngsa_history[ngsa_pos * NARUFILTER_NUM_LANES];
+        vpredict = vfixed_half;
+        for (ord = 0; ord < ngsa_order; ord++) {
+            vpredict = _mm_add_epi32(vpredict,
+                    _mm_mullo_epi32(NARUFILTERLANES_LOAD_SSE41(ngsa_weight, ord), NARUFILTERLANES_LOAD_SSE41(pngsa_history, ord)));
+        }
+        vpredict = _mm_srai_epi32(vpredict, NARU_FIXEDPOINT_DIGITS);
+        vresidual = _mm_sub_epi32(vemphasized, vpredict);
+
+        /* NGSA: バッファ参照位置更新 */
+        ngsa_pos = (ngsa_pos - 1) & ngsa_mask;
+
+        /* NGSA: 自然勾配更新 */
+        pngsa_ngrad = &ngsa_ngrad[ngsa_pos * NARUFILTER_NUM_LANES];
+        for (ord = 0; ord < ar_order; ord++) {
+            const int32_t pos = (ngsa_pos + ngsa_order - 1 - ord) & ngsa_mask;
+            __m128i vg = NARUFILTERLANES_LOAD_SSE41(ngsa_ngrad, pos);
+            vg = _mm_add_epi32(vg, _mm_srai_epi32(_mm_mullo_epi32(
+                            NARUFILTERLANES_LOAD_SSE41(ngsa_ar_coef, ord), NARUFILTERLANES_LOAD_SSE41(pngsa_ngrad, ngsa_order)), NARU_FIXEDPOINT_DIGITS));
+            NARUFILTERLANES_STORE_SSE41(ngsa_ngrad, pos, vg);
+            NARUFILTERLANES_STORE_SSE41(ngsa_ngrad, pos + ngsa_order, vg);
+        }
+        vngrad0 = _mm_setzero_si128();
+        for (ord = 0; ord < ar_order; ord++) {
+            vngrad0 = _mm_sub_epi32(vngrad0,
+                    _mm_mullo_epi32(NARUFILTERLANES_LOAD_SSE41(ngsa_ar_coef, ord), NARUFILTERLANES_LOAD_SSE41(pngsa_history, ord + 1)));
+        }
+        vngrad0 = _mm_add_epi32(_mm_srai_epi32(vngrad0, NARU_FIXEDPOINT_DIGITS), NARUFILTERLANES_LOAD_SSE41(pngsa_history, 0));
+        NARUFILTERLANES_STORE_SSE41(pngsa_ngrad, 0, vngrad0);
+        for (ord = 0; ord < ar_order; ord++) {
+            const int32_t pos = (ngsa_pos + ord + 1) & ngsa_mask;
+            __m128i vg = NARUFILTERLANES_LOAD_SSE41(ngsa_ngrad, pos);
+            vg = _mm_sub_epi32(vg, _mm_srai_epi32(_mm_mullo_epi32(
+                            NARUFILTERLANES_LOAD_SSE41(ngsa_ar_coef, ord), vngrad0), NARU_FIXEDPOINT_DIGITS));
+            NARUFILTERLANES_STORE_SSE41(ngsa_ngrad, pos, vg);
+            NARUFILTERLANES_STORE_SSE41(ngsa_ngrad, pos + ngsa_order, vg);
+        }
+
+        /* NGSA: フィルタ係数更新 符号による変更量の選択はsign命令で代用 */
+        vdelta = _mm_sign_epi32(vstepsize, vresidual);
+        for (ord = 0; ord < ngsa_order; ord++) {
+            __m128i vmul = _mm_add_epi32(_mm_mullo_epi32(vdelta, NARUFILTERLANES_LOAD_SSE41(pngsa_ngrad, ord)), vdelta_half);
+            vmul = _mm_sra_epi32(vmul, vdelta_rshift);
+            NARUFILTERLANES_STORE_SSE41(ngsa_weight, ord, _mm_add_epi32(NARUFILTERLANES_LOAD_SSE41(ngsa_weight, ord), vmul));
+        }
+
+        /* NGSA: 入力データ履歴更新 */
+        NARUFILTERLANES_STORE_SSE41(ngsa_history, ngsa_pos, vemphasized);
+        NARUFILTERLANES_STORE_SSE41(ngsa_history, ngsa_pos + ngsa_order, vemphasized);
+
+        /* SA: フィルタ予測 */
+        vinput = vresidual;
+        psa_history = &sa_history[sa_pos * NARUFILTER_NUM_LANES];
+        vpredict = vfixed_half;
+        for (ord = 0; ord < sa_order; ord++) {
+            vpredict = _mm_add_epi32(vpredict,
+                    _mm_mullo_epi32(NARUFILTERLANES_LOAD_SSE41(sa_weight, ord), NARUFILTERLANES_LOAD_SSE41(psa_history, ord)));
+        }
+        vpredict = _mm_srai_epi32(vpredict, NARU_FIXEDPOINT_DIGITS);
+        vresidual = _mm_sub_epi32(vinput, vpredict);
+
+        /* SA: 係数更新 */
+        for (ord = 0; ord < sa_order; ord++) {
+            NARUFILTERLANES_STORE_SSE41(sa_weight, ord, _mm_add_epi32(NARUFILTERLANES_LOAD_SSE41(sa_weight, ord),
+                        _mm_sign_epi32(NARUFILTERLANES_LOAD_SSE41(psa_history, ord), vresidual)));
+        }
+
+        /* SA: 入力データ履歴更新 */
+        sa_pos = (sa_pos - 1) & sa_mask;
+        NARUFILTERLANES_STORE_SSE41(sa_history, sa_pos, vinput);
+        NARUFILTERLANES_STORE_SSE41(sa_history, sa_pos + sa_order, vinput);
+
+        /* 残差を各チャンネルに書き戻し */
+        _mm_storeu_si128((__m128i *)tmp, vresidual);
+        for (lane = 0; lane < num_lanes; lane++) {
+            buffer[base_lane + lane][smpl] = tmp[lane];
+        }
+    }
+
+    /* 状態を書き戻し（参照位置は全レーン共通なので呼び出し元で更新） */
+    _mm_store_si128((__m128i *)&lanes->emphasis_prev[base_lane], vemphasis_prev);
+}
+
+/* 先頭レーンから4レーン分の合成（SSE4.1） */
+static void NARUFilter_SynthesizeLanesSSE41Group(
+        struct NARUFilterLanes *lanes, int32_t *const *buffer, uint32_t num_samples, int32_t base_lane)
+{
+    uint32_t smpl;
+    int32_t ord, lane, ngsa_pos, sa_pos;
+    int32_t *ngsa_history, *ngsa_weight, *ngsa_ngrad, *sa_history, *sa_weight;
+    const int32_t *ngsa_ar_coef;
+    int32_t tmp[NARUFILTERLANES_NUM_LANES_SSE41];
+    __m128i vemphasis_prev;
+    const int32_t num_lanes = NARUUTILITY_MIN(lanes->num_lanes - base_lane, NARUFILTERLANES_NUM_LANES_SSE41);
+    const int32_t ngsa_order = lanes->ngsa_filter_order;
+    const int32_t ngsa_mask = (ngsa_order > 0) ? (ngsa_order - 1) : 0;
+    const int32_t ar_order = lanes->ngsa_ar_order;
+    const int32_t sa_order = lanes->sa_filter_order;
+    const int32_t sa_mask = (sa_order > 0) ? (sa_order - 1) : 0;
+    const __m128i vfixed_half = _mm_set1_epi32(NARU_FIXEDPOINT_0_5);
+    const __m128i vemphasis_coef = _mm_set1_epi32((1 << NARU_EMPHASIS_FILTER_SHIFT) - 1);
+    const __m128i vstepsize = _mm_load_si128((const __m128i *)&lanes->ngsa_stepsize[base_lane]);
+    const __m128i vdelta_half = _mm_set1_epi32(1 << (lanes->ngsa_delta_rshift - 1));
+    const __m128i vdelta_rshift = _mm_cvtsi32_si128(lanes->ngsa_delta_rshift);
+
+    NARU_ASSERT(lanes != NULL);
+    NARU_ASSERT(buffer != NULL);
+    NARU_ASSERT((num_lanes > 0) && (num_lanes <= NARUFILTERLANES_NUM_LANES_SSE41));
+
+    /* ローカル変数に受けとく */
+    ngsa_history = &lanes->ngsa_history[base_lane];
+    ngsa_weight = &lanes->ngsa_weight[base_lane];
+    ngsa_ngrad = &lanes->ngsa_ngrad[base_lane];
+    ngsa_ar_coef = &lanes->ngsa_ar_coef[base_lane];
+    ngsa_pos = lanes->ngsa_buffer_pos;
+    sa_history = &lanes->sa_history[base_lane];
+    sa_weight = &lanes->sa_weight[base_lane];
+    sa_pos = lanes->sa_buffer_pos;
+    vemphasis_prev = _mm_load_si128((const __m128i *)&lanes->emphasis_prev[base_lane]);
+    memset(tmp, 0, sizeof(tmp));
+
+    for (smpl = 0; smpl < num_samples; smpl++) {
+        __m128i vresidual, vsynth, vpredict, vngrad0, vdelta;
+        int32_t *pngsa_history, *pngsa_ngrad, *psa_history;
+
+        /* 各チャンネルの残差をレーンに集める */
+        for (lane = 0; lane < num_lanes; lane++) {
+            tmp[lane] = buffer[base_lane + lane][smpl];
+        }
+        vresidual = _mm_loadu_si128((const __m128i *)tmp);
+
+        /* SA: フィルタ予測 */
+        psa_history = &sa_history[sa_pos * NARUFILTER_NUM_LANES];
+        vpredict = vfixed_half;
+        for (ord = 0; ord < sa_order; ord++) {
+            vpredict = _mm_add_epi32(vpredict,
+                    _mm_mullo_epi32(NARUFILTERLANES_LOAD_SSE41(sa_weight, ord), NARUFILTERLANES_LOAD_SSE41(psa_history, ord)));
+        }
+        vpredict = _mm_srai_epi32(vpredict, NARU_FIXEDPOINT_DIGITS);
+        vsynth = _mm_add_epi32(vresidual, vpredict);
+
+        /* SA: 係数更新 */
+        for (ord = 0; ord < sa_order; ord++) {
+            NARUFILTERLANES_STORE_SSE41(sa_weight, ord, _mm_add_epi32(NARUFILTERLANES_LOAD_SSE41(sa_weight, ord),
+                        _mm_sign_epi32(NARUFILTERLANES_LOAD_SSE41(psa_history, ord), vresidual)));
+        }
+
+        /* SA: 入力データ履歴更新 */
+        sa_pos = (sa_pos - 1) & sa_mask;
+        NARUFILTERLANES_STORE_SSE41(sa_history, sa_pos, vsynth);
+        NARUFILTERLANES_STORE_SSE41(sa_history, sa_pos + sa_order, vsynth);
+
+        /* NGSA: フィルタ予測 */
+        vresidual = vsynth;
+        pngsa_history = &ngsa_history[ngsa_pos * NARUFILTER_NUM_LANES];
+        vpredict = vfixed_half;
+        for (ord = 0; ord < ngsa_order; ord++) {
+            vpredict = _mm_add_epi32(vpredict,
+                    _mm_mullo_epi32(NARUFILTERLANES_LOAD_SSE41(ngsa_weight, ord), NARUFILTERLANES_LOAD_SSE41(pngsa_history, ord)));
+        }
+        vpredict = _mm_srai_epi32(vpredict, NARU_FIXEDPOINT_DIGITS);
+        vsynth = _mm_add_epi32(vresidual, vpredict);
+
+        /* NGSA: バッファ参照位置更新 */
+        ngsa_pos = (ngsa_pos - 1) & ngsa_mask;
+
+        /* NGSA: 自然勾配更新 */
+        pngsa_ngrad = &ngsa_ngrad[ngsa_pos * NARUFILTER_NUM_LANES];
+        for (ord = 0; ord < ar_order; ord++) {
+            const int32_t pos = (ngsa_pos + ngsa_order - 1 - ord) & ngsa_mask;
+            __m128i vg = NARUFILTERLANES_LOAD_SSE41(ngsa_ngrad, pos);
+            vg = _mm_add_epi32(vg, _mm_srai_epi32(_mm_mullo_epi32(
+                            NARUFILTERLANES_LOAD_SSE41(ngsa_ar_coef, ord), NARUFILTERLANES_LOAD_SSE41(pngsa_ngrad, ngsa_order)), NARU_FIXEDPOINT_DIGITS));
+            NARUFILTERLANES_STORE_SSE41(ngsa_ngrad, pos, vg);
+            NARUFILTERLANES_STORE_SSE41(ngsa_ngrad, pos + ngsa_order, vg);
+        }
+        vngrad0 = _mm_setzero_si128();
+        for (ord = 0; ord < ar_order; ord++) {
+            vngrad0 = _mm_sub_epi32(vngrad0,
+                    _mm_mullo_epi32(NARUFILTERLANES_LOAD_SSE41(ngsa_ar_coef, ord), NARUFILTERLANES_LOAD_SSE41(pngsa_history, ord + 1)));
+        }
+        vngrad0 = _mm_add_epi32(_mm_srai_epi32(vngrad0, NARU_FIXEDPOINT_DIGITS), NARUFILTERLANES_LOAD_SSE41(pngsa_history, 0));
+        NARUFILTERLANES_STORE_SSE41(pngsa_ngrad, 0, vngrad0);
+        for (ord = 0; ord < ar_order; ord++) {
+            const int32_t pos = (ngsa_pos + ord + 1) & ngsa_mask;
+            __m128i vg = NARUFILTERLANES_LOAD_SSE41(ngsa_ngrad, pos);
+            vg = _mm_sub_epi32(vg, _mm_srai_epi32(_mm_mullo_epi32(
+                            NARUFILTERLANES_LOAD_SSE41(ngsa_ar_coef, ord), vngrad0), NARU_FIXEDPOINT_DIGITS));
+            NARUFILTERLANES_STORE_SSE41(ngsa_ngrad, pos, vg);
+            NARUFILTERLANES_STORE_SSE41(ngsa_ngrad, pos + ngsa_order, vg);
+        }
+
+        /* NGSA: フィルタ係数更新 符号による変更量の選択はsign命令で代用 */
+        vdelta = _mm_sign_epi32(vstepsize, vresidual);
+        for (ord = 0; ord < ngsa_order; ord++) {
+            __m128i vmul = _mm_add_epi32(_mm_mullo_epi32(vdelta, NARUFILTERLANES_LOAD_SSE41(pngsa_ngrad, ord)), vdelta_half);
+            vmul = _mm_sra_epi32(vmul, vdelta_rshift);
+            NARUFILTERLANES_STORE_SSE41(ngsa_weight, ord, _mm_add_epi32(NARUFILTERLANES_LOAD_SSE41(ngsa_weight, ord), vmul));
+        }
+
+        /* NGSA: 入力データ履歴更新 */
+        NARUFILTERLANES_STORE_SSE41(ngsa_history, ngsa_pos, vsynth);
+        NARUFILTERLANES_STORE_SSE41(ngsa_history, ngsa_pos + ngsa_order, vsynth);
+
+        /* デエンファシス */
+        vsynth = _mm_add_epi32(vsynth,
+                _mm_srai_epi32(_mm_mullo_epi32(vemphasis_prev, vemphasis_coef), NARU_EMPHASIS_FILTER_SHIFT));
+        vemphasis_prev = vsynth;
+
+        /* 合成結果を各チャンネルに書き戻し */
+        _mm_storeu_si128((__m128i *)tmp, vsynth);
+        for (lane = 0; lane < num_lanes; lane++) {
+            buffer[base_lane + lane][smpl] = tmp[lane];
+        }
+    }
+
+    /* 状態を書き戻し（参照位置は全レーン共通なので呼び出し元で更新） */
+    _mm_store_si128((__m128i *)&lanes->emphasis_prev[base_lane], vemphasis_prev);
+}
+
+/* レーン毎の予測（SSE4.1） */
+void NARUFilter_PredictLanesSSE41(struct NARUFilterLanes *lanes, int32_t *const *buffer, uint32_t num_samples)
+{
+    int32_t base_lane;
+
+    NARU_ASSERT(lanes != NULL);
+    NARU_ASSERT(buffer != NULL);
+
+    /* 4レーンずつ処理 */
+    for (base_lane = 0; base_lane < lanes->num_lanes; base_lane += NARUFILTERLANES_NUM_LANES_SSE41) {
+        NARUFilter_PredictLanesSSE41Group(lanes, buffer, num_samples, base_lane);
+    }
+
+    /* 参照位置を進める */
+    lanes->ngsa_buffer_pos = (lanes->ngsa_buffer_pos - (int32_t)num_samples)
+        & ((lanes->ngsa_filter_order > 0) ? (lanes->ngsa_filter_order - 1) : 0);
+    lanes->sa_buffer_pos = (lanes->sa_buffer_pos - (int32_t)num_samples)
+        & ((lanes->sa_filter_order > 0) ? (lanes->sa_filter_order - 1) : 0);
+}
+
+/* レーン毎の合成（SSE4.1） */
+void NARUFilter_SynthesizeLanesSSE41(struct NARUFilterLanes *lanes, int32_t *const *buffer, uint32_t num_samples)
+{
+    int32_t base_lane;
+
+    NARU_ASSERT(lanes != NULL);
+    NARU_ASSERT(buffer != NULL);
+
+    /* 4レーンずつ処理 */
+    for (base_lane = 0; base_lane < lanes->num_lanes; base_lane += NARUFILTERLANES_NUM_LANES_SSE41) {
+        NARUFilter_SynthesizeLanesSSE41Group(lanes, buffer, num_samples, base_lane);
+    }
+
+    /* 参照位置を進める */
+    lanes->ngsa_buffer_pos = (lanes->ngsa_buffer_pos - (int32_t)num_samples)
+        & ((lanes->ngsa_filter_order > 0) ? (lanes->ngsa_filter_order - 1) : 0);
+    lanes->sa_buffer_pos = (lanes->sa_buffer_pos - (int32_t)num_samples)
+        & ((lanes->sa_filter_order > 0) ? (lanes->sa_filter_order - 1) : 0);
+}
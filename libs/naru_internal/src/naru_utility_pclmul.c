@@ -0,0 +1,69 @@
+#include "naru_utility.h"
+#include "naru_internal.h"
+
+#include <wmmintrin.h>
+
+/* 畳み込みの定数
+* 補足）128bitレジスタのビットiが(127-i)次の係数に対応する（入出力反転済みの）表現で畳み込む。
+* レジスタを上位側係数H（下位64bit）と下位側係数L（上位64bit）に分け、
+* n bit先へ畳み込む時はH * (x^(n+64) mod P) + L * (x^n mod P)を計算する。
+* 反転表現同士の積は1次ずれるため、定数はx^(n+63), x^(n-1)の剰余をビット反転して用いる */
+/* 128bit先への畳み込み: 下位64bitがx^191 mod P, 上位64bitがx^127 mod P */
+#define NARUCRC16PCLMUL_FOLD128_CONSTANT() _mm_set_epi32((int)0xC1000000, 0, (int)0xCCD00000, 0)
+/* 512bit先への畳み込み: 下位64bitがx^575 mod P, 上位64bitがx^511 mod P */
+#define NARUCRC16PCLMUL_FOLD512_CONSTANT() _mm_set_epi32((int)0x81010000, 0, (int)0xC4500000, 0)
+
+/* 畳み込み */
+#define NARUCRC16PCLMUL_FOLD(x, k)\
+    _mm_xor_si128(_mm_clmulepi64_si128((x), (k), 0x00), _mm_clmulepi64_si128((x), (k), 0x11))
+
+/* CRC16(IBM)の計算（PCLMULQDQ） */
+uint16_t NARUUtility_CalculateCRC16PCLMUL(const uint8_t *data, uint64_t data_size)
+{
+    __m128i x0, x1, x2, x3;
+    uint8_t folded[16];
+    const __m128i k128 = NARUCRC16PCLMUL_FOLD128_CONSTANT();
+    const __m128i k512 = NARUCRC16PCLMUL_FOLD512_CONSTANT();
+
+    /* 引数チェック */
+    NARU_ASSERT(data != NULL);
+
+    /* 4レーン分に満たなければテーブル参照で計算 */
+    if (data_size < 64) {
+        return NARUUtility_CalculateCRC16(data, data_size);
+    }
+
+    /* 初期値が0なので先頭64byteはそのまま読み込む */
+    x0 = _mm_loadu_si128((const __m128i *)&data[0]);
+    x1 = _mm_loadu_si128((const __m128i *)&data[16]);
+    x2 = _mm_loadu_si128((const __m128i *)&data[32]);
+    x3 = _mm_loadu_si128((const __m128i *)&data[48]);
+    data += 64;
+    data_size -= 64;
+
+    /* 4レーン並列に512bitずつ畳み込む */
+    while (data_size >= 64) {
+        x0 = _mm_xor_si128(NARUCRC16PCLMUL_FOLD(x0, k512), _mm_loadu_si128((const __m128i *)&data[0]));
+        x1 = _mm_xor_si128(NARUCRC16PCLMUL_FOLD(x1, k512), _mm_loadu_si128((const __m128i *)&data[16]));
+        x2 = _mm_xor_si128(NARUCRC16PCLMUL_FOLD(x2, k512), _mm_loadu_si128((const __m128i *)&data[32]));
+        x3 = _mm_xor_si128(NARUCRC16PCLMUL_FOLD(x3, k512), _mm_loadu_si128((const __m128i *)&data[48]));
+        data += 64;
+        data_size -= 64;
+    }
+
+    /* 4レーンを1つにまとめる */
+    x1 = _mm_xor_si128(NARUCRC16PCLMUL_FOLD(x0, k128), x1);
+    x2 = _mm_xor_si128(NARUCRC16PCLMUL_FOLD(x1, k128), x2);
+    x3 = _mm_xor_si128(NARUCRC16PCLMUL_FOLD(x2, k128), x3);
+
+    /* 残りを128bitずつ畳み込む */
+    while (data_size >= 16) {
+        x3 = _mm_xor_si128(NARUCRC16PCLMUL_FOLD(x3, k128), _mm_loadu_si128((const __m128i *)data));
+        data += 16;
+        data_size -= 16;
+    }
+
+    /* 畳み込んだ128bitは処理済みデータと同じ剰余を持つので、そのCRC16に端数分を続けて計算 */
+    _mm_storeu_si128((__m128i *)folded, x3);
+    return NARUUtility_UpdateCRC16(NARUUtility_CalculateCRC16(folded, sizeof(folded)), data, data_size);
+}
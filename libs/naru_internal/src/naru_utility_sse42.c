@@ -0,0 +1,97 @@
+#include "naru_utility.h"
+#include "naru_internal.h"
+
+#include <string.h>
+#include <nmmintrin.h>
+
+#if defined(__x86_64__) || defined(_M_X64)
+/* 3系列並列処理で1系列が受け持つバイト数 */
+#define NARUCRC32CSSE42_LANE_BYTES 1024
+
+/* CRC32Cのレジスタ値をNARUCRC32CSSE42_LANE_BYTESだけ0を入力した後の値に進めるための表
+* 補足）[i]はレジスタの第iビットのみ1の時の結果。線形なので立っているビットの結果の排他的論理和をとればよい */
+static const uint32_t st_crc32c_lane_shift_table[32] = {
+    0xfe314258, 0xf98ef241, 0xf6f19273, 0xe80f5217,
+    0xd5f2d2df, 0xae09d34f, 0x59ffd06f, 0xb3ffa0de,
+    0x6213374d, 0xc4266e9a, 0x8da0abc5, 0x1ead217b,
+    0x3d5a42f6, 0x7ab485ec, 0xf5690bd8, 0xef3e6141,
+    0xdb90b473, 0xb2cd1e17, 0x60764adf, 0xc0ec95be,
+    0x84355d8d, 0x0d86cdeb, 0x1b0d9bd6, 0x361b37ac,
+    0x6c366f58, 0xd86cdeb0, 0xb535cb91, 0x6f87e1d3,
+    0xdf0fc3a6, 0xbbf3f1bd, 0x720b958b, 0xe4172b16
+};
+
+/* CRC32Cのレジスタ値を1系列分のバイト数だけ進める */
+static uint64_t NARUCRC32CSSE42_ShiftLane(uint64_t crc32c)
+{
+    uint32_t i, shifted = 0;
+
+    for (i = 0; i < 32; i++) {
+        shifted ^= st_crc32c_lane_shift_table[i] & (0U - (uint32_t)((crc32c >> i) & 1));
+    }
+
+    return shifted;
+}
+#endif
+
+/* CRC32Cの計算（SSE4.2） */
+uint32_t NARUUtility_CalculateCRC32CSSE42(const uint8_t *data, uint64_t data_size)
+{
+#if defined(__x86_64__) || defined(_M_X64)
+    uint64_t crc32c;
+#else
+    uint32_t crc32c;
+#endif
+
+    /* 引数チェック */
+    NARU_ASSERT(data != NULL);
+
+    /* 初期値 */
+    crc32c = 0xFFFFFFFFUL;
+
+    /* 1命令で処理できる最大幅ずつ処理
+    * 補足）crc32命令はリトルエンディアンで読んだ値を入力とするが、x86なのでそのまま読めばよい */
+#if defined(__x86_64__) || defined(_M_X64)
+    /* crc32命令のレイテンシを隠すため、連続する3区間を並列に計算してから結合する
+    * 補足）区間A,B,Cを続けた結果は、Aの結果をB,Cの長さ分進めたものとBの結果をCの長さ分進めたものとCの結果（いずれも初期値0）の排他的論理和 */
+    while (data_size >= (3 * NARUCRC32CSSE42_LANE_BYTES)) {
+        uint32_t i;
+        uint64_t crc1 = 0, crc2 = 0;
+        for (i = 0; i < NARUCRC32CSSE42_LANE_BYTES; i += 8) {
+            uint64_t buf0, buf1, buf2;
+            memcpy(&buf0, &data[i], sizeof(uint64_t));
+            memcpy(&buf1, &data[i + NARUCRC32CSSE42_LANE_BYTES], sizeof(uint64_t));
+            memcpy(&buf2, &data[i + 2 * NARUCRC32CSSE42_LANE_BYTES], sizeof(uint64_t));
+            crc32c = _mm_crc32_u64(crc32c, buf0);
+            crc1 = _mm_crc32_u64(crc1, buf1);
+            crc2 = _mm_crc32_u64(crc2, buf2);
+        }
+        crc32c = NARUCRC32CSSE42_ShiftLane(NARUCRC32CSSE42_ShiftLane(crc32c) ^ crc1) ^ crc2;
+        data += 3 * NARUCRC32CSSE42_LANE_BYTES;
+        data_size -= 3 * NARUCRC32CSSE42_LANE_BYTES;
+    }
+    while (data_size >= 8) {
+        uint64_t buf;
+        memcpy(&buf, data, sizeof(uint64_t));
+        crc32c = _mm_crc32_u64(crc32c, buf);
+        data += 8;
+        data_size -= 8;
+    }
+#else
+    while (data_size >= 4) {
+        uint32_t buf;
+        memcpy(&buf, data, sizeof(uint32_t));
+        crc32c = _mm_crc32_u32(crc32c, buf);
+        data += 4;
+        data_size -= 4;
+    }
+#endif
+
+    /* 端数分 */
+    while (data_size--) {
+        crc32c = _mm_crc32_u8((uint32_t)crc32c, *data++);
+    }
+
+    /* 出力反転 */
+    return (uint32_t)crc32c ^ 0xFFFFFFFFUL;
+}
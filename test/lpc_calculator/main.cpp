@@ -85,6 +85,96 @@ TEST(LPCCalculatorTest, CreateDestroyHandleTest)
     }
 }
 
+/* 係数と推定符号長の一括計算テスト */
+TEST(LPCCalculatorTest, CalculateCoefAndCodeLengthTest)
+{
+#define NUM_SAMPLES 1024
+#define ORDER       8
+    /* 個別に計算した結果と一致するか */
+    {
+        uint32_t smpl, ord;
+        struct LPCCalculator *lpcc;
+        double data[NUM_SAMPLES];
+        double lpc_coef[ORDER + 1], parcor_coef[ORDER + 1], length;
+        double ref_lpc_coef[ORDER + 1], ref_parcor_coef[ORDER + 1], ref_length;
+
+        lpcc = LPCCalculator_Create(ORDER, NULL, 0);
+        ASSERT_TRUE(lpcc != NULL);
+
+        /* 減衰する正弦波と微小な雑音 */
+        srand(0);
+        for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+            data[smpl] = 0.5 * sin(0.05 * smpl) * exp(-0.001 * smpl) + 1.0e-3 * ((double)rand() / RAND_MAX - 0.5);
+        }
+
+        ASSERT_EQ(LPCCALCULATOR_APIRESULT_OK,
+                LPCCalculator_CalculateCoefAndCodeLength(lpcc, data, NUM_SAMPLES, 16, lpc_coef, parcor_coef, ORDER, &length));
+
+        /* LPC係数はLevinson-Durbin再帰の中間ベクトルを直接取り出す */
+        ASSERT_EQ(LPCCALCULATOR_ERROR_OK, LPCCalculator_CalculateCoef(lpcc, data, NUM_SAMPLES, ORDER));
+        memcpy(ref_lpc_coef, lpcc->lpc_coef, sizeof(double) * (ORDER + 1));
+        ASSERT_EQ(LPCCALCULATOR_APIRESULT_OK,
+                LPCCalculator_CalculatePARCORCoef(lpcc, data, NUM_SAMPLES, ref_parcor_coef, ORDER));
+        ASSERT_EQ(LPCCALCULATOR_APIRESULT_OK,
+                LPCCalculator_EstimateCodeLength(data, NUM_SAMPLES, 16, ref_parcor_coef, ORDER, &ref_length));
+
+        for (ord = 0; ord < ORDER + 1; ord++) {
+            EXPECT_EQ(ref_lpc_coef[ord], lpc_coef[ord]);
+            EXPECT_EQ(ref_parcor_coef[ord], parcor_coef[ord]);
+        }
+        EXPECT_EQ(ref_length, length);
+
+        LPCCalculator_Destroy(lpcc);
+    }
+
+    /* 無音の場合は符号長0 */
+    {
+        struct LPCCalculator *lpcc;
+        double data[NUM_SAMPLES];
+        double lpc_coef[ORDER + 1], parcor_coef[ORDER + 1], length;
+
+        lpcc = LPCCalculator_Create(ORDER, NULL, 0);
+        ASSERT_TRUE(lpcc != NULL);
+
+        memset(data, 0, sizeof(data));
+        ASSERT_EQ(LPCCALCULATOR_APIRESULT_OK,
+                LPCCalculator_CalculateCoefAndCodeLength(lpcc, data, NUM_SAMPLES, 16, lpc_coef, parcor_coef, ORDER, &length));
+        EXPECT_EQ(0.0, length);
+
+        LPCCalculator_Destroy(lpcc);
+    }
+
+    /* 失敗ケース */
+    {
+        struct LPCCalculator *lpcc;
+        double data[NUM_SAMPLES];
+        double lpc_coef[ORDER + 2], parcor_coef[ORDER + 2], length;
+
+        lpcc = LPCCalculator_Create(ORDER, NULL, 0);
+        ASSERT_TRUE(lpcc != NULL);
+
+        memset(data, 0, sizeof(data));
+        EXPECT_EQ(LPCCALCULATOR_APIRESULT_INVALID_ARGUMENT,
+                LPCCalculator_CalculateCoefAndCodeLength(NULL, data, NUM_SAMPLES, 16, lpc_coef, parcor_coef, ORDER, &length));
+        EXPECT_EQ(LPCCALCULATOR_APIRESULT_INVALID_ARGUMENT,
+                LPCCalculator_CalculateCoefAndCodeLength(lpcc, NULL, NUM_SAMPLES, 16, lpc_coef, parcor_coef, ORDER, &length));
+        EXPECT_EQ(LPCCALCULATOR_APIRESULT_INVALID_ARGUMENT,
+                LPCCalculator_CalculateCoefAndCodeLength(lpcc, data, 0, 16, lpc_coef, parcor_coef, ORDER, &length));
+        EXPECT_EQ(LPCCALCULATOR_APIRESULT_INVALID_ARGUMENT,
+                LPCCalculator_CalculateCoefAndCodeLength(lpcc, data, NUM_SAMPLES, 16, NULL, parcor_coef, ORDER, &length));
+        EXPECT_EQ(LPCCALCULATOR_APIRESULT_INVALID_ARGUMENT,
+                LPCCalculator_CalculateCoefAndCodeLength(lpcc, data, NUM_SAMPLES, 16, lpc_coef, NULL, ORDER, &length));
+        EXPECT_EQ(LPCCALCULATOR_APIRESULT_INVALID_ARGUMENT,
+                LPCCalculator_CalculateCoefAndCodeLength(lpcc, data, NUM_SAMPLES, 16, lpc_coef, parcor_coef, ORDER, NULL));
+        EXPECT_EQ(LPCCALCULATOR_APIRESULT_EXCEED_MAX_ORDER,
+                LPCCalculator_CalculateCoefAndCodeLength(lpcc, data, NUM_SAMPLES, 16, lpc_coef, parcor_coef, ORDER + 1, &length));
+
+        LPCCalculator_Destroy(lpcc);
+    }
+#undef NUM_SAMPLES
+#undef ORDER
+}
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
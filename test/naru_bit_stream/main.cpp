@@ -23,7 +23,7 @@ TEST(NARUBitStreamTest, CreateDestroyTest)
         EXPECT_EQ(test_memory_size, strm.memory_size);
         EXPECT_TRUE(strm.memory_p == test_memory);
         EXPECT_EQ(0, strm.bit_buffer);
-        EXPECT_EQ(8, strm.bit_count);
+        EXPECT_EQ(NARUBITWRITER_BUFFER_BITS, strm.bit_count);
         EXPECT_TRUE(!(strm.flags & NARUBITSTREAM_FLAGS_MODE_READ));
         NARUBitStream_Close(&strm);
 
@@ -114,7 +114,7 @@ TEST(NARUBitStreamTest, PutGetTest)
         /* 2bitしか書いていないがフラッシュ */
         NARUBitStream_Flush(&strm);
         EXPECT_EQ(0, strm.bit_buffer);
-        EXPECT_EQ(8, strm.bit_count);
+        EXPECT_EQ(NARUBITWRITER_BUFFER_BITS, strm.bit_count);
         NARUBitStream_Close(&strm);
 
         /* 1バイトで先頭2bitだけが立っているはず */
@@ -122,8 +122,15 @@ TEST(NARUBitStreamTest, PutGetTest)
         NARUBitReader_GetBits(&strm, &bits, 8);
         EXPECT_EQ(0xC0, bits);
         NARUBitStream_Flush(&strm);
+#if defined(NARUBITSTREAM_USE_64BIT_BUFFER)
+        /* 先読みしたバイトは残るが、バイト境界に揃っているはず */
+        EXPECT_EQ(0, strm.bit_count % 8);
+        NARUBitStream_Tell(&strm, (int32_t *)&bits);
+        EXPECT_EQ(1, bits);
+#else
         EXPECT_EQ(0, strm.bit_count);
         EXPECT_EQ(0xC0, strm.bit_buffer);
+#endif
         NARUBitStream_Close(&strm);
     }
 
@@ -202,6 +209,142 @@ TEST(NARUBitStreamTest, GetZeroRunLengthTest)
     }
 }
 
+/* 0の並びの書き込みテスト */
+TEST(NARUBitStreamTest, PutZeroRunTest)
+{
+    /* 書き込み開始位置と長さを変えて書き込み、ランレングスとして読めるか */
+    {
+        struct NARUBitStream strm;
+        uint8_t data[64];
+        uint32_t offset, test_length, run, bits;
+        int32_t size;
+
+        for (offset = 0; offset < 8; offset++) {
+            for (test_length = 0; test_length <= 300; test_length++) {
+                NARUBitWriter_Open(&strm, data, sizeof(data));
+                if (offset > 0) {
+                    NARUBitWriter_PutBits(&strm, 0xFF, offset);
+                }
+                NARUBitWriter_PutZeroRun(&strm, test_length);
+                NARUBitWriter_PutBits(&strm, 1, 1);
+                NARUBitStream_Flush(&strm);
+                NARUBitStream_Tell(&strm, &size);
+                NARUBitStream_Close(&strm);
+                EXPECT_EQ((offset + test_length + 1 + 7) / 8, (uint32_t)size);
+
+                NARUBitReader_Open(&strm, data, (size_t)size);
+                if (offset > 0) {
+                    NARUBitReader_GetBits(&strm, &bits, offset);
+                    EXPECT_EQ(0xFFU >> (8 - offset), bits);
+                }
+                NARUBitReader_GetZeroRunLength(&strm, &run);
+                EXPECT_EQ(test_length, run);
+                NARUBitStream_Close(&strm);
+            }
+        }
+    }
+}
+
+/* ビット読み込みとランレングス取得を混ぜたテスト */
+TEST(NARUBitStreamTest, MixedReadTest)
+{
+    /* 長いランや終端付近の読み込みを含めて書いた値が読めるか */
+    {
+#define TEST_NUM_CODES 2000
+        struct NARUBitStream strm;
+        uint8_t *data;
+        uint32_t *runs, *vals, *nbits;
+        uint32_t i, run, val, is_ok;
+        int32_t size, pos;
+
+        data = (uint8_t *)malloc(TEST_NUM_CODES * 32);
+        runs = (uint32_t *)malloc(sizeof(uint32_t) * TEST_NUM_CODES);
+        vals = (uint32_t *)malloc(sizeof(uint32_t) * TEST_NUM_CODES);
+        nbits = (uint32_t *)malloc(sizeof(uint32_t) * TEST_NUM_CODES);
+
+        srand(0);
+        NARUBitWriter_Open(&strm, data, TEST_NUM_CODES * 32);
+        for (i = 0; i < TEST_NUM_CODES; i++) {
+            /* たまに64bitを越えるランを混ぜる */
+            runs[i] = ((i % 97) == 0) ? (uint32_t)(64 + (rand() % 100)) : (uint32_t)(rand() % 20);
+            nbits[i] = (uint32_t)(rand() % 33);
+            vals[i] = (nbits[i] > 0) ? ((uint32_t)rand() & (0xFFFFFFFFUL >> (32 - nbits[i]))) : 0;
+            run = runs[i];
+            while (run > 0) {
+                const uint32_t n = (run > 32) ? 32 : run;
+                NARUBitWriter_PutBits(&strm, 0, n);
+                run -= n;
+            }
+            NARUBitWriter_PutBits(&strm, 1, 1);
+            if (nbits[i] > 0) {
+                NARUBitWriter_PutBits(&strm, vals[i], nbits[i]);
+            }
+        }
+        NARUBitStream_Flush(&strm);
+        NARUBitStream_Tell(&strm, &size);
+        NARUBitStream_Close(&strm);
+
+        /* 書き込んだサイズちょうどのメモリとして読む */
+        NARUBitReader_Open(&strm, data, (size_t)size);
+        is_ok = 1;
+        for (i = 0; i < TEST_NUM_CODES; i++) {
+            NARUBitReader_GetZeroRunLength(&strm, &run);
+            NARUBitReader_GetBits(&strm, &val, nbits[i]);
+            if ((run != runs[i]) || (val != vals[i])) {
+                is_ok = 0;
+                break;
+            }
+        }
+        EXPECT_EQ(1, is_ok);
+        NARUBitStream_Flush(&strm);
+        NARUBitStream_Tell(&strm, &pos);
+        EXPECT_EQ(size, pos);
+        NARUBitStream_Close(&strm);
+
+        free(nbits);
+        free(vals);
+        free(runs);
+        free(data);
+#undef TEST_NUM_CODES
+    }
+
+    /* 読み込み途中のTell/Seek */
+    {
+        struct NARUBitStream strm;
+        uint8_t data[16];
+        uint32_t i, val;
+        int32_t pos;
+
+        for (i = 0; i < sizeof(data); i++) {
+            data[i] = (uint8_t)(0x11 * i);
+        }
+
+        NARUBitReader_Open(&strm, data, sizeof(data));
+        /* 読み込み途中のバイトの次を指す */
+        NARUBitReader_GetBits(&strm, &val, 12);
+        EXPECT_EQ(0x001, val);
+        NARUBitStream_Tell(&strm, &pos);
+        EXPECT_EQ(2, pos);
+        /* 現在位置からのシーク */
+        NARUBitStream_Seek(&strm, 3, NARUBITSTREAM_SEEK_CUR);
+        NARUBitStream_Tell(&strm, &pos);
+        EXPECT_EQ(5, pos);
+        NARUBitReader_GetBits(&strm, &val, 16);
+        EXPECT_EQ(0x5566, val);
+        /* 先頭に戻って読み直す */
+        NARUBitStream_Seek(&strm, 0, NARUBITSTREAM_SEEK_SET);
+        NARUBitReader_GetBits(&strm, &val, 32);
+        EXPECT_EQ(0x00112233UL, val);
+        /* 終端の1バイト */
+        NARUBitStream_Seek(&strm, 0, NARUBITSTREAM_SEEK_END);
+        NARUBitReader_GetBits(&strm, &val, 8);
+        EXPECT_EQ(0xFF, val);
+        NARUBitStream_Tell(&strm, &pos);
+        EXPECT_EQ(16, pos);
+        NARUBitStream_Close(&strm);
+    }
+}
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -8,6 +8,61 @@ extern "C" {
 #include "../../libs/naru_coder/src/naru_coder.c"
 }
 
+/* 再帰的ライス符号を1つだけ出力 */
+static void NARURecursiveRice_PutCode(
+        struct NARUBitStream *stream, NARURecursiveRiceParameter* rice_parameters, uint32_t num_params, uint32_t val)
+{
+    struct NARURecursiveRiceEncodeTable table;
+
+    NARURecursiveRice_MakeEncodeTable(&table, rice_parameters, num_params);
+    NARURecursiveRice_PutCodeByTable(stream, rice_parameters, num_params, &table, val);
+}
+
+/* 再帰的ライス符号を1つだけ取得 */
+static uint32_t NARURecursiveRice_GetCode(
+        struct NARUBitStream *stream, NARURecursiveRiceParameter* rice_parameters, uint32_t num_params)
+{
+    uint32_t val;
+    struct NARUCoderBitPeeker peeker;
+    struct NARURecursiveRiceDecodeTable table;
+
+    NARUCoderBitPeeker_Load(&peeker, stream);
+    NARURecursiveRice_MakeDecodeTable(&table, rice_parameters, num_params);
+    val = NARURecursiveRice_GetCodeByTable(&peeker, rice_parameters, num_params, &table);
+    NARUCoderBitPeeker_Store(&peeker, stream);
+
+    return val;
+}
+
+/* 素朴な実装によるゴロム符号の出力（比較用） */
+static void NARUGolomb_PutCodeReference(struct NARUBitStream *stream, uint32_t m, uint32_t val)
+{
+    uint32_t i, quot, rest, b, two_b;
+
+    quot = val / m;
+    rest = val % m;
+
+    for (i = 0; i < quot; i++) {
+        NARUBitWriter_PutBits(stream, 0, 1);
+    }
+    NARUBitWriter_PutBits(stream, 1, 1);
+
+    b = NARUUTILITY_LOG2CEIL(m);
+    if (NARUUTILITY_IS_POWERED_OF_2(m)) {
+        if (m > 1) {
+            NARUBitWriter_PutBits(stream, rest, b);
+        }
+        return;
+    }
+
+    two_b = (uint32_t)(1UL << b);
+    if (rest < (two_b - m)) {
+        NARUBitWriter_PutBits(stream, rest, b - 1);
+    } else {
+        NARUBitWriter_PutBits(stream, rest + two_b - m, b);
+    }
+}
+
 /* ハンドル作成破棄テスト */
 TEST(NARUCoderTest, CreateDestroyHandleTest)
 {
@@ -358,6 +413,429 @@ TEST(NARUCoderTest, RecursiveRiceTest)
 
 }
 
+/* 復号テーブルによる連続復号テスト */
+TEST(NARUCoderTest, RecursiveRiceDecodeTableTest)
+{
+    /* 乱数値を符号化し、テーブル復号の結果と読み出し位置を確認 */
+    {
+#define TEST_OUTPUT_LENGTH 4096
+        uint32_t i, num_params, encsize, marker, is_ok;
+        uint32_t *data;
+        uint8_t *encimg;
+        struct NARUBitStream strm;
+        struct NARUCoderBitPeeker peeker;
+        struct NARURecursiveRiceDecodeTable table;
+        NARURecursiveRiceParameter param_array[NARUCODER_MAX_NUM_RECURSIVERICE_PARAMETER];
+
+        data = (uint32_t *)malloc(sizeof(uint32_t) * TEST_OUTPUT_LENGTH);
+        encimg = (uint8_t *)malloc(sizeof(uint32_t) * TEST_OUTPUT_LENGTH * 4);
+
+        for (num_params = 1; num_params <= 3; num_params++) {
+            /* 大小の値を混ぜる（大きな値でガンマ符号側も通す） */
+            srand(num_params);
+            for (i = 0; i < TEST_OUTPUT_LENGTH; i++) {
+                data[i] = (uint32_t)rand() >> (rand() % 31);
+                if ((i % 512) == 0) {
+                    data[i] = 0;
+                }
+            }
+
+            /* 書き込み: 末尾に目印を付ける */
+            NARUBitWriter_Open(&strm, encimg, sizeof(uint32_t) * TEST_OUTPUT_LENGTH * 4);
+            for (i = 0; i < num_params; i++) {
+                NARUCODER_PARAMETER_SET(param_array, i, 1);
+            }
+            for (i = 0; i < TEST_OUTPUT_LENGTH; i++) {
+                NARURecursiveRice_PutCode(&strm, param_array, num_params, data[i]);
+            }
+            NARUBitWriter_PutBits(&strm, 0x5A, 8);
+            NARUBitStream_Flush(&strm);
+            NARUBitStream_Tell(&strm, (int32_t *)&encsize);
+            NARUBitStream_Close(&strm);
+
+            /* 読み込み */
+            NARUBitReader_Open(&strm, encimg, encsize);
+            for (i = 0; i < num_params; i++) {
+                NARUCODER_PARAMETER_SET(param_array, i, 1);
+            }
+            is_ok = 1;
+            NARUCoderBitPeeker_Load(&peeker, &strm);
+            NARURecursiveRice_MakeDecodeTable(&table, param_array, num_params);
+            for (i = 0; i < TEST_OUTPUT_LENGTH; i++) {
+                if (NARURecursiveRice_GetCodeByTable(&peeker, param_array, num_params, &table) != data[i]) {
+                    is_ok = 0;
+                    break;
+                }
+            }
+            NARUCoderBitPeeker_Store(&peeker, &strm);
+            EXPECT_EQ(1, is_ok);
+
+            /* 書き戻した位置から続きを読めるか */
+            NARUBitReader_GetBits(&strm, &marker, 8);
+            EXPECT_EQ(0x5A, marker);
+            NARUBitStream_Close(&strm);
+        }
+
+        free(encimg);
+        free(data);
+#undef TEST_OUTPUT_LENGTH
+    }
+}
+
+/* 再帰的ライス符号の符号化テーブルテスト */
+TEST(NARUCoderTest, RecursiveRiceEncodeTableTest)
+{
+    /* キャッシュした桁数とその有効範囲が、パラメータから直接計算した桁数と一致するか */
+    {
+        uint32_t i, is_ok;
+        NARURecursiveRiceParameter param, prev_param;
+        struct NARURecursiveRiceEncodeTable table;
+        NARURecursiveRiceParameter param_array[1];
+
+        is_ok = 1;
+        prev_param = 0;
+        param_array[0] = 0;
+        NARURecursiveRice_MakeEncodeTable(&table, param_array, 1);
+        /* 全ての桁数の境界付近を通るようにパラメータを動かす（32bitの符号を固定小数にした2^40未満の範囲） */
+        for (i = 0; i < (1 << 20); i++) {
+            param = (i < (1 << 16)) ? i : (((NARURecursiveRiceParameter)rand() << 9) ^ (NARURecursiveRiceParameter)rand()) >> (rand() % 32);
+            param_array[0] = param;
+            if ((param - table.lower[0]) >= table.width[0]) {
+                NARURecursiveRice_SetEncodeTableStage(&table, param_array, 0);
+            }
+            if ((table.k[0] != NARURICE_CALCULATE_LOG2_RICE_PARAMETER(param_array, 0))
+                    || ((param - table.lower[0]) >= table.width[0])) {
+                is_ok = 0;
+                break;
+            }
+            /* 直前のパラメータも範囲内ならば同じ桁数になるはず */
+            param_array[0] = prev_param;
+            if (((prev_param - table.lower[0]) < table.width[0])
+                    && (table.k[0] != NARURICE_CALCULATE_LOG2_RICE_PARAMETER(param_array, 0))) {
+                is_ok = 0;
+                break;
+            }
+            prev_param = param;
+        }
+        EXPECT_EQ(1, is_ok);
+    }
+
+    /* テーブルを使い続けた符号化結果が、毎回テーブルを作り直した結果と一致するか */
+    {
+#define TEST_OUTPUT_LENGTH 4096
+        uint32_t i, num_params;
+        int32_t size1, size2;
+        uint32_t *data;
+        uint8_t *encimg1, *encimg2;
+        struct NARUBitStream strm;
+        struct NARURecursiveRiceEncodeTable table;
+        NARURecursiveRiceParameter param_array[NARUCODER_MAX_NUM_RECURSIVERICE_PARAMETER];
+
+        data = (uint32_t *)malloc(sizeof(uint32_t) * TEST_OUTPUT_LENGTH);
+        encimg1 = (uint8_t *)malloc(sizeof(uint32_t) * TEST_OUTPUT_LENGTH * 4);
+        encimg2 = (uint8_t *)malloc(sizeof(uint32_t) * TEST_OUTPUT_LENGTH * 4);
+
+        for (num_params = 1; num_params <= 3; num_params++) {
+            srand(num_params);
+            for (i = 0; i < TEST_OUTPUT_LENGTH; i++) {
+                data[i] = (uint32_t)rand() >> (rand() % 31);
+            }
+
+            NARUBitWriter_Open(&strm, encimg1, sizeof(uint32_t) * TEST_OUTPUT_LENGTH * 4);
+            for (i = 0; i < num_params; i++) {
+                NARUCODER_PARAMETER_SET(param_array, i, 1);
+            }
+            for (i = 0; i < TEST_OUTPUT_LENGTH; i++) {
+                NARURecursiveRice_PutCode(&strm, param_array, num_params, data[i]);
+            }
+            NARUBitStream_Flush(&strm);
+            NARUBitStream_Tell(&strm, &size1);
+            NARUBitStream_Close(&strm);
+
+            NARUBitWriter_Open(&strm, encimg2, sizeof(uint32_t) * TEST_OUTPUT_LENGTH * 4);
+            for (i = 0; i < num_params; i++) {
+                NARUCODER_PARAMETER_SET(param_array, i, 1);
+            }
+            NARURecursiveRice_MakeEncodeTable(&table, param_array, num_params);
+            for (i = 0; i < TEST_OUTPUT_LENGTH; i++) {
+                NARURecursiveRice_PutCodeByTable(&strm, param_array, num_params, &table, data[i]);
+            }
+            NARUBitStream_Flush(&strm);
+            NARUBitStream_Tell(&strm, &size2);
+            NARUBitStream_Close(&strm);
+
+            ASSERT_EQ(size1, size2);
+            EXPECT_EQ(0, memcmp(encimg1, encimg2, (size_t)size1));
+        }
+
+        free(encimg2);
+        free(encimg1);
+        free(data);
+#undef TEST_OUTPUT_LENGTH
+    }
+}
+
+/* 固定パラメータのゴロム符号テスト */
+TEST(NARUCoderTest, GolombTest)
+{
+    /* 逆数乗算による除算が厳密か */
+    {
+        uint32_t m, i, is_ok;
+        struct NARUGolombParameter gp;
+        const uint32_t test_vals[] = { 0, 1, 2, 3, 0x7FFFFFFFU, 0x80000000U, 0xFFFFFFFEU, 0xFFFFFFFFU };
+
+        is_ok = 1;
+        srand(0);
+        for (m = 1; m <= 1024; m++) {
+            NARUGolombParameter_Set(&gp, m);
+            for (i = 0; i < sizeof(test_vals) / sizeof(test_vals[0]); i++) {
+                if (NARUGolombParameter_Divide(&gp, test_vals[i]) != (test_vals[i] / m)) {
+                    is_ok = 0;
+                }
+            }
+            for (i = 0; i < 1024; i++) {
+                const uint32_t val = ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+                if (NARUGolombParameter_Divide(&gp, val) != (val / m)) {
+                    is_ok = 0;
+                }
+            }
+        }
+        EXPECT_EQ(1, is_ok);
+    }
+
+    /* 一括符号化の結果が素朴な実装と一致し、復号できるか */
+    {
+#define TEST_NUM_CHANNELS 3
+#define TEST_NUM_SAMPLES  1000
+#define TEST_OUTPUT_SIZE  (TEST_NUM_CHANNELS * TEST_NUM_SAMPLES * 32)
+        uint32_t ch, smpl, m_base, marker, is_ok;
+        int32_t encsize, refsize;
+        uint32_t m[TEST_NUM_CHANNELS];
+        int32_t *data[TEST_NUM_CHANNELS], *decoded[TEST_NUM_CHANNELS];
+        uint8_t *encimg, *refimg;
+        struct NARUBitStream strm;
+
+        for (ch = 0; ch < TEST_NUM_CHANNELS; ch++) {
+            data[ch] = (int32_t *)malloc(sizeof(int32_t) * TEST_NUM_SAMPLES);
+            decoded[ch] = (int32_t *)malloc(sizeof(int32_t) * TEST_NUM_SAMPLES);
+        }
+        encimg = (uint8_t *)malloc(TEST_OUTPUT_SIZE);
+        refimg = (uint8_t *)malloc(TEST_OUTPUT_SIZE);
+
+        for (m_base = 1; m_base <= 20; m_base++) {
+            /* チャンネル毎にパラメータを変える（2の冪でないものも含む） */
+            srand(m_base);
+            for (ch = 0; ch < TEST_NUM_CHANNELS; ch++) {
+                m[ch] = m_base + ch;
+                for (smpl = 0; smpl < TEST_NUM_SAMPLES; smpl++) {
+                    /* 時々大きな値を混ぜて長い商も通す */
+                    data[ch][smpl] = (rand() % (int32_t)(8 * m[ch])) - (int32_t)(4 * m[ch]);
+                    if ((smpl % 97) == 0) {
+                        data[ch][smpl] = (rand() % 4096) - 2048;
+                    }
+                }
+            }
+
+            /* 素朴な実装で符号化 */
+            NARUBitWriter_Open(&strm, refimg, TEST_OUTPUT_SIZE);
+            for (smpl = 0; smpl < TEST_NUM_SAMPLES; smpl++) {
+                for (ch = 0; ch < TEST_NUM_CHANNELS; ch++) {
+                    NARUGolomb_PutCodeReference(&strm, m[ch], NARUUTILITY_SINT32_TO_UINT32(data[ch][smpl]));
+                }
+            }
+            NARUBitWriter_PutBits(&strm, 0x5A, 8);
+            NARUBitStream_Flush(&strm);
+            NARUBitStream_Tell(&strm, &refsize);
+            NARUBitStream_Close(&strm);
+
+            /* 一括符号化 */
+            NARUBitWriter_Open(&strm, encimg, TEST_OUTPUT_SIZE);
+            NARUGolomb_PutDataArray(&strm, m, (const int32_t **)data, TEST_NUM_CHANNELS, TEST_NUM_SAMPLES);
+            NARUBitWriter_PutBits(&strm, 0x5A, 8);
+            NARUBitStream_Flush(&strm);
+            NARUBitStream_Tell(&strm, &encsize);
+            NARUBitStream_Close(&strm);
+
+            ASSERT_EQ(refsize, encsize);
+            EXPECT_EQ(0, memcmp(refimg, encimg, (size_t)encsize));
+
+            /* 復号 */
+            NARUBitReader_Open(&strm, encimg, (uint32_t)encsize);
+            NARUGolomb_GetDataArray(&strm, m, decoded, TEST_NUM_CHANNELS, TEST_NUM_SAMPLES);
+            NARUBitReader_GetBits(&strm, &marker, 8);
+            EXPECT_EQ(0x5A, marker);
+            NARUBitStream_Close(&strm);
+
+            is_ok = 1;
+            for (ch = 0; ch < TEST_NUM_CHANNELS; ch++) {
+                if (memcmp(data[ch], decoded[ch], sizeof(int32_t) * TEST_NUM_SAMPLES) != 0) {
+                    is_ok = 0;
+                }
+            }
+            EXPECT_EQ(1, is_ok);
+        }
+
+        free(refimg);
+        free(encimg);
+        for (ch = 0; ch < TEST_NUM_CHANNELS; ch++) {
+            free(decoded[ch]);
+            free(data[ch]);
+        }
+#undef TEST_NUM_CHANNELS
+#undef TEST_NUM_SAMPLES
+#undef TEST_OUTPUT_SIZE
+    }
+}
+
+/* 符号長計算テスト */
+TEST(NARUCoderTest, CalculateCodeLengthTest)
+{
+    /* 計算した符号長が実際の出力ビット数と一致するか */
+    {
+#define TEST_NUM_SAMPLES 1000
+#define TEST_OUTPUT_SIZE (TEST_NUM_SAMPLES * 32)
+        uint32_t i, smpl, log2_param, prefix_bits, is_ok;
+        int32_t encsize;
+        uint64_t length;
+        int32_t *data;
+        uint8_t *encimg;
+        struct NARUBitStream strm;
+        struct NARUCoder *coder;
+        const int32_t test_amplitudes[] = { 0, 1, 3, 10, 100, 3000, 1 << 20 };
+
+        data = (int32_t *)malloc(sizeof(int32_t) * TEST_NUM_SAMPLES);
+        encimg = (uint8_t *)malloc(TEST_OUTPUT_SIZE);
+        coder = NARUCoder_Create(1, NARUCODER_NUM_RECURSIVERICE_PARAMETER, NULL, 0);
+        ASSERT_TRUE(coder != NULL);
+
+        srand(0);
+        is_ok = 1;
+        for (i = 0; i < sizeof(test_amplitudes) / sizeof(test_amplitudes[0]); i++) {
+            for (smpl = 0; smpl < TEST_NUM_SAMPLES; smpl++) {
+                /* 時々大きな値を混ぜてガンマ符号も通す */
+                data[smpl] = (rand() % (2 * test_amplitudes[i] + 1)) - test_amplitudes[i];
+                if ((smpl % 97) == 0) {
+                    data[smpl] = (rand() % (1 << 16)) - (1 << 15);
+                }
+            }
+            for (log2_param = 0; log2_param < 24; log2_param++) {
+                length = NARUCoder_CalculateChannelCodeLength(
+                        NARUCODER_NUM_RECURSIVERICE_PARAMETER, log2_param, data, TEST_NUM_SAMPLES);
+                /* 出力領域に収まらない組み合わせ（振幅に対してパラメータが小さすぎる）は飛ばす */
+                if (((length + 7) / 8 + 1) >= TEST_OUTPUT_SIZE) {
+                    continue;
+                }
+                /* 先頭にずらすビット数を変えて出力バイト数を比較し、ビット単位で一致を確かめる */
+                for (prefix_bits = 0; prefix_bits < 8; prefix_bits++) {
+                    uint32_t j;
+                    for (j = 0; j < NARUCODER_NUM_RECURSIVERICE_PARAMETER; j++) {
+                        NARUCODER_PARAMETER_SET(coder->init_rice_parameter[0], j, 1U << log2_param);
+                        NARUCODER_PARAMETER_SET(coder->rice_parameter[0], j, 1U << log2_param);
+                    }
+                    NARUBitWriter_Open(&strm, encimg, TEST_OUTPUT_SIZE);
+                    if (prefix_bits > 0) {
+                        NARUBitWriter_PutBits(&strm, 0, prefix_bits);
+                    }
+                    NARUCoder_PutChannelDataArray(coder, &strm,
+                            NARUCODER_NUM_RECURSIVERICE_PARAMETER, 0, data, TEST_NUM_SAMPLES);
+                    NARUBitStream_Flush(&strm);
+                    NARUBitStream_Tell(&strm, &encsize);
+                    NARUBitStream_Close(&strm);
+                    if ((uint64_t)encsize != ((length + prefix_bits + 7) / 8)) {
+                        is_ok = 0;
+                    }
+                }
+            }
+        }
+        EXPECT_EQ(1, is_ok);
+
+        NARUCoder_Destroy(coder);
+        free(encimg);
+        free(data);
+#undef TEST_NUM_SAMPLES
+#undef TEST_OUTPUT_SIZE
+    }
+}
+
+/* rANS符号テスト */
+TEST(NARUCoderTest, RANSTest)
+{
+    /* 様々な分布・サンプル数で符号化復号できるか */
+    {
+#define TEST_MAX_NUM_SAMPLES 4096
+#define TEST_OUTPUT_SIZE     (TEST_MAX_NUM_SAMPLES * 16 + 64)
+        uint32_t i, smpl, encsize, decsize, is_ok;
+        int32_t *data, *decoded;
+        uint32_t *work;
+        uint8_t *encimg;
+        struct NARUCoder *coder;
+        const uint32_t test_num_samples[] = { 1, 3, 4, 5, 1000, TEST_MAX_NUM_SAMPLES };
+        const int32_t test_amplitudes[] = { 0, 1, 2, 5, 100, 30000, 1 << 20 };
+
+        data = (int32_t *)malloc(sizeof(int32_t) * TEST_MAX_NUM_SAMPLES);
+        decoded = (int32_t *)malloc(sizeof(int32_t) * TEST_MAX_NUM_SAMPLES);
+        work = (uint32_t *)malloc(sizeof(uint32_t) * TEST_MAX_NUM_SAMPLES);
+        encimg = (uint8_t *)malloc(TEST_OUTPUT_SIZE);
+        coder = NARUCoder_Create(1, NARUCODER_NUM_RECURSIVERICE_PARAMETER, NULL, 0);
+        ASSERT_TRUE(coder != NULL);
+
+        srand(0);
+        is_ok = 1;
+        for (i = 0; i < sizeof(test_num_samples) / sizeof(test_num_samples[0]); i++) {
+            uint32_t j;
+            for (j = 0; j < sizeof(test_amplitudes) / sizeof(test_amplitudes[0]); j++) {
+                const uint32_t num_samples = test_num_samples[i];
+                for (smpl = 0; smpl < num_samples; smpl++) {
+                    /* 一様分布を2つ足して山なりにし、時々極端な値を混ぜてエスケープも通す */
+                    data[smpl] = 0;
+                    if (test_amplitudes[j] > 0) {
+                        data[smpl] = (rand() % (test_amplitudes[j] + 1)) - (rand() % (test_amplitudes[j] + 1));
+                    }
+                    if ((smpl % 331) == 7) {
+                        data[smpl] = (smpl & 1) ? INT32_MAX : INT32_MIN;
+                    }
+                }
+
+                NARUCoder_CalculateInitialRecursiveRiceParameter(coder,
+                        NARUCODER_NUM_RECURSIVERICE_PARAMETER, (const int32_t **)&data, 1, num_samples);
+                if (NARUCoder_PutChannelDataArrayRANS(coder, 0, data, num_samples,
+                            work, encimg, TEST_OUTPUT_SIZE, &encsize) != NARU_ERROR_OK) {
+                    is_ok = 0;
+                    continue;
+                }
+                memset(decoded, 0xCD, sizeof(int32_t) * num_samples);
+                if ((NARUCoder_GetChannelDataArrayRANS(coder, 0, encimg, TEST_OUTPUT_SIZE,
+                                decoded, num_samples, &decsize) != NARU_ERROR_OK)
+                        || (encsize != decsize)
+                        || (memcmp(data, decoded, sizeof(int32_t) * num_samples) != 0)) {
+                    is_ok = 0;
+                }
+
+                /* 末尾が欠けていたら復号に失敗する */
+                if (NARUCoder_GetChannelDataArrayRANS(coder, 0, encimg, encsize - 1,
+                            decoded, num_samples, &decsize) == NARU_ERROR_OK) {
+                    is_ok = 0;
+                }
+
+                /* 出力領域が足りない */
+                if (NARUCoder_PutChannelDataArrayRANS(coder, 0, data, num_samples,
+                            work, encimg, encsize - 1, &encsize) != NARU_ERROR_INSUFFICIENT_BUFFER) {
+                    is_ok = 0;
+                }
+            }
+        }
+        EXPECT_EQ(1, is_ok);
+
+        NARUCoder_Destroy(coder);
+        free(encimg);
+        free(work);
+        free(decoded);
+        free(data);
+#undef TEST_MAX_NUM_SAMPLES
+#undef TEST_OUTPUT_SIZE
+    }
+}
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
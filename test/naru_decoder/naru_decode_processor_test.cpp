@@ -1,4 +1,5 @@
 #include <stdlib.h>
+#include <math.h>
 #include <string.h>
 
 #include <gtest/gtest.h>
@@ -72,3 +73,147 @@ TEST(NARUDecodeProcessorTest, CreateDestroyHandleTest)
         free(work);
     }
 }
+
+/* 次数特化版の合成処理が1サンプル毎の合成処理と一致するか確認 */
+TEST(NARUDecodeProcessorTest, SynthesizeSpecializedOrderTest)
+{
+#define TEST_NUM_SAMPLES 1024
+    void *ref_work, *test_work;
+    int32_t work_size, ngsa_order, sa_order, call;
+    struct NARUDecodeProcessor *ref, *test;
+    int32_t residual[TEST_NUM_SAMPLES], ref_buffer[TEST_NUM_SAMPLES], test_buffer[TEST_NUM_SAMPLES];
+
+    work_size = NARUDecodeProcessor_CalculateWorkSize(NARU_MAX_FILTER_ORDER);
+    ref_work = malloc(work_size);
+    test_work = malloc(work_size);
+    ref = NARUDecodeProcessor_Create(NARU_MAX_FILTER_ORDER, ref_work, work_size);
+    test = NARUDecodeProcessor_Create(NARU_MAX_FILTER_ORDER, test_work, work_size);
+    ASSERT_TRUE(ref != NULL);
+    ASSERT_TRUE(test != NULL);
+
+    /* 汎用C実装では全次数で次数特化版が選ばれる */
+    test->ngsa->functions = test->sa->functions = NARUFilter_GetFunctions(NARUFILTER_IMPLEMENTATION_SCALAR);
+
+    srand(0);
+    for (ngsa_order = 4; ngsa_order <= NARU_MAX_FILTER_ORDER; ngsa_order *= 2) {
+        for (sa_order = 1; sa_order <= NARU_MAX_FILTER_ORDER; sa_order *= 2) {
+            uint32_t smpl;
+            NARUDecodeProcessor_Reset(ref);
+            NARUDecodeProcessor_Reset(test);
+            NARUDecodeProcessor_SetFilterOrder(ref, ngsa_order, 1, sa_order);
+            NARUDecodeProcessor_SetFilterOrder(test, ngsa_order, 1, sa_order);
+            ref->ngsa->ar_coef[0] = test->ngsa->ar_coef[0] = (rand() % (1 << NARU_FIXEDPOINT_DIGITS));
+            /* ブロックをまたいだ状態の引き継ぎも確認 */
+            for (call = 0; call < 2; call++) {
+                for (smpl = 0; smpl < TEST_NUM_SAMPLES; smpl++) {
+                    residual[smpl] = (rand() % 512) - 256;
+                }
+                memcpy(ref_buffer, residual, sizeof(int32_t) * TEST_NUM_SAMPLES);
+                memcpy(test_buffer, residual, sizeof(int32_t) * TEST_NUM_SAMPLES);
+                /* リファレンス: 1サンプル毎に合成 */
+                NARUNGSAFilter_InitializeNaturalGradient(ref->ngsa);
+                NARUDecodeProcessor_SynthesizeCascade(ref, ref_buffer, TEST_NUM_SAMPLES);
+                NARUDecodeProcessor_Synthesize(test, test_buffer, TEST_NUM_SAMPLES);
+                ASSERT_EQ(0, memcmp(ref_buffer, test_buffer, sizeof(int32_t) * TEST_NUM_SAMPLES));
+                EXPECT_EQ(0, memcmp(ref->ngsa->weight, test->ngsa->weight, sizeof(int32_t) * (size_t)ngsa_order));
+                EXPECT_EQ(0, memcmp(ref->sa->weight, test->sa->weight, sizeof(int32_t) * (size_t)sa_order));
+            }
+        }
+    }
+
+    NARUDecodeProcessor_Destroy(ref);
+    NARUDecodeProcessor_Destroy(test);
+    free(ref_work);
+    free(test_work);
+#undef TEST_NUM_SAMPLES
+}
+
+/* 複数チャンネル一括合成の結果がチャンネル毎の合成と一致するか確認 */
+TEST(NARUDecodeProcessorTest, SynthesizeMultiChannelTest)
+{
+#define TEST_NUM_SAMPLES 1024
+    void *ref_work[NARU_MAX_NUM_CHANNELS], *test_work[NARU_MAX_NUM_CHANNELS], *lanes_work;
+    int32_t work_size, lanes_work_size, impl, ngsa_order, ar_order, call;
+    uint32_t ch, num_channels;
+    struct NARUDecodeProcessor *ref[NARU_MAX_NUM_CHANNELS], *test[NARU_MAX_NUM_CHANNELS];
+    struct NARUFilterLanes *lanes;
+    int32_t ref_data[NARU_MAX_NUM_CHANNELS][TEST_NUM_SAMPLES], test_data[NARU_MAX_NUM_CHANNELS][TEST_NUM_SAMPLES];
+    int32_t *ref_buffer[NARU_MAX_NUM_CHANNELS], *test_buffer[NARU_MAX_NUM_CHANNELS];
+
+    work_size = NARUDecodeProcessor_CalculateWorkSize(NARU_MAX_FILTER_ORDER);
+    for (ch = 0; ch < NARU_MAX_NUM_CHANNELS; ch++) {
+        ref_work[ch] = malloc(work_size);
+        test_work[ch] = malloc(work_size);
+        ref[ch] = NARUDecodeProcessor_Create(NARU_MAX_FILTER_ORDER, ref_work[ch], work_size);
+        test[ch] = NARUDecodeProcessor_Create(NARU_MAX_FILTER_ORDER, test_work[ch], work_size);
+        ASSERT_TRUE(ref[ch] != NULL);
+        ASSERT_TRUE(test[ch] != NULL);
+        ref_buffer[ch] = ref_data[ch];
+        test_buffer[ch] = test_data[ch];
+    }
+    lanes_work_size = NARUFilterLanes_CalculateWorkSize(NARU_MAX_FILTER_ORDER);
+    ASSERT_TRUE(lanes_work_size > 0);
+    lanes_work = malloc(lanes_work_size);
+    lanes = NARUFilterLanes_Create(NARU_MAX_FILTER_ORDER, lanes_work, lanes_work_size);
+    ASSERT_TRUE(lanes != NULL);
+
+    srand(0);
+    for (impl = 0; impl < NARUFILTER_IMPLEMENTATION_NUM; impl++) {
+        const struct NARUFilterFunctions *functions
+            = NARUFilter_GetFunctions((NARUFilterImplementation)impl);
+        /* 実行環境で使えない実装はスキップ */
+        if (functions == NULL) {
+            continue;
+        }
+        lanes->functions = functions;
+        for (num_channels = 1; num_channels <= NARU_MAX_NUM_CHANNELS; num_channels++) {
+            for (ngsa_order = 8; ngsa_order <= NARU_MAX_FILTER_ORDER; ngsa_order *= 2) {
+                for (ar_order = 1; ar_order <= 2; ar_order++) {
+                    for (ch = 0; ch < num_channels; ch++) {
+                        int32_t i;
+                        NARUDecodeProcessor_Reset(ref[ch]);
+                        NARUDecodeProcessor_Reset(test[ch]);
+                        NARUDecodeProcessor_SetFilterOrder(ref[ch], ngsa_order, ar_order, 8);
+                        NARUDecodeProcessor_SetFilterOrder(test[ch], ngsa_order, ar_order, 8);
+                        for (i = 0; i < ar_order; i++) {
+                            ref[ch]->ngsa->ar_coef[i] = test[ch]->ngsa->ar_coef[i]
+                                = (rand() % (1 << NARU_FIXEDPOINT_DIGITS)) / (i + 1);
+                        }
+                    }
+                    /* ブロックをまたいだ状態の引き継ぎも確認 */
+                    for (call = 0; call < 2; call++) {
+                        for (ch = 0; ch < num_channels; ch++) {
+                            uint32_t smpl;
+                            for (smpl = 0; smpl < TEST_NUM_SAMPLES; smpl++) {
+                                ref_data[ch][smpl] = test_data[ch][smpl]
+                                    = (int32_t)(300.0 * sin(0.01 * (ch + 1) * smpl)) + (rand() % 64) - 32;
+                            }
+                        }
+                        /* リファレンス: チャンネル毎に合成 */
+                        for (ch = 0; ch < num_channels; ch++) {
+                            NARUDecodeProcessor_Synthesize(ref[ch], ref_buffer[ch], TEST_NUM_SAMPLES);
+                        }
+                        NARUDecodeProcessor_SynthesizeMultiChannel(test, lanes, test_buffer, num_channels, TEST_NUM_SAMPLES);
+                        for (ch = 0; ch < num_channels; ch++) {
+                            ASSERT_EQ(0, memcmp(ref_data[ch], test_data[ch], sizeof(int32_t) * TEST_NUM_SAMPLES));
+                            EXPECT_EQ(ref[ch]->deemphasis_prev, test[ch]->deemphasis_prev);
+                            EXPECT_EQ(ref[ch]->ngsa->buffer_pos, test[ch]->ngsa->buffer_pos);
+                            EXPECT_EQ(ref[ch]->sa->buffer_pos, test[ch]->sa->buffer_pos);
+                            EXPECT_EQ(0, memcmp(ref[ch]->ngsa->weight, test[ch]->ngsa->weight, sizeof(int32_t) * (size_t)ngsa_order));
+                            EXPECT_EQ(0, memcmp(ref[ch]->sa->weight, test[ch]->sa->weight, sizeof(int32_t) * 8));
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    for (ch = 0; ch < NARU_MAX_NUM_CHANNELS; ch++) {
+        NARUDecodeProcessor_Destroy(ref[ch]);
+        NARUDecodeProcessor_Destroy(test[ch]);
+        free(ref_work[ch]);
+        free(test_work[ch]);
+    }
+    free(lanes_work);
+#undef TEST_NUM_SAMPLES
+}
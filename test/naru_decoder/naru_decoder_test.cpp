@@ -5,6 +5,7 @@
 
 /* エンコーダを使用 */
 #include "naru_encoder.h"
+#include "naru_encode_processor.h"
 
 /* テスト対象のモジュール */
 extern "C" {
@@ -26,6 +27,8 @@ extern "C" {
         header__p->ar_order                   = 1;\
         header__p->second_filter_order        = 4;\
         header__p->ch_process_method          = NARU_CH_PROCESS_METHOD_NONE;\
+        header__p->block_checksum_type        = NARU_BLOCK_CHECKSUM_TYPE_CRC16;\
+        header__p->has_seek_table             = 0;\
     } while (0);
 
 /* ヘッダにある情報からエンコードパラメータを作成 */
@@ -42,6 +45,11 @@ extern "C" {
         param__p->second_filter_order = header__p->second_filter_order;\
         param__p->ch_process_method = header__p->ch_process_method;\
         param__p->num_encode_trials = 1; /* 仮 */\
+        param__p->num_threads = 1;\
+        param__p->num_preroll_samples = 0;\
+        param__p->use_rans = 0;\
+        param__p->block_checksum_type = header__p->block_checksum_type;\
+        param__p->use_seek_table = header__p->has_seek_table;\
     } while (0);
 
 /* 有効なエンコーダコンフィグをセット */
@@ -51,6 +59,10 @@ extern "C" {
         config__p->max_num_channels           = 8;\
         config__p->max_num_samples_per_block  = 8192;\
         config__p->max_filter_order           = 32;\
+        config__p->max_num_threads            = 1;\
+        config__p->enable_streaming           = 1;\
+        config__p->enable_rans                = 1;\
+        config__p->enable_seek_table          = 1;\
     } while (0);
 
 /* 有効なデコーダコンフィグをセット */
@@ -60,6 +72,8 @@ extern "C" {
         config__p->max_num_channels = 8;\
         config__p->max_filter_order = 32;\
         config__p->check_crc = 1;\
+        config__p->max_num_threads = 1;\
+        config__p->max_num_samples_per_block = 8192;\
     } while (0);
 
 /* ヘッダデコードテスト */
@@ -87,6 +101,79 @@ TEST(NARUDecoderTest, DecodeHeaderTest)
         EXPECT_EQ(header.filter_order, tmp_header.filter_order);
         EXPECT_EQ(header.ar_order, tmp_header.ar_order);
         EXPECT_EQ(header.ch_process_method, tmp_header.ch_process_method);
+        EXPECT_EQ(header.block_checksum_type, tmp_header.block_checksum_type);
+    }
+
+    /* CRC32Cのチェックサム種別を記録したヘッダ */
+    {
+        uint8_t data[NARU_HEADER_SIZE] = { 0, };
+        struct NARUHeader header, tmp_header;
+
+        NARU_SetValidHeader(&header);
+        header.block_checksum_type = NARU_BLOCK_CHECKSUM_TYPE_CRC32C;
+        header.max_num_samples_per_block = 0xFFFF;
+
+        EXPECT_EQ(NARU_APIRESULT_OK, NARUEncoder_EncodeHeader(&header, data, sizeof(data)));
+        EXPECT_EQ(NARU_APIRESULT_OK, NARUDecoder_DecodeHeader(data, sizeof(data), &tmp_header));
+        EXPECT_EQ(NARU_BLOCK_CHECKSUM_TYPE_CRC32C, tmp_header.block_checksum_type);
+        EXPECT_EQ(0xFFFFU, tmp_header.max_num_samples_per_block);
+        EXPECT_EQ(NARU_ERROR_OK, NARUDecoder_CheckHeaderFormat(&tmp_header));
+
+        /* CRC16のみの旧バージョンでCRC32Cは不正 */
+        ByteArray_WriteUint32BE(&data[4], NARU_FORMAT_VERSION_CRC16_CHECKSUM);
+        EXPECT_EQ(NARU_APIRESULT_OK, NARUDecoder_DecodeHeader(data, sizeof(data), &tmp_header));
+        EXPECT_EQ(NARU_ERROR_INVALID_FORMAT, NARUDecoder_CheckHeaderFormat(&tmp_header));
+    }
+
+    /* シークテーブルありを記録したヘッダ */
+    {
+        uint8_t data[NARU_HEADER_SIZE] = { 0, };
+        struct NARUHeader header, tmp_header;
+
+        NARU_SetValidHeader(&header);
+        header.has_seek_table = 1;
+
+        EXPECT_EQ(NARU_APIRESULT_OK, NARUEncoder_EncodeHeader(&header, data, sizeof(data)));
+        EXPECT_EQ(NARU_APIRESULT_OK, NARUDecoder_DecodeHeader(data, sizeof(data), &tmp_header));
+        EXPECT_EQ(1, tmp_header.has_seek_table);
+        EXPECT_EQ(NARU_ERROR_OK, NARUDecoder_CheckHeaderFormat(&tmp_header));
+
+        /* 旧バージョンにシークテーブルはない */
+        ByteArray_WriteUint32BE(&data[4], NARU_FORMAT_VERSION_CRC16_CHECKSUM);
+        EXPECT_EQ(NARU_APIRESULT_OK, NARUDecoder_DecodeHeader(data, sizeof(data), &tmp_header));
+        EXPECT_EQ(NARU_ERROR_INVALID_FORMAT, NARUDecoder_CheckHeaderFormat(&tmp_header));
+    }
+
+    /* CRC16のみの旧バージョンも受け付ける
+    * 補足）最大ブロックあたりサンプル数は32bitで記録されている */
+    {
+        uint8_t data[NARU_HEADER_SIZE] = { 0, };
+        struct NARUHeader header, tmp_header;
+
+        NARU_SetValidHeader(&header);
+
+        EXPECT_EQ(NARU_APIRESULT_OK, NARUEncoder_EncodeHeader(&header, data, sizeof(data)));
+        ByteArray_WriteUint32BE(&data[4], NARU_FORMAT_VERSION_CRC16_CHECKSUM);
+        ByteArray_WriteUint32BE(&data[24], header.max_num_samples_per_block);
+        EXPECT_EQ(NARU_APIRESULT_OK, NARUDecoder_DecodeHeader(data, sizeof(data), &tmp_header));
+        EXPECT_EQ(NARU_FORMAT_VERSION_CRC16_CHECKSUM, tmp_header.format_version);
+        EXPECT_EQ(NARU_BLOCK_CHECKSUM_TYPE_CRC16, tmp_header.block_checksum_type);
+        EXPECT_EQ(header.max_num_samples_per_block, tmp_header.max_num_samples_per_block);
+        EXPECT_EQ(NARU_ERROR_OK, NARUDecoder_CheckHeaderFormat(&tmp_header));
+    }
+
+    /* 残差インターリーブ形式の旧バージョンも受け付ける */
+    {
+        uint8_t data[NARU_HEADER_SIZE] = { 0, };
+        struct NARUHeader header, tmp_header;
+
+        NARU_SetValidHeader(&header);
+
+        EXPECT_EQ(NARU_APIRESULT_OK, NARUEncoder_EncodeHeader(&header, data, sizeof(data)));
+        ByteArray_WriteUint32BE(&data[4], NARU_FORMAT_VERSION_INTERLEAVED_RESIDUAL);
+        EXPECT_EQ(NARU_APIRESULT_OK, NARUDecoder_DecodeHeader(data, sizeof(data), &tmp_header));
+        EXPECT_EQ(NARU_FORMAT_VERSION_INTERLEAVED_RESIDUAL, tmp_header.format_version);
+        EXPECT_EQ(NARU_ERROR_OK, NARUDecoder_CheckHeaderFormat(&tmp_header));
     }
 
     /* ヘッダデコード失敗ケース */
@@ -120,6 +207,11 @@ TEST(NARUDecoderTest, DecodeHeaderTest)
         ByteArray_WriteUint32BE(&data[4], NARU_FORMAT_VERSION + 1);
         EXPECT_EQ(NARU_APIRESULT_OK, NARUDecoder_DecodeHeader(data, sizeof(data), &getheader));
         EXPECT_EQ(NARU_ERROR_INVALID_FORMAT, NARUDecoder_CheckHeaderFormat(&getheader));
+        memcpy(data, valid_data, sizeof(valid_data));
+        memset(&getheader, 0xCD, sizeof(getheader));
+        ByteArray_WriteUint32BE(&data[4], NARU_FORMAT_VERSION_INTERLEAVED_RESIDUAL - 1);
+        EXPECT_EQ(NARU_APIRESULT_OK, NARUDecoder_DecodeHeader(data, sizeof(data), &getheader));
+        EXPECT_EQ(NARU_ERROR_INVALID_FORMAT, NARUDecoder_CheckHeaderFormat(&getheader));
 
         /* 異常なエンコーダバージョン */
         memcpy(data, valid_data, sizeof(valid_data));
@@ -168,6 +260,20 @@ TEST(NARUDecoderTest, DecodeHeaderTest)
         EXPECT_EQ(NARU_APIRESULT_OK, NARUDecoder_DecodeHeader(data, sizeof(data), &getheader));
         EXPECT_EQ(NARU_ERROR_INVALID_FORMAT, NARUDecoder_CheckHeaderFormat(&getheader));
 
+        /* 異常なブロックのチェックサム種別 */
+        memcpy(data, valid_data, sizeof(valid_data));
+        memset(&getheader, 0xCD, sizeof(getheader));
+        ByteArray_WriteUint8(&data[24], NARU_BLOCK_CHECKSUM_TYPE_INVALID);
+        EXPECT_EQ(NARU_APIRESULT_OK, NARUDecoder_DecodeHeader(data, sizeof(data), &getheader));
+        EXPECT_EQ(NARU_ERROR_INVALID_FORMAT, NARUDecoder_CheckHeaderFormat(&getheader));
+
+        /* 異常なシークテーブルの有無 */
+        memcpy(data, valid_data, sizeof(valid_data));
+        memset(&getheader, 0xCD, sizeof(getheader));
+        ByteArray_WriteUint8(&data[25], 2);
+        EXPECT_EQ(NARU_APIRESULT_OK, NARUDecoder_DecodeHeader(data, sizeof(data), &getheader));
+        EXPECT_EQ(NARU_ERROR_INVALID_FORMAT, NARUDecoder_CheckHeaderFormat(&getheader));
+
         /* 異常なフィルタ次数 */
         memcpy(data, valid_data, sizeof(valid_data));
         memset(&getheader, 0xCD, sizeof(getheader));
@@ -240,6 +346,16 @@ TEST(NARUDecoderTest, CreateDestroyHandleTest)
         NARUDecoder_SetValidConfig(&config);
         config.max_filter_order = 3;
         EXPECT_TRUE(NARUDecoder_CalculateWorkSize(&config) < 0);
+
+        /* スレッド数0は単一スレッドとして扱う */
+        NARUDecoder_SetValidConfig(&config);
+        config.max_num_threads = 0;
+        EXPECT_EQ(work_size, NARUDecoder_CalculateWorkSize(&config));
+
+        /* スレッド数を増やすとワークサイズは増える */
+        NARUDecoder_SetValidConfig(&config);
+        config.max_num_threads = 4;
+        EXPECT_TRUE(NARUDecoder_CalculateWorkSize(&config) > work_size);
     }
 
     /* ワーク領域渡しによるハンドル作成（成功例） */
@@ -322,6 +438,15 @@ TEST(NARUDecoderTest, CreateDestroyHandleTest)
         config.max_filter_order = 3;
         decoder = NARUDecoder_Create(&config, work, work_size);
         EXPECT_TRUE(decoder == NULL);
+
+        /* スレッド数0は単一スレッドとして作成できる */
+        NARUDecoder_SetValidConfig(&config);
+        config.max_num_threads = 0;
+        decoder = NARUDecoder_Create(&config, work, work_size);
+        EXPECT_TRUE(decoder != NULL);
+        NARUDecoder_Destroy(decoder);
+
+        free(work);
     }
 
     /* 自前確保によるハンドル作成（失敗ケース） */
@@ -351,6 +476,7 @@ TEST(NARUDecoderTest, CreateDestroyHandleTest)
         config.max_filter_order = 3;
         decoder = NARUDecoder_Create(&config, NULL, 0);
         EXPECT_TRUE(decoder == NULL);
+
     }
 }
 
@@ -583,3 +709,1467 @@ TEST(NARUDecoderTest, DecodeBlockTest)
         NARUEncoder_Destroy(encoder);
     }
 }
+
+/* 複数スレッドによる一括デコードテスト */
+TEST(NARUDecoderTest, DecodeWholeParallelTest)
+{
+    /* 複数ブロックのデータをスレッド数を変えてデコードしてみる */
+    {
+        struct NARUEncoder *encoder;
+        struct NARUDecoder *decoder;
+        struct NARUEncoderConfig encoder_config;
+        struct NARUDecoderConfig decoder_config;
+        struct NARUEncodeParameter parameter;
+        struct NARUHeader header;
+        uint8_t *data;
+        int32_t *input[NARU_MAX_NUM_CHANNELS];
+        int32_t *output[NARU_MAX_NUM_CHANNELS];
+        uint32_t ch, smpl, sufficient_size, output_size;
+        uint8_t num_threads;
+
+        NARU_SetValidHeader(&header);
+        header.num_channels = 2;
+        header.num_samples = 1000; /* 最終ブロックは端数 */
+        header.ch_process_method = NARU_CH_PROCESS_METHOD_MS;
+        NARUEncoder_SetValidConfig(&encoder_config);
+
+        /* 十分なデータサイズ */
+        sufficient_size = NARU_HEADER_SIZE + (2 * header.num_channels * header.num_samples * header.bits_per_sample) / 8;
+
+        /* データ領域確保 */
+        data = (uint8_t *)malloc(sufficient_size);
+        for (ch = 0; ch < header.num_channels; ch++) {
+            input[ch] = (int32_t *)malloc(sizeof(int32_t) * header.num_samples);
+            output[ch] = (int32_t *)malloc(sizeof(int32_t) * header.num_samples);
+        }
+
+        /* 入力に白色雑音をセット */
+        srand(0);
+        for (ch = 0; ch < header.num_channels; ch++) {
+            for (smpl = 0; smpl < header.num_samples; smpl++) {
+                input[ch][smpl] = (rand() % (1 << 12)) - (1 << 11);
+            }
+        }
+
+        /* エンコード */
+        encoder = NARUEncoder_Create(&encoder_config, NULL, 0);
+        ASSERT_TRUE(encoder != NULL);
+        NARUEncoder_ConvertHeaderToParameter(&header, &parameter);
+        EXPECT_EQ(NARU_APIRESULT_OK, NARUEncoder_SetEncodeParameter(encoder, &parameter));
+        EXPECT_EQ(NARU_APIRESULT_OK,
+                NARUEncoder_EncodeWhole(encoder, input, header.num_samples, data, sufficient_size, &output_size));
+        NARUEncoder_Destroy(encoder);
+
+        /* スレッド数0は単一スレッドとして扱う */
+        for (num_threads = 0; num_threads <= 4; num_threads++) {
+            NARUDecoder_SetValidConfig(&decoder_config);
+            decoder_config.max_num_threads = num_threads;
+            decoder = NARUDecoder_Create(&decoder_config, NULL, 0);
+            ASSERT_TRUE(decoder != NULL);
+
+            /* デコード結果は元の信号に一致 */
+            for (ch = 0; ch < header.num_channels; ch++) {
+                memset(output[ch], 0, sizeof(int32_t) * header.num_samples);
+            }
+            EXPECT_EQ(NARU_APIRESULT_OK,
+                    NARUDecoder_DecodeWhole(decoder, data, output_size, output, header.num_channels, header.num_samples));
+            for (ch = 0; ch < header.num_channels; ch++) {
+                EXPECT_EQ(0, memcmp(input[ch], output[ch], sizeof(int32_t) * header.num_samples));
+            }
+
+            /* バッファサイズ不足 */
+            EXPECT_EQ(NARU_APIRESULT_INSUFFICIENT_BUFFER,
+                    NARUDecoder_DecodeWhole(decoder, data, output_size, output, header.num_channels, header.num_samples - 1));
+
+            /* データサイズ不足 */
+            EXPECT_NE(NARU_APIRESULT_OK,
+                    NARUDecoder_DecodeWhole(decoder, data, output_size - 1, output, header.num_channels, header.num_samples));
+
+            NARUDecoder_Destroy(decoder);
+        }
+
+        /* 領域の開放 */
+        for (ch = 0; ch < header.num_channels; ch++) {
+            free(output[ch]);
+            free(input[ch]);
+        }
+        free(data);
+    }
+}
+
+/* 十分なデータサイズ: ヘッダ + 入力PCMの2倍 */
+#define NARUDecoderTest_CalculateSufficientSize(p_header, num_samples)\
+    (NARU_HEADER_SIZE + (2 * (p_header)->num_channels * (num_samples) * (p_header)->bits_per_sample) / 8)
+
+/* チャンネル毎の信号領域を確保 */
+static void NARUDecoderTest_AllocateSignal(int32_t **signal, uint32_t num_channels, uint32_t num_samples)
+{
+    uint32_t ch;
+    for (ch = 0; ch < num_channels; ch++) {
+        signal[ch] = (int32_t *)malloc(sizeof(int32_t) * num_samples);
+    }
+}
+
+/* チャンネル毎の信号領域を開放 */
+static void NARUDecoderTest_FreeSignal(int32_t **signal, uint32_t num_channels)
+{
+    uint32_t ch;
+    for (ch = 0; ch < num_channels; ch++) {
+        free(signal[ch]);
+    }
+}
+
+/* 信号に振幅amplitude_bitsビットの白色雑音をセット
+* 補足）乱数列は毎回先頭から作るので、引数が同じならば信号も同じになる */
+static void NARUDecoderTest_SetWhiteNoise(
+        int32_t **signal, uint32_t num_channels, uint32_t num_samples, uint32_t amplitude_bits)
+{
+    uint32_t ch, smpl;
+    const int32_t range = (int32_t)1 << amplitude_bits;
+
+    srand(0);
+    for (ch = 0; ch < num_channels; ch++) {
+        for (smpl = 0; smpl < num_samples; smpl++) {
+            signal[ch][smpl] = (rand() % range) - (range / 2);
+        }
+    }
+}
+
+/* 入力に白色雑音をセットし、ヘッダの設定でエンコード */
+static void NARUDecoderTest_EncodeWhiteNoise(
+        const struct NARUHeader *header, uint8_t use_rans, uint32_t num_samples, uint32_t amplitude_bits,
+        int32_t **input, uint8_t *data, uint32_t data_size, uint32_t *output_size)
+{
+    struct NARUEncoder *encoder;
+    struct NARUEncoderConfig config;
+    struct NARUEncodeParameter parameter;
+
+    NARUDecoderTest_SetWhiteNoise(input, header->num_channels, num_samples, amplitude_bits);
+
+    /* エンコード */
+    NARUEncoder_SetValidConfig(&config);
+    encoder = NARUEncoder_Create(&config, NULL, 0);
+    ASSERT_TRUE(encoder != NULL);
+    NARUEncoder_ConvertHeaderToParameter(header, &parameter);
+    parameter.use_rans = use_rans;
+    EXPECT_EQ(NARU_APIRESULT_OK, NARUEncoder_SetEncodeParameter(encoder, &parameter));
+    EXPECT_EQ(NARU_APIRESULT_OK,
+            NARUEncoder_EncodeWhole(encoder, input, num_samples, data, data_size, output_size));
+    NARUEncoder_Destroy(encoder);
+}
+
+/* 残差を全チャンネルインターリーブしていた旧フォーマットの圧縮ブロックを作成 */
+static void NARUDecoderTest_EncodeInterleavedResidualBlock(
+        const struct NARUHeader *header, const int32_t *const *input, uint32_t num_samples,
+        uint8_t *data, uint32_t data_size, uint32_t *output_size)
+{
+    uint32_t ch, block_data_size;
+    int32_t work_size;
+    int32_t *buffer[NARU_MAX_NUM_CHANNELS];
+    void *work[NARU_MAX_NUM_CHANNELS];
+    struct NARUEncodeProcessor *processor[NARU_MAX_NUM_CHANNELS];
+    struct NARUCoder *coder;
+    struct NARUBitStream stream;
+    const double ar_coef[NARU_MAX_AR_ORDER + 1] = { 0.0, };
+
+    /* プロセッサと符号化ハンドルの作成 */
+    work_size = NARUEncodeProcessor_CalculateWorkSize(header->filter_order);
+    for (ch = 0; ch < header->num_channels; ch++) {
+        work[ch] = malloc((size_t)work_size);
+        processor[ch] = NARUEncodeProcessor_Create(header->filter_order, work[ch], work_size);
+        ASSERT_TRUE(processor[ch] != NULL);
+        NARUEncodeProcessor_Reset(processor[ch]);
+        NARUEncodeProcessor_SetFilterOrder(processor[ch],
+                header->filter_order, header->ar_order, header->second_filter_order);
+        NARUEncodeProcessor_SetARCoef(processor[ch], ar_coef);
+        buffer[ch] = (int32_t *)malloc(sizeof(int32_t) * num_samples);
+        memcpy(buffer[ch], input[ch], sizeof(int32_t) * num_samples);
+    }
+    coder = NARUCoder_Create(header->num_channels, NARUCODER_NUM_RECURSIVERICE_PARAMETER, NULL, 0);
+    ASSERT_TRUE(coder != NULL);
+
+    /* ブロックヘッダ: サイズとCRC16は後で書き込む */
+    ByteArray_WriteUint16BE(&data[0], NARU_BLOCK_SYNC_CODE);
+    ByteArray_WriteUint8(&data[8], NARU_BLOCK_DATA_TYPE_COMPRESSDATA);
+    ByteArray_WriteUint16BE(&data[9], num_samples);
+
+    /* フィルタ状態・初期パラメータ・インターリーブされた残差を1つのビット列に書き出す */
+    NARUBitWriter_Open(&stream, &data[NARU_BLOCK_HEADER_SIZE], data_size - NARU_BLOCK_HEADER_SIZE);
+    for (ch = 0; ch < header->num_channels; ch++) {
+        NARUEncodeProcessor_PutFilterState(processor[ch], &stream);
+    }
+    for (ch = 0; ch < header->num_channels; ch++) {
+        NARUEncodeProcessor_Predict(processor[ch], buffer[ch], num_samples);
+    }
+    NARUCoder_CalculateInitialRecursiveRiceParameter(coder,
+            NARUCODER_NUM_RECURSIVERICE_PARAMETER, (const int32_t **)buffer, header->num_channels, num_samples);
+    for (ch = 0; ch < header->num_channels; ch++) {
+        NARUCoder_PutInitialRecursiveRiceParameter(coder, &stream, NARUCODER_NUM_RECURSIVERICE_PARAMETER, ch);
+    }
+    NARUCoder_PutDataArray(coder, &stream,
+            NARUCODER_NUM_RECURSIVERICE_PARAMETER, (const int32_t **)buffer, header->num_channels, num_samples);
+    NARUBitStream_Flush(&stream);
+    NARUBitStream_Tell(&stream, (int32_t *)&block_data_size);
+    NARUBitStream_Close(&stream);
+
+    /* ブロックサイズとCRC16 */
+    ByteArray_WriteUint32BE(&data[2], block_data_size + 5);
+    ByteArray_WriteUint16BE(&data[6], NARUUtility_CalculateCRC16(&data[8], block_data_size + 3));
+
+    (*output_size) = NARU_BLOCK_HEADER_SIZE + block_data_size;
+
+    /* 領域の開放 */
+    NARUCoder_Destroy(coder);
+    for (ch = 0; ch < header->num_channels; ch++) {
+        free(buffer[ch]);
+        NARUEncodeProcessor_Destroy(processor[ch]);
+        free(work[ch]);
+    }
+}
+
+/* フォーマットバージョン毎の残差配置のデコードテスト */
+TEST(NARUDecoderTest, DecodeResidualLayoutTest)
+{
+    /* 旧フォーマット（残差インターリーブ）のブロックをデコードできるか */
+    {
+        struct NARUDecoder *decoder;
+        struct NARUDecoderConfig config;
+        struct NARUHeader header;
+        uint8_t *data;
+        int32_t *input[NARU_MAX_NUM_CHANNELS];
+        int32_t *output[NARU_MAX_NUM_CHANNELS];
+        uint32_t ch, sufficient_size, output_size, decode_output_size, out_num_samples;
+
+        NARU_SetValidHeader(&header);
+        header.format_version = NARU_FORMAT_VERSION_INTERLEAVED_RESIDUAL;
+        header.num_channels = 2;
+        NARUDecoder_SetValidConfig(&config);
+
+        /* データ領域確保 */
+        sufficient_size = NARUDecoderTest_CalculateSufficientSize(&header, header.max_num_samples_per_block);
+        data = (uint8_t *)malloc(sufficient_size);
+        NARUDecoderTest_AllocateSignal(input, header.num_channels, header.max_num_samples_per_block);
+        NARUDecoderTest_AllocateSignal(output, header.num_channels, header.max_num_samples_per_block);
+
+        /* 入力に白色雑音をセット */
+        NARUDecoderTest_SetWhiteNoise(input, header.num_channels, header.max_num_samples_per_block, 12);
+
+        NARUDecoderTest_EncodeInterleavedResidualBlock(&header,
+                input, header.max_num_samples_per_block, data, sufficient_size, &output_size);
+
+        /* デコード */
+        decoder = NARUDecoder_Create(&config, NULL, 0);
+        ASSERT_TRUE(decoder != NULL);
+        EXPECT_EQ(NARU_APIRESULT_OK, NARUDecoder_SetHeader(decoder, &header));
+        EXPECT_EQ(NARU_APIRESULT_OK,
+                NARUDecoder_DecodeBlock(decoder, data, output_size,
+                    output, header.num_channels, header.max_num_samples_per_block, &decode_output_size, &out_num_samples));
+
+        /* 出力チェック */
+        EXPECT_EQ(output_size, decode_output_size);
+        EXPECT_EQ(header.max_num_samples_per_block, out_num_samples);
+        for (ch = 0; ch < header.num_channels; ch++) {
+            EXPECT_EQ(0, memcmp(input[ch], output[ch], sizeof(int32_t) * header.max_num_samples_per_block));
+        }
+
+        /* 領域の開放 */
+        NARUDecoderTest_FreeSignal(output, header.num_channels);
+        NARUDecoderTest_FreeSignal(input, header.num_channels);
+        free(data);
+        NARUDecoder_Destroy(decoder);
+    }
+
+    /* サブストリームのサイズ表が壊れている場合にエラーを返すか */
+    {
+        struct NARUDecoder *decoder;
+        struct NARUDecoderConfig decoder_config;
+        struct NARUHeader header, tmp_header;
+        uint8_t *data, *block;
+        int32_t *input[NARU_MAX_NUM_CHANNELS];
+        int32_t *output[NARU_MAX_NUM_CHANNELS];
+        uint32_t ch, sufficient_size, output_size, decode_output_size, out_num_samples;
+        uint32_t table_offset, substream_size;
+
+        NARU_SetValidHeader(&header);
+        header.num_channels = 2;
+        NARUDecoder_SetValidConfig(&decoder_config);
+        decoder_config.check_crc = 0;
+
+        /* データ領域確保 */
+        sufficient_size = NARUDecoderTest_CalculateSufficientSize(&header, header.max_num_samples_per_block);
+        data = (uint8_t *)malloc(sufficient_size);
+        NARUDecoderTest_AllocateSignal(input, header.num_channels, header.max_num_samples_per_block);
+        NARUDecoderTest_AllocateSignal(output, header.num_channels, header.max_num_samples_per_block);
+
+        /* 白色雑音をエンコード */
+        NARUDecoderTest_EncodeWhiteNoise(&header, 0, header.max_num_samples_per_block, 12,
+                input, data, sufficient_size, &output_size);
+
+        /* 圧縮ブロックになっていることを確認 */
+        block = data + NARU_HEADER_SIZE;
+        ASSERT_EQ(NARU_BLOCK_DATA_TYPE_COMPRESSDATA, ByteArray_ReadUint8(&block[8]));
+
+        decoder = NARUDecoder_Create(&decoder_config, NULL, 0);
+        ASSERT_TRUE(decoder != NULL);
+        EXPECT_EQ(NARU_APIRESULT_OK, NARUDecoder_DecodeHeader(data, output_size, &tmp_header));
+        EXPECT_EQ(NARU_APIRESULT_OK, NARUDecoder_SetHeader(decoder, &tmp_header));
+
+        /* サイズ表の位置を特定: フィルタ状態と初期パラメータを読み飛ばした直後のバイト境界 */
+        {
+            struct NARUBitStream stream;
+            NARUBitReader_Open(&stream, &block[NARU_BLOCK_HEADER_SIZE], output_size - NARU_HEADER_SIZE - NARU_BLOCK_HEADER_SIZE);
+            for (ch = 0; ch < header.num_channels; ch++) {
+                NARUDecodeProcessor_GetFilterState(decoder->processor[ch], &stream);
+            }
+            for (ch = 0; ch < header.num_channels; ch++) {
+                NARUCoder_GetInitialRecursiveRiceParameter(decoder->coder,
+                        &stream, NARUCODER_NUM_RECURSIVERICE_PARAMETER, ch);
+            }
+            NARUBitStream_Flush(&stream);
+            NARUBitStream_Tell(&stream, (int32_t *)&table_offset);
+            NARUBitStream_Close(&stream);
+            table_offset += NARU_BLOCK_HEADER_SIZE;
+        }
+        substream_size = ByteArray_ReadUint32BE(&block[table_offset]);
+        ASSERT_TRUE((table_offset + NARU_BLOCK_SUBSTREAM_SIZE_BYTES + substream_size) < (output_size - NARU_HEADER_SIZE));
+
+        /* 壊していなければデコードできる */
+        EXPECT_EQ(NARU_APIRESULT_OK,
+                NARUDecoder_DecodeBlock(decoder, block, output_size - NARU_HEADER_SIZE,
+                    output, header.num_channels, header.max_num_samples_per_block, &decode_output_size, &out_num_samples));
+        EXPECT_EQ(output_size - NARU_HEADER_SIZE, decode_output_size);
+        for (ch = 0; ch < header.num_channels; ch++) {
+            EXPECT_EQ(0, memcmp(input[ch], output[ch], sizeof(int32_t) * header.max_num_samples_per_block));
+        }
+
+        /* サブストリームサイズが読み出しサイズと不一致 */
+        ByteArray_WriteUint32BE(&block[table_offset], substream_size + 1);
+        EXPECT_EQ(NARU_APIRESULT_INVALID_FORMAT,
+                NARUDecoder_DecodeBlock(decoder, block, output_size - NARU_HEADER_SIZE,
+                    output, header.num_channels, header.max_num_samples_per_block, &decode_output_size, &out_num_samples));
+
+        /* サブストリームサイズがブロックをはみ出す */
+        ByteArray_WriteUint32BE(&block[table_offset], output_size);
+        EXPECT_EQ(NARU_APIRESULT_INSUFFICIENT_DATA,
+                NARUDecoder_DecodeBlock(decoder, block, output_size - NARU_HEADER_SIZE,
+                    output, header.num_channels, header.max_num_samples_per_block, &decode_output_size, &out_num_samples));
+
+        /* 領域の開放 */
+        NARUDecoderTest_FreeSignal(output, header.num_channels);
+        NARUDecoderTest_FreeSignal(input, header.num_channels);
+        free(data);
+        NARUDecoder_Destroy(decoder);
+    }
+
+    /* rANS符号化したブロックをデコードでき、破損を検出できるか */
+    {
+        struct NARUDecoder *decoder;
+        struct NARUDecoderConfig decoder_config;
+        struct NARUHeader header, tmp_header;
+        uint8_t *data, *block, last_byte;
+        int32_t *input[NARU_MAX_NUM_CHANNELS];
+        int32_t *output[NARU_MAX_NUM_CHANNELS];
+        uint32_t ch, sufficient_size, output_size, decode_output_size, out_num_samples;
+
+        NARU_SetValidHeader(&header);
+        header.num_channels = 2;
+        NARUDecoder_SetValidConfig(&decoder_config);
+        decoder_config.check_crc = 0;
+        /* 状態の初期値などの付加情報を上回って小さくなるよう、ブロックを長めに取る */
+        header.max_num_samples_per_block = 4096;
+
+        /* データ領域確保 */
+        sufficient_size = NARUDecoderTest_CalculateSufficientSize(&header, header.max_num_samples_per_block);
+        data = (uint8_t *)malloc(sufficient_size);
+        NARUDecoderTest_AllocateSignal(input, header.num_channels, header.max_num_samples_per_block);
+        NARUDecoderTest_AllocateSignal(output, header.num_channels, header.max_num_samples_per_block);
+
+        /* 小振幅の白色雑音をrANS符号を有効にしてエンコード
+        * 補足）少数の値に集中した残差は再帰的ライス符号よりrANS符号の方が小さくなる */
+        NARUDecoderTest_EncodeWhiteNoise(&header, 1, header.max_num_samples_per_block, 2,
+                input, data, sufficient_size, &output_size);
+
+        /* rANS符号化したブロックになっていることを確認 */
+        block = data + NARU_HEADER_SIZE;
+        ASSERT_EQ(NARU_BLOCK_DATA_TYPE_COMPRESSDATA_RANS, ByteArray_ReadUint8(&block[8]));
+
+        decoder = NARUDecoder_Create(&decoder_config, NULL, 0);
+        ASSERT_TRUE(decoder != NULL);
+        EXPECT_EQ(NARU_APIRESULT_OK, NARUDecoder_DecodeHeader(data, output_size, &tmp_header));
+        EXPECT_EQ(NARU_APIRESULT_OK, NARUDecoder_SetHeader(decoder, &tmp_header));
+
+        /* 壊していなければデコードできる */
+        EXPECT_EQ(NARU_APIRESULT_OK,
+                NARUDecoder_DecodeBlock(decoder, block, output_size - NARU_HEADER_SIZE,
+                    output, header.num_channels, header.max_num_samples_per_block, &decode_output_size, &out_num_samples));
+        EXPECT_EQ(output_size - NARU_HEADER_SIZE, decode_output_size);
+        for (ch = 0; ch < header.num_channels; ch++) {
+            EXPECT_EQ(0, memcmp(input[ch], output[ch], sizeof(int32_t) * header.max_num_samples_per_block));
+        }
+
+        /* rANS符号列の末尾が壊れている
+        * 補足）最後に読む符号語を少し増やすと読み込み位置は変わらず、復号後の状態だけが一致しなくなる
+        *       減らすと状態が下限を下回って余分に読み込もうとするので、最下位の0のビットを立てる */
+        last_byte = block[output_size - NARU_HEADER_SIZE - 1];
+        ASSERT_NE(0xFF, last_byte);
+        block[output_size - NARU_HEADER_SIZE - 1] = (uint8_t)(last_byte | (~last_byte & (last_byte + 1)));
+        EXPECT_EQ(NARU_APIRESULT_INVALID_FORMAT,
+                NARUDecoder_DecodeBlock(decoder, block, output_size - NARU_HEADER_SIZE,
+                    output, header.num_channels, header.max_num_samples_per_block, &decode_output_size, &out_num_samples));
+        block[output_size - NARU_HEADER_SIZE - 1] = last_byte;
+
+        /* 4以前のバージョンのストリームにもrANS符号化したブロックは存在しない */
+        tmp_header.format_version = NARU_FORMAT_VERSION_CRC16_CHECKSUM;
+        EXPECT_EQ(NARU_APIRESULT_OK, NARUDecoder_SetHeader(decoder, &tmp_header));
+        EXPECT_EQ(NARU_APIRESULT_INVALID_FORMAT,
+                NARUDecoder_DecodeBlock(decoder, block, output_size - NARU_HEADER_SIZE,
+                    output, header.num_channels, header.max_num_samples_per_block, &decode_output_size, &out_num_samples));
+
+        /* 旧フォーマットにはrANS符号化したブロックは存在しない */
+        tmp_header.format_version = NARU_FORMAT_VERSION_INTERLEAVED_RESIDUAL;
+        EXPECT_EQ(NARU_APIRESULT_OK, NARUDecoder_SetHeader(decoder, &tmp_header));
+        EXPECT_EQ(NARU_APIRESULT_INVALID_FORMAT,
+                NARUDecoder_DecodeBlock(decoder, block, output_size - NARU_HEADER_SIZE,
+                    output, header.num_channels, header.max_num_samples_per_block, &decode_output_size, &out_num_samples));
+
+        /* 領域の開放 */
+        NARUDecoderTest_FreeSignal(output, header.num_channels);
+        NARUDecoderTest_FreeSignal(input, header.num_channels);
+        free(data);
+        NARUDecoder_Destroy(decoder);
+    }
+}
+
+/* 途中で途切れたブロックのデコードテスト */
+TEST(NARUDecoderTest, DecodeTruncatedBlockTest)
+{
+    /* ブロックサイズを縮めても範囲外を読まず、データ不足を返すか */
+    {
+        struct NARUDecoder *decoder;
+        struct NARUDecoderConfig decoder_config;
+        struct NARUHeader header, tmp_header;
+        uint8_t *data;
+        int32_t *input[NARU_MAX_NUM_CHANNELS];
+        int32_t *output[NARU_MAX_NUM_CHANNELS];
+        uint32_t ch, sufficient_size, output_size, decode_output_size, out_num_samples;
+        uint32_t num_channels, use_rans;
+
+        for (num_channels = 1; num_channels <= 2; num_channels++) {
+            for (use_rans = 0; use_rans <= 1; use_rans++) {
+                uint32_t block_size, data_size, is_ok;
+
+                NARU_SetValidHeader(&header);
+                header.num_channels = num_channels;
+                header.max_num_samples_per_block = 4096;
+                NARUDecoder_SetValidConfig(&decoder_config);
+                decoder_config.check_crc = 0;
+
+                /* データ領域確保 */
+                sufficient_size = NARUDecoderTest_CalculateSufficientSize(&header, header.max_num_samples_per_block);
+                data = (uint8_t *)malloc(sufficient_size);
+                NARUDecoderTest_AllocateSignal(input, header.num_channels, header.max_num_samples_per_block);
+                NARUDecoderTest_AllocateSignal(output, header.num_channels, header.max_num_samples_per_block);
+
+                /* 白色雑音をエンコード */
+                NARUDecoderTest_EncodeWhiteNoise(&header, (uint8_t)use_rans, header.max_num_samples_per_block, 8,
+                        input, data, sufficient_size, &output_size);
+                ASSERT_NE(NARU_BLOCK_DATA_TYPE_RAWDATA, ByteArray_ReadUint8(&data[NARU_HEADER_SIZE + 8]));
+
+                decoder = NARUDecoder_Create(&decoder_config, NULL, 0);
+                ASSERT_TRUE(decoder != NULL);
+                EXPECT_EQ(NARU_APIRESULT_OK, NARUDecoder_DecodeHeader(data, output_size, &tmp_header));
+                EXPECT_EQ(NARU_APIRESULT_OK, NARUDecoder_SetHeader(decoder, &tmp_header));
+
+                /* データ部を1バイトずつ縮め、ちょうどのサイズの領域に入れてデコード */
+                /* 補足）範囲外の読み込みはAddressSanitizer等で検出できる */
+                block_size = output_size - NARU_HEADER_SIZE;
+                is_ok = 1;
+                for (data_size = NARU_BLOCK_HEADER_SIZE + 1; data_size < block_size; data_size++) {
+                    uint8_t *block = (uint8_t *)malloc(data_size);
+                    memcpy(block, &data[NARU_HEADER_SIZE], data_size);
+                    ByteArray_WriteUint32BE(&block[2], data_size - 6);
+                    if (NARUDecoder_DecodeBlock(decoder, block, data_size,
+                                output, header.num_channels, header.max_num_samples_per_block,
+                                &decode_output_size, &out_num_samples) != NARU_APIRESULT_INSUFFICIENT_DATA) {
+                        is_ok = 0;
+                    }
+                    free(block);
+                }
+                EXPECT_EQ(1, is_ok);
+
+                /* ブロックヘッダに満たない */
+                EXPECT_EQ(NARU_APIRESULT_INSUFFICIENT_DATA,
+                        NARUDecoder_DecodeBlock(decoder, &data[NARU_HEADER_SIZE], NARU_BLOCK_HEADER_SIZE - 1,
+                            output, header.num_channels, header.max_num_samples_per_block, &decode_output_size, &out_num_samples));
+
+                /* 縮めていなければデコードできる */
+                EXPECT_EQ(NARU_APIRESULT_OK,
+                        NARUDecoder_DecodeBlock(decoder, &data[NARU_HEADER_SIZE], block_size,
+                            output, header.num_channels, header.max_num_samples_per_block, &decode_output_size, &out_num_samples));
+                EXPECT_EQ(block_size, decode_output_size);
+                for (ch = 0; ch < header.num_channels; ch++) {
+                    EXPECT_EQ(0, memcmp(input[ch], output[ch], sizeof(int32_t) * header.max_num_samples_per_block));
+                }
+
+                /* 先頭の残差のガンマ符号の桁数が32を超えるように壊すと破損を返す */
+                if ((num_channels == 1) && (use_rans == 0)) {
+                    struct NARUBitStream stream;
+                    uint32_t residual_offset;
+                    /* 商部分がちょうど閾値の16bitの0、続くガンマ符号の桁数が47 */
+                    const uint8_t corrupted_gamma[] = { 0x00, 0x00, 0x80, 0x00, 0x00, 0x00, 0x00, 0x01 };
+                    uint8_t *block = (uint8_t *)malloc(block_size);
+                    memcpy(block, &data[NARU_HEADER_SIZE], block_size);
+                    /* 1チャンネルならばフィルタ状態と初期パラメータの直後が残差 */
+                    NARUBitReader_Open(&stream, &block[NARU_BLOCK_HEADER_SIZE], block_size - NARU_BLOCK_HEADER_SIZE);
+                    NARUDecodeProcessor_GetFilterState(decoder->processor[0], &stream);
+                    NARUCoder_GetInitialRecursiveRiceParameter(decoder->coder,
+                            &stream, NARUCODER_NUM_RECURSIVERICE_PARAMETER, 0);
+                    NARUBitStream_Flush(&stream);
+                    NARUBitStream_Tell(&stream, (int32_t *)&residual_offset);
+                    NARUBitStream_Close(&stream);
+                    memcpy(&block[NARU_BLOCK_HEADER_SIZE + residual_offset], corrupted_gamma, sizeof(corrupted_gamma));
+                    EXPECT_EQ(NARU_APIRESULT_INVALID_FORMAT,
+                            NARUDecoder_DecodeBlock(decoder, block, block_size,
+                                output, header.num_channels, header.max_num_samples_per_block, &decode_output_size, &out_num_samples));
+                    free(block);
+                }
+
+                /* 領域の開放 */
+                NARUDecoderTest_FreeSignal(output, header.num_channels);
+                NARUDecoderTest_FreeSignal(input, header.num_channels);
+                free(data);
+                NARUDecoder_Destroy(decoder);
+            }
+        }
+    }
+}
+
+/* CRC32Cチェックサムを持つブロックのデコードテスト */
+TEST(NARUDecoderTest, DecodeCRC32CChecksumTest)
+{
+    struct NARUDecoder *decoder;
+    struct NARUDecoderConfig decoder_config;
+    struct NARUHeader header, tmp_header;
+    uint8_t *data;
+    int32_t *input[NARU_MAX_NUM_CHANNELS];
+    int32_t *output[NARU_MAX_NUM_CHANNELS];
+    uint32_t ch, sufficient_size, output_size, decode_output_size, out_num_samples, use_rans;
+    uint8_t num_threads;
+
+    NARU_SetValidHeader(&header);
+    header.num_channels = 2;
+    header.num_samples = 1000; /* 最終ブロックは端数 */
+    header.ch_process_method = NARU_CH_PROCESS_METHOD_MS;
+    header.block_checksum_type = NARU_BLOCK_CHECKSUM_TYPE_CRC32C;
+
+    /* データ領域確保 */
+    sufficient_size = NARUDecoderTest_CalculateSufficientSize(&header, header.num_samples);
+    data = (uint8_t *)malloc(sufficient_size);
+    NARUDecoderTest_AllocateSignal(input, header.num_channels, header.num_samples);
+    NARUDecoderTest_AllocateSignal(output, header.num_channels, header.num_samples);
+
+    for (use_rans = 0; use_rans <= 1; use_rans++) {
+        /* 白色雑音をエンコード */
+        NARUDecoderTest_EncodeWhiteNoise(&header, (uint8_t)use_rans, header.num_samples, 12,
+                input, data, sufficient_size, &output_size);
+
+        /* ヘッダにチェックサム種別が記録されている */
+        EXPECT_EQ(NARU_APIRESULT_OK, NARUDecoder_DecodeHeader(data, output_size, &tmp_header));
+        EXPECT_EQ(NARU_BLOCK_CHECKSUM_TYPE_CRC32C, tmp_header.block_checksum_type);
+
+        /* 単一スレッド・複数スレッドでデコード結果は元の信号に一致 */
+        for (num_threads = 1; num_threads <= 2; num_threads++) {
+            NARUDecoder_SetValidConfig(&decoder_config);
+            decoder_config.max_num_threads = num_threads;
+            decoder = NARUDecoder_Create(&decoder_config, NULL, 0);
+            ASSERT_TRUE(decoder != NULL);
+            for (ch = 0; ch < header.num_channels; ch++) {
+                memset(output[ch], 0, sizeof(int32_t) * header.num_samples);
+            }
+            EXPECT_EQ(NARU_APIRESULT_OK,
+                    NARUDecoder_DecodeWhole(decoder, data, output_size, output, header.num_channels, header.num_samples));
+            for (ch = 0; ch < header.num_channels; ch++) {
+                EXPECT_EQ(0, memcmp(input[ch], output[ch], sizeof(int32_t) * header.num_samples));
+            }
+            NARUDecoder_Destroy(decoder);
+        }
+
+        NARUDecoder_SetValidConfig(&decoder_config);
+        decoder = NARUDecoder_Create(&decoder_config, NULL, 0);
+        ASSERT_TRUE(decoder != NULL);
+        EXPECT_EQ(NARU_APIRESULT_OK, NARUDecoder_SetHeader(decoder, &tmp_header));
+
+        /* ブロックヘッダ分のデータがない */
+        EXPECT_EQ(NARU_APIRESULT_INSUFFICIENT_DATA,
+                NARUDecoder_DecodeBlock(decoder, data + NARU_HEADER_SIZE, NARU_BLOCK_HEADER_SIZE_FOR_CHECKSUM(NARU_BLOCK_CHECKSUM_TYPE_CRC32C) - 1,
+                    output, header.num_channels, header.max_num_samples_per_block, &decode_output_size, &out_num_samples));
+
+        /* 先頭ブロックのデコードサイズはブロックサイズ+同期コードとブロックサイズ自体の領域 */
+        EXPECT_EQ(NARU_APIRESULT_OK,
+                NARUDecoder_DecodeBlock(decoder, data + NARU_HEADER_SIZE, output_size - NARU_HEADER_SIZE,
+                    output, header.num_channels, header.max_num_samples_per_block, &decode_output_size, &out_num_samples));
+        EXPECT_EQ(ByteArray_ReadUint32BE(&data[NARU_HEADER_SIZE + 2]) + 6, decode_output_size);
+        EXPECT_EQ(header.max_num_samples_per_block, out_num_samples);
+
+        /* チェックサムの破壊を検知 */
+        data[NARU_HEADER_SIZE + 6] ^= 0x01;
+        EXPECT_EQ(NARU_APIRESULT_DETECT_DATA_CORRUPTION,
+                NARUDecoder_DecodeBlock(decoder, data + NARU_HEADER_SIZE, output_size - NARU_HEADER_SIZE,
+                    output, header.num_channels, header.max_num_samples_per_block, &decode_output_size, &out_num_samples));
+        data[NARU_HEADER_SIZE + 6] ^= 0x01;
+
+        /* ブロックチャンネルあたりサンプル数の破壊を検知 */
+        data[NARU_HEADER_SIZE + 11] ^= 0x01;
+        EXPECT_EQ(NARU_APIRESULT_DETECT_DATA_CORRUPTION,
+                NARUDecoder_DecodeBlock(decoder, data + NARU_HEADER_SIZE, output_size - NARU_HEADER_SIZE,
+                    output, header.num_channels, header.max_num_samples_per_block, &decode_output_size, &out_num_samples));
+        data[NARU_HEADER_SIZE + 11] ^= 0x01;
+
+        /* ブロック末尾1byteの破壊を検知 */
+        data[NARU_HEADER_SIZE + decode_output_size - 1] ^= 0xFF;
+        EXPECT_EQ(NARU_APIRESULT_DETECT_DATA_CORRUPTION,
+                NARUDecoder_DecodeBlock(decoder, data + NARU_HEADER_SIZE, output_size - NARU_HEADER_SIZE,
+                    output, header.num_channels, header.max_num_samples_per_block, &decode_output_size, &out_num_samples));
+
+        NARUDecoder_Destroy(decoder);
+    }
+
+    /* 領域の開放 */
+    NARUDecoderTest_FreeSignal(output, header.num_channels);
+    NARUDecoderTest_FreeSignal(input, header.num_channels);
+    free(data);
+}
+
+/* ブロック位置取得テスト */
+TEST(NARUDecoderTest, ScanBlocksTest)
+{
+    struct NARUDecoder *decoder;
+    struct NARUDecoderConfig decoder_config;
+    struct NARUHeader header;
+    struct NARUBlockInformation *info;
+    uint8_t *data;
+    int32_t *input[NARU_MAX_NUM_CHANNELS];
+    int32_t *output[NARU_MAX_NUM_CHANNELS];
+    uint32_t ch, smpl, blk, sufficient_size, output_size, num_blocks, expected_num_blocks, checksum_type;
+    uint32_t decode_size, num_decode_samples;
+    uint8_t num_threads;
+
+    NARU_SetValidHeader(&header);
+    header.num_channels = 2;
+    header.num_samples = 1000; /* 最終ブロックは端数 */
+    header.ch_process_method = NARU_CH_PROCESS_METHOD_MS;
+    expected_num_blocks = (header.num_samples + header.max_num_samples_per_block - 1) / header.max_num_samples_per_block;
+
+    /* データ領域確保 */
+    sufficient_size = NARUDecoderTest_CalculateSufficientSize(&header, header.num_samples);
+    data = (uint8_t *)malloc(sufficient_size);
+    info = (struct NARUBlockInformation *)malloc(sizeof(struct NARUBlockInformation) * expected_num_blocks);
+    NARUDecoderTest_AllocateSignal(input, header.num_channels, header.num_samples);
+    NARUDecoderTest_AllocateSignal(output, header.num_channels, header.num_samples);
+
+    for (checksum_type = 0; checksum_type < NARU_BLOCK_CHECKSUM_TYPE_INVALID; checksum_type++) {
+        /* 白色雑音をエンコード */
+        header.block_checksum_type = (NARUBlockChecksumType)checksum_type;
+        NARUDecoderTest_EncodeWhiteNoise(&header, 0, header.num_samples, 12,
+                input, data, sufficient_size, &output_size);
+
+        for (num_threads = 1; num_threads <= 2; num_threads++) {
+            NARUDecoder_SetValidConfig(&decoder_config);
+            decoder_config.max_num_threads = num_threads;
+            decoder = NARUDecoder_Create(&decoder_config, NULL, 0);
+            ASSERT_TRUE(decoder != NULL);
+
+            /* 引数が不正 */
+            EXPECT_EQ(NARU_APIRESULT_INVALID_ARGUMENT,
+                    NARUDecoder_ScanBlocks(NULL, data, output_size, info, expected_num_blocks, &num_blocks));
+            EXPECT_EQ(NARU_APIRESULT_INVALID_ARGUMENT,
+                    NARUDecoder_ScanBlocks(decoder, NULL, output_size, info, expected_num_blocks, &num_blocks));
+            EXPECT_EQ(NARU_APIRESULT_INVALID_ARGUMENT,
+                    NARUDecoder_ScanBlocks(decoder, data, output_size, info, expected_num_blocks, NULL));
+
+            /* ブロック数のみを数える */
+            EXPECT_EQ(NARU_APIRESULT_OK,
+                    NARUDecoder_ScanBlocks(decoder, data, output_size, NULL, 0, &num_blocks));
+            EXPECT_EQ(expected_num_blocks, num_blocks);
+
+            /* 取得した位置は隙間なく並び、各ブロックを単独でデコードすると元の信号に一致 */
+            EXPECT_EQ(NARU_APIRESULT_OK,
+                    NARUDecoder_ScanBlocks(decoder, data, output_size, info, expected_num_blocks, &num_blocks));
+            EXPECT_EQ(expected_num_blocks, num_blocks);
+            EXPECT_EQ(NARU_HEADER_SIZE, info[0].byte_offset);
+            EXPECT_EQ(0U, info[0].sample_offset);
+            for (blk = 0; blk < num_blocks; blk++) {
+                int32_t *buffer_ptr[NARU_MAX_NUM_CHANNELS];
+                if (blk > 0) {
+                    EXPECT_EQ(info[blk - 1].byte_offset + info[blk - 1].block_size, info[blk].byte_offset);
+                    EXPECT_EQ(info[blk - 1].sample_offset + info[blk - 1].num_samples, info[blk].sample_offset);
+                }
+                EXPECT_TRUE(info[blk].block_type < NARU_BLOCK_DATA_TYPE_INVALID);
+                for (ch = 0; ch < header.num_channels; ch++) {
+                    buffer_ptr[ch] = &output[ch][info[blk].sample_offset];
+                }
+                EXPECT_EQ(NARU_APIRESULT_OK,
+                        NARUDecoder_DecodeBlock(decoder, &data[info[blk].byte_offset], info[blk].block_size,
+                            buffer_ptr, header.num_channels, info[blk].num_samples, &decode_size, &num_decode_samples));
+                EXPECT_EQ(info[blk].block_size, decode_size);
+                EXPECT_EQ(info[blk].num_samples, num_decode_samples);
+            }
+            EXPECT_EQ(output_size, info[num_blocks - 1].byte_offset + info[num_blocks - 1].block_size);
+            EXPECT_EQ(header.num_samples, info[num_blocks - 1].sample_offset + info[num_blocks - 1].num_samples);
+            for (ch = 0; ch < header.num_channels; ch++) {
+                EXPECT_EQ(0, memcmp(input[ch], output[ch], sizeof(int32_t) * header.num_samples));
+            }
+
+            /* 情報の格納領域が足りない */
+            EXPECT_EQ(NARU_APIRESULT_INSUFFICIENT_BUFFER,
+                    NARUDecoder_ScanBlocks(decoder, data, output_size, info, expected_num_blocks - 1, &num_blocks));
+            EXPECT_EQ(expected_num_blocks - 1, num_blocks);
+
+            /* データの末尾が欠けている */
+            EXPECT_EQ(NARU_APIRESULT_INSUFFICIENT_DATA,
+                    NARUDecoder_ScanBlocks(decoder, data, output_size - 1, info, expected_num_blocks, &num_blocks));
+            EXPECT_EQ(expected_num_blocks - 1, num_blocks);
+
+            /* 同期コードの破壊 */
+            data[info[3].byte_offset] ^= 0xFF;
+            EXPECT_EQ(NARU_APIRESULT_INVALID_FORMAT,
+                    NARUDecoder_ScanBlocks(decoder, data, output_size, info, expected_num_blocks, &num_blocks));
+            EXPECT_EQ(3U, num_blocks);
+            data[info[3].byte_offset] ^= 0xFF;
+
+            /* ブロックサイズの破壊: 加算で桁あふれする値でも不正として弾く */
+            {
+                uint8_t size_field[4];
+                memcpy(size_field, &data[NARU_HEADER_SIZE + 2], sizeof(size_field));
+                data[NARU_HEADER_SIZE + 2] = 0xFF; data[NARU_HEADER_SIZE + 3] = 0xFF;
+                data[NARU_HEADER_SIZE + 4] = 0xFF; data[NARU_HEADER_SIZE + 5] = 0xFA;
+                EXPECT_EQ(NARU_APIRESULT_INVALID_FORMAT,
+                        NARUDecoder_ScanBlocks(decoder, data, output_size, info, expected_num_blocks, &num_blocks));
+                EXPECT_EQ(0U, num_blocks);
+                memcpy(&data[NARU_HEADER_SIZE + 2], size_field, sizeof(size_field));
+            }
+
+            /* ブロックサイズの破壊: データ部を持たないサイズは走査・デコードのどちらでも不正として弾く */
+            {
+                uint8_t size_field[4];
+                memcpy(size_field, &data[NARU_HEADER_SIZE + 2], sizeof(size_field));
+                ByteArray_WriteUint32BE(&data[NARU_HEADER_SIZE + 2], NARU_BLOCK_CHECKSUM_SIZE(checksum_type) + 3);
+                EXPECT_EQ(NARU_APIRESULT_INVALID_FORMAT,
+                        NARUDecoder_ScanBlocks(decoder, data, output_size, info, expected_num_blocks, &num_blocks));
+                EXPECT_EQ(0U, num_blocks);
+                EXPECT_EQ(NARU_APIRESULT_INVALID_FORMAT,
+                        NARUDecoder_DecodeBlock(decoder, &data[NARU_HEADER_SIZE], output_size - NARU_HEADER_SIZE,
+                            output, header.num_channels, header.num_samples, &decode_size, &num_decode_samples));
+                memcpy(&data[NARU_HEADER_SIZE + 2], size_field, sizeof(size_field));
+            }
+
+            /* ブロック末尾1byteの破壊を検知し、それより前のブロック数を返す */
+            EXPECT_EQ(NARU_APIRESULT_OK,
+                    NARUDecoder_ScanBlocks(decoder, data, output_size, info, expected_num_blocks, &num_blocks));
+            data[info[5].byte_offset + info[5].block_size - 1] ^= 0xFF;
+            EXPECT_EQ(NARU_APIRESULT_DETECT_DATA_CORRUPTION,
+                    NARUDecoder_ScanBlocks(decoder, data, output_size, info, expected_num_blocks, &num_blocks));
+            EXPECT_EQ(5U, num_blocks);
+            NARUDecoder_Destroy(decoder);
+
+            /* CRC検査がOFFならばブロックヘッダのみを見るので成功 */
+            decoder_config.check_crc = 0;
+            decoder = NARUDecoder_Create(&decoder_config, NULL, 0);
+            ASSERT_TRUE(decoder != NULL);
+            EXPECT_EQ(NARU_APIRESULT_OK,
+                    NARUDecoder_ScanBlocks(decoder, data, output_size, info, expected_num_blocks, &num_blocks));
+            EXPECT_EQ(expected_num_blocks, num_blocks);
+            data[info[5].byte_offset + info[5].block_size - 1] ^= 0xFF;
+            NARUDecoder_Destroy(decoder);
+        }
+    }
+
+    /* 領域の開放 */
+    NARUDecoderTest_FreeSignal(output, header.num_channels);
+    NARUDecoderTest_FreeSignal(input, header.num_channels);
+    free(info);
+    free(data);
+}
+
+/* シークテーブルを用いたシークテスト */
+TEST(NARUDecoderTest, SeekTest)
+{
+    /* 指定サンプルからのデコード */
+    {
+        struct NARUDecoder *decoder;
+        struct NARUDecoderConfig decoder_config;
+        struct NARUHeader header;
+        struct NARUBlockInformation *info, find_info;
+        uint8_t *data;
+        int32_t *input[NARU_MAX_NUM_CHANNELS];
+        int32_t *output[NARU_MAX_NUM_CHANNELS];
+        uint32_t ch, i, sufficient_size, output_size, table_size, num_blocks, num_decode_samples;
+        uint32_t checksum_type, use_seek_table;
+        const uint32_t positions[] = { 0, 1, 31, 32, 33, 500, 991, 992, 999 };
+
+        NARU_SetValidHeader(&header);
+        header.num_channels = 2;
+        header.num_samples = 1000; /* 最終ブロックは端数 */
+        header.ch_process_method = NARU_CH_PROCESS_METHOD_MS;
+        NARUDecoder_SetValidConfig(&decoder_config);
+
+        sufficient_size = NARUDecoderTest_CalculateSufficientSize(&header, header.num_samples);
+        data = (uint8_t *)malloc(sufficient_size);
+        info = (struct NARUBlockInformation *)malloc(sizeof(struct NARUBlockInformation) * header.num_samples);
+        NARUDecoderTest_AllocateSignal(input, header.num_channels, header.num_samples);
+        NARUDecoderTest_AllocateSignal(output, header.num_channels, header.num_samples);
+
+        decoder = NARUDecoder_Create(&decoder_config, NULL, 0);
+        ASSERT_TRUE(decoder != NULL);
+
+        for (checksum_type = 0; checksum_type < NARU_BLOCK_CHECKSUM_TYPE_INVALID; checksum_type++) {
+            for (use_seek_table = 0; use_seek_table <= 1; use_seek_table++) {
+                header.block_checksum_type = (NARUBlockChecksumType)checksum_type;
+                header.has_seek_table = (uint8_t)use_seek_table;
+                NARUDecoderTest_EncodeWhiteNoise(&header, 0, header.num_samples, 12,
+                        input, data, sufficient_size, &output_size);
+
+                /* シークテーブルの有無に依らず一括デコードできる */
+                EXPECT_EQ(NARU_APIRESULT_OK,
+                        NARUDecoder_DecodeWhole(decoder, data, output_size, output, header.num_channels, header.num_samples));
+                for (ch = 0; ch < header.num_channels; ch++) {
+                    EXPECT_EQ(0, memcmp(input[ch], output[ch], sizeof(int32_t) * header.num_samples));
+                }
+                EXPECT_EQ(NARU_APIRESULT_OK,
+                        NARUDecoder_ScanBlocks(decoder, data, output_size, info, header.num_samples, &num_blocks));
+
+                for (i = 0; i < sizeof(positions) / sizeof(positions[0]); i++) {
+                    const struct NARUBlockInformation *ref_info = &info[positions[i] / header.max_num_samples_per_block];
+                    /* ブロック位置は全ブロックを辿った結果に一致 */
+                    EXPECT_EQ(NARU_APIRESULT_OK,
+                            NARUDecoder_FindBlock(decoder, data, output_size, positions[i], &find_info));
+                    EXPECT_EQ(ref_info->byte_offset, find_info.byte_offset);
+                    EXPECT_EQ(ref_info->block_size, find_info.block_size);
+                    EXPECT_EQ(ref_info->sample_offset, find_info.sample_offset);
+                    EXPECT_EQ(ref_info->num_samples, find_info.num_samples);
+                    EXPECT_EQ(ref_info->block_type, find_info.block_type);
+                    /* 指定サンプルからブロック末尾までが出力される */
+                    EXPECT_EQ(NARU_APIRESULT_OK,
+                            NARUDecoder_DecodeBlockFromSample(decoder, data, output_size, positions[i],
+                                output, header.num_channels, header.max_num_samples_per_block, &num_decode_samples));
+                    EXPECT_EQ(ref_info->sample_offset + ref_info->num_samples - positions[i], num_decode_samples);
+                    for (ch = 0; ch < header.num_channels; ch++) {
+                        EXPECT_EQ(0, memcmp(&input[ch][positions[i]], output[ch], sizeof(int32_t) * num_decode_samples));
+                    }
+                }
+
+                /* 失敗ケース */
+                EXPECT_EQ(NARU_APIRESULT_INVALID_ARGUMENT,
+                        NARUDecoder_FindBlock(NULL, data, output_size, 0, &find_info));
+                EXPECT_EQ(NARU_APIRESULT_INVALID_ARGUMENT,
+                        NARUDecoder_FindBlock(decoder, NULL, output_size, 0, &find_info));
+                EXPECT_EQ(NARU_APIRESULT_INVALID_ARGUMENT,
+                        NARUDecoder_FindBlock(decoder, data, output_size, 0, NULL));
+                EXPECT_EQ(NARU_APIRESULT_INVALID_ARGUMENT,
+                        NARUDecoder_FindBlock(decoder, data, output_size, header.num_samples, &find_info));
+                EXPECT_EQ(NARU_APIRESULT_INVALID_ARGUMENT,
+                        NARUDecoder_DecodeBlockFromSample(decoder, data, output_size, 0,
+                            NULL, header.num_channels, header.max_num_samples_per_block, &num_decode_samples));
+                EXPECT_EQ(NARU_APIRESULT_INVALID_ARGUMENT,
+                        NARUDecoder_DecodeBlockFromSample(decoder, data, output_size, 0,
+                            output, header.num_channels, header.max_num_samples_per_block, NULL));
+                /* ブロック全体が収まらない */
+                EXPECT_EQ(NARU_APIRESULT_INSUFFICIENT_BUFFER,
+                        NARUDecoder_DecodeBlockFromSample(decoder, data, output_size, 33,
+                            output, header.num_channels, header.max_num_samples_per_block - 1, &num_decode_samples));
+            }
+
+            /* シークテーブルが壊れている・欠けている時は、先頭からブロックヘッダを辿って見つける */
+            table_size = ByteArray_ReadUint32BE(&data[output_size - 4]);
+            EXPECT_EQ(NARU_SEEKTABLE_BLOCK_SIZE(checksum_type, num_blocks), table_size);
+            for (i = 0; i < 3; i++) {
+                const struct NARUBlockInformation *ref_info = &info[500 / header.max_num_samples_per_block];
+                uint32_t data_size = output_size;
+                uint8_t table_tail[8];
+                memcpy(table_tail, &data[output_size - sizeof(table_tail)], sizeof(table_tail));
+                switch (i) {
+                case 0:
+                    /* チェックサム不一致 */
+                    data[output_size - 5] ^= 0x01;
+                    break;
+                case 1:
+                    /* 末尾が欠けてシークテーブルが見つからない */
+                    data_size = output_size - 1;
+                    break;
+                default:
+                    /* シークテーブルのサイズが不正 */
+                    ByteArray_WriteUint32BE(&data[output_size - 4], table_size + 1);
+                    break;
+                }
+                EXPECT_EQ(NARU_APIRESULT_OK,
+                        NARUDecoder_FindBlock(decoder, data, data_size, 500, &find_info));
+                EXPECT_EQ(ref_info->byte_offset, find_info.byte_offset);
+                EXPECT_EQ(ref_info->block_size, find_info.block_size);
+                EXPECT_EQ(ref_info->sample_offset, find_info.sample_offset);
+                EXPECT_EQ(ref_info->num_samples, find_info.num_samples);
+                EXPECT_EQ(NARU_APIRESULT_OK,
+                        NARUDecoder_DecodeBlockFromSample(decoder, data, data_size, 500,
+                            output, header.num_channels, header.max_num_samples_per_block, &num_decode_samples));
+                EXPECT_EQ(ref_info->sample_offset + ref_info->num_samples - 500, num_decode_samples);
+                for (ch = 0; ch < header.num_channels; ch++) {
+                    EXPECT_EQ(0, memcmp(&input[ch][500], output[ch], sizeof(int32_t) * num_decode_samples));
+                }
+                memcpy(&data[output_size - sizeof(table_tail)], table_tail, sizeof(table_tail));
+            }
+        }
+
+        NARUDecoder_Destroy(decoder);
+        NARUDecoderTest_FreeSignal(output, header.num_channels);
+        NARUDecoderTest_FreeSignal(input, header.num_channels);
+        free(info);
+        free(data);
+    }
+
+    /* 間引かれたシークポイントからブロックを辿る */
+    {
+#define NUM_SAMPLES_PER_BLOCK 16
+#define NUM_BLOCKS            (8192 + 1001) /* エンコーダのシークポイント数上限を超えるブロック数 */
+#define NUM_SAMPLES           (NUM_SAMPLES_PER_BLOCK * NUM_BLOCKS)
+        struct NARUEncoder *encoder;
+        struct NARUDecoder *decoder;
+        struct NARUEncoderConfig encoder_config;
+        struct NARUDecoderConfig decoder_config;
+        struct NARUEncodeParameter parameter;
+        struct NARUHeader header;
+        struct NARUBlockInformation *info, find_info;
+        int32_t *input[1];
+        uint8_t *data;
+        uint32_t smpl, block, data_size, output_size, num_blocks;
+
+        NARU_SetValidHeader(&header);
+        header.num_samples = NUM_SAMPLES;
+        header.max_num_samples_per_block = NUM_SAMPLES_PER_BLOCK;
+        header.filter_order = 4;
+        header.has_seek_table = 1;
+        NARUEncoder_SetValidConfig(&encoder_config);
+        NARUDecoder_SetValidConfig(&decoder_config);
+
+        data_size = NARU_HEADER_SIZE + 4 * NUM_SAMPLES * sizeof(int32_t);
+        data = (uint8_t *)malloc(data_size);
+        info = (struct NARUBlockInformation *)malloc(sizeof(struct NARUBlockInformation) * NUM_BLOCKS);
+        input[0] = (int32_t *)malloc(sizeof(int32_t) * NUM_SAMPLES);
+        for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+            input[0][smpl] = (int32_t)(smpl % 64) - 32;
+        }
+
+        encoder = NARUEncoder_Create(&encoder_config, NULL, 0);
+        ASSERT_TRUE(encoder != NULL);
+        NARUEncoder_ConvertHeaderToParameter(&header, &parameter);
+        ASSERT_EQ(NARU_APIRESULT_OK, NARUEncoder_SetEncodeParameter(encoder, &parameter));
+        ASSERT_EQ(NARU_APIRESULT_OK, NARUEncoder_EncodeWhole(encoder, input, NUM_SAMPLES, data, data_size, &output_size));
+        NARUEncoder_Destroy(encoder);
+
+        decoder = NARUDecoder_Create(&decoder_config, NULL, 0);
+        ASSERT_TRUE(decoder != NULL);
+        ASSERT_EQ(NARU_APIRESULT_OK, NARUDecoder_ScanBlocks(decoder, data, output_size, info, NUM_BLOCKS, &num_blocks));
+        ASSERT_EQ(NUM_BLOCKS, num_blocks);
+
+        /* シークポイントのない奇数番目のブロックも含めて全て見つかる */
+        for (block = 0; block < NUM_BLOCKS; block++) {
+            ASSERT_EQ(NARU_APIRESULT_OK,
+                    NARUDecoder_FindBlock(decoder, data, output_size, block * NUM_SAMPLES_PER_BLOCK + (block % NUM_SAMPLES_PER_BLOCK), &find_info));
+            EXPECT_EQ(info[block].byte_offset, find_info.byte_offset);
+            EXPECT_EQ(info[block].sample_offset, find_info.sample_offset);
+        }
+
+        NARUDecoder_Destroy(decoder);
+        free(input[0]);
+        free(info);
+        free(data);
+#undef NUM_SAMPLES_PER_BLOCK
+#undef NUM_BLOCKS
+#undef NUM_SAMPLES
+    }
+}
+
+/* 範囲デコードテスト */
+TEST(NARUDecoderTest, DecodeRangeTest)
+{
+    /* 成功例 */
+    {
+        struct NARUDecoder *decoder;
+        struct NARUDecoderConfig decoder_config;
+        struct NARUHeader header;
+        uint8_t *data;
+        int32_t *input[NARU_MAX_NUM_CHANNELS];
+        int32_t *output[NARU_MAX_NUM_CHANNELS];
+        uint32_t ch, i, sufficient_size, output_size, num_threads, use_seek_table;
+        const uint32_t ranges[][2] = {
+            { 0, 1000 }, { 0, 1 }, { 5, 20 }, { 31, 33 }, { 32, 64 }, { 32, 65 },
+            { 33, 999 }, { 64, 992 }, { 100, 900 }, { 992, 1000 }, { 999, 1000 } };
+
+        NARU_SetValidHeader(&header);
+        header.num_channels = 2;
+        header.num_samples = 1000; /* 最終ブロックは端数 */
+        header.ch_process_method = NARU_CH_PROCESS_METHOD_MS;
+
+        sufficient_size = NARUDecoderTest_CalculateSufficientSize(&header, header.num_samples);
+        data = (uint8_t *)malloc(sufficient_size);
+        NARUDecoderTest_AllocateSignal(input, header.num_channels, header.num_samples);
+        NARUDecoderTest_AllocateSignal(output, header.num_channels, header.num_samples);
+
+        for (use_seek_table = 0; use_seek_table <= 1; use_seek_table++) {
+            header.has_seek_table = (uint8_t)use_seek_table;
+            NARUDecoderTest_EncodeWhiteNoise(&header, 0, header.num_samples, 12,
+                    input, data, sufficient_size, &output_size);
+
+            for (num_threads = 1; num_threads <= 4; num_threads += 3) {
+                NARUDecoder_SetValidConfig(&decoder_config);
+                decoder_config.max_num_threads = (uint8_t)num_threads;
+                decoder = NARUDecoder_Create(&decoder_config, NULL, 0);
+                ASSERT_TRUE(decoder != NULL);
+
+                /* 範囲のサンプルのみが出力される */
+                for (i = 0; i < sizeof(ranges) / sizeof(ranges[0]); i++) {
+                    const uint32_t num_range_samples = ranges[i][1] - ranges[i][0];
+                    EXPECT_EQ(NARU_APIRESULT_OK,
+                            NARUDecoder_DecodeRange(decoder, data, output_size, ranges[i][0], ranges[i][1],
+                                output, header.num_channels, num_range_samples));
+                    for (ch = 0; ch < header.num_channels; ch++) {
+                        EXPECT_EQ(0, memcmp(&input[ch][ranges[i][0]], output[ch], sizeof(int32_t) * num_range_samples));
+                    }
+                }
+
+                NARUDecoder_Destroy(decoder);
+            }
+        }
+
+        NARUDecoderTest_FreeSignal(output, header.num_channels);
+        NARUDecoderTest_FreeSignal(input, header.num_channels);
+        free(data);
+    }
+
+    /* 失敗ケース */
+    {
+        struct NARUEncoder *encoder;
+        struct NARUDecoder *decoder;
+        struct NARUEncoderConfig encoder_config;
+        struct NARUDecoderConfig decoder_config;
+        struct NARUEncodeParameter parameter;
+        struct NARUHeader header;
+        uint8_t *data;
+        int32_t *input[NARU_MAX_NUM_CHANNELS];
+        int32_t *output[NARU_MAX_NUM_CHANNELS];
+        uint32_t i, smpl, sufficient_size, output_size;
+
+        NARU_SetValidHeader(&header);
+        header.num_channels = 1;
+        header.num_samples = 1000;
+        NARUEncoder_SetValidConfig(&encoder_config);
+        NARUDecoder_SetValidConfig(&decoder_config);
+
+        sufficient_size = NARUDecoderTest_CalculateSufficientSize(&header, header.num_samples);
+        data = (uint8_t *)malloc(sufficient_size);
+        input[0] = (int32_t *)malloc(sizeof(int32_t) * header.num_samples);
+        output[0] = (int32_t *)malloc(sizeof(int32_t) * header.num_samples);
+        for (smpl = 0; smpl < header.num_samples; smpl++) {
+            input[0][smpl] = (int32_t)(smpl % 64) - 32;
+        }
+
+        encoder = NARUEncoder_Create(&encoder_config, NULL, 0);
+        ASSERT_TRUE(encoder != NULL);
+        NARUEncoder_ConvertHeaderToParameter(&header, &parameter);
+        EXPECT_EQ(NARU_APIRESULT_OK, NARUEncoder_SetEncodeParameter(encoder, &parameter));
+        EXPECT_EQ(NARU_APIRESULT_OK,
+                NARUEncoder_EncodeWhole(encoder, input, header.num_samples, data, sufficient_size, &output_size));
+        NARUEncoder_Destroy(encoder);
+
+        decoder = NARUDecoder_Create(&decoder_config, NULL, 0);
+        ASSERT_TRUE(decoder != NULL);
+
+        /* 不正な引数 */
+        EXPECT_EQ(NARU_APIRESULT_INVALID_ARGUMENT,
+                NARUDecoder_DecodeRange(NULL, data, output_size, 0, 10, output, 1, header.num_samples));
+        EXPECT_EQ(NARU_APIRESULT_INVALID_ARGUMENT,
+                NARUDecoder_DecodeRange(decoder, NULL, output_size, 0, 10, output, 1, header.num_samples));
+        EXPECT_EQ(NARU_APIRESULT_INVALID_ARGUMENT,
+                NARUDecoder_DecodeRange(decoder, data, output_size, 0, 10, NULL, 1, header.num_samples));
+        EXPECT_EQ(NARU_APIRESULT_INVALID_ARGUMENT,
+                NARUDecoder_DecodeRange(decoder, data, output_size, 10, 10, output, 1, header.num_samples));
+        EXPECT_EQ(NARU_APIRESULT_INVALID_ARGUMENT,
+                NARUDecoder_DecodeRange(decoder, data, output_size, 0, header.num_samples + 1, output, 1, header.num_samples));
+        EXPECT_EQ(NARU_APIRESULT_INVALID_ARGUMENT,
+                NARUDecoder_DecodeRange(decoder, data, output_size, header.num_samples, header.num_samples + 1, output, 1, header.num_samples));
+
+        /* 出力バッファ不足 */
+        EXPECT_EQ(NARU_APIRESULT_INSUFFICIENT_BUFFER,
+                NARUDecoder_DecodeRange(decoder, data, output_size, 10, 100, output, 0, header.num_samples));
+        EXPECT_EQ(NARU_APIRESULT_INSUFFICIENT_BUFFER,
+                NARUDecoder_DecodeRange(decoder, data, output_size, 10, 100, output, 1, 89));
+
+        /* 途中のブロックの破損・データの途切れ */
+        data[output_size / 2] ^= 0x01;
+        EXPECT_EQ(NARU_APIRESULT_DETECT_DATA_CORRUPTION,
+                NARUDecoder_DecodeRange(decoder, data, output_size, 10, 990, output, 1, header.num_samples));
+        data[output_size / 2] ^= 0x01;
+        EXPECT_EQ(NARU_APIRESULT_INSUFFICIENT_DATA,
+                NARUDecoder_DecodeRange(decoder, data, output_size - 1, 10, 1000, output, 1, header.num_samples));
+        EXPECT_EQ(NARU_APIRESULT_OK,
+                NARUDecoder_DecodeRange(decoder, data, output_size, 10, 1000, output, 1, header.num_samples));
+
+        NARUDecoder_Destroy(decoder);
+
+        /* ブロックバッファがブロックより小さい時はブロック境界の範囲のみデコードできる */
+        for (i = 0; i < 2; i++) {
+            decoder_config.max_num_samples_per_block = i * (header.max_num_samples_per_block - 1);
+            decoder = NARUDecoder_Create(&decoder_config, NULL, 0);
+            ASSERT_TRUE(decoder != NULL);
+            EXPECT_EQ(NARU_APIRESULT_OK,
+                    NARUDecoder_DecodeRange(decoder, data, output_size,
+                        header.max_num_samples_per_block, 3 * header.max_num_samples_per_block,
+                        output, 1, header.num_samples));
+            EXPECT_EQ(0, memcmp(&input[0][header.max_num_samples_per_block], output[0],
+                        sizeof(int32_t) * 2 * header.max_num_samples_per_block));
+            EXPECT_EQ(NARU_APIRESULT_INSUFFICIENT_BUFFER,
+                    NARUDecoder_DecodeRange(decoder, data, output_size, 1, 100, output, 1, header.num_samples));
+            NARUDecoder_Destroy(decoder);
+        }
+
+        free(output[0]);
+        free(input[0]);
+        free(data);
+    }
+}
+
+/* ストリーミングデコード出力の蓄積先 */
+struct NARUDecoderTestStreamOutput {
+    int32_t *data[NARU_MAX_NUM_CHANNELS];
+    uint32_t num_samples;
+    uint32_t capacity;
+    uint32_t num_callbacks;
+};
+
+/* ストリーミングデコード出力コールバック */
+static NARUApiResult NARUDecoderTest_WriteCallback(
+        const struct NARUHeader *header, const int32_t *const *buffer, uint32_t num_samples, void *user_data)
+{
+    uint32_t ch;
+    struct NARUDecoderTestStreamOutput *output = (struct NARUDecoderTestStreamOutput *)user_data;
+    if ((output->num_samples + num_samples) > output->capacity) {
+        return NARU_APIRESULT_INSUFFICIENT_BUFFER;
+    }
+    for (ch = 0; ch < header->num_channels; ch++) {
+        memcpy(&output->data[ch][output->num_samples], buffer[ch], sizeof(int32_t) * num_samples);
+    }
+    output->num_samples += num_samples;
+    output->num_callbacks++;
+    return NARU_APIRESULT_OK;
+}
+
+/* ストリーミングエンコード出力の蓄積先 */
+struct NARUDecoderTestEncodedOutput {
+    uint8_t *data;
+    uint32_t size;
+    uint32_t capacity;
+};
+
+/* ストリーミングエンコード出力コールバック */
+static NARUApiResult NARUDecoderTest_WriteEncodedCallback(const uint8_t *data, uint32_t data_size, void *user_data)
+{
+    struct NARUDecoderTestEncodedOutput *output = (struct NARUDecoderTestEncodedOutput *)user_data;
+    if ((output->size + data_size) > output->capacity) {
+        return NARU_APIRESULT_INSUFFICIENT_BUFFER;
+    }
+    memcpy(&output->data[output->size], data, data_size);
+    output->size += data_size;
+    return NARU_APIRESULT_OK;
+}
+
+/* ストリーミングデコードテスト */
+TEST(NARUDecoderTest, StreamingDecodeTest)
+{
+    /* 任意の区切りで供給したデータのデコード */
+    {
+        struct NARUDecoder *decoder;
+        struct NARUDecoderConfig decoder_config;
+        struct NARUHeader header;
+        struct NARUDecoderTestStreamOutput output;
+        uint8_t *data, *block_data;
+        int32_t *input[NARU_MAX_NUM_CHANNELS];
+        uint32_t ch, i, progress, sufficient_size, output_size, block_data_size;
+        uint32_t checksum_type, use_seek_table, required_size;
+        const uint32_t chunk_sizes[] = { 1, 7, 13, 100, 4096, 0xFFFFFFFF };
+
+        NARU_SetValidHeader(&header);
+        header.num_channels = 2;
+        header.num_samples = 1000; /* 最終ブロックは端数 */
+        header.ch_process_method = NARU_CH_PROCESS_METHOD_MS;
+        NARUDecoder_SetValidConfig(&decoder_config);
+
+        sufficient_size = NARUDecoderTest_CalculateSufficientSize(&header, header.num_samples);
+        data = (uint8_t *)malloc(sufficient_size);
+        block_data_size = NARUENCODER_CALCULATE_MAX_BLOCK_SIZE(header.num_channels, header.max_num_samples_per_block);
+        block_data = (uint8_t *)malloc(block_data_size);
+        output.capacity = header.num_samples;
+        NARUDecoderTest_AllocateSignal(input, header.num_channels, header.num_samples);
+        NARUDecoderTest_AllocateSignal(output.data, header.num_channels, header.num_samples);
+
+        decoder = NARUDecoder_Create(&decoder_config, NULL, 0);
+        ASSERT_TRUE(decoder != NULL);
+
+        for (checksum_type = 0; checksum_type < NARU_BLOCK_CHECKSUM_TYPE_INVALID; checksum_type++) {
+            for (use_seek_table = 0; use_seek_table <= 1; use_seek_table++) {
+                header.block_checksum_type = (NARUBlockChecksumType)checksum_type;
+                header.has_seek_table = (uint8_t)use_seek_table;
+                NARUDecoderTest_EncodeWhiteNoise(&header, 0, header.num_samples, 12,
+                        input, data, sufficient_size, &output_size);
+
+                for (i = 0; i < sizeof(chunk_sizes) / sizeof(chunk_sizes[0]); i++) {
+                    output.num_samples = 0;
+                    ASSERT_EQ(NARU_APIRESULT_OK,
+                            NARUDecoder_BeginStreaming(decoder, block_data, block_data_size, NARUDecoderTest_WriteCallback, &output));
+                    for (progress = 0; progress < output_size; progress += chunk_sizes[i]) {
+                        ASSERT_EQ(NARU_APIRESULT_OK,
+                                NARUDecoder_PushData(decoder, &data[progress], NARUUTILITY_MIN(chunk_sizes[i], output_size - progress)));
+                        if (chunk_sizes[i] > (output_size - progress)) {
+                            break;
+                        }
+                    }
+                    EXPECT_EQ(NARU_APIRESULT_OK, NARUDecoder_GetStreamRequiredSize(decoder, &required_size));
+                    EXPECT_EQ(0U, required_size);
+                    EXPECT_EQ(NARU_APIRESULT_OK, NARUDecoder_FinishStreaming(decoder));
+                    EXPECT_EQ(header.num_samples, output.num_samples);
+                    for (ch = 0; ch < header.num_channels; ch++) {
+                        EXPECT_EQ(0, memcmp(input[ch], output.data[ch], sizeof(int32_t) * header.num_samples));
+                    }
+                }
+
+                /* 必要サイズずつ供給すると、ヘッダ以外は供給毎に1ブロックずつ出力される */
+                output.num_samples = 0;
+                output.num_callbacks = 0;
+                ASSERT_EQ(NARU_APIRESULT_OK,
+                        NARUDecoder_BeginStreaming(decoder, block_data, block_data_size, NARUDecoderTest_WriteCallback, &output));
+                progress = 0;
+                EXPECT_EQ(NARU_APIRESULT_OK, NARUDecoder_GetStreamRequiredSize(decoder, &required_size));
+                EXPECT_EQ((uint32_t)NARU_HEADER_SIZE, required_size);
+                while (required_size > 0) {
+                    const uint32_t prev_num_callbacks = output.num_callbacks;
+                    ASSERT_TRUE((progress + required_size) <= output_size);
+                    ASSERT_EQ(NARU_APIRESULT_OK, NARUDecoder_PushData(decoder, &data[progress], required_size));
+                    progress += required_size;
+                    ASSERT_EQ(NARU_APIRESULT_OK, NARUDecoder_GetStreamRequiredSize(decoder, &required_size));
+                    if (progress == NARU_HEADER_SIZE) {
+                        /* 次はブロックヘッダ */
+                        EXPECT_EQ(NARU_BLOCK_HEADER_SIZE_FOR_CHECKSUM(checksum_type), required_size);
+                    } else {
+                        EXPECT_EQ(prev_num_callbacks + 1, output.num_callbacks);
+                    }
+                    /* ブロックヘッダまで供給するとブロック全体の残りサイズが分かる */
+                    if (required_size > 0) {
+                        ASSERT_EQ(NARU_APIRESULT_OK, NARUDecoder_PushData(decoder, &data[progress], required_size));
+                        progress += required_size;
+                        ASSERT_EQ(NARU_APIRESULT_OK, NARUDecoder_GetStreamRequiredSize(decoder, &required_size));
+                        EXPECT_EQ(ByteArray_ReadUint32BE(&data[progress - NARU_BLOCK_HEADER_SIZE_FOR_CHECKSUM(checksum_type) + 2]) + 6,
+                                required_size + NARU_BLOCK_HEADER_SIZE_FOR_CHECKSUM(checksum_type));
+                    }
+                }
+                EXPECT_EQ(NARU_APIRESULT_OK, NARUDecoder_FinishStreaming(decoder));
+                EXPECT_EQ(header.num_samples, output.num_samples);
+                /* シークテーブルは読まずに終わる */
+                if (use_seek_table == 0) {
+                    EXPECT_EQ(output_size, progress);
+                } else {
+                    EXPECT_GT(output_size, progress);
+                }
+            }
+        }
+
+        NARUDecoder_Destroy(decoder);
+        NARUDecoderTest_FreeSignal(output.data, header.num_channels);
+        NARUDecoderTest_FreeSignal(input, header.num_channels);
+        free(block_data);
+        free(data);
+    }
+
+    /* 総サンプル数が未確定のストリーミングエンコード出力のデコード */
+    {
+#define NUM_SAMPLES 5000
+        struct NARUEncoder *encoder;
+        struct NARUDecoder *decoder;
+        struct NARUEncoderConfig encoder_config;
+        struct NARUDecoderConfig decoder_config;
+        struct NARUEncodeParameter parameter;
+        struct NARUHeader header;
+        struct NARUDecoderTestStreamOutput output;
+        struct NARUDecoderTestEncodedOutput encoded;
+        uint8_t *block_data;
+        int32_t *input[1];
+        uint32_t smpl, progress, block_data_size, use_seek_table, required_size;
+
+        NARU_SetValidHeader(&header);
+        header.num_channels = 1;
+        header.num_samples = NUM_SAMPLES;
+        NARUEncoder_SetValidConfig(&encoder_config);
+        NARUDecoder_SetValidConfig(&decoder_config);
+
+        block_data_size = NARUENCODER_CALCULATE_MAX_BLOCK_SIZE(header.num_channels, header.max_num_samples_per_block);
+        block_data = (uint8_t *)malloc(block_data_size);
+        encoded.capacity = NARU_HEADER_SIZE + 4 * NUM_SAMPLES * sizeof(int32_t);
+        encoded.data = (uint8_t *)malloc(encoded.capacity);
+        input[0] = (int32_t *)malloc(sizeof(int32_t) * NUM_SAMPLES);
+        output.data[0] = (int32_t *)malloc(sizeof(int32_t) * NUM_SAMPLES);
+        output.capacity = NUM_SAMPLES;
+        for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+            input[0][smpl] = (int32_t)(smpl % 64) - 32;
+        }
+
+        decoder = NARUDecoder_Create(&decoder_config, NULL, 0);
+        ASSERT_TRUE(decoder != NULL);
+
+        for (use_seek_table = 0; use_seek_table <= 1; use_seek_table++) {
+            /* ヘッダを書き換えずにストリーミングエンコードの出力をそのまま使う */
+            header.has_seek_table = (uint8_t)use_seek_table;
+            encoded.size = 0;
+            encoder = NARUEncoder_Create(&encoder_config, NULL, 0);
+            ASSERT_TRUE(encoder != NULL);
+            NARUEncoder_ConvertHeaderToParameter(&header, &parameter);
+            ASSERT_EQ(NARU_APIRESULT_OK, NARUEncoder_SetEncodeParameter(encoder, &parameter));
+            ASSERT_EQ(NARU_APIRESULT_OK,
+                    NARUEncoder_BeginStreaming(encoder, block_data, block_data_size, NARUDecoderTest_WriteEncodedCallback, &encoded));
+            ASSERT_EQ(NARU_APIRESULT_OK, NARUEncoder_PushSamples(encoder, input, NUM_SAMPLES));
+            ASSERT_EQ(NARU_APIRESULT_OK, NARUEncoder_FinishStreaming(encoder, block_data, NARU_HEADER_SIZE));
+            NARUEncoder_Destroy(encoder);
+
+            output.num_samples = 0;
+            ASSERT_EQ(NARU_APIRESULT_OK,
+                    NARUDecoder_BeginStreaming(decoder, block_data, block_data_size, NARUDecoderTest_WriteCallback, &output));
+            for (progress = 0; progress < encoded.size; progress += 100) {
+                ASSERT_EQ(NARU_APIRESULT_OK,
+                        NARUDecoder_PushData(decoder, &encoded.data[progress], NARUUTILITY_MIN(100, encoded.size - progress)));
+            }
+            /* シークテーブルがあればそこで終わりと分かる */
+            EXPECT_EQ(NARU_APIRESULT_OK, NARUDecoder_GetStreamRequiredSize(decoder, &required_size));
+            if (use_seek_table == 0) {
+                EXPECT_LT(0U, required_size);
+            } else {
+                EXPECT_EQ(0U, required_size);
+            }
+            EXPECT_EQ(NARU_APIRESULT_OK, NARUDecoder_FinishStreaming(decoder));
+            EXPECT_EQ((uint32_t)NUM_SAMPLES, output.num_samples);
+            EXPECT_EQ(0, memcmp(input[0], output.data[0], sizeof(int32_t) * NUM_SAMPLES));
+        }
+
+        NARUDecoder_Destroy(decoder);
+        free(output.data[0]);
+        free(input[0]);
+        free(encoded.data);
+        free(block_data);
+#undef NUM_SAMPLES
+    }
+
+    /* 失敗ケース */
+    {
+        struct NARUDecoder *decoder;
+        struct NARUDecoderConfig decoder_config;
+        struct NARUHeader header;
+        struct NARUDecoderTestStreamOutput output;
+        uint8_t *data, *block_data;
+        int32_t *input[1];
+        uint32_t progress, sufficient_size, output_size, block_data_size, required_size;
+
+        NARU_SetValidHeader(&header);
+        header.num_channels = 1;
+        header.num_samples = 1000;
+        NARUDecoder_SetValidConfig(&decoder_config);
+
+        sufficient_size = NARUDecoderTest_CalculateSufficientSize(&header, header.num_samples);
+        data = (uint8_t *)malloc(sufficient_size);
+        block_data_size = NARUENCODER_CALCULATE_MAX_BLOCK_SIZE(header.num_channels, header.max_num_samples_per_block);
+        block_data = (uint8_t *)malloc(block_data_size);
+        input[0] = (int32_t *)malloc(sizeof(int32_t) * header.num_samples);
+        output.data[0] = (int32_t *)malloc(sizeof(int32_t) * header.num_samples);
+        output.capacity = header.num_samples;
+        NARUDecoderTest_EncodeWhiteNoise(&header, 0, header.num_samples, 12,
+                input, data, sufficient_size, &output_size);
+
+        decoder = NARUDecoder_Create(&decoder_config, NULL, 0);
+        ASSERT_TRUE(decoder != NULL);
+
+        /* ストリーミング開始前 */
+        EXPECT_EQ(NARU_APIRESULT_PARAMETER_NOT_SET, NARUDecoder_PushData(decoder, data, output_size));
+        EXPECT_EQ(NARU_APIRESULT_PARAMETER_NOT_SET, NARUDecoder_GetStreamRequiredSize(decoder, &required_size));
+        EXPECT_EQ(NARU_APIRESULT_PARAMETER_NOT_SET, NARUDecoder_FinishStreaming(decoder));
+
+        /* 不正な引数 */
+        EXPECT_EQ(NARU_APIRESULT_INVALID_ARGUMENT,
+                NARUDecoder_BeginStreaming(NULL, block_data, block_data_size, NARUDecoderTest_WriteCallback, &output));
+        EXPECT_EQ(NARU_APIRESULT_INVALID_ARGUMENT,
+                NARUDecoder_BeginStreaming(decoder, NULL, block_data_size, NARUDecoderTest_WriteCallback, &output));
+        EXPECT_EQ(NARU_APIRESULT_INVALID_ARGUMENT,
+                NARUDecoder_BeginStreaming(decoder, block_data, block_data_size, NULL, &output));
+        EXPECT_EQ(NARU_APIRESULT_INSUFFICIENT_BUFFER,
+                NARUDecoder_BeginStreaming(decoder, block_data, NARU_HEADER_SIZE - 1, NARUDecoderTest_WriteCallback, &output));
+        ASSERT_EQ(NARU_APIRESULT_OK,
+                NARUDecoder_BeginStreaming(decoder, block_data, block_data_size, NARUDecoderTest_WriteCallback, &output));
+        EXPECT_EQ(NARU_APIRESULT_INVALID_ARGUMENT, NARUDecoder_PushData(NULL, data, output_size));
+        EXPECT_EQ(NARU_APIRESULT_INVALID_ARGUMENT, NARUDecoder_PushData(decoder, NULL, output_size));
+        EXPECT_EQ(NARU_APIRESULT_OK, NARUDecoder_PushData(decoder, NULL, 0));
+        EXPECT_EQ(NARU_APIRESULT_INVALID_ARGUMENT, NARUDecoder_GetStreamRequiredSize(NULL, &required_size));
+        EXPECT_EQ(NARU_APIRESULT_INVALID_ARGUMENT, NARUDecoder_GetStreamRequiredSize(decoder, NULL));
+        EXPECT_EQ(NARU_APIRESULT_INVALID_ARGUMENT, NARUDecoder_FinishStreaming(NULL));
+
+        /* ヘッダの途中・ブロックの途中・ブロックの区切りで途切れる */
+        EXPECT_EQ(NARU_APIRESULT_INSUFFICIENT_DATA, NARUDecoder_FinishStreaming(decoder));
+        output.num_samples = 0;
+        ASSERT_EQ(NARU_APIRESULT_OK,
+                NARUDecoder_BeginStreaming(decoder, block_data, block_data_size, NARUDecoderTest_WriteCallback, &output));
+        EXPECT_EQ(NARU_APIRESULT_OK, NARUDecoder_PushData(decoder, data, output_size - 1));
+        EXPECT_EQ(NARU_APIRESULT_OK, NARUDecoder_GetStreamRequiredSize(decoder, &required_size));
+        EXPECT_EQ(1U, required_size);
+        EXPECT_EQ(NARU_APIRESULT_INSUFFICIENT_DATA, NARUDecoder_FinishStreaming(decoder));
+        output.num_samples = 0;
+        ASSERT_EQ(NARU_APIRESULT_OK,
+                NARUDecoder_BeginStreaming(decoder, block_data, block_data_size, NARUDecoderTest_WriteCallback, &output));
+        progress = NARU_HEADER_SIZE + ByteArray_ReadUint32BE(&data[NARU_HEADER_SIZE + 2]) + 6;
+        EXPECT_EQ(NARU_APIRESULT_OK, NARUDecoder_PushData(decoder, data, progress));
+        EXPECT_EQ(header.max_num_samples_per_block, output.num_samples);
+        EXPECT_EQ(NARU_APIRESULT_INSUFFICIENT_DATA, NARUDecoder_FinishStreaming(decoder));
+
+        /* ブロックの破損 */
+        output.num_samples = 0;
+        data[output_size / 2] ^= 0x01;
+        ASSERT_EQ(NARU_APIRESULT_OK,
+                NARUDecoder_BeginStreaming(decoder, block_data, block_data_size, NARUDecoderTest_WriteCallback, &output));
+        EXPECT_EQ(NARU_APIRESULT_DETECT_DATA_CORRUPTION, NARUDecoder_PushData(decoder, data, output_size));
+        data[output_size / 2] ^= 0x01;
+
+        /* コールバックの結果が返る */
+        output.num_samples = 0;
+        output.capacity = header.num_samples - 1;
+        ASSERT_EQ(NARU_APIRESULT_OK,
+                NARUDecoder_BeginStreaming(decoder, block_data, block_data_size, NARUDecoderTest_WriteCallback, &output));
+        EXPECT_EQ(NARU_APIRESULT_INSUFFICIENT_BUFFER, NARUDecoder_PushData(decoder, data, output_size));
+        output.capacity = header.num_samples;
+
+        /* 溜められないブロックは供給の区切りに依らず失敗 */
+        output.num_samples = 0;
+        ASSERT_EQ(NARU_APIRESULT_OK,
+                NARUDecoder_BeginStreaming(decoder, block_data, NARU_HEADER_SIZE + 16, NARUDecoderTest_WriteCallback, &output));
+        EXPECT_EQ(NARU_APIRESULT_INSUFFICIENT_BUFFER, NARUDecoder_PushData(decoder, data, output_size));
+        output.num_samples = 0;
+        ASSERT_EQ(NARU_APIRESULT_OK,
+                NARUDecoder_BeginStreaming(decoder, block_data, NARU_HEADER_SIZE + 16, NARUDecoderTest_WriteCallback, &output));
+        EXPECT_EQ(NARU_APIRESULT_OK, NARUDecoder_PushData(decoder, data, NARU_HEADER_SIZE + 1));
+        EXPECT_EQ(NARU_APIRESULT_INSUFFICIENT_BUFFER, NARUDecoder_PushData(decoder, &data[NARU_HEADER_SIZE + 1], 15));
+        NARUDecoder_Destroy(decoder);
+
+        /* ブロックバッファに1ブロックが収まらない */
+        decoder_config.max_num_samples_per_block = header.max_num_samples_per_block - 1;
+        decoder = NARUDecoder_Create(&decoder_config, NULL, 0);
+        ASSERT_TRUE(decoder != NULL);
+        ASSERT_EQ(NARU_APIRESULT_OK,
+                NARUDecoder_BeginStreaming(decoder, block_data, block_data_size, NARUDecoderTest_WriteCallback, &output));
+        EXPECT_EQ(NARU_APIRESULT_INSUFFICIENT_BUFFER, NARUDecoder_PushData(decoder, data, output_size));
+        NARUDecoder_Destroy(decoder);
+
+        free(output.data[0]);
+        free(input[0]);
+        free(block_data);
+        free(data);
+    }
+}
@@ -223,9 +223,15 @@ static int32_t NARUEncodeDecodeTest_ExecuteTestCase(const struct EncodeDecodeTes
     encoder_config.max_num_channels           = num_channels;
     encoder_config.max_num_samples_per_block  = test_case->encode_parameter.num_samples_per_block;
     encoder_config.max_filter_order           = NARUUTILITY_MAX(test_case->encode_parameter.filter_order, test_case->encode_parameter.second_filter_order);
+    encoder_config.max_num_threads            = NARUUTILITY_MAX(1, test_case->encode_parameter.num_threads);
+    encoder_config.enable_streaming           = 0;
+    encoder_config.enable_rans                = test_case->encode_parameter.use_rans;
+    encoder_config.enable_seek_table          = test_case->encode_parameter.use_seek_table;
     decoder_config.max_num_channels           = num_channels;
     decoder_config.max_filter_order           = NARUUTILITY_MAX(test_case->encode_parameter.filter_order, test_case->encode_parameter.second_filter_order);
     decoder_config.check_crc                  = 1;
+    decoder_config.max_num_threads            = NARUUTILITY_MAX(1, test_case->encode_parameter.num_threads);
+    decoder_config.max_num_samples_per_block  = test_case->encode_parameter.num_samples_per_block;
 
     /* 一時領域の割り当て */
     input_double  = (double **)malloc(sizeof(double*) * num_channels);
@@ -286,6 +292,27 @@ static int32_t NARUEncodeDecodeTest_ExecuteTestCase(const struct EncodeDecodeTes
         }
     }
 
+    /* 範囲デコードして一致確認 */
+    {
+        const uint32_t start_sample = num_samples / 3;
+        const uint32_t end_sample = num_samples - num_samples / 5;
+        if ((api_ret = NARUDecoder_DecodeRange(decoder, data, output_size,
+                        start_sample, end_sample, output, num_channels, num_samples)) != NARU_APIRESULT_OK) {
+            fprintf(stderr, "Range decode failed! ret:%d \n", api_ret);
+            ret = 6;
+            goto EXIT;
+        }
+        for (ch = 0; ch < num_channels; ch++) {
+            for (smpl = 0; smpl < (end_sample - start_sample); smpl++) {
+                if (input[ch][start_sample + smpl] != output[ch][smpl]) {
+                    printf("%5d %12d vs %12d \n", start_sample + smpl, input[ch][start_sample + smpl], output[ch][smpl]);
+                    ret = 7;
+                    goto EXIT;
+                }
+            }
+        }
+    }
+
     /* ここまで来れば成功 */
     ret = 0;
 
@@ -692,6 +719,32 @@ TEST(NARUEncodeDecodeTest, EncodeDecodeCheckTest)
         { { 8,  8, 8000, 1024, NARU_MAX_FILTER_ORDER, 1, NARU_MAX_FILTER_ORDER, NARU_CH_PROCESS_METHOD_MS, 2 }, 0, 8192, NARUEncodeDecodeTest_GenerateGaussNoise },
         { { 8, 16, 8000, 1024, NARU_MAX_FILTER_ORDER, 1, NARU_MAX_FILTER_ORDER, NARU_CH_PROCESS_METHOD_MS, 2 }, 0, 8192, NARUEncodeDecodeTest_GenerateGaussNoise },
         // { { 8, 24, 8000, 1024, NARU_MAX_FILTER_ORDER, 1, NARU_MAX_FILTER_ORDER, NARU_CH_PROCESS_METHOD_MS, 2 }, 0, 8192, NARUEncodeDecodeTest_GenerateGaussNoise },
+
+        /* ブロック独立（並列）エンコードの部 */
+        { { 1, 16, 8000, 1024,  8, 1,  4, NARU_CH_PROCESS_METHOD_NONE, 2, 1, 1024 }, 0, 8192, NARUEncodeDecodeTest_GenerateSinWave },
+        { { 2, 16, 8000, 1024,  8, 2,  8, NARU_CH_PROCESS_METHOD_MS, 2, 2, 1024 }, 0, 8192, NARUEncodeDecodeTest_GenerateChirp },
+        { { 2, 16, 8000, 1024, 16, 1,  8, NARU_CH_PROCESS_METHOD_MS, 2, 4,  500 }, 0, 8192 + 100, NARUEncodeDecodeTest_GenerateGaussNoise },
+        { { 8, 16, 8000, 1024, NARU_MAX_FILTER_ORDER, 1, NARU_MAX_FILTER_ORDER, NARU_CH_PROCESS_METHOD_MS, 3, 3, 3000 }, 0, 8192, NARUEncodeDecodeTest_GenerateWhiteNoise },
+
+        /* rANS符号の部 */
+        { { 1,  8, 8000, 1024,  4, 1,  4, NARU_CH_PROCESS_METHOD_NONE, 2, 1,    0, 1 }, 0, 8192, NARUEncodeDecodeTest_GenerateSinWave },
+        { { 2, 16, 8000, 1024,  8, 2,  8, NARU_CH_PROCESS_METHOD_MS, 2, 1,    0, 1 }, 0, 8192, NARUEncodeDecodeTest_GenerateSinWave },
+        { { 2, 16, 8000, 1024,  8, 2,  8, NARU_CH_PROCESS_METHOD_MS, 2, 1,    0, 1 }, 0, 8192, NARUEncodeDecodeTest_GenerateChirp },
+        { { 8, 16, 8000, 1024, 16, 1,  8, NARU_CH_PROCESS_METHOD_MS, 2, 1,    0, 1 }, 0, 8192 + 100, NARUEncodeDecodeTest_GenerateGaussNoise },
+        { { 2, 16, 8000, 1024,  8, 1,  4, NARU_CH_PROCESS_METHOD_MS, 2, 1,    0, 1 }, 0, 8192, NARUEncodeDecodeTest_GenerateWhiteNoise },
+        { { 2, 16, 8000, 1024,  8, 1,  4, NARU_CH_PROCESS_METHOD_MS, 2, 1,    0, 1 }, 0, 8192, NARUEncodeDecodeTest_GenerateNyquistOsc },
+        { { 2, 16, 8000, 1024, 16, 1,  8, NARU_CH_PROCESS_METHOD_MS, 2, 2, 1024, 1 }, 0, 8192, NARUEncodeDecodeTest_GenerateGaussNoise },
+
+        /* CRC32Cチェックサムの部 */
+        { { 1, 16, 8000, 1024,  8, 1,  4, NARU_CH_PROCESS_METHOD_NONE, 2, 1,    0, 0, NARU_BLOCK_CHECKSUM_TYPE_CRC32C }, 0, 8192, NARUEncodeDecodeTest_GenerateSilence },
+        { { 2, 16, 8000, 1024,  8, 2,  8, NARU_CH_PROCESS_METHOD_MS, 2, 1,    0, 0, NARU_BLOCK_CHECKSUM_TYPE_CRC32C }, 0, 8192 + 100, NARUEncodeDecodeTest_GenerateChirp },
+        { { 2, 16, 8000, 1024,  8, 1,  4, NARU_CH_PROCESS_METHOD_MS, 2, 1,    0, 0, NARU_BLOCK_CHECKSUM_TYPE_CRC32C }, 0, 8192, NARUEncodeDecodeTest_GenerateWhiteNoise },
+        { { 2, 16, 8000, 1024, 16, 1,  8, NARU_CH_PROCESS_METHOD_MS, 2, 2, 1024, 1, NARU_BLOCK_CHECKSUM_TYPE_CRC32C }, 0, 8192, NARUEncodeDecodeTest_GenerateGaussNoise },
+
+        /* シークテーブルの部 */
+        { { 1, 16, 8000, 1024,  8, 1,  4, NARU_CH_PROCESS_METHOD_NONE, 2, 1,    0, 0, NARU_BLOCK_CHECKSUM_TYPE_CRC16, 1 }, 0, 8192, NARUEncodeDecodeTest_GenerateSilence },
+        { { 2, 16, 8000, 1024,  8, 2,  8, NARU_CH_PROCESS_METHOD_MS, 2, 1,    0, 0, NARU_BLOCK_CHECKSUM_TYPE_CRC16, 1 }, 0, 8192 + 100, NARUEncodeDecodeTest_GenerateChirp },
+        { { 2, 16, 8000, 1024, 16, 1,  8, NARU_CH_PROCESS_METHOD_MS, 2, 2, 1024, 1, NARU_BLOCK_CHECKSUM_TYPE_CRC32C, 1 }, 0, 8192 + 100, NARUEncodeDecodeTest_GenerateGaussNoise },
     };
 
     /* テストケース数 */
@@ -23,6 +23,8 @@ extern "C" {
         header__p->ar_order                   = 1;\
         header__p->second_filter_order        = 4;\
         header__p->ch_process_method          = NARU_CH_PROCESS_METHOD_NONE;\
+        header__p->block_checksum_type        = NARU_BLOCK_CHECKSUM_TYPE_CRC16;\
+        header__p->has_seek_table             = 0;\
     } while (0);
 
 /* 有効なエンコードパラメータをセット */
@@ -38,6 +40,11 @@ extern "C" {
         param__p->second_filter_order   = 4;\
         param__p->ch_process_method     = NARU_CH_PROCESS_METHOD_NONE;\
         param__p->num_encode_trials     = 1;\
+        param__p->num_threads           = 1;\
+        param__p->num_preroll_samples   = 0;\
+        param__p->use_rans              = 0;\
+        param__p->block_checksum_type   = NARU_BLOCK_CHECKSUM_TYPE_CRC16;\
+        param__p->use_seek_table        = 0;\
     } while (0);
 
 /* 有効なコンフィグをセット */
@@ -47,6 +54,10 @@ extern "C" {
         config__p->max_num_channels           = 8;\
         config__p->max_num_samples_per_block  = 8192;\
         config__p->max_filter_order           = 32;\
+        config__p->max_num_threads            = 1;\
+        config__p->enable_streaming           = 1;\
+        config__p->enable_rans                = 1;\
+        config__p->enable_seek_table          = 1;\
     } while (0);
 
 /* ヘッダエンコードテスト */
@@ -92,6 +103,21 @@ TEST(NARUEncoderTest, EncodeHeaderTest)
         header.num_samples = 0;
         EXPECT_EQ(NARU_APIRESULT_INVALID_FORMAT, NARUEncoder_EncodeHeader(&header, data, sizeof(data)));
 
+        /* ブロックヘッダに記録できないブロックあたりサンプル数 */
+        NARU_SetValidHeader(&header);
+        header.max_num_samples_per_block = 0x10000;
+        EXPECT_EQ(NARU_APIRESULT_INVALID_FORMAT, NARUEncoder_EncodeHeader(&header, data, sizeof(data)));
+
+        /* 異常なブロックのチェックサム種別 */
+        NARU_SetValidHeader(&header);
+        header.block_checksum_type = NARU_BLOCK_CHECKSUM_TYPE_INVALID;
+        EXPECT_EQ(NARU_APIRESULT_INVALID_FORMAT, NARUEncoder_EncodeHeader(&header, data, sizeof(data)));
+
+        /* 異常なシークテーブルの有無 */
+        NARU_SetValidHeader(&header);
+        header.has_seek_table = 2;
+        EXPECT_EQ(NARU_APIRESULT_INVALID_FORMAT, NARUEncoder_EncodeHeader(&header, data, sizeof(data)));
+
         /* 異常なサンプリングレート */
         NARU_SetValidHeader(&header);
         header.sampling_rate = 0;
@@ -167,6 +193,36 @@ TEST(NARUEncoderTest, CreateDestroyHandleTest)
         NARUEncoder_SetValidConfig(&config);
         config.max_filter_order = 3;
         EXPECT_TRUE(NARUEncoder_CalculateWorkSize(&config) < 0);
+
+        /* スレッド数0は単一スレッドとして扱う */
+        NARUEncoder_SetValidConfig(&config);
+        work_size = NARUEncoder_CalculateWorkSize(&config);
+        config.max_num_threads = 0;
+        EXPECT_EQ(work_size, NARUEncoder_CalculateWorkSize(&config));
+
+        /* スレッド数を増やすとワーカー分だけ大きくなる */
+        NARUEncoder_SetValidConfig(&config);
+        work_size = NARUEncoder_CalculateWorkSize(&config);
+        config.max_num_threads = 4;
+        EXPECT_TRUE(NARUEncoder_CalculateWorkSize(&config) > work_size);
+
+        /* ストリーミングを使わなければ入力バッファ分だけ小さくなる */
+        NARUEncoder_SetValidConfig(&config);
+        work_size = NARUEncoder_CalculateWorkSize(&config);
+        config.enable_streaming = 0;
+        EXPECT_TRUE(NARUEncoder_CalculateWorkSize(&config) < work_size);
+
+        /* rANS符号を使わなければ作業領域分だけ小さくなる */
+        NARUEncoder_SetValidConfig(&config);
+        work_size = NARUEncoder_CalculateWorkSize(&config);
+        config.enable_rans = 0;
+        EXPECT_TRUE(NARUEncoder_CalculateWorkSize(&config) < work_size);
+
+        /* シークテーブルを使わなければ作成先の分だけ小さくなる */
+        NARUEncoder_SetValidConfig(&config);
+        work_size = NARUEncoder_CalculateWorkSize(&config);
+        config.enable_seek_table = 0;
+        EXPECT_TRUE(NARUEncoder_CalculateWorkSize(&config) < work_size);
     }
 
     /* ワーク領域渡しによるハンドル作成（成功例） */
@@ -188,7 +244,7 @@ TEST(NARUEncoderTest, CreateDestroyHandleTest)
         EXPECT_TRUE(encoder->lpcc != NULL);
         EXPECT_TRUE(encoder->processor != NULL);
         EXPECT_TRUE(encoder->coder != NULL);
-        EXPECT_TRUE(encoder->window != NULL);
+        EXPECT_TRUE(encoder->window[0] != NULL);
         EXPECT_TRUE(encoder->buffer != NULL);
         EXPECT_TRUE(encoder->buffer[0] != NULL);
         EXPECT_TRUE(encoder->buffer_double != NULL);
@@ -212,7 +268,7 @@ TEST(NARUEncoderTest, CreateDestroyHandleTest)
         EXPECT_TRUE(encoder->lpcc != NULL);
         EXPECT_TRUE(encoder->processor != NULL);
         EXPECT_TRUE(encoder->coder != NULL);
-        EXPECT_TRUE(encoder->window != NULL);
+        EXPECT_TRUE(encoder->window[0] != NULL);
         EXPECT_TRUE(encoder->buffer != NULL);
         EXPECT_TRUE(encoder->buffer[0] != NULL);
         EXPECT_TRUE(encoder->buffer_double != NULL);
@@ -300,10 +356,130 @@ TEST(NARUEncoderTest, CreateDestroyHandleTest)
         config.max_filter_order = 3;
         encoder = NARUEncoder_Create(&config, NULL, 0);
         EXPECT_TRUE(encoder == NULL);
+
+    }
+
+    /* スレッド数0は単一スレッドとして作成できる */
+    {
+        int32_t work_size;
+        void *work;
+        struct NARUEncoder *encoder;
+        struct NARUEncoderConfig config;
+        struct NARUEncodeParameter parameter;
+        int32_t samples[256] = { 0, };
+        const int32_t *input[1] = { samples };
+        uint8_t data[2048];
+        uint32_t output_size;
+
+        NARUEncoder_SetValidConfig(&config);
+        NARUEncoder_SetValidEncodeParameter(&parameter);
+        parameter.num_channels = 1;
+        config.max_num_threads = 0;
+
+        work_size = NARUEncoder_CalculateWorkSize(&config);
+        work = malloc((size_t)work_size);
+        encoder = NARUEncoder_Create(&config, work, work_size);
+        ASSERT_TRUE(encoder != NULL);
+        EXPECT_EQ(NARU_APIRESULT_OK, NARUEncoder_SetEncodeParameter(encoder, &parameter));
+        EXPECT_EQ(NARU_APIRESULT_OK, NARUEncoder_EncodeWhole(encoder, input, 256, data, sizeof(data), &output_size));
+        NARUEncoder_Destroy(encoder);
+        free(work);
+
+        encoder = NARUEncoder_Create(&config, NULL, 0);
+        ASSERT_TRUE(encoder != NULL);
+        EXPECT_EQ(NARU_APIRESULT_OK, NARUEncoder_SetEncodeParameter(encoder, &parameter));
+        EXPECT_EQ(NARU_APIRESULT_OK, NARUEncoder_EncodeWhole(encoder, input, 256, data, sizeof(data), &output_size));
+        NARUEncoder_Destroy(encoder);
+    }
+
+    /* rANS符号の作業領域を確保していないハンドルでrANS符号を指定 */
+    {
+        struct NARUEncoder *encoder;
+        struct NARUEncoderConfig config;
+        struct NARUEncodeParameter parameter;
+
+        NARUEncoder_SetValidConfig(&config);
+        config.enable_rans = 0;
+        encoder = NARUEncoder_Create(&config, NULL, 0);
+        ASSERT_TRUE(encoder != NULL);
+
+        NARUEncoder_SetValidEncodeParameter(&parameter);
+        parameter.use_rans = 1;
+        EXPECT_EQ(NARU_APIRESULT_INSUFFICIENT_BUFFER, NARUEncoder_SetEncodeParameter(encoder, &parameter));
+        parameter.use_rans = 0;
+        EXPECT_EQ(NARU_APIRESULT_OK, NARUEncoder_SetEncodeParameter(encoder, &parameter));
+
+        NARUEncoder_Destroy(encoder);
+    }
+
+    /* シークテーブルの作成先を確保していないハンドルでシークテーブルを指定 */
+    {
+        struct NARUEncoder *encoder;
+        struct NARUEncoderConfig config;
+        struct NARUEncodeParameter parameter;
+
+        NARUEncoder_SetValidConfig(&config);
+        config.enable_seek_table = 0;
+        encoder = NARUEncoder_Create(&config, NULL, 0);
+        ASSERT_TRUE(encoder != NULL);
+
+        NARUEncoder_SetValidEncodeParameter(&parameter);
+        parameter.use_seek_table = 1;
+        EXPECT_EQ(NARU_APIRESULT_INSUFFICIENT_BUFFER, NARUEncoder_SetEncodeParameter(encoder, &parameter));
+        parameter.use_seek_table = 0;
+        EXPECT_EQ(NARU_APIRESULT_OK, NARUEncoder_SetEncodeParameter(encoder, &parameter));
+
+        NARUEncoder_Destroy(encoder);
     }
 }
 
 /* 1ブロックエンコードテスト */
+/* 窓キャッシュテスト */
+TEST(NARUEncoderTest, WindowCacheTest)
+{
+    struct NARUEncoder *encoder;
+    struct NARUEncoderConfig config;
+    const double *window1, *window2;
+    double *reference;
+    uint32_t smpl, size1, size2;
+
+    NARUEncoder_SetValidConfig(&config);
+    encoder = NARUEncoder_Create(&config, NULL, 0);
+    ASSERT_TRUE(encoder != NULL);
+
+    size1 = config.max_num_samples_per_block;
+    size2 = config.max_num_samples_per_block / 3;
+    reference = (double *)malloc(sizeof(double) * config.max_num_samples_per_block);
+
+    /* 作成した窓は通常の窓と一致 */
+    window1 = NARUEncoder_GetWindow(encoder, size1);
+    NARUUtility_MakeSinWindow(reference, size1);
+    for (smpl = 0; smpl < size1; smpl++) {
+        EXPECT_EQ(reference[smpl], window1[smpl]);
+    }
+
+    /* 2つの長さを交互に使っても作り直さない */
+    window2 = NARUEncoder_GetWindow(encoder, size2);
+    EXPECT_TRUE(window1 != window2);
+    NARUUtility_MakeSinWindow(reference, size2);
+    for (smpl = 0; smpl < size2; smpl++) {
+        EXPECT_EQ(reference[smpl], window2[smpl]);
+    }
+    EXPECT_EQ(window1, NARUEncoder_GetWindow(encoder, size1));
+    EXPECT_EQ(window2, NARUEncoder_GetWindow(encoder, size2));
+
+    /* 新しい長さは最後に使った窓以外を置き換える */
+    EXPECT_EQ(window1, NARUEncoder_GetWindow(encoder, size2 + 1));
+    EXPECT_EQ(window2, NARUEncoder_GetWindow(encoder, size2));
+    NARUUtility_MakeSinWindow(reference, size2 + 1);
+    for (smpl = 0; smpl < size2 + 1; smpl++) {
+        EXPECT_EQ(reference[smpl], window1[smpl]);
+    }
+
+    free(reference);
+    NARUEncoder_Destroy(encoder);
+}
+
 TEST(NARUEncoderTest, EncodeBlockTest)
 {
     /* 無効な引数 */
@@ -311,6 +487,7 @@ TEST(NARUEncoderTest, EncodeBlockTest)
         struct NARUEncoder *encoder;
         struct NARUEncoderConfig config;
         struct NARUEncodeParameter parameter;
+        struct NARUBlockAnalysis analysis;
         int32_t *input[NARU_MAX_NUM_CHANNELS];
         uint8_t *data;
         uint32_t ch, sufficient_size, output_size, num_samples;
@@ -331,31 +508,44 @@ TEST(NARUEncoderTest, EncodeBlockTest)
         encoder = NARUEncoder_Create(&config, NULL, 0);
         ASSERT_TRUE(encoder != NULL);
 
+        /* データタイプは圧縮データとする */
+        memset(&analysis, 0, sizeof(analysis));
+        analysis.block_type = NARU_BLOCK_DATA_TYPE_COMPRESSDATA;
+
         /* 無効な引数を渡す */
         EXPECT_EQ(
                 NARU_APIRESULT_INVALID_ARGUMENT,
-                NARUEncoder_EncodeBlock(NULL, input, parameter.num_samples_per_block,
+                NARUEncoder_EncodeBlock(NULL, &analysis, input, parameter.num_samples_per_block,
                     data, sufficient_size, &output_size));
         EXPECT_EQ(
                 NARU_APIRESULT_INVALID_ARGUMENT,
-                NARUEncoder_EncodeBlock(encoder, NULL, parameter.num_samples_per_block,
+                NARUEncoder_EncodeBlock(encoder, &analysis, NULL, parameter.num_samples_per_block,
                     data, sufficient_size, &output_size));
         EXPECT_EQ(
                 NARU_APIRESULT_INVALID_ARGUMENT,
-                NARUEncoder_EncodeBlock(encoder, input, 0,
+                NARUEncoder_EncodeBlock(encoder, &analysis, input, 0,
                     data, sufficient_size, &output_size));
         EXPECT_EQ(
                 NARU_APIRESULT_INVALID_ARGUMENT,
-                NARUEncoder_EncodeBlock(encoder, input, parameter.num_samples_per_block,
+                NARUEncoder_EncodeBlock(encoder, &analysis, input, parameter.num_samples_per_block,
                     NULL, sufficient_size, &output_size));
         EXPECT_EQ(
                 NARU_APIRESULT_INVALID_ARGUMENT,
-                NARUEncoder_EncodeBlock(encoder, input, parameter.num_samples_per_block,
+                NARUEncoder_EncodeBlock(encoder, &analysis, input, parameter.num_samples_per_block,
                     data, 0, &output_size));
         EXPECT_EQ(
                 NARU_APIRESULT_INVALID_ARGUMENT,
-                NARUEncoder_EncodeBlock(encoder, input, parameter.num_samples_per_block,
+                NARUEncoder_EncodeBlock(encoder, &analysis, input, parameter.num_samples_per_block,
                     data, sufficient_size, NULL));
+        EXPECT_EQ(
+                NARU_APIRESULT_INVALID_ARGUMENT,
+                NARUEncoder_EncodeBlock(encoder, NULL, input, parameter.num_samples_per_block,
+                    data, sufficient_size, &output_size));
+        analysis.block_type = NARU_BLOCK_DATA_TYPE_INVALID;
+        EXPECT_EQ(
+                NARU_APIRESULT_INVALID_ARGUMENT,
+                NARUEncoder_EncodeBlock(encoder, &analysis, input, parameter.num_samples_per_block,
+                    data, sufficient_size, &output_size));
 
         /* 領域の開放 */
         for (ch = 0; ch < parameter.num_channels; ch++) {
@@ -370,6 +560,7 @@ TEST(NARUEncoderTest, EncodeBlockTest)
         struct NARUEncoder *encoder;
         struct NARUEncoderConfig config;
         struct NARUEncodeParameter parameter;
+        struct NARUBlockAnalysis analysis;
         int32_t *input[NARU_MAX_NUM_CHANNELS];
         uint8_t *data;
         uint32_t ch, sufficient_size, output_size, num_samples;
@@ -393,9 +584,11 @@ TEST(NARUEncoderTest, EncodeBlockTest)
         ASSERT_TRUE(encoder != NULL);
 
         /* パラメータセット前にエンコード: エラー */
+        memset(&analysis, 0, sizeof(analysis));
+        analysis.block_type = NARU_BLOCK_DATA_TYPE_COMPRESSDATA;
         EXPECT_EQ(
                 NARU_APIRESULT_PARAMETER_NOT_SET,
-                NARUEncoder_EncodeBlock(encoder, input, parameter.num_samples_per_block,
+                NARUEncoder_EncodeBlock(encoder, &analysis, input, parameter.num_samples_per_block,
                     data, sufficient_size, &output_size));
 
         /* パラメータ設定 */
@@ -403,10 +596,16 @@ TEST(NARUEncoderTest, EncodeBlockTest)
                 NARU_APIRESULT_OK,
                 NARUEncoder_SetEncodeParameter(encoder, &parameter));
 
+        /* ブロック解析: 無音は圧縮データと判定される */
+        EXPECT_EQ(
+                NARU_APIRESULT_OK,
+                NARUEncoder_AnalyzeBlock(encoder, input, parameter.num_samples_per_block, &analysis));
+        EXPECT_EQ(NARU_BLOCK_DATA_TYPE_COMPRESSDATA, analysis.block_type);
+
         /* 1ブロックエンコード */
         EXPECT_EQ(
                 NARU_APIRESULT_OK,
-                NARUEncoder_EncodeBlock(encoder, input, parameter.num_samples_per_block,
+                NARUEncoder_EncodeBlock(encoder, &analysis, input, parameter.num_samples_per_block,
                     data, sufficient_size, &output_size));
 
         /* 領域の開放 */
@@ -422,6 +621,7 @@ TEST(NARUEncoderTest, EncodeBlockTest)
         struct NARUEncoder *encoder;
         struct NARUEncoderConfig config;
         struct NARUEncodeParameter parameter;
+        struct NARUBlockAnalysis analysis;
         struct NARUBitStream stream;
         int32_t *input[NARU_MAX_NUM_CHANNELS];
         uint8_t *data;
@@ -451,10 +651,16 @@ TEST(NARUEncoderTest, EncodeBlockTest)
                 NARU_APIRESULT_OK,
                 NARUEncoder_SetEncodeParameter(encoder, &parameter));
 
+        /* ブロック解析: 無音は圧縮データと判定される */
+        EXPECT_EQ(
+                NARU_APIRESULT_OK,
+                NARUEncoder_AnalyzeBlock(encoder, input, parameter.num_samples_per_block, &analysis));
+        EXPECT_EQ(NARU_BLOCK_DATA_TYPE_COMPRESSDATA, analysis.block_type);
+
         /* 1ブロックエンコード */
         EXPECT_EQ(
                 NARU_APIRESULT_OK,
-                NARUEncoder_EncodeBlock(encoder, input, parameter.num_samples_per_block,
+                NARUEncoder_EncodeBlock(encoder, &analysis, input, parameter.num_samples_per_block,
                     data, sufficient_size, &output_size));
 
         /* ブロック先頭の同期コードがあるので2バイトよりは大きいはず */
@@ -482,4 +688,524 @@ TEST(NARUEncoderTest, EncodeBlockTest)
         free(data);
         NARUEncoder_Destroy(encoder);
     }
+
+    /* 圧縮が効かない信号は生データブロックになる */
+    {
+        struct NARUEncoder *encoder;
+        struct NARUEncoderConfig config;
+        struct NARUEncodeParameter parameter;
+        struct NARUBlockAnalysis analysis;
+        int32_t *input[NARU_MAX_NUM_CHANNELS];
+        uint8_t *data;
+        uint32_t ch, smpl, sufficient_size, output_size, raw_size;
+
+        NARUEncoder_SetValidEncodeParameter(&parameter);
+        NARUEncoder_SetValidConfig(&config);
+        parameter.num_channels = 2;
+        parameter.num_samples_per_block = 1024;
+
+        /* 十分なデータサイズ */
+        sufficient_size = (2 * parameter.num_channels * parameter.num_samples_per_block * parameter.bits_per_sample) / 8;
+        /* 生データのサイズ */
+        raw_size = (parameter.num_channels * parameter.num_samples_per_block * parameter.bits_per_sample) / 8;
+
+        /* データ領域確保 */
+        data = (uint8_t *)malloc(sufficient_size);
+        for (ch = 0; ch < parameter.num_channels; ch++) {
+            input[ch] = (int32_t *)malloc(sizeof(int32_t) * parameter.num_samples_per_block);
+        }
+
+        /* 入力にフルスケールの白色雑音をセット */
+        srand(0);
+        for (ch = 0; ch < parameter.num_channels; ch++) {
+            for (smpl = 0; smpl < parameter.num_samples_per_block; smpl++) {
+                input[ch][smpl] = (rand() % (1 << 16)) - (1 << 15);
+            }
+        }
+
+        /* エンコーダ作成 */
+        encoder = NARUEncoder_Create(&config, NULL, 0);
+        ASSERT_TRUE(encoder != NULL);
+
+        /* パラメータ設定 */
+        EXPECT_EQ(
+                NARU_APIRESULT_OK,
+                NARUEncoder_SetEncodeParameter(encoder, &parameter));
+
+        /* ブロック解析: 生データと判定される */
+        EXPECT_EQ(
+                NARU_APIRESULT_OK,
+                NARUEncoder_AnalyzeBlock(encoder, input, parameter.num_samples_per_block, &analysis));
+        EXPECT_EQ(NARU_BLOCK_DATA_TYPE_RAWDATA, analysis.block_type);
+
+        /* 1ブロックエンコード */
+        EXPECT_EQ(
+                NARU_APIRESULT_OK,
+                NARUEncoder_EncodeBlock(encoder, &analysis, input, parameter.num_samples_per_block,
+                    data, sufficient_size, &output_size));
+
+        /* ブロックヘッダとインターリーブした生データだけが出力される */
+        EXPECT_EQ(NARU_BLOCK_HEADER_SIZE_FOR_CHECKSUM(parameter.block_checksum_type) + raw_size, output_size);
+        EXPECT_EQ(NARU_BLOCK_DATA_TYPE_RAWDATA, ByteArray_ReadUint8(&data[8]));
+        EXPECT_EQ(parameter.num_samples_per_block, ByteArray_ReadUint16BE(&data[9]));
+        EXPECT_EQ(NARUUTILITY_SINT32_TO_UINT32(input[0][0]) & 0xFFFFU, ByteArray_ReadUint16BE(&data[11]));
+        EXPECT_EQ(NARUUTILITY_SINT32_TO_UINT32(input[1][0]) & 0xFFFFU, ByteArray_ReadUint16BE(&data[13]));
+
+        /* 領域の開放 */
+        for (ch = 0; ch < parameter.num_channels; ch++) {
+            free(input[ch]);
+        }
+        free(data);
+        NARUEncoder_Destroy(encoder);
+    }
+}
+
+/* 十分なデータサイズ: ヘッダ + 32bit入力の2倍 */
+#define NARUEncoderTest_CalculateSufficientSize(num_channels, num_samples)\
+    (NARU_HEADER_SIZE + 2 * (num_channels) * (num_samples) * sizeof(int32_t))
+
+/* 正弦波と雑音を混ぜた信号を作成
+* 補足）乱数列は毎回先頭から作るので、引数が同じならば信号も同じになる */
+static void NARUEncoderTest_CreateSineNoiseSignal(int32_t **signal, uint32_t num_channels, uint32_t num_samples)
+{
+    uint32_t ch, smpl;
+
+    srand(0);
+    for (ch = 0; ch < num_channels; ch++) {
+        signal[ch] = (int32_t *)malloc(sizeof(int32_t) * num_samples);
+        for (smpl = 0; smpl < num_samples; smpl++) {
+            signal[ch][smpl] = (int32_t)(8192.0f * sin(0.01f * (ch + 1) * smpl)) + (rand() % 256) - 128;
+        }
+    }
+}
+
+/* 信号の領域を開放 */
+static void NARUEncoderTest_FreeSignal(int32_t **signal, uint32_t num_channels)
+{
+    uint32_t ch;
+    for (ch = 0; ch < num_channels; ch++) {
+        free(signal[ch]);
+    }
+}
+
+/* ブロック独立エンコードテスト */
+TEST(NARUEncoderTest, EncodeWholeIndependentlyTest)
+{
+    /* パラメータ設定の失敗ケース */
+    {
+        struct NARUEncoder *encoder;
+        struct NARUEncoderConfig config;
+        struct NARUEncodeParameter parameter;
+
+        NARUEncoder_SetValidConfig(&config);
+        config.max_num_threads = 2;
+        encoder = NARUEncoder_Create(&config, NULL, 0);
+        ASSERT_TRUE(encoder != NULL);
+
+        /* 先行サンプル無しでは複数スレッド指定不可 */
+        NARUEncoder_SetValidEncodeParameter(&parameter);
+        parameter.num_threads = 2;
+        parameter.num_preroll_samples = 0;
+        EXPECT_EQ(NARU_APIRESULT_INVALID_FORMAT, NARUEncoder_SetEncodeParameter(encoder, &parameter));
+
+        /* 最大スレッド数を超えている */
+        NARUEncoder_SetValidEncodeParameter(&parameter);
+        parameter.num_threads = 3;
+        parameter.num_preroll_samples = parameter.num_samples_per_block;
+        EXPECT_EQ(NARU_APIRESULT_INSUFFICIENT_BUFFER, NARUEncoder_SetEncodeParameter(encoder, &parameter));
+
+        NARUEncoder_Destroy(encoder);
+    }
+
+    /* スレッド数によらず出力が一致するか */
+    {
+#define NUM_CHANNELS 2
+#define NUM_SAMPLES  (10 * 1024 + 123)
+        struct NARUEncoder *encoder;
+        struct NARUEncoderConfig config;
+        struct NARUEncodeParameter parameter;
+        int32_t *input[NUM_CHANNELS];
+        uint8_t *data, *ref_data;
+        uint32_t data_size, ref_output_size, output_size;
+        uint8_t num_threads;
+
+        NARUEncoder_SetValidConfig(&config);
+        config.max_num_threads = 4;
+        NARUEncoder_SetValidEncodeParameter(&parameter);
+        parameter.num_channels = NUM_CHANNELS;
+        parameter.num_samples_per_block = 1024;
+        parameter.num_encode_trials = 2;
+        parameter.ch_process_method = NARU_CH_PROCESS_METHOD_MS;
+        parameter.num_preroll_samples = parameter.num_samples_per_block;
+
+        data_size = NARUEncoderTest_CalculateSufficientSize(NUM_CHANNELS, NUM_SAMPLES);
+        data = (uint8_t *)malloc(data_size);
+        ref_data = (uint8_t *)malloc(data_size);
+        NARUEncoderTest_CreateSineNoiseSignal(input, NUM_CHANNELS, NUM_SAMPLES);
+
+        encoder = NARUEncoder_Create(&config, NULL, 0);
+        ASSERT_TRUE(encoder != NULL);
+
+        /* 単一スレッドで参照データ作成 */
+        parameter.num_threads = 1;
+        ASSERT_EQ(NARU_APIRESULT_OK, NARUEncoder_SetEncodeParameter(encoder, &parameter));
+        ASSERT_EQ(NARU_APIRESULT_OK,
+                NARUEncoder_EncodeWhole(encoder, input, NUM_SAMPLES, ref_data, data_size, &ref_output_size));
+
+        for (num_threads = 2; num_threads <= 4; num_threads++) {
+            parameter.num_threads = num_threads;
+            ASSERT_EQ(NARU_APIRESULT_OK, NARUEncoder_SetEncodeParameter(encoder, &parameter));
+            ASSERT_EQ(NARU_APIRESULT_OK,
+                    NARUEncoder_EncodeWhole(encoder, input, NUM_SAMPLES, data, data_size, &output_size));
+            EXPECT_EQ(ref_output_size, output_size);
+            EXPECT_EQ(0, memcmp(ref_data, data, ref_output_size));
+        }
+
+        /* 連続して呼んでも同じ結果になる */
+        ASSERT_EQ(NARU_APIRESULT_OK,
+                NARUEncoder_EncodeWhole(encoder, input, NUM_SAMPLES, data, data_size, &output_size));
+        EXPECT_EQ(ref_output_size, output_size);
+        EXPECT_EQ(0, memcmp(ref_data, data, ref_output_size));
+
+        NARUEncoder_Destroy(encoder);
+        NARUEncoderTest_FreeSignal(input, NUM_CHANNELS);
+        free(ref_data);
+        free(data);
+#undef NUM_CHANNELS
+#undef NUM_SAMPLES
+    }
+}
+
+/* ストリーミング出力の蓄積先 */
+struct NARUEncoderTestStreamOutput {
+    uint8_t *data;
+    uint32_t size;
+    uint32_t capacity;
+};
+
+/* ストリーミング出力コールバック */
+static NARUApiResult NARUEncoderTest_WriteCallback(const uint8_t *data, uint32_t data_size, void *user_data)
+{
+    struct NARUEncoderTestStreamOutput *output = (struct NARUEncoderTestStreamOutput *)user_data;
+    if ((output->size + data_size) > output->capacity) {
+        return NARU_APIRESULT_INSUFFICIENT_BUFFER;
+    }
+    memcpy(&output->data[output->size], data, data_size);
+    output->size += data_size;
+    return NARU_APIRESULT_OK;
+}
+
+/* ストリーミングエンコードテスト */
+TEST(NARUEncoderTest, StreamingEncodeTest)
+{
+    /* 失敗ケース */
+    {
+        struct NARUEncoder *encoder;
+        struct NARUEncoderConfig config;
+        struct NARUEncodeParameter parameter;
+        struct NARUEncoderTestStreamOutput output;
+        uint8_t block_data[NARUENCODER_CALCULATE_MAX_BLOCK_SIZE(1, 32)];
+        uint8_t header_data[NARU_HEADER_SIZE];
+        int32_t samples[32] = { 0, };
+        const int32_t *input[1] = { samples };
+
+        NARUEncoder_SetValidConfig(&config);
+        encoder = NARUEncoder_Create(&config, NULL, 0);
+        ASSERT_TRUE(encoder != NULL);
+        output.capacity = 1024;
+        output.data = (uint8_t *)malloc(output.capacity);
+        output.size = 0;
+
+        /* パラメータ未設定 */
+        EXPECT_EQ(NARU_APIRESULT_PARAMETER_NOT_SET,
+                NARUEncoder_BeginStreaming(encoder, block_data, sizeof(block_data), NARUEncoderTest_WriteCallback, &output));
+
+        NARUEncoder_SetValidEncodeParameter(&parameter);
+        ASSERT_EQ(NARU_APIRESULT_OK, NARUEncoder_SetEncodeParameter(encoder, &parameter));
+
+        /* 不正な引数 */
+        EXPECT_EQ(NARU_APIRESULT_INVALID_ARGUMENT,
+                NARUEncoder_BeginStreaming(NULL, block_data, sizeof(block_data), NARUEncoderTest_WriteCallback, &output));
+        EXPECT_EQ(NARU_APIRESULT_INVALID_ARGUMENT,
+                NARUEncoder_BeginStreaming(encoder, NULL, sizeof(block_data), NARUEncoderTest_WriteCallback, &output));
+        EXPECT_EQ(NARU_APIRESULT_INVALID_ARGUMENT,
+                NARUEncoder_BeginStreaming(encoder, block_data, sizeof(block_data), NULL, &output));
+
+        /* 1ブロックが収まらない */
+        EXPECT_EQ(NARU_APIRESULT_INSUFFICIENT_BUFFER,
+                NARUEncoder_BeginStreaming(encoder, block_data, sizeof(block_data) - 1, NARUEncoderTest_WriteCallback, &output));
+
+        /* ストリーミング入力バッファを確保していない */
+        {
+            struct NARUEncoder *tmp_encoder;
+            config.enable_streaming = 0;
+            tmp_encoder = NARUEncoder_Create(&config, NULL, 0);
+            ASSERT_TRUE(tmp_encoder != NULL);
+            ASSERT_EQ(NARU_APIRESULT_OK, NARUEncoder_SetEncodeParameter(tmp_encoder, &parameter));
+            EXPECT_EQ(NARU_APIRESULT_INSUFFICIENT_BUFFER,
+                    NARUEncoder_BeginStreaming(tmp_encoder, block_data, sizeof(block_data), NARUEncoderTest_WriteCallback, &output));
+            NARUEncoder_Destroy(tmp_encoder);
+            config.enable_streaming = 1;
+        }
+
+        /* 開始前のサンプル供給と終了 */
+        EXPECT_EQ(NARU_APIRESULT_PARAMETER_NOT_SET, NARUEncoder_PushSamples(encoder, input, 32));
+        EXPECT_EQ(NARU_APIRESULT_PARAMETER_NOT_SET, NARUEncoder_FinishStreaming(encoder, header_data, sizeof(header_data)));
+
+        /* 先行サンプルが1ブロックを超える */
+        parameter.num_preroll_samples = parameter.num_samples_per_block + 1;
+        ASSERT_EQ(NARU_APIRESULT_OK, NARUEncoder_SetEncodeParameter(encoder, &parameter));
+        EXPECT_EQ(NARU_APIRESULT_INVALID_FORMAT,
+                NARUEncoder_BeginStreaming(encoder, block_data, sizeof(block_data), NARUEncoderTest_WriteCallback, &output));
+
+        /* サンプルを供給せずに終了 */
+        NARUEncoder_SetValidEncodeParameter(&parameter);
+        ASSERT_EQ(NARU_APIRESULT_OK, NARUEncoder_SetEncodeParameter(encoder, &parameter));
+        ASSERT_EQ(NARU_APIRESULT_OK,
+                NARUEncoder_BeginStreaming(encoder, block_data, sizeof(block_data), NARUEncoderTest_WriteCallback, &output));
+        EXPECT_EQ(NARU_HEADER_SIZE, output.size);
+        EXPECT_EQ(NARU_APIRESULT_INVALID_ARGUMENT, NARUEncoder_PushSamples(encoder, NULL, 32));
+        EXPECT_EQ(NARU_APIRESULT_INSUFFICIENT_BUFFER, NARUEncoder_FinishStreaming(encoder, header_data, sizeof(header_data) - 1));
+        EXPECT_EQ(NARU_APIRESULT_INSUFFICIENT_DATA, NARUEncoder_FinishStreaming(encoder, header_data, sizeof(header_data)));
+
+        /* コールバックの失敗は中断として返る */
+        output.size = 0;
+        output.capacity = NARU_HEADER_SIZE;
+        ASSERT_EQ(NARU_APIRESULT_OK,
+                NARUEncoder_BeginStreaming(encoder, block_data, sizeof(block_data), NARUEncoderTest_WriteCallback, &output));
+        EXPECT_EQ(NARU_APIRESULT_INSUFFICIENT_BUFFER, NARUEncoder_PushSamples(encoder, input, 32));
+        EXPECT_EQ(NARU_APIRESULT_PARAMETER_NOT_SET, NARUEncoder_PushSamples(encoder, input, 32));
+
+        free(output.data);
+        NARUEncoder_Destroy(encoder);
+    }
+
+    /* 供給サンプル数によらず一括エンコードと一致するか */
+    {
+#define NUM_CHANNELS 2
+#define NUM_SAMPLES  (10 * 1024 + 123)
+        struct NARUEncoder *encoder;
+        struct NARUEncoderConfig config;
+        struct NARUEncodeParameter parameter;
+        struct NARUEncoderTestStreamOutput output;
+        int32_t *input[NUM_CHANNELS];
+        const int32_t *input_ptr[NUM_CHANNELS];
+        uint8_t *ref_data, *block_data;
+        uint32_t ch, data_size, ref_output_size, block_data_size, progress, i, mode;
+        const uint32_t chunk_sizes[] = { 1, 100, 1024, 3000, NUM_SAMPLES };
+
+        NARUEncoder_SetValidConfig(&config);
+        NARUEncoder_SetValidEncodeParameter(&parameter);
+        parameter.num_channels = NUM_CHANNELS;
+        parameter.num_samples_per_block = 1024;
+        parameter.num_encode_trials = 2;
+        parameter.ch_process_method = NARU_CH_PROCESS_METHOD_MS;
+
+        data_size = NARUEncoderTest_CalculateSufficientSize(NUM_CHANNELS, NUM_SAMPLES);
+        ref_data = (uint8_t *)malloc(data_size);
+        output.data = (uint8_t *)malloc(data_size);
+        output.capacity = data_size;
+        block_data_size = NARUENCODER_CALCULATE_MAX_BLOCK_SIZE(NUM_CHANNELS, parameter.num_samples_per_block);
+        block_data = (uint8_t *)malloc(block_data_size);
+        NARUEncoderTest_CreateSineNoiseSignal(input, NUM_CHANNELS, NUM_SAMPLES);
+
+        /* 時系列順とブロック独立の両方を確認 */
+        for (mode = 0; mode < 2; mode++) {
+            parameter.num_preroll_samples = (mode == 0) ? 0 : parameter.num_samples_per_block / 2;
+
+            /* 一括エンコードで参照データ作成 */
+            encoder = NARUEncoder_Create(&config, NULL, 0);
+            ASSERT_TRUE(encoder != NULL);
+            ASSERT_EQ(NARU_APIRESULT_OK, NARUEncoder_SetEncodeParameter(encoder, &parameter));
+            ASSERT_EQ(NARU_APIRESULT_OK,
+                    NARUEncoder_EncodeWhole(encoder, input, NUM_SAMPLES, ref_data, data_size, &ref_output_size));
+
+            for (i = 0; i < sizeof(chunk_sizes) / sizeof(chunk_sizes[0]); i++) {
+                output.size = 0;
+                ASSERT_EQ(NARU_APIRESULT_OK,
+                        NARUEncoder_BeginStreaming(encoder, block_data, block_data_size, NARUEncoderTest_WriteCallback, &output));
+                for (progress = 0; progress < NUM_SAMPLES; progress += chunk_sizes[i]) {
+                    for (ch = 0; ch < NUM_CHANNELS; ch++) {
+                        input_ptr[ch] = &input[ch][progress];
+                    }
+                    ASSERT_EQ(NARU_APIRESULT_OK,
+                            NARUEncoder_PushSamples(encoder, input_ptr, NARUUTILITY_MIN(chunk_sizes[i], NUM_SAMPLES - progress)));
+                }
+                /* 先頭のヘッダを確定したヘッダで書き換える */
+                ASSERT_EQ(NARU_APIRESULT_OK, NARUEncoder_FinishStreaming(encoder, output.data, NARU_HEADER_SIZE));
+                EXPECT_EQ(ref_output_size, output.size);
+                EXPECT_EQ(0, memcmp(ref_data, output.data, ref_output_size));
+            }
+
+            NARUEncoder_Destroy(encoder);
+        }
+
+        NARUEncoderTest_FreeSignal(input, NUM_CHANNELS);
+        free(block_data);
+        free(output.data);
+        free(ref_data);
+#undef NUM_CHANNELS
+#undef NUM_SAMPLES
+    }
+}
+
+/* シークテーブル付加テスト */
+TEST(NARUEncoderTest, SeekTableEncodeTest)
+{
+    /* 一括エンコードとストリーミングエンコードで同一のシークテーブルが付加される */
+    {
+#define NUM_CHANNELS 2
+#define NUM_SAMPLES  (10 * 1024 + 123)
+        struct NARUEncoder *encoder;
+        struct NARUEncoderConfig config;
+        struct NARUEncodeParameter parameter;
+        struct NARUEncoderTestStreamOutput output;
+        int32_t *input[NUM_CHANNELS];
+        uint8_t *ref_data, *block_data;
+        uint32_t data_size, ref_output_size, block_data_size, mode, table_size, checksum_type;
+
+        NARUEncoder_SetValidConfig(&config);
+        NARUEncoder_SetValidEncodeParameter(&parameter);
+        parameter.num_channels = NUM_CHANNELS;
+        parameter.num_samples_per_block = 1024;
+        parameter.ch_process_method = NARU_CH_PROCESS_METHOD_MS;
+        parameter.use_seek_table = 1;
+
+        data_size = NARUEncoderTest_CalculateSufficientSize(NUM_CHANNELS, NUM_SAMPLES);
+        ref_data = (uint8_t *)malloc(data_size);
+        output.data = (uint8_t *)malloc(data_size);
+        output.capacity = data_size;
+        block_data_size = NARUENCODER_CALCULATE_MAX_BLOCK_SIZE(NUM_CHANNELS, parameter.num_samples_per_block);
+        block_data = (uint8_t *)malloc(block_data_size);
+        NARUEncoderTest_CreateSineNoiseSignal(input, NUM_CHANNELS, NUM_SAMPLES);
+
+        for (checksum_type = 0; checksum_type < NARU_BLOCK_CHECKSUM_TYPE_INVALID; checksum_type++) {
+            parameter.block_checksum_type = (NARUBlockChecksumType)checksum_type;
+            for (mode = 0; mode < 2; mode++) {
+                uint32_t point, read_offset;
+                const uint8_t *table;
+                parameter.num_preroll_samples = (mode == 0) ? 0 : parameter.num_samples_per_block / 2;
+
+                encoder = NARUEncoder_Create(&config, NULL, 0);
+                ASSERT_TRUE(encoder != NULL);
+                ASSERT_EQ(NARU_APIRESULT_OK, NARUEncoder_SetEncodeParameter(encoder, &parameter));
+                ASSERT_EQ(NARU_APIRESULT_OK,
+                        NARUEncoder_EncodeWhole(encoder, input, NUM_SAMPLES, ref_data, data_size, &ref_output_size));
+
+                /* ヘッダにシークテーブルありが記録され、末尾に全ブロック分のシークポイントがある */
+                EXPECT_EQ(1, ref_data[25]);
+                table_size = ByteArray_ReadUint32BE(&ref_data[ref_output_size - 4]);
+                EXPECT_EQ(NARU_SEEKTABLE_BLOCK_SIZE(checksum_type, 11), table_size);
+                table = &ref_data[ref_output_size - table_size];
+                EXPECT_EQ(NARU_BLOCK_SYNC_CODE, ByteArray_ReadUint16BE(&table[0]));
+                EXPECT_EQ(NARU_BLOCK_DATA_TYPE_SEEKTABLE, table[6 + NARU_BLOCK_CHECKSUM_SIZE(checksum_type)]);
+                EXPECT_EQ(11U, ByteArray_ReadUint32BE(&table[NARU_BLOCK_HEADER_SIZE_FOR_CHECKSUM(checksum_type)]));
+                read_offset = NARU_HEADER_SIZE;
+                for (point = 0; point < 11; point++) {
+                    const uint8_t *point_ptr = &table[NARU_BLOCK_HEADER_SIZE_FOR_CHECKSUM(checksum_type) + 4 + NARU_SEEKPOINT_SIZE * point];
+                    EXPECT_EQ(point * 1024, ByteArray_ReadUint32BE(&point_ptr[0]));
+                    EXPECT_EQ(read_offset, ByteArray_ReadUint32BE(&point_ptr[4]));
+                    EXPECT_EQ(NARU_BLOCK_SYNC_CODE, ByteArray_ReadUint16BE(&ref_data[read_offset]));
+                    read_offset += ByteArray_ReadUint32BE(&ref_data[read_offset + 2]) + 6;
+                }
+                EXPECT_EQ(ref_output_size - table_size, read_offset);
+
+                /* 出力先にシークテーブルが収まらない
+                * 補足）時系列順のエンコードはフィルタ状態を引き継ぐので、新しいハンドルで確認 */
+                {
+                    struct NARUEncoder *tmp_encoder;
+                    uint32_t output_size;
+                    tmp_encoder = NARUEncoder_Create(&config, NULL, 0);
+                    ASSERT_TRUE(tmp_encoder != NULL);
+                    ASSERT_EQ(NARU_APIRESULT_OK, NARUEncoder_SetEncodeParameter(tmp_encoder, &parameter));
+                    EXPECT_EQ(NARU_APIRESULT_INSUFFICIENT_BUFFER,
+                            NARUEncoder_EncodeWhole(tmp_encoder, input, NUM_SAMPLES, output.data, ref_output_size - 1, &output_size));
+                    NARUEncoder_Destroy(tmp_encoder);
+                }
+
+                /* ストリーミングエンコードの出力は一括エンコードに一致 */
+                output.size = 0;
+                ASSERT_EQ(NARU_APIRESULT_OK,
+                        NARUEncoder_BeginStreaming(encoder, block_data, block_data_size, NARUEncoderTest_WriteCallback, &output));
+                ASSERT_EQ(NARU_APIRESULT_OK, NARUEncoder_PushSamples(encoder, input, NUM_SAMPLES));
+                ASSERT_EQ(NARU_APIRESULT_OK, NARUEncoder_FinishStreaming(encoder, output.data, NARU_HEADER_SIZE));
+                EXPECT_EQ(ref_output_size, output.size);
+                EXPECT_EQ(0, memcmp(ref_data, output.data, ref_output_size));
+
+                NARUEncoder_Destroy(encoder);
+            }
+        }
+
+        NARUEncoderTest_FreeSignal(input, NUM_CHANNELS);
+        free(block_data);
+        free(output.data);
+        free(ref_data);
+#undef NUM_CHANNELS
+#undef NUM_SAMPLES
+    }
+
+    /* シークポイント数が上限を超えたら間引かれる */
+    {
+#define NUM_SAMPLES_PER_BLOCK 16
+#define NUM_BLOCKS            (NARUENCODER_MAX_NUM_SEEK_POINTS + 1001)
+#define NUM_SAMPLES           (NUM_SAMPLES_PER_BLOCK * NUM_BLOCKS)
+        struct NARUEncoder *encoder;
+        struct NARUEncoderConfig config;
+        struct NARUEncodeParameter parameter;
+        int32_t *input[1];
+        uint8_t *data;
+        const uint8_t *table, *point_ptr;
+        uint32_t smpl, data_size, output_size, table_size, num_points, point, block, read_offset;
+
+        NARUEncoder_SetValidConfig(&config);
+        NARUEncoder_SetValidEncodeParameter(&parameter);
+        parameter.num_channels = 1;
+        parameter.num_samples_per_block = NUM_SAMPLES_PER_BLOCK;
+        parameter.filter_order = 4;
+        parameter.ar_order = 1;
+        parameter.second_filter_order = 4;
+        parameter.num_encode_trials = 1;
+        parameter.use_seek_table = 1;
+
+        data_size = NARU_HEADER_SIZE + 4 * NUM_SAMPLES * sizeof(int32_t);
+        data = (uint8_t *)malloc(data_size);
+        input[0] = (int32_t *)malloc(sizeof(int32_t) * NUM_SAMPLES);
+        for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+            input[0][smpl] = (int32_t)(smpl % 64) - 32;
+        }
+
+        encoder = NARUEncoder_Create(&config, NULL, 0);
+        ASSERT_TRUE(encoder != NULL);
+        ASSERT_EQ(NARU_APIRESULT_OK, NARUEncoder_SetEncodeParameter(encoder, &parameter));
+        ASSERT_EQ(NARU_APIRESULT_OK, NARUEncoder_EncodeWhole(encoder, input, NUM_SAMPLES, data, data_size, &output_size));
+
+        /* 一度間引かれて2ブロックおきになる */
+        table_size = ByteArray_ReadUint32BE(&data[output_size - 4]);
+        table = &data[output_size - table_size];
+        num_points = ByteArray_ReadUint32BE(&table[NARU_BLOCK_HEADER_SIZE_FOR_CHECKSUM(NARU_BLOCK_CHECKSUM_TYPE_CRC16)]);
+        EXPECT_EQ((NUM_BLOCKS + 1) / 2, num_points);
+        EXPECT_EQ(NARU_SEEKTABLE_BLOCK_SIZE(NARU_BLOCK_CHECKSUM_TYPE_CRC16, num_points), table_size);
+
+        /* 各シークポイントが偶数番目のブロック先頭を指す */
+        point = 0;
+        read_offset = NARU_HEADER_SIZE;
+        for (block = 0; block < NUM_BLOCKS; block++) {
+            if ((block % 2) == 0) {
+                point_ptr = &table[NARU_BLOCK_HEADER_SIZE_FOR_CHECKSUM(NARU_BLOCK_CHECKSUM_TYPE_CRC16) + 4 + NARU_SEEKPOINT_SIZE * point];
+                EXPECT_EQ(block * NUM_SAMPLES_PER_BLOCK, ByteArray_ReadUint32BE(&point_ptr[0]));
+                EXPECT_EQ(read_offset, ByteArray_ReadUint32BE(&point_ptr[4]));
+                point++;
+            }
+            read_offset += ByteArray_ReadUint32BE(&data[read_offset + 2]) + 6;
+        }
+        EXPECT_EQ(num_points, point);
+        EXPECT_EQ(output_size - table_size, read_offset);
+
+        NARUEncoder_Destroy(encoder);
+        free(input[0]);
+        free(data);
+#undef NUM_SAMPLES_PER_BLOCK
+#undef NUM_BLOCKS
+#undef NUM_SAMPLES
+    }
 }
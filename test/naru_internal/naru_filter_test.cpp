@@ -0,0 +1,168 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <gtest/gtest.h>
+
+/* テスト対象のモジュール */
+extern "C" {
+#include "../../libs/naru_internal/src/naru_filter.c"
+}
+
+/* テストする最大のフィルタ次数（端数処理確認のため2の冪乗以外も含める） */
+#define NARUFILTERTEST_MAX_ORDER (NARU_MAX_FILTER_ORDER + 7)
+
+/* 関数テーブル取得テスト */
+TEST(NARUFilterTest, GetFunctionsTest)
+{
+    /* 汎用C実装は必ず取得できる */
+    EXPECT_TRUE(NARUFilter_GetFunctions(NARUFILTER_IMPLEMENTATION_SCALAR) != NULL);
+
+    /* 最速の実装は取得できる */
+    EXPECT_TRUE(NARUFilter_GetFunctions(NARUFilter_GetAvailableImplementation()) != NULL);
+
+    /* 無効な種別 */
+    EXPECT_TRUE(NARUFilter_GetFunctions(NARUFILTER_IMPLEMENTATION_NUM) == NULL);
+
+    /* フィルタ作成時には最速の実装が選ばれる */
+    {
+        void *work;
+        int32_t work_size;
+        struct NARUSAFilter *sa;
+        struct NARUNGSAFilter *ngsa;
+        const struct NARUFilterFunctions *functions
+            = NARUFilter_GetFunctions(NARUFilter_GetAvailableImplementation());
+
+        work_size = NARUSAFilter_CalculateWorkSize(NARU_MAX_FILTER_ORDER);
+        work = malloc(work_size);
+        sa = NARUSAFilter_Create(NARU_MAX_FILTER_ORDER, work, work_size);
+        ASSERT_TRUE(sa != NULL);
+        EXPECT_EQ(functions, sa->functions);
+        free(work);
+
+        work_size = NARUNGSAFilter_CalculateWorkSize(NARU_MAX_FILTER_ORDER);
+        work = malloc(work_size);
+        ngsa = NARUNGSAFilter_Create(NARU_MAX_FILTER_ORDER, work, work_size);
+        ASSERT_TRUE(ngsa != NULL);
+        EXPECT_EQ(functions, ngsa->functions);
+        free(work);
+    }
+}
+
+/* 乱数入力に対して各実装が汎用C実装と一致するか確認 */
+TEST(NARUFilterTest, RandomInputTest)
+{
+    int32_t impl, order, offset, trial;
+    int32_t weight_ref[NARUFILTERTEST_MAX_ORDER], weight_test[NARUFILTERTEST_MAX_ORDER];
+    int32_t data[NARUFILTERTEST_MAX_ORDER + 1];
+    const struct NARUFilterFunctions *reference = NARUFilter_GetFunctions(NARUFILTER_IMPLEMENTATION_SCALAR);
+
+    srand(0);
+    for (impl = 0; impl < NARUFILTER_IMPLEMENTATION_NUM; impl++) {
+        const struct NARUFilterFunctions *functions
+            = NARUFilter_GetFunctions((NARUFilterImplementation)impl);
+        /* 実行環境で使えない実装はスキップ */
+        if (functions == NULL) {
+            continue;
+        }
+        for (order = 0; order <= NARUFILTERTEST_MAX_ORDER; order++) {
+            /* 非アラインなアドレスも確認 */
+            for (offset = 0; offset <= 1; offset++) {
+                const int32_t *history = &data[offset];
+                for (trial = 0; trial < 8; trial++) {
+                    int32_t i, sign, delta, rshift;
+                    for (i = 0; i < NARUFILTERTEST_MAX_ORDER; i++) {
+                        weight_ref[i] = weight_test[i] = (rand() % (1 << 20)) - (1 << 19);
+                    }
+                    for (i = 0; i < NARUFILTERTEST_MAX_ORDER + 1; i++) {
+                        data[i] = (rand() % (1 << 17)) - (1 << 16);
+                    }
+
+                    /* 内積 */
+                    EXPECT_EQ(reference->dot_product(weight_ref, history, order),
+                            functions->dot_product(weight_test, history, order));
+
+                    /* NGSAの係数更新 */
+                    delta = (rand() % (2 * NARUNGSA_MAX_STEPSIZE_SCALE + 1)) - NARUNGSA_MAX_STEPSIZE_SCALE;
+                    rshift = NARUNGSA_STEPSIZE_SCALE_BITWIDTH + (rand() % 7);
+                    reference->update_ngsa_weight(weight_ref, history, delta, rshift, order);
+                    functions->update_ngsa_weight(weight_test, history, delta, rshift, order);
+                    EXPECT_EQ(0, memcmp(weight_ref, weight_test, sizeof(int32_t) * NARUFILTERTEST_MAX_ORDER));
+
+                    /* SAの係数更新 */
+                    sign = (rand() % 3) - 1;
+                    reference->update_sa_weight(weight_ref, history, sign, order);
+                    functions->update_sa_weight(weight_test, history, sign, order);
+                    EXPECT_EQ(0, memcmp(weight_ref, weight_test, sizeof(int32_t) * NARUFILTERTEST_MAX_ORDER));
+                }
+            }
+        }
+    }
+}
+
+/* 実信号を適応フィルタで処理したときに各実装が汎用C実装と一致するか確認 */
+TEST(NARUFilterTest, RealSignalTest)
+{
+    FILE *fp;
+    uint8_t *pcm;
+    int32_t *signal;
+    int32_t impl, order;
+    uint32_t num_samples, smpl;
+    const struct NARUFilterFunctions *reference = NARUFilter_GetFunctions(NARUFILTER_IMPLEMENTATION_SCALAR);
+
+    /* 8bitモノラルのa.wavを読み込み（ヘッダ44byteは読み飛ばす） */
+    fp = fopen("a.wav", "rb");
+    ASSERT_TRUE(fp != NULL);
+    pcm = (uint8_t *)malloc(240044);
+    num_samples = (uint32_t)fread(pcm, sizeof(uint8_t), 240044, fp) - 44;
+    fclose(fp);
+    signal = (int32_t *)malloc(sizeof(int32_t) * num_samples);
+    for (smpl = 0; smpl < num_samples; smpl++) {
+        signal[smpl] = ((int32_t)pcm[44 + smpl] - 128) << 8;
+    }
+    free(pcm);
+
+    for (impl = 0; impl < NARUFILTER_IMPLEMENTATION_NUM; impl++) {
+        const struct NARUFilterFunctions *functions
+            = NARUFilter_GetFunctions((NARUFilterImplementation)impl);
+        if (functions == NULL) {
+            continue;
+        }
+        for (order = 1; order <= NARU_MAX_FILTER_ORDER; order *= 2) {
+            int32_t ngsa_weight[2][NARU_MAX_FILTER_ORDER], sa_weight[2][NARU_MAX_FILTER_ORDER];
+            int32_t history[NARU_MAX_FILTER_ORDER];
+            const int32_t rshift = NARUNGSA_STEPSIZE_SCALE_BITWIDTH + (int32_t)NARUUTILITY_LOG2CEIL((uint32_t)order);
+            const int32_t delta_table[3] = { -(1 << NARUNGSA_STEPSIZE_SCALE_BITWIDTH), 0, (1 << NARUNGSA_STEPSIZE_SCALE_BITWIDTH) };
+            int32_t is_equal = 1;
+
+            memset(ngsa_weight, 0, sizeof(ngsa_weight));
+            memset(sa_weight, 0, sizeof(sa_weight));
+            memset(history, 0, sizeof(history));
+
+            /* 係数を適応させながら全サンプルを処理 */
+            for (smpl = 0; smpl < num_samples; smpl++) {
+                int32_t predict[2], residual[2];
+                /* NGSA相当: 自然勾配の代わりに履歴を使用 */
+                predict[0] = NARU_FIXEDPOINT_0_5 + reference->dot_product(ngsa_weight[0], history, order);
+                predict[1] = NARU_FIXEDPOINT_0_5 + functions->dot_product(ngsa_weight[1], history, order);
+                residual[0] = signal[smpl] - (predict[0] >> NARU_FIXEDPOINT_DIGITS);
+                residual[1] = signal[smpl] - (predict[1] >> NARU_FIXEDPOINT_DIGITS);
+                reference->update_ngsa_weight(ngsa_weight[0], history, delta_table[NARUUTILITY_SIGN(residual[0]) + 1], rshift, order);
+                functions->update_ngsa_weight(ngsa_weight[1], history, delta_table[NARUUTILITY_SIGN(residual[1]) + 1], rshift, order);
+                /* SA相当 */
+                reference->update_sa_weight(sa_weight[0], history, NARUUTILITY_SIGN(residual[0]), order);
+                functions->update_sa_weight(sa_weight[1], history, NARUUTILITY_SIGN(residual[1]), order);
+                is_equal &= (residual[0] == residual[1]);
+                /* 履歴更新 */
+                memmove(&history[1], &history[0], sizeof(int32_t) * (size_t)(order - 1));
+                history[0] = signal[smpl];
+            }
+
+            EXPECT_TRUE(is_equal);
+            EXPECT_EQ(0, memcmp(ngsa_weight[0], ngsa_weight[1], sizeof(int32_t) * (size_t)order));
+            EXPECT_EQ(0, memcmp(sa_weight[0], sa_weight[1], sizeof(int32_t) * (size_t)order));
+        }
+    }
+
+    free(signal);
+}
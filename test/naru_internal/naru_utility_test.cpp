@@ -36,6 +36,57 @@ TEST(NARUUtilityTest, CalculateCRC16Test)
             ret = NARUUtility_CalculateCRC16(crc16ibm_test_case[i].data, sizeof(crc16ibm_test_case[i].data));
             EXPECT_EQ(ret, crc16ibm_test_case[i].answer);
         }
+
+        /* 全実装で一致するか？ */
+        for (i = 0; i < crc16ibm_num_test_cases; i++) {
+            int32_t impl;
+            for (impl = 0; impl < NARUUTILITY_CRC16_IMPLEMENTATION_NUM; impl++) {
+                NARUUtilityCRC16Function crc16
+                    = NARUUtility_GetCRC16Function((NARUUtilityCRC16Implementation)impl);
+                if (crc16 == NULL) {
+                    continue;
+                }
+                ret = crc16(crc16ibm_test_case[i].data, sizeof(crc16ibm_test_case[i].data));
+                EXPECT_EQ(ret, crc16ibm_test_case[i].answer);
+            }
+        }
+    }
+
+    /* 実行環境で最速の実装が取得できるか？ */
+    EXPECT_TRUE(NARUUtility_GetCRC16Function(NARUUtility_GetAvailableCRC16Implementation()) != NULL);
+
+    /* 様々な長さと開始位置で1バイトずつの計算と一致するか？ */
+    {
+        int32_t impl;
+        uint32_t i, offset, size;
+        uint8_t data[16 + 1024];
+        const NARUUtilityCRC16Function bytewise
+            = NARUUtility_GetCRC16Function(NARUUTILITY_CRC16_IMPLEMENTATION_BYTEWISE);
+
+        srand(0);
+        for (i = 0; i < sizeof(data); i++) {
+            data[i] = (uint8_t)(rand() & 0xFF);
+        }
+
+        ASSERT_TRUE(bytewise != NULL);
+        for (impl = 0; impl < NARUUTILITY_CRC16_IMPLEMENTATION_NUM; impl++) {
+            NARUUtilityCRC16Function crc16
+                = NARUUtility_GetCRC16Function((NARUUtilityCRC16Implementation)impl);
+            if (crc16 == NULL) {
+                continue;
+            }
+            for (offset = 0; offset < 16; offset++) {
+                for (size = 0; size <= 1024; size++) {
+                    EXPECT_EQ(bytewise(&data[offset], size), crc16(&data[offset], size));
+                }
+            }
+        }
+
+        /* 途中結果からの継続計算が一括計算と一致するか？ */
+        for (size = 0; size <= 64; size++) {
+            EXPECT_EQ(bytewise(data, 1024),
+                    NARUUtility_UpdateCRC16(NARUUtility_CalculateCRC16(data, size), &data[size], 1024 - size));
+        }
     }
 
     /* 実データでテスト */
@@ -68,6 +119,18 @@ TEST(NARUUtilityTest, CalculateCRC16Test)
             fread(data, sizeof(uint8_t), data_size, fp);
             ret = NARUUtility_CalculateCRC16(data, data_size);
             EXPECT_EQ(ret, crc16ibm_test_case[i].answer);
+            {
+                int32_t impl;
+                for (impl = 0; impl < NARUUTILITY_CRC16_IMPLEMENTATION_NUM; impl++) {
+                    NARUUtilityCRC16Function crc16
+                        = NARUUtility_GetCRC16Function((NARUUtilityCRC16Implementation)impl);
+                    if (crc16 == NULL) {
+                        continue;
+                    }
+                    ret = crc16(data, data_size);
+                    EXPECT_EQ(ret, crc16ibm_test_case[i].answer);
+                }
+            }
 
             free(data);
             fclose(fp);
@@ -76,6 +139,120 @@ TEST(NARUUtilityTest, CalculateCRC16Test)
     }
 }
 
+/* CRC32Cの計算テスト */
+TEST(NARUUtilityTest, CalculateCRC32CTest)
+{
+    /* リファレンス値と一致するか？ */
+    {
+        int32_t impl;
+        uint32_t i;
+
+        /* テストケース */
+        struct CRC32CTestCaseFor32BitData {
+            uint8_t data[4];
+            uint32_t answer;
+        };
+
+        static const struct CRC32CTestCaseFor32BitData crc32c_test_case[] = {
+            { { 0x00, 0x00, 0x00, 0x01 }, 0xBA0CC8C4 },
+            { { 0x10, 0x00, 0x00, 0x00 }, 0xA103FAFA },
+            { { 0x00, 0xFF, 0xFF, 0x00 }, 0x7A8144EC },
+            { { 0xDE, 0xAD, 0xBE, 0xAF }, 0xB0A76A32 },
+            { { 0xAB, 0xAD, 0xCA, 0xFE }, 0xD1BAE7A3 },
+            { { 0x12, 0x34, 0x56, 0x78 }, 0x4300918A },
+        };
+        const uint32_t crc32c_num_test_cases = sizeof(crc32c_test_case) / sizeof(crc32c_test_case[0]);
+        static const uint8_t check_string[] = "123456789";
+
+        for (impl = 0; impl < NARUUTILITY_CRC32C_IMPLEMENTATION_NUM; impl++) {
+            NARUUtilityCRC32CFunction crc32c
+                = NARUUtility_GetCRC32CFunction((NARUUtilityCRC32CImplementation)impl);
+            if (crc32c == NULL) {
+                continue;
+            }
+            for (i = 0; i < crc32c_num_test_cases; i++) {
+                EXPECT_EQ(crc32c_test_case[i].answer,
+                        crc32c(crc32c_test_case[i].data, sizeof(crc32c_test_case[i].data)));
+            }
+            /* 標準的なチェック値 */
+            EXPECT_EQ(0xE3069283UL, crc32c(check_string, sizeof(check_string) - 1));
+            /* 空データ */
+            EXPECT_EQ(0UL, crc32c(check_string, 0));
+        }
+    }
+
+    /* 実行環境で最速の実装が取得できるか？ */
+    EXPECT_TRUE(NARUUtility_GetCRC32CFunction(NARUUtility_GetAvailableCRC32CImplementation()) != NULL);
+
+    /* 様々な長さと開始位置で全実装が一致するか？ */
+    {
+        int32_t impl;
+        uint32_t i, offset, size;
+        uint8_t data[16 + 8192];
+
+        srand(0);
+        for (i = 0; i < sizeof(data); i++) {
+            data[i] = (uint8_t)(rand() & 0xFF);
+        }
+
+        for (impl = 0; impl < NARUUTILITY_CRC32C_IMPLEMENTATION_NUM; impl++) {
+            NARUUtilityCRC32CFunction crc32c
+                = NARUUtility_GetCRC32CFunction((NARUUtilityCRC32CImplementation)impl);
+            if (crc32c == NULL) {
+                continue;
+            }
+            for (offset = 0; offset < 16; offset++) {
+                /* 補足）長いデータは並列処理する実装があるので、長さを飛ばしながら8192byteまで確認 */
+                for (size = 0; size <= 8192; size += (size < 1024) ? 1 : 7) {
+                    EXPECT_EQ(NARUUtility_CalculateCRC32C(&data[offset], size), crc32c(&data[offset], size));
+                }
+            }
+        }
+    }
+
+    /* 実データでテスト */
+    {
+        struct stat fstat;
+        int32_t impl;
+        uint32_t i, data_size;
+        uint8_t *data;
+        FILE *fp;
+
+        /* テストケース */
+        struct CRC32CTestCaseForFile {
+            const char *filename;
+            uint32_t answer;
+        };
+
+        static const struct CRC32CTestCaseForFile crc32c_test_case[] = {
+            { "a.wav",            0x4538063F },
+            { "PriChanIcon.png",  0xF3BE150C },
+        };
+        const uint32_t crc32c_num_test_cases
+            = sizeof(crc32c_test_case) / sizeof(crc32c_test_case[0]);
+
+        for (i = 0; i < crc32c_num_test_cases; i++) {
+            stat(crc32c_test_case[i].filename, &fstat);
+            data_size = fstat.st_size;
+            data = (uint8_t *)malloc(fstat.st_size * sizeof(uint8_t));
+
+            fp = fopen(crc32c_test_case[i].filename, "rb");
+            fread(data, sizeof(uint8_t), data_size, fp);
+            for (impl = 0; impl < NARUUTILITY_CRC32C_IMPLEMENTATION_NUM; impl++) {
+                NARUUtilityCRC32CFunction crc32c
+                    = NARUUtility_GetCRC32CFunction((NARUUtilityCRC32CImplementation)impl);
+                if (crc32c == NULL) {
+                    continue;
+                }
+                EXPECT_EQ(crc32c_test_case[i].answer, crc32c(data, data_size));
+            }
+
+            free(data);
+            fclose(fp);
+        }
+    }
+}
+
 /* データビット幅取得テスト */
 TEST(NARUUtilityTest, GetDataBitWidthTest)
 {
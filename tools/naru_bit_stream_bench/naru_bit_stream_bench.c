@@ -0,0 +1,130 @@
+#include "naru_bit_stream_bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* 1計測あたりの符号数 */
+#define NARUBITSTREAMBENCH_NUM_CODES    (1 << 20)
+/* 計測回数（最短時間を採用） */
+#define NARUBITSTREAMBENCH_NUM_TRIALS   10
+
+/* 計測する符号列の設定 */
+static const struct {
+    const char *name;       /* 名前 */
+    uint32_t max_run;       /* 通常の0のラン長の最大値 */
+    uint32_t long_run;      /* まれに現れる長いランの長さ */
+    uint32_t max_nbits;     /* 値のビット数の最大値 */
+} test_patterns[] = {
+    { "short codes",  3,   0, 16 },
+    { "rice codes",  15,  40, 24 },
+    { "long runs",   64, 200, 32 },
+};
+
+/* 符号列の作成 */
+static void make_codes(uint32_t *runs, uint32_t *vals, uint32_t *nbits, uint32_t num_codes,
+        uint32_t max_run, uint32_t long_run, uint32_t max_nbits)
+{
+    uint32_t i;
+
+    for (i = 0; i < num_codes; i++) {
+        /* 時々長いランを混ぜる */
+        runs[i] = (uint32_t)rand() % (max_run + 1);
+        if ((long_run > 0) && ((rand() % 64) == 0)) {
+            runs[i] = long_run;
+        }
+        nbits[i] = (uint32_t)rand() % (max_nbits + 1);
+        vals[i] = (nbits[i] > 0) ? ((uint32_t)rand() & (0xFFFFFFFFUL >> (32 - nbits[i]))) : 0;
+    }
+}
+
+/* 経過時間の計測開始 */
+#define NARUBITSTREAMBENCH_START_TIMER(start) ((start) = clock())
+/* 経過時間[ns]を1符号あたりに換算し最短時間を更新 */
+#define NARUBITSTREAMBENCH_UPDATE_MIN_TIME(start, min_time)\
+    do {\
+        const double __elapsed = ((double)(clock() - (start)) * 1.0e9) / CLOCKS_PER_SEC / NARUBITSTREAMBENCH_NUM_CODES;\
+        if (((min_time) < 0.0) || (__elapsed < (min_time))) {\
+            (min_time) = __elapsed;\
+        }\
+    } while (0)
+
+int main(void)
+{
+    uint32_t i, trial;
+    uint8_t *byte_data, *word_data;
+    uint32_t *runs, *vals, *nbits;
+    const size_t data_size = (size_t)NARUBITSTREAMBENCH_NUM_CODES * 32;
+    const uint32_t num_patterns = sizeof(test_patterns) / sizeof(test_patterns[0]);
+    int ret = 0;
+
+    byte_data = (uint8_t *)malloc(data_size);
+    word_data = (uint8_t *)malloc(data_size);
+    runs = (uint32_t *)malloc(sizeof(uint32_t) * NARUBITSTREAMBENCH_NUM_CODES);
+    vals = (uint32_t *)malloc(sizeof(uint32_t) * NARUBITSTREAMBENCH_NUM_CODES);
+    nbits = (uint32_t *)malloc(sizeof(uint32_t) * NARUBITSTREAMBENCH_NUM_CODES);
+    if ((byte_data == NULL) || (word_data == NULL)
+            || (runs == NULL) || (vals == NULL) || (nbits == NULL)) {
+        fprintf(stderr, "Failed to allocate memory. \n");
+        ret = 1;
+        goto EXIT;
+    }
+
+    srand(0);
+    printf("%-12s %-6s %14s %14s %8s \n", "pattern", "op", "byte[ns/code]", "64bit[ns/code]", "speedup");
+    for (i = 0; i < num_patterns; i++) {
+        clock_t start;
+        size_t byte_size = 0, word_size = 0;
+        uint32_t byte_checksum = 0, word_checksum = 0;
+        double byte_write = -1.0, word_write = -1.0, byte_read = -1.0, word_read = -1.0;
+
+        make_codes(runs, vals, nbits, NARUBITSTREAMBENCH_NUM_CODES,
+                test_patterns[i].max_run, test_patterns[i].long_run, test_patterns[i].max_nbits);
+
+        for (trial = 0; trial < NARUBITSTREAMBENCH_NUM_TRIALS; trial++) {
+            NARUBITSTREAMBENCH_START_TIMER(start);
+            byte_size = NARUBitStreamBench_WriteByte(byte_data, data_size, runs, vals, nbits, NARUBITSTREAMBENCH_NUM_CODES);
+            NARUBITSTREAMBENCH_UPDATE_MIN_TIME(start, byte_write);
+            NARUBITSTREAMBENCH_START_TIMER(start);
+            word_size = NARUBitStreamBench_Write64bit(word_data, data_size, runs, vals, nbits, NARUBITSTREAMBENCH_NUM_CODES);
+            NARUBITSTREAMBENCH_UPDATE_MIN_TIME(start, word_write);
+        }
+
+        /* 書き込み結果はバイト単位で一致するはず */
+        if ((byte_size != word_size) || (memcmp(byte_data, word_data, byte_size) != 0)) {
+            fprintf(stderr, "%s: written data mismatch. \n", test_patterns[i].name);
+            ret = 1;
+        }
+
+        for (trial = 0; trial < NARUBITSTREAMBENCH_NUM_TRIALS; trial++) {
+            NARUBITSTREAMBENCH_START_TIMER(start);
+            byte_checksum = NARUBitStreamBench_ReadByte(byte_data, byte_size, nbits, NARUBITSTREAMBENCH_NUM_CODES);
+            NARUBITSTREAMBENCH_UPDATE_MIN_TIME(start, byte_read);
+            NARUBITSTREAMBENCH_START_TIMER(start);
+            word_checksum = NARUBitStreamBench_Read64bit(byte_data, byte_size, nbits, NARUBITSTREAMBENCH_NUM_CODES);
+            NARUBITSTREAMBENCH_UPDATE_MIN_TIME(start, word_read);
+        }
+
+        /* 両者の読み込み結果は一致するはず */
+        if (byte_checksum != word_checksum) {
+            fprintf(stderr, "%s: read checksum mismatch (%08X, %08X). \n",
+                    test_patterns[i].name, byte_checksum, word_checksum);
+            ret = 1;
+        }
+
+        printf("%-12s %-6s %14.2f %14.2f %7.2fx \n",
+                test_patterns[i].name, "write", byte_write, word_write, byte_write / word_write);
+        printf("%-12s %-6s %14.2f %14.2f %7.2fx \n",
+                test_patterns[i].name, "read", byte_read, word_read, byte_read / word_read);
+    }
+
+EXIT:
+    free(nbits);
+    free(vals);
+    free(runs);
+    free(word_data);
+    free(byte_data);
+
+    return ret;
+}
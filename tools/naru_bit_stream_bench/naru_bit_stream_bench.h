@@ -0,0 +1,27 @@
+#ifndef NARU_BIT_STREAM_BENCH_H_INCLUDED
+#define NARU_BIT_STREAM_BENCH_H_INCLUDED
+
+#include "naru_stdint.h"
+#include <stddef.h>
+
+/* 符号列は（0のラン長 + 1 + nbits[i]ビットの値）の並び */
+
+/* 64bitバッファによる符号列の書き込み 書き込んだバイト数を返す */
+size_t NARUBitStreamBench_Write64bit(
+        uint8_t *data, size_t data_size,
+        const uint32_t *runs, const uint32_t *vals, const uint32_t *nbits, uint32_t num_codes);
+
+/* 1バイトずつの符号列の書き込み 書き込んだバイト数を返す */
+size_t NARUBitStreamBench_WriteByte(
+        uint8_t *data, size_t data_size,
+        const uint32_t *runs, const uint32_t *vals, const uint32_t *nbits, uint32_t num_codes);
+
+/* 64bitバッファによる符号列の読み込み 読んだ値のチェックサムを返す */
+uint32_t NARUBitStreamBench_Read64bit(
+        const uint8_t *data, size_t data_size, const uint32_t *nbits, uint32_t num_codes);
+
+/* 1バイトずつの符号列の読み込み 読んだ値のチェックサムを返す */
+uint32_t NARUBitStreamBench_ReadByte(
+        const uint8_t *data, size_t data_size, const uint32_t *nbits, uint32_t num_codes);
+
+#endif /* NARU_BIT_STREAM_BENCH_H_INCLUDED */
@@ -0,0 +1,59 @@
+#include "naru_bit_stream_bench.h"
+#include "naru_bit_stream.h"
+
+/* 関数名の接尾辞はコンパイル時に指定する */
+#if !defined(NARUBITSTREAMBENCH_FUNCTION_SUFFIX)
+#error "NARUBITSTREAMBENCH_FUNCTION_SUFFIX must be defined."
+#endif
+
+/* 接尾辞を付けた関数名の生成 */
+#define NARUBITSTREAMBENCH_CONCAT_(name, suffix) name ## suffix
+#define NARUBITSTREAMBENCH_CONCAT(name, suffix) NARUBITSTREAMBENCH_CONCAT_(name, suffix)
+#define NARUBITSTREAMBENCH_FUNCTION(name) NARUBITSTREAMBENCH_CONCAT(name, NARUBITSTREAMBENCH_FUNCTION_SUFFIX)
+
+/* 符号列の書き込み */
+size_t NARUBITSTREAMBENCH_FUNCTION(NARUBitStreamBench_Write)(
+        uint8_t *data, size_t data_size,
+        const uint32_t *runs, const uint32_t *vals, const uint32_t *nbits, uint32_t num_codes)
+{
+    uint32_t i;
+    int32_t size;
+    struct NARUBitStream stream;
+
+    NARUBitWriter_Open(&stream, data, data_size);
+
+    for (i = 0; i < num_codes; i++) {
+        NARUBitWriter_PutZeroRun(&stream, runs[i]);
+        NARUBitWriter_PutBits(&stream, 1, 1);
+        if (nbits[i] > 0) {
+            NARUBitWriter_PutBits(&stream, vals[i], nbits[i]);
+        }
+    }
+
+    NARUBitStream_Flush(&stream);
+    NARUBitStream_Tell(&stream, &size);
+    NARUBitStream_Close(&stream);
+
+    return (size_t)size;
+}
+
+/* 符号列の読み込み */
+uint32_t NARUBITSTREAMBENCH_FUNCTION(NARUBitStreamBench_Read)(
+        const uint8_t *data, size_t data_size, const uint32_t *nbits, uint32_t num_codes)
+{
+    uint32_t i, run, val, checksum;
+    struct NARUBitStream stream;
+
+    NARUBitReader_Open(&stream, (uint8_t *)data, data_size);
+
+    checksum = 0;
+    for (i = 0; i < num_codes; i++) {
+        NARUBitReader_GetZeroRunLength(&stream, &run);
+        NARUBitReader_GetBits(&stream, &val, nbits[i]);
+        checksum = (checksum * 31) + run + val;
+    }
+
+    NARUBitStream_Close(&stream);
+
+    return checksum;
+}
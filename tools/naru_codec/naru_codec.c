@@ -19,8 +19,20 @@ static struct CommandLineParserSpecification command_line_spec[] = {
     { 'm', "mode", COMMAND_LINE_PARSER_TRUE,
         "Specify compress mode: 0(fast decode), ..., 4(high compression) default:2",
         NULL, COMMAND_LINE_PARSER_FALSE },
+    { 't', "threads", COMMAND_LINE_PARSER_TRUE,
+        "Specify number of threads(1-255, over 1 enables block-independent encoding) default:1",
+        NULL, COMMAND_LINE_PARSER_FALSE },
+    { 'r', "rans", COMMAND_LINE_PARSER_FALSE,
+        "Use rANS entropy coder for blocks where it is smaller than recursive Rice coder",
+        NULL, COMMAND_LINE_PARSER_FALSE },
+    { 'k', "checksum", COMMAND_LINE_PARSER_TRUE,
+        "Specify block checksum at encoding(crc16 or crc32c) default:crc16",
+        NULL, COMMAND_LINE_PARSER_FALSE },
+    { 's', "seek-table", COMMAND_LINE_PARSER_FALSE,
+        "Append a seek table for fast seeking",
+        NULL, COMMAND_LINE_PARSER_FALSE },
     { 'c', "crc-check", COMMAND_LINE_PARSER_TRUE,
-        "Whether to check CRC16 at decoding(yes or no) default:yes",
+        "Whether to check block checksum at decoding(yes or no) default:yes",
         NULL, COMMAND_LINE_PARSER_FALSE },
     { 'h', "help", COMMAND_LINE_PARSER_FALSE,
         "Show command help message",
@@ -54,7 +66,8 @@ static const uint32_t num_encode_preset = sizeof(encode_preset) / sizeof(encode_
 static const uint32_t default_preset_no = 2;
 
 /* エンコード 成功時は0、失敗時は0以外を返す */
-static int do_encode(const char* in_filename, const char* out_filename, uint32_t encode_preset_no)
+static int do_encode(const char* in_filename, const char* out_filename, uint32_t encode_preset_no, uint8_t num_threads, uint8_t use_rans,
+        NARUBlockChecksumType block_checksum_type, uint8_t use_seek_table)
 {
     FILE *out_fp;
     struct WAVFile *in_wav;
@@ -72,6 +85,10 @@ static int do_encode(const char* in_filename, const char* out_filename, uint32_t
     config.max_num_channels = NARU_MAX_NUM_CHANNELS;
     config.max_num_samples_per_block = 60 * 1024;
     config.max_filter_order = NARU_MAX_FILTER_ORDER;
+    config.max_num_threads = num_threads;
+    config.enable_streaming = 0;
+    config.enable_rans = use_rans;
+    config.enable_seek_table = use_seek_table;
     if ((encoder = NARUEncoder_Create(&config, NULL, 0)) == NULL) {
         fprintf(stderr, "Failed to create encoder handle. \n");
         return 1;
@@ -102,6 +119,12 @@ static int do_encode(const char* in_filename, const char* out_filename, uint32_t
     parameter.second_filter_order = encode_preset[encode_preset_no].second_filter_order;
     parameter.ch_process_method = encode_preset[encode_preset_no].ch_process_method;
     parameter.num_encode_trials = encode_preset[encode_preset_no].num_encode_trials;
+    /* 複数スレッド指定時は直前の1ブロックでフィルタを慣らしてブロック独立にエンコード */
+    parameter.num_threads = num_threads;
+    parameter.num_preroll_samples = (num_threads > 1) ? parameter.num_samples_per_block : 0;
+    parameter.use_rans = use_rans;
+    parameter.block_checksum_type = block_checksum_type;
+    parameter.use_seek_table = use_seek_table;
     /* 2ch未満の信号にはMS処理できないので無効に */
     if (num_channels < 2) {
         parameter.ch_process_method = NARU_CH_PROCESS_METHOD_NONE;
@@ -156,7 +179,7 @@ static int do_encode(const char* in_filename, const char* out_filename, uint32_t
 }
 
 /* デコード 成功時は0、失敗時は0以外を返す */
-static int do_decode(const char* in_filename, const char* out_filename, uint8_t check_crc)
+static int do_decode(const char* in_filename, const char* out_filename, uint8_t check_crc, uint8_t num_threads)
 {
     FILE* in_fp;
     struct WAVFile* out_wav;
@@ -173,6 +196,8 @@ static int do_decode(const char* in_filename, const char* out_filename, uint8_t
     config.max_num_channels = NARU_MAX_NUM_CHANNELS;
     config.max_filter_order = NARU_MAX_FILTER_ORDER;
     config.check_crc        = check_crc;
+    config.max_num_threads  = num_threads;
+    config.max_num_samples_per_block = 0;
     if ((decoder = NARUDecoder_Create(&config, NULL, 0)) == NULL) {
         fprintf(stderr, "Failed to create decoder handle. \n");
         return 1;
@@ -253,6 +278,7 @@ int main(int argc, char** argv)
     const char* filename_ptr[2] = { NULL, NULL };
     const char* input_file;
     const char* output_file;
+    uint32_t num_threads = 1;
 
     /* 引数が足らない */
     if (argc == 1) {
@@ -299,6 +325,15 @@ int main(int argc, char** argv)
         return 1;
     }
 
+    /* スレッド数取得 */
+    if (CommandLineParser_GetOptionAcquired(command_line_spec, "threads") == COMMAND_LINE_PARSER_TRUE) {
+        num_threads = (uint32_t)strtol(CommandLineParser_GetArgumentString(command_line_spec, "threads"), NULL, 10);
+        if ((num_threads == 0) || (num_threads > 255)) {
+            fprintf(stderr, "%s: number of threads is out of range. \n", argv[0]);
+            return 1;
+        }
+    }
+
     if (CommandLineParser_GetOptionAcquired(command_line_spec, "decode") == COMMAND_LINE_PARSER_TRUE) {
         /* デコード */
         uint8_t crc_check = 1;
@@ -309,13 +344,15 @@ int main(int argc, char** argv)
             crc_check = (strcmp(crc_check_arg, "yes") == 0) ? 1 : 0;
         }
         /* 一括デコード実行 */
-        if (do_decode(input_file, output_file, crc_check) != 0) {
+        if (do_decode(input_file, output_file, crc_check, (uint8_t)num_threads) != 0) {
             fprintf(stderr, "%s: failed to decode %s. \n", argv[0], input_file);
             return 1;
         }
     } else if (CommandLineParser_GetOptionAcquired(command_line_spec, "encode") == COMMAND_LINE_PARSER_TRUE) {
         /* エンコード */
         uint32_t encode_preset_no = default_preset_no;
+        uint8_t use_rans = 0, use_seek_table = 0;
+        NARUBlockChecksumType block_checksum_type = NARU_BLOCK_CHECKSUM_TYPE_CRC16;
         /* エンコードプリセット番号取得 */
         if (CommandLineParser_GetOptionAcquired(command_line_spec, "mode") == COMMAND_LINE_PARSER_TRUE) {
             encode_preset_no = (uint32_t)strtol(CommandLineParser_GetArgumentString(command_line_spec, "mode"), NULL, 10);
@@ -324,8 +361,29 @@ int main(int argc, char** argv)
                 return 1;
             }
         }
+        /* rANS符号を使うか */
+        if (CommandLineParser_GetOptionAcquired(command_line_spec, "rans") == COMMAND_LINE_PARSER_TRUE) {
+            use_rans = 1;
+        }
+        /* ブロックのチェックサム種別取得 */
+        if (CommandLineParser_GetOptionAcquired(command_line_spec, "checksum") == COMMAND_LINE_PARSER_TRUE) {
+            const char* checksum_arg
+                = CommandLineParser_GetArgumentString(command_line_spec, "checksum");
+            if (strcmp(checksum_arg, "crc16") == 0) {
+                block_checksum_type = NARU_BLOCK_CHECKSUM_TYPE_CRC16;
+            } else if (strcmp(checksum_arg, "crc32c") == 0) {
+                block_checksum_type = NARU_BLOCK_CHECKSUM_TYPE_CRC32C;
+            } else {
+                fprintf(stderr, "%s: unknown block checksum %s. \n", argv[0], checksum_arg);
+                return 1;
+            }
+        }
+        /* シークテーブルを付加するか */
+        if (CommandLineParser_GetOptionAcquired(command_line_spec, "seek-table") == COMMAND_LINE_PARSER_TRUE) {
+            use_seek_table = 1;
+        }
         /* 一括エンコード実行 */
-        if (do_encode(input_file, output_file, encode_preset_no) != 0) {
+        if (do_encode(input_file, output_file, encode_preset_no, (uint8_t)num_threads, use_rans, block_checksum_type, use_seek_table) != 0) {
             fprintf(stderr, "%s: failed to encode %s. \n", argv[0], input_file);
             return 1;
         }
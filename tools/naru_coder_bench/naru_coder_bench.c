@@ -0,0 +1,212 @@
+#include "naru_coder.h"
+#include "naru_bit_stream.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+/* チャンネル数 */
+#define NARUCODERBENCH_NUM_CHANNELS     2
+/* 1ブロックあたりのサンプル数 */
+#define NARUCODERBENCH_NUM_SAMPLES      4096
+/* 1計測あたりのブロック数 */
+#define NARUCODERBENCH_NUM_BLOCKS       32
+/* 再帰的ライス符号のパラメータ数 */
+#define NARUCODERBENCH_NUM_PARAMETERS   2
+/* 計測回数（最短時間を採用） */
+#define NARUCODERBENCH_NUM_TRIALS       20
+/* 計測する符号の種類数（0:再帰的ライス符号, 1:rANS符号） */
+#define NARUCODERBENCH_NUM_CODER_TYPES  2
+/* 1計測あたりの符号数 */
+#define NARUCODERBENCH_NUM_SYMBOLS\
+    ((double)NARUCODERBENCH_NUM_CHANNELS * NARUCODERBENCH_NUM_SAMPLES * NARUCODERBENCH_NUM_BLOCKS)
+
+/* 計測する残差の設定 */
+static const struct {
+    const char *name;   /* 名前 */
+    double scale;       /* ラプラス分布の尺度（平均絶対値） */
+} test_patterns[] = {
+    { "silent-ish",      1.0 },
+    { "quiet",          40.0 },
+    { "moderate",      800.0 },
+    { "loud",        20000.0 },
+};
+
+/* 符号の名前 */
+static const char *coder_name[NARUCODERBENCH_NUM_CODER_TYPES] = { "rice", "rans" };
+
+/* ラプラス分布に従う残差の作成 */
+static void make_residual(int32_t *data, uint32_t num_samples, double scale)
+{
+    uint32_t i;
+
+    for (i = 0; i < num_samples; i++) {
+        const double u = ((double)rand() + 1.0) / ((double)RAND_MAX + 2.0);
+        const double abs = -scale * log(u);
+        data[i] = (int32_t)((rand() & 1) ? abs : -abs);
+    }
+}
+
+/* 経過時間の計測開始 */
+#define NARUCODERBENCH_START_TIMER(start) ((start) = clock())
+/* 経過時間[ns]を1符号あたりに換算し最短時間を更新 */
+#define NARUCODERBENCH_UPDATE_MIN_TIME(start, min_time)\
+    do {\
+        const double __elapsed = ((double)(clock() - (start)) * 1.0e9) / CLOCKS_PER_SEC / NARUCODERBENCH_NUM_SYMBOLS;\
+        if (((min_time) < 0.0) || (__elapsed < (min_time))) {\
+            (min_time) = __elapsed;\
+        }\
+    } while (0)
+
+int main(void)
+{
+    uint32_t i, ch, blk, trial;
+    int32_t *data[NARUCODERBENCH_NUM_BLOCKS][NARUCODERBENCH_NUM_CHANNELS];
+    int32_t *decoded[NARUCODERBENCH_NUM_CHANNELS];
+    uint32_t encoded_size[NARUCODERBENCH_NUM_BLOCKS];
+    uint32_t substream_size[NARUCODERBENCH_NUM_BLOCKS][NARUCODERBENCH_NUM_CHANNELS];
+    uint32_t coder_type;
+    uint32_t *work;
+    uint8_t *encoded;
+    struct NARUCoder *coder;
+    struct NARUBitStream stream;
+    const uint32_t block_capacity = NARUCODERBENCH_NUM_CHANNELS * NARUCODERBENCH_NUM_SAMPLES * 8;
+    const uint32_t num_patterns = sizeof(test_patterns) / sizeof(test_patterns[0]);
+    int ret = 0;
+
+    /* 領域確保 */
+    coder = NARUCoder_Create(NARUCODERBENCH_NUM_CHANNELS, NARUCODERBENCH_NUM_PARAMETERS, NULL, 0);
+    encoded = (uint8_t *)malloc((size_t)block_capacity * NARUCODERBENCH_NUM_BLOCKS);
+    work = (uint32_t *)malloc(sizeof(uint32_t) * NARUCODERBENCH_NUM_SAMPLES);
+    for (ch = 0; ch < NARUCODERBENCH_NUM_CHANNELS; ch++) {
+        decoded[ch] = (int32_t *)malloc(sizeof(int32_t) * NARUCODERBENCH_NUM_SAMPLES);
+        for (blk = 0; blk < NARUCODERBENCH_NUM_BLOCKS; blk++) {
+            data[blk][ch] = (int32_t *)malloc(sizeof(int32_t) * NARUCODERBENCH_NUM_SAMPLES);
+            if (data[blk][ch] == NULL) {
+                ret = 1;
+            }
+        }
+        if (decoded[ch] == NULL) {
+            ret = 1;
+        }
+    }
+    if ((coder == NULL) || (encoded == NULL) || (work == NULL) || (ret != 0)) {
+        fprintf(stderr, "Failed to allocate memory. \n");
+        return 1;
+    }
+
+    srand(0);
+    printf("%-12s %-6s %10s %16s %16s \n", "pattern", "coder", "bits/smpl", "encode[ns/smpl]", "decode[ns/smpl]");
+    for (i = 0; i < num_patterns; i++) {
+        for (blk = 0; blk < NARUCODERBENCH_NUM_BLOCKS; blk++) {
+            for (ch = 0; ch < NARUCODERBENCH_NUM_CHANNELS; ch++) {
+                make_residual(data[blk][ch], NARUCODERBENCH_NUM_SAMPLES, test_patterns[i].scale);
+            }
+        }
+
+        /* 初期パラメータは全ブロック共通とし、計測から除く */
+        NARUCoder_CalculateInitialRecursiveRiceParameter(coder, NARUCODERBENCH_NUM_PARAMETERS,
+                (const int32_t **)data[0], NARUCODERBENCH_NUM_CHANNELS, NARUCODERBENCH_NUM_SAMPLES);
+
+        for (coder_type = 0; coder_type < NARUCODERBENCH_NUM_CODER_TYPES; coder_type++) {
+            clock_t start;
+            double encode_time = -1.0, decode_time = -1.0;
+            double total_bits = 0.0;
+
+            /* 符号化: フォーマットに合わせてチャンネル毎にバイト境界から符号化 */
+            for (trial = 0; trial < NARUCODERBENCH_NUM_TRIALS; trial++) {
+                NARUCODERBENCH_START_TIMER(start);
+                for (blk = 0; blk < NARUCODERBENCH_NUM_BLOCKS; blk++) {
+                    uint32_t offset = 0;
+                    uint8_t *block = &encoded[blk * block_capacity];
+                    NARUBitWriter_Open(&stream, block, block_capacity);
+                    for (ch = 0; ch < NARUCODERBENCH_NUM_CHANNELS; ch++) {
+                        NARUCoder_PutInitialRecursiveRiceParameter(coder, &stream, NARUCODERBENCH_NUM_PARAMETERS, ch);
+                    }
+                    NARUBitStream_Flush(&stream);
+                    NARUBitStream_Tell(&stream, (int32_t *)&offset);
+                    NARUBitStream_Close(&stream);
+                    for (ch = 0; ch < NARUCODERBENCH_NUM_CHANNELS; ch++) {
+                        uint32_t size;
+                        if (coder_type == 0) {
+                            NARUBitWriter_Open(&stream, &block[offset], block_capacity - offset);
+                            NARUCoder_PutChannelDataArray(coder, &stream, NARUCODERBENCH_NUM_PARAMETERS,
+                                    ch, data[blk][ch], NARUCODERBENCH_NUM_SAMPLES);
+                            NARUBitStream_Flush(&stream);
+                            NARUBitStream_Tell(&stream, (int32_t *)&size);
+                            NARUBitStream_Close(&stream);
+                        } else if (NARUCoder_PutChannelDataArrayRANS(coder, ch, data[blk][ch], NARUCODERBENCH_NUM_SAMPLES,
+                                    work, &block[offset], block_capacity - offset, &size) != NARU_ERROR_OK) {
+                            fprintf(stderr, "%s: failed to encode. \n", test_patterns[i].name);
+                            return 1;
+                        }
+                        substream_size[blk][ch] = size;
+                        offset += size;
+                    }
+                    encoded_size[blk] = offset;
+                }
+                NARUCODERBENCH_UPDATE_MIN_TIME(start, encode_time);
+            }
+
+            /* 復号 */
+            for (trial = 0; trial < NARUCODERBENCH_NUM_TRIALS; trial++) {
+                NARUCODERBENCH_START_TIMER(start);
+                for (blk = 0; blk < NARUCODERBENCH_NUM_BLOCKS; blk++) {
+                    uint32_t offset = 0;
+                    const uint8_t *block = &encoded[blk * block_capacity];
+                    NARUBitReader_Open(&stream, (uint8_t *)block, encoded_size[blk]);
+                    for (ch = 0; ch < NARUCODERBENCH_NUM_CHANNELS; ch++) {
+                        NARUCoder_GetInitialRecursiveRiceParameter(coder, &stream, NARUCODERBENCH_NUM_PARAMETERS, ch);
+                    }
+                    NARUBitStream_Flush(&stream);
+                    NARUBitStream_Tell(&stream, (int32_t *)&offset);
+                    NARUBitStream_Close(&stream);
+                    for (ch = 0; ch < NARUCODERBENCH_NUM_CHANNELS; ch++) {
+                        uint32_t size;
+                        if (coder_type == 0) {
+                            NARUBitReader_Open(&stream, (uint8_t *)&block[offset], substream_size[blk][ch]);
+                            NARUCoder_GetChannelDataArray(coder, &stream, NARUCODERBENCH_NUM_PARAMETERS,
+                                    ch, decoded[ch], NARUCODERBENCH_NUM_SAMPLES);
+                            NARUBitStream_Close(&stream);
+                        } else if (NARUCoder_GetChannelDataArrayRANS(coder, ch, &block[offset], substream_size[blk][ch],
+                                    decoded[ch], NARUCODERBENCH_NUM_SAMPLES, &size) != NARU_ERROR_OK) {
+                            fprintf(stderr, "%s: failed to decode. \n", test_patterns[i].name);
+                            return 1;
+                        }
+                        offset += substream_size[blk][ch];
+                    }
+                }
+                NARUCODERBENCH_UPDATE_MIN_TIME(start, decode_time);
+            }
+
+            /* 最終ブロックが元に戻るか確認 */
+            for (ch = 0; ch < NARUCODERBENCH_NUM_CHANNELS; ch++) {
+                if (memcmp(decoded[ch], data[NARUCODERBENCH_NUM_BLOCKS - 1][ch],
+                            sizeof(int32_t) * NARUCODERBENCH_NUM_SAMPLES) != 0) {
+                    fprintf(stderr, "%s: decoded data mismatch. \n", test_patterns[i].name);
+                    ret = 1;
+                }
+            }
+
+            for (blk = 0; blk < NARUCODERBENCH_NUM_BLOCKS; blk++) {
+                total_bits += 8.0 * encoded_size[blk];
+            }
+            printf("%-12s %-6s %10.3f %16.2f %16.2f \n", test_patterns[i].name, coder_name[coder_type],
+                    total_bits / NARUCODERBENCH_NUM_SYMBOLS, encode_time, decode_time);
+        }
+    }
+
+    for (ch = 0; ch < NARUCODERBENCH_NUM_CHANNELS; ch++) {
+        for (blk = 0; blk < NARUCODERBENCH_NUM_BLOCKS; blk++) {
+            free(data[blk][ch]);
+        }
+        free(decoded[ch]);
+    }
+    free(work);
+    free(encoded);
+    NARUCoder_Destroy(coder);
+
+    return ret;
+}
@@ -72,6 +72,8 @@ int main(int argc, char **argv)
     decoder_config.max_num_channels = NARU_MAX_NUM_CHANNELS;
     decoder_config.max_filter_order = NARU_MAX_FILTER_ORDER;
     decoder_config.check_crc        = 1;
+    decoder_config.max_num_threads  = 1;
+    decoder_config.max_num_samples_per_block = 0;
     if ((decoder = NARUDecoder_Create(&decoder_config, NULL, 0)) == NULL) {
         fprintf(stderr, "Failed to create decoder handle. \n");
         return 1;